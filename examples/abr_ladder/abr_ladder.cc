@@ -0,0 +1,70 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <iostream>
+#include <string>
+
+struct LadderStep {
+  const char* name;
+  int width;
+  int height;
+  int64_t bit_rate;
+};
+
+static const LadderStep kLadder[] = {
+  { "1080p", 1920, 1080, 5000000 },
+  { "720p", 1280, 720, 3000000 },
+  { "480p", 854, 480, 1400000 },
+  { "360p", 640, 360, 800000 },
+};
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <input file> <output prefix> [encoder name]" << std::endl;
+    return 1;
+  }
+
+  std::string prefix = argv[2];
+  avc::AvcAbrLadderConfig config;
+  for (const LadderStep& step : kLadder) {
+    avc::AvcAbrRendition rendition;
+    rendition.url_ = prefix + "_" + step.name + ".mp4";
+    rendition.width_ = step.width;
+    rendition.height_ = step.height;
+    rendition.bit_rate_ = step.bit_rate;
+    if (argc > 3)
+      rendition.encoder_name_ = argv[3];
+    config.renditions_.push_back(rendition);
+  }
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  auto ladder = avc::CreateAvcAbrLadder(avc_loader, config);
+  if (!ladder) {
+    std::cerr << "Cannot create ladder" << std::endl;
+    return 2;
+  }
+
+  int res = ladder->Run(argv[1]);
+  avc::AvcAbrLadderStatistics stat = ladder->GetStatistics();
+  if (res < 0)
+    std::cerr << "Ladder failed, error " << res << std::endl;
+
+  double per_second = stat.elapsed_ms_ > 0 ? stat.frames_decoded_ * 1000.0 / stat.elapsed_ms_ : 0;
+  std::cerr << "  decoded frames " << stat.frames_decoded_
+    << ", " << static_cast<int>(stat.elapsed_ms_) << " ms"
+    << ", " << per_second << " frames/s"
+    << ", decoder waits " << stat.decoder_waits_ << std::endl;
+
+  for (size_t i = 0; i < stat.renditions_.size(); i++) {
+    const avc::AvcAbrRenditionStatistics& rendition = stat.renditions_[i];
+    std::cerr << "  " << kLadder[i].name << ": frames " << rendition.frames_submitted_
+      << ", scaled " << rendition.frames_scaled_ << " in " << static_cast<int>(rendition.scale_ms_) << " ms"
+      << ", packets " << rendition.packets_written_
+      << ", " << rendition.bytes_written_ / 1024 << " KB" << std::endl;
+  }
+  return res < 0 ? 2 : 0;
+}
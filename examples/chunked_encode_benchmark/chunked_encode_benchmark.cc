@@ -0,0 +1,57 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <media file> [max threads] [output file]" << std::endl;
+    return 1;
+  }
+
+  std::string input_url = argv[1];
+  int max_threads = argc > 2 ? std::max(1, atoi(argv[2])) : static_cast<int>(std::thread::hardware_concurrency());
+  std::string output_url = argc > 3 ? argv[3] : "chunked_output.mp4";
+  if (max_threads < 1)
+    max_threads = 1;
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  double single_thread_ms = 0;
+  for (int threads = 1; threads <= max_threads; threads = threads < max_threads ? std::min(threads * 2, max_threads) : threads + 1) {
+    avc::AvcChunkedEncoderConfig config;
+    config.threads_count_ = threads;
+    auto encoder = avc::CreateAvcChunkedEncoder(avc_loader, config);
+    if (!encoder) {
+      std::cerr << "Cannot create chunked encoder" << std::endl;
+      return 2;
+    }
+
+    int ret = encoder->Encode(input_url, output_url);
+    if (ret < 0) {
+      std::cerr << "Encoding with " << threads << " threads failed " << ret << std::endl;
+      return 3;
+    }
+
+    auto stat = encoder->GetStatistics();
+    double total_ms = stat.split_ms_ + stat.encode_ms_ + stat.join_ms_;
+    if (threads == 1)
+      single_thread_ms = total_ms;
+
+    printf("threads %2d: chunks %3zu (%s), split %8.1f ms, encode %9.1f ms, join %8.1f ms, %8.1f frames/s, speedup %5.2f\n",
+      threads, encoder->GetChunks().size(), stat.index_used_ ? "index" : "scan",
+      stat.split_ms_, stat.encode_ms_, stat.join_ms_,
+      stat.frames_encoded_ * 1000.0 / total_ms, single_thread_ms / total_ms);
+  }
+
+  return 0;
+}
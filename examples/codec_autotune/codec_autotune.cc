@@ -0,0 +1,61 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+static void PrintSettings(const char* title, const avc::AvcCodecThreadSettings& settings) {
+  std::cerr << title << ": threads " << settings.thread_count_ << ", type ";
+  if (settings.thread_type_ == FF_THREAD_FRAME)
+    std::cerr << "frame";
+  else if (settings.thread_type_ == FF_THREAD_SLICE)
+    std::cerr << "slice";
+  else
+    std::cerr << "default";
+  std::cerr << ", slices " << settings.slices_ << ", " << settings.frames_per_second_ << " fps" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 5) {
+    std::cerr << "Usage: " << argv[0] << " <settings file> <encoder name> <width> <height>" << std::endl;
+    return 1;
+  }
+
+  std::string encoder_name = argv[2];
+  int width = atoi(argv[3]);
+  int height = atoi(argv[4]);
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvUtilLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  // settings file is loaded on creation and saved after calibration
+  avc::AvcCodecAutotunerConfig config;
+  config.cache_url_ = argv[1];
+  auto autotuner = avc::CreateAvcCodecAutotuner(avc_loader, config);
+  if (!autotuner) {
+    std::cerr << "Cannot create autotuner" << std::endl;
+    return 2;
+  }
+
+  int res = autotuner->Calibrate(encoder_name, width, height);
+  if (res < 0) {
+    std::cerr << "Calibration of " << encoder_name << " failed: " << res << std::endl;
+    return 3;
+  }
+
+  avc::AvcCodecThreadSettings settings;
+  if (autotuner->GetSettings(encoder_name, true, width, height, settings))
+    PrintSettings("encoder", settings);
+
+  const avc::AVCodec* encoder = avc_loader->avcodec_find_encoder_by_name(encoder_name.c_str());
+  const avc::AVCodec* decoder = encoder ? avc_loader->avcodec_find_decoder(avc_loader->d()->AVCodecGetId(encoder)) : nullptr;
+  if (decoder && autotuner->GetSettings(avc_loader->d()->AVCodecGetName(decoder), false, width, height, settings))
+    PrintSettings("decoder", settings);
+
+  std::cerr << autotuner->GetSettingsCount() << " settings in " << argv[1] << std::endl;
+  return 0;
+}
@@ -0,0 +1,182 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+struct BenchmarkResult {
+  uint64_t frames = 0;
+  double total_ms = 0;
+};
+
+static double elapsed_ms(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+static avc::AVCodecContext* open_decoder(std::shared_ptr<avc::IAvcModuleProvider> avc_loader, avc::AVCodecParameters* codecpar) {
+  auto d = avc_loader->d();
+  avc::AVCodec* codec = avc_loader->avcodec_find_decoder(d->AVCodecParametersGetCodecId(codecpar));
+  if (!codec)
+    return nullptr;
+
+  avc::AVCodecContext* codec_ctx = avc_loader->avcodec_alloc_context3(codec);
+  avc_loader->avcodec_parameters_to_context(codec_ctx, codecpar);
+  d->AVCodecContextSetThreadCount(codec_ctx, 1);  // codec work stays on caller thread, overhead is visible
+  if (avc_loader->avcodec_open2(codec_ctx, codec, nullptr) < 0)
+    avc_loader->avcodec_free_context(&codec_ctx);
+  return codec_ctx;
+}
+
+// One provider call per avcodec_send_packet and per avcodec_receive_frame
+static bool run_single(std::shared_ptr<avc::IAvcModuleProvider> avc_loader, avc::AVCodecParameters* codecpar,
+                       const std::vector<const avc::AVPacket*>& packets, BenchmarkResult& result) {
+  avc::AVCodecContext* codec_ctx = open_decoder(avc_loader, codecpar);
+  if (!codec_ctx)
+    return false;
+
+  avc::AVFrame* frame = avc_loader->av_frame_alloc();
+  auto start = Clock::now();
+
+  // last packet is null and flushes decoder
+  for (const avc::AVPacket* packet : packets) {
+    if (avc_loader->avcodec_send_packet(codec_ctx, packet) < 0 && packet)
+      continue;
+
+    while (avc_loader->avcodec_receive_frame(codec_ctx, frame) >= 0) {
+      result.frames++;
+      avc_loader->av_frame_unref(frame);
+    }
+  }
+
+  result.total_ms = elapsed_ms(start, Clock::now());
+
+  avc_loader->av_frame_free(&frame);
+  avc_loader->avcodec_free_context(&codec_ctx);
+  return true;
+}
+
+// One DecodeBatch call per batch of packets, frames are drained into batch of frames
+static bool run_batch(std::shared_ptr<avc::IAvcModuleProvider> avc_loader, avc::AVCodecParameters* codecpar,
+                      const std::vector<const avc::AVPacket*>& packets, int batch_size, BenchmarkResult& result) {
+  avc::AVCodecContext* codec_ctx = open_decoder(avc_loader, codecpar);
+  if (!codec_ctx)
+    return false;
+
+  std::vector<avc::AVFrame*> frames(batch_size);
+  for (auto& frame : frames)
+    frame = avc_loader->av_frame_alloc();
+  std::vector<int> send_results(packets.size());
+
+  auto start = Clock::now();
+
+  size_t next = 0;
+  while (true) {
+    int count = static_cast<int>(std::min(packets.size() - next, static_cast<size_t>(batch_size)));
+    int received = 0;
+    int ret = avc_loader->DecodeBatch(codec_ctx, packets.data() + next, count, send_results.data() + next,
+                                      frames.data(), batch_size, &received);
+    for (int i = 0; i < received; i++) {
+      result.frames++;
+      avc_loader->av_frame_unref(frames[i]);
+    }
+
+    // AVERROR(EAGAIN) marks packets which were not sent because all frames were filled, they go to next batch
+    for (int i = 0; i < count && send_results[next] != AVERROR(EAGAIN); i++)
+      next++;
+
+    if (ret == AVERROR_EOF || (ret < 0 && ret != AVERROR(EAGAIN)))
+      break;
+  }
+
+  result.total_ms = elapsed_ms(start, Clock::now());
+
+  for (auto& frame : frames)
+    avc_loader->av_frame_free(&frame);
+  avc_loader->avcodec_free_context(&codec_ctx);
+  return true;
+}
+
+static void print_result(const char* name, const BenchmarkResult& result, size_t packets_count) {
+  std::cerr << name << ": " << result.frames << " frames in " << result.total_ms << " ms, "
+    << (packets_count ? result.total_ms * 1000.0 / packets_count : 0) << " us per packet" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <media file> [audio|video] [batch size] [iterations]" << std::endl;
+    return 1;
+  }
+
+  std::string url = argv[1];
+  int media_type = (argc > 2 && std::string(argv[2]) == "video") ? AVMEDIA_TYPE_VIDEO : AVMEDIA_TYPE_AUDIO;
+  int batch_size = argc > 3 ? std::max(1, atoi(argv[3])) : 16;
+  int iterations = argc > 4 ? std::max(1, atoi(argv[4])) : 3;
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  auto d = avc_loader->d();
+  avc::AVFormatContext* fmt_ctx = nullptr;
+  if (avc_loader->avformat_open_input(&fmt_ctx, url.c_str(), nullptr, nullptr) < 0) {
+    std::cerr << "Cannot open " << url << std::endl;
+    return 2;
+  }
+  avc_loader->avformat_find_stream_info(fmt_ctx, nullptr);
+
+  int stream_index = avc_loader->av_find_best_stream(fmt_ctx, media_type, -1, -1, nullptr, 0);
+  if (stream_index < 0) {
+    std::cerr << "No " << (media_type == AVMEDIA_TYPE_VIDEO ? "video" : "audio") << " stream in " << url << std::endl;
+    avc_loader->avformat_close_input(&fmt_ctx);
+    return 3;
+  }
+
+  // packets are read in advance, so only codec calls are measured
+  std::vector<const avc::AVPacket*> packets;
+  avc::AVPacket* pkt = avc_loader->av_packet_alloc();
+  while (avc_loader->av_read_frame(fmt_ctx, pkt) >= 0) {
+    if (d->AVPacketGetStreamIndex(pkt) == stream_index) {
+      avc::AVPacket* stored = avc_loader->av_packet_alloc();
+      avc_loader->av_packet_move_ref(stored, pkt);
+      packets.push_back(stored);
+    } else {
+      avc_loader->av_packet_unref(pkt);
+    }
+  }
+  avc_loader->av_packet_free(&pkt);
+  size_t packets_count = packets.size();
+  packets.push_back(nullptr);
+
+  avc::AVCodecParameters* codecpar = d->AVStreamGetCodecPar(d->AVFormatContextGetStreamByIdx(fmt_ctx, stream_index));
+  int ret = 0;
+  std::cerr << packets_count << " packets of stream " << stream_index << ", batch " << batch_size << std::endl;
+  for (int i = 0; i < iterations && ret == 0; i++) {
+    std::cerr << "Iteration " << i + 1 << std::endl;
+
+    BenchmarkResult single;
+    BenchmarkResult batched;
+    if (!run_single(avc_loader, codecpar, packets, single) ||
+        !run_batch(avc_loader, codecpar, packets, batch_size, batched)) {
+      std::cerr << "Cannot open decoder" << std::endl;
+      ret = 4;
+      break;
+    }
+    print_result("  single calls", single, packets_count);
+    print_result("  DecodeBatch ", batched, packets_count);
+  }
+
+  for (const avc::AVPacket* packet : packets) {
+    avc::AVPacket* owned = const_cast<avc::AVPacket*>(packet);
+    avc_loader->av_packet_free(&owned);
+  }
+  avc_loader->avformat_close_input(&fmt_ctx);
+  return ret;
+}
@@ -0,0 +1,183 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/avc_coroutines.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Decoded packets are small, so few packets in flight per session are enough
+static const size_t kPacketsQueueSize = 8;
+
+struct SessionsResult {
+  std::mutex mutex;
+  std::condition_variable cond;
+  int sessions_left = 0;
+  std::atomic<uint64_t> frames{0};
+  std::atomic<int> failed{0};
+};
+
+class Session {
+ public:
+  Session(avc::IAvcModuleProvider* provider, avc::IAvcExecutor& executor, avc::IAvcExecutor* io_executor)
+    : provider_(provider), executor_(executor), io_executor_(io_executor), packets_(executor, kPacketsQueueSize) {}
+
+  ~Session() {
+    if (codec_ctx_)
+      provider_->avcodec_free_context(&codec_ctx_);
+    if (fmt_ctx_)
+      provider_->avformat_close_input(&fmt_ctx_);
+  }
+
+  bool Open(const std::string& url) {
+    auto d = provider_->d();
+    if (provider_->avformat_open_input(&fmt_ctx_, url.c_str(), nullptr, nullptr) < 0)
+      return false;
+    provider_->avformat_find_stream_info(fmt_ctx_, nullptr);
+
+    stream_idx_ = provider_->av_find_best_stream(fmt_ctx_, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (stream_idx_ < 0)
+      return false;
+
+    avc::AVCodecParameters* codecpar = d->AVStreamGetCodecPar(d->AVFormatContextGetStreamByIdx(fmt_ctx_, stream_idx_));
+    avc::AVCodec* codec = provider_->avcodec_find_decoder(d->AVCodecParametersGetCodecId(codecpar));
+    if (!codec)
+      return false;
+
+    codec_ctx_ = provider_->avcodec_alloc_context3(codec);
+    provider_->avcodec_parameters_to_context(codec_ctx_, codecpar);
+    // Parallelism comes from sessions, so every decoder is single-threaded
+    d->AVCodecContextSetThreadCount(codec_ctx_, 1);
+    return provider_->avcodec_open2(codec_ctx_, codec, nullptr) >= 0;
+  }
+
+  avc::coro::Task<void> Run(SessionsResult& result) {
+    avc::coro::Spawn(executor_, ReadPackets(), [this, &result](std::exception_ptr) { OnPartDone(result); });
+
+    uint64_t frames = 0;
+    avc::coro::Decoder decoder(provider_, codec_ctx_, packets_);
+    avc::AvcFrameHandle frame = avc::AvcAllocFrame(provider_);
+    int res;
+    while ((res = co_await decoder.NextFrame(frame.get())) == 0) {
+      frames++;
+      provider_->av_frame_unref(frame.get());
+    }
+
+    if (res != AVERROR_EOF)
+      result.failed++;
+
+    // Stop reader if decoder failed before end of file
+    packets_.Close();
+    result.frames += frames;
+  }
+
+  void OnPartDone(SessionsResult& result) {
+    if (parts_done_.fetch_add(1) + 1 < 2)
+      return;
+
+    std::lock_guard<std::mutex> lock(result.mutex);
+    result.sessions_left--;
+    result.cond.notify_all();
+  }
+
+ private:
+  avc::coro::Task<void> ReadPackets() {
+    avc::coro::Demuxer demuxer(provider_, fmt_ctx_, executor_, io_executor_);
+    auto d = provider_->d();
+
+    for (;;) {
+      avc::AvcPacketHandle packet = avc::AvcAllocPacket(provider_);
+      if (co_await demuxer.Read(packet.get()) < 0)
+        break;
+
+      if (d->AVPacketGetStreamIndex(packet.get()) != stream_idx_)
+        continue;
+
+      if (!co_await packets_.Push(std::move(packet)))
+        break;
+    }
+
+    packets_.Close();
+  }
+
+  avc::IAvcModuleProvider* provider_;
+  avc::IAvcExecutor& executor_;
+  avc::IAvcExecutor* io_executor_;
+
+  avc::AVFormatContext* fmt_ctx_ = nullptr;
+  avc::AVCodecContext* codec_ctx_ = nullptr;
+  int stream_idx_ = -1;
+
+  avc::coro::Channel<avc::AvcPacketHandle> packets_;
+  std::atomic<int> parts_done_{0};
+};
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <media file> [sessions] [threads] [io threads]" << std::endl;
+    return 1;
+  }
+
+  std::string url = argv[1];
+  int sessions_count = argc > 2 ? std::max(1, atoi(argv[2])) : 64;
+  int threads_count = argc > 3 ? atoi(argv[3]) : 0;
+  int io_threads_count = argc > 4 ? atoi(argv[4]) : 2;
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  // Sessions executor is declared last, so it is stopped first while I/O executor still accepts its posts
+  std::shared_ptr<avc::IAvcExecutor> io_executor = io_threads_count > 0 ? avc::CreateAvcThreadPoolExecutor(io_threads_count) : nullptr;
+  std::shared_ptr<avc::IAvcExecutor> executor = avc::CreateAvcThreadPoolExecutor(threads_count);
+
+  std::vector<std::unique_ptr<Session>> sessions;
+  for (int i = 0; i < sessions_count; i++) {
+    std::unique_ptr<Session> session(new Session(avc_loader.get(), *executor, io_executor.get()));
+    if (!session->Open(url)) {
+      std::cerr << "Cannot open " << url << std::endl;
+      return 2;
+    }
+    sessions.push_back(std::move(session));
+  }
+
+  SessionsResult result;
+  result.sessions_left = sessions_count;
+  auto start = Clock::now();
+
+  for (auto& session : sessions) {
+    Session* s = session.get();
+    avc::coro::Spawn(*executor, s->Run(result), [s, &result](std::exception_ptr) { s->OnPartDone(result); });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(result.mutex);
+    result.cond.wait(lock, [&result]() { return result.sessions_left == 0; });
+  }
+
+  double total_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  double fps = total_ms > 0 ? result.frames * 1000.0 / total_ms : 0;
+
+  std::cerr << "sessions " << sessions_count
+    << ", threads " << executor->GetThreadsCount()
+    << ", io threads " << (io_executor ? io_executor->GetThreadsCount() : 0)
+    << ", frames " << result.frames.load()
+    << ", " << static_cast<int>(total_ms) << " ms"
+    << ", " << static_cast<int>(fps) << " fps";
+  if (result.failed)
+    std::cerr << ", failed " << result.failed.load();
+  std::cerr << std::endl;
+
+  sessions.clear();
+  return result.failed ? 3 : 0;
+}
@@ -0,0 +1,179 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+
+typedef std::chrono::steady_clock Clock;
+
+struct BenchmarkResult {
+  uint64_t frames = 0;
+  double total_ms = 0;
+  double first_frame_ms = 0;
+  double wait_total_ms = 0;
+  double wait_max_ms = 0;
+};
+
+static double elapsed_ms(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+static void simulate_work(int work_us) {
+  if (work_us <= 0)
+    return;
+
+  auto until = Clock::now() + std::chrono::microseconds(work_us);
+  while (Clock::now() < until) {
+  }
+}
+
+static void on_frame(BenchmarkResult& result, Clock::time_point start, Clock::time_point wait_start, Clock::time_point got) {
+  double wait_ms = elapsed_ms(wait_start, got);
+  if (result.frames == 0)
+    result.first_frame_ms = elapsed_ms(start, got);
+
+  result.frames++;
+  result.wait_total_ms += wait_ms;
+  result.wait_max_ms = std::max(result.wait_max_ms, wait_ms);
+}
+
+// Regular loop as it is usually written: everything on caller thread
+static bool run_naive(std::shared_ptr<avc::IAvcModuleProvider> avc_loader, const std::string& url, int work_us, BenchmarkResult& result) {
+  auto d = avc_loader->d();
+  auto start = Clock::now();
+
+  avc::AVFormatContext* fmt_ctx = nullptr;
+  if (avc_loader->avformat_open_input(&fmt_ctx, url.c_str(), nullptr, nullptr) < 0)
+    return false;
+  avc_loader->avformat_find_stream_info(fmt_ctx, nullptr);
+
+  std::map<int, avc::AVCodecContext*> decoders;
+  for (int i = 0; i < d->AVFormatContextGetNbStreams(fmt_ctx); i++) {
+    avc::AVCodecParameters* codecpar = d->AVStreamGetCodecPar(d->AVFormatContextGetStreamByIdx(fmt_ctx, i));
+    int media_type = d->AVCodecParametersGetCodecType(codecpar);
+    if (media_type != AVMEDIA_TYPE_VIDEO && media_type != AVMEDIA_TYPE_AUDIO)
+      continue;
+
+    avc::AVCodec* codec = avc_loader->avcodec_find_decoder(d->AVCodecParametersGetCodecId(codecpar));
+    if (!codec)
+      continue;
+
+    avc::AVCodecContext* codec_ctx = avc_loader->avcodec_alloc_context3(codec);
+    avc_loader->avcodec_parameters_to_context(codec_ctx, codecpar);
+    if (avc_loader->avcodec_open2(codec_ctx, codec, nullptr) < 0) {
+      avc_loader->avcodec_free_context(&codec_ctx);
+      continue;
+    }
+    decoders[i] = codec_ctx;
+  }
+
+  avc::AVPacket* pkt = avc_loader->av_packet_alloc();
+  avc::AVFrame* frame = avc_loader->av_frame_alloc();
+  auto wait_start = Clock::now();
+
+  auto drain = [&](avc::AVCodecContext* codec_ctx) {
+    while (avc_loader->avcodec_receive_frame(codec_ctx, frame) >= 0) {
+      on_frame(result, start, wait_start, Clock::now());
+      simulate_work(work_us);
+      avc_loader->av_frame_unref(frame);
+      wait_start = Clock::now();
+    }
+  };
+
+  while (avc_loader->av_read_frame(fmt_ctx, pkt) >= 0) {
+    auto it = decoders.find(d->AVPacketGetStreamIndex(pkt));
+    if (it != decoders.end() && avc_loader->avcodec_send_packet(it->second, pkt) >= 0)
+      drain(it->second);
+    avc_loader->av_packet_unref(pkt);
+  }
+
+  for (auto& it : decoders) {
+    avc_loader->avcodec_send_packet(it.second, nullptr);
+    drain(it.second);
+    avc_loader->avcodec_free_context(&it.second);
+  }
+
+  result.total_ms = elapsed_ms(start, Clock::now());
+
+  avc_loader->av_frame_free(&frame);
+  avc_loader->av_packet_free(&pkt);
+  avc_loader->avformat_close_input(&fmt_ctx);
+  return true;
+}
+
+static bool run_pipeline(std::shared_ptr<avc::IAvcModuleProvider> avc_loader, const std::string& url, int work_us, BenchmarkResult& result) {
+  auto start = Clock::now();
+
+  auto pipeline = avc::CreateAvcDecodePipeline(avc_loader, url);
+  if (!pipeline)
+    return false;
+
+  avc::AVFrame* frame = avc_loader->av_frame_alloc();
+  int stream_index = -1;
+  auto wait_start = Clock::now();
+  while (pipeline->ReceiveFrame(frame, &stream_index) == 0) {
+    on_frame(result, start, wait_start, Clock::now());
+    simulate_work(work_us);
+    avc_loader->av_frame_unref(frame);
+    wait_start = Clock::now();
+  }
+
+  result.total_ms = elapsed_ms(start, Clock::now());
+
+  auto stat = pipeline->GetStatistics();
+  std::cerr << "  pipeline: packets " << stat.packets_read_ << " (dropped " << stat.packets_dropped_ << ")"
+    << ", demuxer waits " << stat.demuxer_waits_ << ", decoder waits " << stat.decoder_waits_ << std::endl;
+
+  avc_loader->av_frame_free(&frame);
+  return true;
+}
+
+static void print_result(const char* name, const BenchmarkResult& result) {
+  std::cerr << name << ": " << result.frames << " frames in " << result.total_ms << " ms, "
+    << (result.total_ms > 0 ? result.frames * 1000.0 / result.total_ms : 0) << " fps"
+    << ", first frame " << result.first_frame_ms << " ms"
+    << ", wait avg " << (result.frames ? result.wait_total_ms / result.frames : 0) << " ms"
+    << ", wait max " << result.wait_max_ms << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <media file> [consumer work us per frame] [iterations]" << std::endl;
+    return 1;
+  }
+
+  std::string url = argv[1];
+  int work_us = argc > 2 ? atoi(argv[2]) : 0;
+  int iterations = argc > 3 ? std::max(1, atoi(argv[3])) : 3;
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  for (int i = 0; i < iterations; i++) {
+    std::cerr << "Iteration " << i + 1 << std::endl;
+
+    BenchmarkResult naive;
+    if (!run_naive(avc_loader, url, work_us, naive)) {
+      std::cerr << "Cannot open " << url << std::endl;
+      return 2;
+    }
+    print_result("  naive loop", naive);
+
+    BenchmarkResult pipelined;
+    if (!run_pipeline(avc_loader, url, work_us, pipelined)) {
+      std::cerr << "Cannot create pipeline for " << url << std::endl;
+      return 2;
+    }
+    print_result("  pipeline  ", pipelined);
+  }
+
+  return 0;
+}
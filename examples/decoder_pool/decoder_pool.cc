@@ -0,0 +1,76 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <media file> [clips] [pool]" << std::endl;
+    return 1;
+  }
+
+  std::string url = argv[1];
+  int clips_count = argc > 2 ? std::max(1, atoi(argv[2])) : 100;
+  bool use_pool = argc > 3;
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  avc::AvcDecodePipelineConfig config;
+  if (use_pool)
+    config.decoder_pool_ = avc::CreateAvcDecoderPool(avc_loader, avc::AvcDecoderPoolConfig());
+
+  avc::AVFrame* frame = avc_loader->av_frame_alloc();
+  uint64_t frames = 0;
+  int failed = 0;
+  auto start = Clock::now();
+
+  for (int i = 0; i < clips_count; i++) {
+    // every pipeline is short-lived, its decoders go back to pool on destruction
+    auto pipeline = avc::CreateAvcDecodePipeline(avc_loader, url, config);
+    if (!pipeline) {
+      std::cerr << "Cannot open " << url << std::endl;
+      avc_loader->av_frame_free(&frame);
+      return 2;
+    }
+
+    int stream_index = -1;
+    int res;
+    while ((res = pipeline->ReceiveFrame(frame, &stream_index)) == 0) {
+      frames++;
+      avc_loader->av_frame_unref(frame);
+    }
+    if (res != AVERROR_EOF)
+      failed++;
+  }
+
+  double total_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  avc_loader->av_frame_free(&frame);
+
+  std::cerr << "clips " << clips_count
+    << ", frames " << frames
+    << ", " << static_cast<int>(total_ms) << " ms";
+  if (failed)
+    std::cerr << ", failed " << failed;
+  std::cerr << std::endl;
+
+  if (use_pool) {
+    avc::AvcDecoderPoolStatistics stat = config.decoder_pool_->GetStatistics();
+    std::cerr << "decoders acquired " << stat.acquired_
+      << ", reused " << stat.reused_
+      << ", opened " << stat.opened_
+      << ", open " << static_cast<int>(stat.open_ms_) << " ms"
+      << ", idle " << stat.idle_ << std::endl;
+  }
+
+  return failed ? 3 : 0;
+}
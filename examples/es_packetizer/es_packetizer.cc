@@ -0,0 +1,59 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <chrono>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <elementary stream file> <decoder name, e.g. h264, hevc, aac>" << std::endl;
+    return 1;
+  }
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvUtilLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  avc::AVCodec* codec = avc_loader->avcodec_find_decoder_by_name(argv[2]);
+  if (!codec) {
+    std::cerr << "Decoder " << argv[2] << " not found" << std::endl;
+    return 2;
+  }
+
+  auto packetizer = avc::CreateAvcPacketizer(avc_loader, avc_loader->d()->AVCodecGetId(codec));
+  if (!packetizer) {
+    std::cerr << "No parser for " << argv[2] << std::endl;
+    return 2;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  int res = packetizer->SendFile(argv[1]);
+  if (res < 0) {
+    std::cerr << "Cannot map " << argv[1] << ", error " << res << std::endl;
+    return 2;
+  }
+
+  avc::AVPacket* packet = avc_loader->av_packet_alloc();
+  int keyframes = 0;
+  while ((res = packetizer->ReceivePacket(packet)) == 0) {
+    if (avc_loader->d()->AVPacketGetFlags(packet) & AV_PKT_FLAG_KEY)
+      keyframes++;
+    avc_loader->av_packet_unref(packet);
+  }
+  avc_loader->av_packet_free(&packet);
+
+  if (res != AVERROR_EOF) {
+    std::cerr << "Packetizing " << argv[1] << " failed, error " << res << std::endl;
+    return 2;
+  }
+
+  double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  avc::AvcPacketizerStatistics stat = packetizer->GetStatistics();
+  std::cerr << "  packets " << stat.packets_ << " (keyframes " << keyframes << ")"
+    << ", referenced " << stat.packets_referenced_ << ", copied " << stat.packets_copied_
+    << " (" << stat.bytes_copied_ << " bytes)" << ", " << static_cast<int>(elapsed_ms) << " ms" << std::endl;
+  return 0;
+}
@@ -0,0 +1,105 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <iostream>
+
+// Same video as generate_video_ffmpeg_loader.cc, but encoding and muxing run on pipeline threads,
+// so frame generation is not stalled by encoder or file writes
+
+int main() {
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  avc_loader->avformat_network_init();
+
+  const char* filename = "output_pipeline.mp4";
+  const int width = 640;
+  const int height = 480;
+  const int fps = 25;
+  const int num_frames = 100;
+
+  auto pipeline = avc::CreateAvcEncodePipeline(avc_loader, filename);
+  if (!pipeline) {
+    std::cerr << "Cannot create output " << filename << std::endl;
+    return 1;
+  }
+
+  const avc::AVCodec* codec = avc_loader->avcodec_find_encoder_by_name("libx264");
+
+  avc::AVCodecContext* codec_ctx = avc_loader->avcodec_alloc_context3(codec);
+  avc_loader->d()->AVCodecContextSetWidth(codec_ctx, width);
+  avc_loader->d()->AVCodecContextSetHeight(codec_ctx, height);
+  avc_loader->d()->AVCodecContextSetTimeBase(codec_ctx, cmf::MediaTimeBase(1, fps));
+  avc_loader->d()->AVCodecContextSetFrameRate(codec_ctx, cmf::MediaTimeBase(fps, 1));
+  avc_loader->d()->AVCodecContextSetPixFmt(codec_ctx,
+    avc_loader->GetVideoPixelFormatConverter()->VideoPixelFormatToAVPixelFormat(cmf::VideoPixelFormat_YUV420P));
+  avc_loader->d()->AVCodecContextSetGopSize(codec_ctx, 10);
+
+  pipeline->PrepareEncoder(codec_ctx);  // global header flag when output wants it
+
+  if (avc_loader->avcodec_open2(codec_ctx, codec, nullptr) < 0) {
+    std::cerr << "Cannot open encoder" << std::endl;
+    avc_loader->avcodec_free_context(&codec_ctx);
+    return 2;
+  }
+
+  int stream_index = pipeline->AddStream(codec_ctx);  // pipeline owns encoder context now
+  if (stream_index < 0 || pipeline->Start() < 0) {
+    std::cerr << "Cannot start pipeline" << std::endl;
+    return 3;
+  }
+
+  avc::AVFrame* frame = avc_loader->av_frame_alloc();
+
+  for (int i = 0; i < num_frames; i++) {
+    // pipeline keeps reference to submitted frame, so every frame gets own buffer
+    avc_loader->av_frame_unref(frame);
+    avc_loader->d()->AVFrameSetFormat(frame, avc_loader->d()->AVCodecContextGetPixFmt(codec_ctx));
+    avc_loader->d()->AVFrameSetWidth(frame, width);
+    avc_loader->d()->AVFrameSetHeight(frame, height);
+    avc_loader->av_frame_get_buffer(frame, 0);
+
+    uint8_t* data0_ptr = avc_loader->d()->AVFrameGetData(frame, 0);
+    int line_size_0 = avc_loader->d()->AVFrameGetLineSize(frame, 0);
+    uint8_t* data1_ptr = avc_loader->d()->AVFrameGetData(frame, 1);
+    int line_size_1 = avc_loader->d()->AVFrameGetLineSize(frame, 1);
+    uint8_t* data2_ptr = avc_loader->d()->AVFrameGetData(frame, 2);
+    int line_size_2 = avc_loader->d()->AVFrameGetLineSize(frame, 2);
+
+    for (int y = 0; y < height; y++)
+      for (int x = 0; x < width; x++)
+        data0_ptr[y * line_size_0 + x] = x + y + i * 3;
+
+    for (int y = 0; y < height / 2; y++) {
+      for (int x = 0; x < width / 2; x++) {
+        data1_ptr[y * line_size_1 + x] = 128 + y + i * 2;
+        data2_ptr[y * line_size_2 + x] = 64 + x + i * 5;
+      }
+    }
+
+    avc_loader->d()->AVFrameSetPts(frame, i);
+
+    // SubmitFrame never blocks. Producer may do other work when queue is full, here it just waits
+    int ret = 0;
+    while ((ret = pipeline->SubmitFrame(stream_index, frame)) == AVERROR(EAGAIN))
+      ret = pipeline->WaitForSubmit(stream_index);
+
+    if (ret < 0) {
+      std::cerr << "Encoding failed " << ret << std::endl;
+      break;
+    }
+  }
+
+  avc_loader->av_frame_free(&frame);
+
+  int ret = pipeline->Finish();
+  auto stat = pipeline->GetStatistics();
+  std::cerr << "Frames submitted " << stat.frames_submitted_ << ", rejected " << stat.frames_rejected_
+    << ", packets written " << stat.packets_written_ << ", bytes " << stat.bytes_written_
+    << ", frame queue peak " << stat.frame_queue_peak_depth_ << ", packet queue peak " << stat.packet_queue_peak_depth_ << std::endl;
+
+  return ret < 0 ? 4 : 0;
+}
@@ -0,0 +1,158 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+struct BenchmarkResult {
+  uint64_t seeks = 0;
+  uint64_t packets_read = 0;
+  int index_entries = 0;
+  double open_ms = 0;
+  double seek_ms = 0;
+};
+
+static double elapsed_ms(Clock::time_point from) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - from).count();
+}
+
+static void print_result(const char* name, const BenchmarkResult& result) {
+  std::cerr << name << ": open " << result.open_ms << " ms"
+    << ", seeks " << result.seeks << " in " << result.seek_ms << " ms"
+    << ", " << (result.seeks ? result.seek_ms / result.seeks : 0) << " ms per seek"
+    << ", " << (result.seeks ? static_cast<double>(result.packets_read) / result.seeks : 0) << " packets per seek";
+  if (result.index_entries > 0)
+    std::cerr << ", injected entries " << result.index_entries;
+  std::cerr << std::endl;
+}
+
+// Every seek goes backward to keyframe before target and reads packets until key packet of video stream,
+// as player or thumbnailer does. With index loaded, entries are injected by Apply right after open
+static bool run_seeks(std::shared_ptr<avc::IAvcModuleProvider> avc_loader, const std::string& url,
+                      std::shared_ptr<avc::IAvcKeyframeIndex> index, const std::vector<double>& targets,
+                      BenchmarkResult& result) {
+  auto d = avc_loader->d();
+  auto start = Clock::now();
+
+  avc::AVFormatContext* fmt_ctx = nullptr;
+  if (avc_loader->avformat_open_input(&fmt_ctx, url.c_str(), nullptr, nullptr) < 0)
+    return false;
+  avc_loader->avformat_find_stream_info(fmt_ctx, nullptr);
+
+  int stream_idx = avc_loader->av_find_best_stream(fmt_ctx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+  if (stream_idx < 0) {
+    avc_loader->avformat_close_input(&fmt_ctx);
+    return false;
+  }
+
+  if (index) {
+    result.index_entries = index->Apply(fmt_ctx);
+    if (result.index_entries < 0) {
+      avc_loader->avformat_close_input(&fmt_ctx);
+      return false;
+    }
+  }
+  result.open_ms = elapsed_ms(start);
+
+  avc::AVStream* stream = d->AVFormatContextGetStreamByIdx(fmt_ctx, stream_idx);
+  cmf::MediaTimeBase time_base = d->AVStreamGetTimeBase(stream);
+  int64_t start_time = d->AVStreamGetStartTime(stream);
+  if (start_time == AV_NOPTS_VALUE)
+    start_time = 0;
+
+  avc::AVPacket* pkt = avc_loader->av_packet_alloc();
+  start = Clock::now();
+
+  for (double target : targets) {
+    int64_t timestamp = start_time + static_cast<int64_t>(target * time_base.den_ / time_base.num_);
+    if (avc_loader->av_seek_frame(fmt_ctx, stream_idx, timestamp, AVSEEK_FLAG_BACKWARD) < 0)
+      continue;
+    result.seeks++;
+
+    while (avc_loader->av_read_frame(fmt_ctx, pkt) >= 0) {
+      result.packets_read++;
+      bool found = d->AVPacketGetStreamIndex(pkt) == stream_idx && (d->AVPacketGetFlags(pkt) & AV_PKT_FLAG_KEY);
+      avc_loader->av_packet_unref(pkt);
+      if (found)
+        break;
+    }
+  }
+
+  result.seek_ms = elapsed_ms(start);
+
+  avc_loader->av_packet_free(&pkt);
+  avc_loader->avformat_close_input(&fmt_ctx);
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <media file> [sidecar file] [seeks count]" << std::endl;
+    return 1;
+  }
+
+  std::string url = argv[1];
+  std::string sidecar_url = argc > 2 ? argv[2] : url + ".kfi";
+  int seeks_count = argc > 3 ? std::max(1, atoi(argv[3])) : 100;
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  // Sidecar is built by one pass over input only when it is missing or does not match input
+  auto index = avc::CreateAvcKeyframeIndex(avc_loader);
+  auto start = Clock::now();
+  if (index->Load(sidecar_url, url) < 0) {
+    if (index->Build(url) < 0 || index->Save(sidecar_url) < 0) {
+      std::cerr << "Cannot build keyframe index of " << url << std::endl;
+      return 2;
+    }
+    std::cerr << "Index built and saved to " << sidecar_url << " in " << elapsed_ms(start) << " ms" << std::endl;
+    start = Clock::now();
+    if (index->Load(sidecar_url, url) < 0) {
+      std::cerr << "Cannot load " << sidecar_url << std::endl;
+      return 2;
+    }
+  }
+  std::cerr << "Index loaded from " << sidecar_url << " in " << elapsed_ms(start) << " ms" << std::endl;
+
+  avc::AVFormatContext* fmt_ctx = nullptr;
+  if (avc_loader->avformat_open_input(&fmt_ctx, url.c_str(), nullptr, nullptr) < 0) {
+    std::cerr << "Cannot open " << url << std::endl;
+    return 2;
+  }
+  avc_loader->avformat_find_stream_info(fmt_ctx, nullptr);
+  int64_t duration = avc_loader->d()->AVFormatContextGetDuration(fmt_ctx);
+  avc_loader->avformat_close_input(&fmt_ctx);
+  if (duration <= 0) {
+    std::cerr << "Duration of " << url << " is unknown" << std::endl;
+    return 3;
+  }
+
+  // Same random targets for both modes
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<double> distribution(0.0, static_cast<double>(duration) / AV_TIME_BASE);
+  std::vector<double> targets(seeks_count);
+  for (auto& target : targets)
+    target = distribution(generator);
+
+  BenchmarkResult plain;
+  BenchmarkResult indexed;
+  if (!run_seeks(avc_loader, url, nullptr, targets, plain) ||
+      !run_seeks(avc_loader, url, index, targets, indexed)) {
+    std::cerr << "Cannot open video stream of " << url << std::endl;
+    return 4;
+  }
+  print_result("without index", plain);
+  print_result("with index   ", indexed);
+  return 0;
+}
@@ -0,0 +1,163 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+typedef std::chrono::steady_clock Clock;
+
+struct BenchmarkResult {
+  uint64_t thumbnails = 0;
+  double total_ms = 0;
+};
+
+static double elapsed_ms(Clock::time_point from) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - from).count();
+}
+
+static void print_result(const char* name, const BenchmarkResult& result) {
+  double per_second = result.total_ms > 0 ? result.thumbnails * 1000.0 / result.total_ms : 0;
+  std::cerr << name << ": thumbnails " << result.thumbnails
+    << ", " << static_cast<int>(result.total_ms) << " ms"
+    << ", " << per_second << " thumbnails/s" << std::endl;
+}
+
+// Usual approach: decode everything and pick first frame after every sampling point
+static bool run_full_decode(std::shared_ptr<avc::IAvcModuleProvider> avc_loader, const std::string& url,
+                            double interval, int max_thumbnails, BenchmarkResult& result) {
+  auto d = avc_loader->d();
+  auto start = Clock::now();
+
+  avc::AVFormatContext* fmt_ctx = nullptr;
+  if (avc_loader->avformat_open_input(&fmt_ctx, url.c_str(), nullptr, nullptr) < 0)
+    return false;
+  avc_loader->avformat_find_stream_info(fmt_ctx, nullptr);
+
+  int stream_idx = avc_loader->av_find_best_stream(fmt_ctx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+  if (stream_idx < 0) {
+    avc_loader->avformat_close_input(&fmt_ctx);
+    return false;
+  }
+
+  avc::AVStream* stream = d->AVFormatContextGetStreamByIdx(fmt_ctx, stream_idx);
+  avc::AVCodecParameters* codecpar = d->AVStreamGetCodecPar(stream);
+  avc::AVCodec* codec = avc_loader->avcodec_find_decoder(d->AVCodecParametersGetCodecId(codecpar));
+  avc::AVCodecContext* codec_ctx = codec ? avc_loader->avcodec_alloc_context3(codec) : nullptr;
+  if (!codec_ctx) {
+    avc_loader->avformat_close_input(&fmt_ctx);
+    return false;
+  }
+  avc_loader->avcodec_parameters_to_context(codec_ctx, codecpar);
+  if (avc_loader->avcodec_open2(codec_ctx, codec, nullptr) < 0) {
+    avc_loader->avcodec_free_context(&codec_ctx);
+    avc_loader->avformat_close_input(&fmt_ctx);
+    return false;
+  }
+
+  cmf::MediaTimeBase time_base = d->AVStreamGetTimeBase(stream);
+  int64_t start_time = d->AVStreamGetStartTime(stream);
+  if (start_time == AV_NOPTS_VALUE)
+    start_time = 0;
+  int64_t step = std::max<int64_t>(1, static_cast<int64_t>(interval * time_base.den_ / time_base.num_));
+  int64_t next_point = start_time;
+
+  avc::AVPacket* pkt = avc_loader->av_packet_alloc();
+  avc::AVFrame* frame = avc_loader->av_frame_alloc();
+  bool done = false;
+
+  auto drain = [&]() {
+    while (!done && avc_loader->avcodec_receive_frame(codec_ctx, frame) >= 0) {
+      int64_t pts = d->AVFrameGetPts(frame);
+      if (pts != AV_NOPTS_VALUE && pts >= next_point) {
+        result.thumbnails++;
+        while (next_point <= pts)
+          next_point += step;
+        done = max_thumbnails > 0 && result.thumbnails >= static_cast<uint64_t>(max_thumbnails);
+      }
+      avc_loader->av_frame_unref(frame);
+    }
+  };
+
+  while (!done && avc_loader->av_read_frame(fmt_ctx, pkt) >= 0) {
+    if (d->AVPacketGetStreamIndex(pkt) == stream_idx && avc_loader->avcodec_send_packet(codec_ctx, pkt) >= 0)
+      drain();
+    avc_loader->av_packet_unref(pkt);
+  }
+  avc_loader->avcodec_send_packet(codec_ctx, nullptr);
+  drain();
+
+  result.total_ms = elapsed_ms(start);
+
+  avc_loader->av_frame_free(&frame);
+  avc_loader->av_packet_free(&pkt);
+  avc_loader->avcodec_free_context(&codec_ctx);
+  avc_loader->avformat_close_input(&fmt_ctx);
+  return true;
+}
+
+static bool run_sampler(std::shared_ptr<avc::IAvcModuleProvider> avc_loader, const std::string& url,
+                        double interval, int max_thumbnails, BenchmarkResult& result) {
+  auto start = Clock::now();
+
+  avc::AvcKeyframeSamplerConfig config;
+  config.interval_seconds_ = interval;
+  config.max_frames_ = max_thumbnails;
+
+  auto sampler = avc::CreateAvcKeyframeSampler(avc_loader, config);
+  if (!sampler || sampler->Open(url) < 0)
+    return false;
+
+  avc::AVFrame* frame = avc_loader->av_frame_alloc();
+  while (sampler->NextFrame(frame) == 0) {
+    result.thumbnails++;
+    avc_loader->av_frame_unref(frame);
+  }
+  avc_loader->av_frame_free(&frame);
+
+  result.total_ms = elapsed_ms(start);
+
+  avc::AvcKeyframeSamplerStatistics stat = sampler->GetStatistics();
+  std::cerr << "  sampler: seeks " << stat.seeks_
+    << ", packets read " << stat.packets_read_
+    << ", decoded " << stat.packets_decoded_
+    << ", skipped " << stat.packets_skipped_
+    << ", decode " << static_cast<int>(stat.decode_ms_) << " ms" << std::endl;
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <media file> [interval, seconds] [max thumbnails]" << std::endl;
+    return 1;
+  }
+
+  std::string url = argv[1];
+  double interval = argc > 2 ? atof(argv[2]) : 10.0;
+  int max_thumbnails = argc > 3 ? std::max(0, atoi(argv[3])) : 0;
+  if (interval <= 0)
+    interval = 10.0;
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  BenchmarkResult full;
+  if (!run_full_decode(avc_loader, url, interval, max_thumbnails, full)) {
+    std::cerr << "Cannot decode " << url << std::endl;
+    return 2;
+  }
+  print_result("  full decode", full);
+
+  BenchmarkResult sampled;
+  if (!run_sampler(avc_loader, url, interval, max_thumbnails, sampled)) {
+    std::cerr << "Cannot open sampler for " << url << std::endl;
+    return 2;
+  }
+  print_result("  keyframes  ", sampled);
+  return 0;
+}
@@ -0,0 +1,55 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <input url> [frames count]" << std::endl;
+    return 1;
+  }
+
+  int frames_limit = argc > 2 ? std::stoi(argv[2]) : 0;
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  avc::AvcDecodePipelineConfig config;
+  config.low_latency_ = true;
+  config.latency_tracer_ = avc::CreateAvcLatencyTracer(avc_loader);
+
+  auto pipeline = avc::CreateAvcDecodePipeline(avc_loader, argv[1], config);
+  if (!pipeline) {
+    std::cerr << "Cannot open " << argv[1] << std::endl;
+    return 2;
+  }
+
+  avc::AVFrame* frame = avc_loader->av_frame_alloc();
+  int stream_index = -1;
+  int frames = 0;
+  int res;
+  while ((res = pipeline->ReceiveFrame(frame, &stream_index)) == 0) {
+    avc_loader->av_frame_unref(frame);
+    if (++frames == frames_limit)
+      break;
+  }
+  avc_loader->av_frame_free(&frame);
+  pipeline->Stop();
+
+  if (res < 0 && res != AVERROR_EOF) {
+    std::cerr << "Decoding " << argv[1] << " failed, error " << res << std::endl;
+    return 2;
+  }
+
+  for (int index : config.latency_tracer_->GetStreamIndexes()) {
+    avc::AvcLatencyStatistics stat = config.latency_tracer_->GetStreamStatistics(index);
+    std::cerr << "  stream " << index << ": frames " << stat.frames_measured_
+      << ", latency us min " << stat.min_us_ << " p50 " << stat.p50_us_ << " p90 " << stat.p90_us_
+      << " p99 " << stat.p99_us_ << " max " << stat.max_us_ << ", dropped packets " << stat.stamps_dropped_ << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,67 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <cache file> <input file> [input file...]" << std::endl;
+    return 1;
+  }
+
+  std::string cache_url = argv[1];
+  std::vector<std::string> urls(argv + 2, argv + argc);
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  auto prober = avc::CreateAvcMediaProber(avc_loader);
+  if (!prober) {
+    std::cerr << "Cannot create prober" << std::endl;
+    return 2;
+  }
+
+  // missing cache is normal for first run
+  prober->LoadCache(cache_url);
+
+  std::vector<avc::AvcProbeResult> results;
+  size_t failed = prober->ProbeBatch(urls, &results);
+  for (size_t i = 0; i < urls.size(); i++) {
+    const avc::AvcProbeResult& result = results[i];
+    if (result.error_ < 0) {
+      std::cerr << urls[i] << ": error " << result.error_ << std::endl;
+      continue;
+    }
+
+    std::cerr << urls[i] << ": duration ";
+    if (result.duration_ != AV_NOPTS_VALUE)
+      std::cerr << static_cast<double>(result.duration_) / AV_TIME_BASE << " s";
+    else
+      std::cerr << "unknown";
+    std::cerr << ", streams " << result.streams_count_ << std::endl;
+
+    for (int s = 0; s < result.streams_count_ && s < avc::kAvcProbeMaxStreams; s++) {
+      const avc::AvcProbeStreamInfo& info = result.streams_[s];
+      std::cerr << "  #" << info.index_ << " codec " << info.codec_id_;
+      if (info.media_type_ == AVMEDIA_TYPE_VIDEO)
+        std::cerr << " video " << info.width_ << "x" << info.height_;
+      else if (info.media_type_ == AVMEDIA_TYPE_AUDIO)
+        std::cerr << " audio " << info.sample_rate_ << " Hz, " << info.channels_ << " channels";
+      std::cerr << std::endl;
+    }
+  }
+
+  int res = prober->SaveCache(cache_url);
+  if (res < 0)
+    std::cerr << "Cannot save cache " << cache_url << ", error " << res << std::endl;
+
+  avc::AvcMediaProberStatistics stat = prober->GetStatistics();
+  std::cerr << "  files opened " << stat.files_opened_ << ", from cache " << stat.cache_hits_
+    << ", failed " << failed << ", probe time " << static_cast<int>(stat.probe_ms_) << " ms" << std::endl;
+  return 0;
+}
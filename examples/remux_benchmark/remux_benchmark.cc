@@ -0,0 +1,47 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <input file> <output file> [start, seconds] [end, seconds] [batch size]" << std::endl;
+    return 1;
+  }
+
+  avc::AvcRemuxerConfig config;
+  config.start_seconds_ = argc > 3 ? std::max(0.0, atof(argv[3])) : 0.0;
+  config.end_seconds_ = argc > 4 ? std::max(0.0, atof(argv[4])) : 0.0;
+  if (argc > 5 && atoi(argv[5]) > 0)
+    config.batch_size_ = static_cast<size_t>(atoi(argv[5]));
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  auto remuxer = avc::CreateAvcRemuxer(avc_loader, config);
+  if (!remuxer) {
+    std::cerr << "Cannot create remuxer" << std::endl;
+    return 2;
+  }
+
+  int res = remuxer->Remux(argv[1], argv[2]);
+  if (res < 0) {
+    std::cerr << "Remux " << argv[1] << " to " << argv[2] << " failed, error " << res << std::endl;
+    return 2;
+  }
+
+  avc::AvcRemuxerStatistics stat = remuxer->GetStatistics();
+  std::cerr << "  packets: read " << stat.packets_read_
+    << ", written " << stat.packets_written_
+    << ", dropped " << stat.packets_dropped_
+    << ", batches " << stat.batches_ << std::endl;
+  std::cerr << "  " << static_cast<int>(stat.elapsed_ms_) << " ms"
+    << ", " << static_cast<uint64_t>(stat.packets_per_second_) << " packets/s"
+    << ", " << stat.megabytes_per_second_ << " MB/s" << std::endl;
+  return 0;
+}
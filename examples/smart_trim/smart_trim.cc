@@ -0,0 +1,41 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+  if (argc < 4) {
+    std::cerr << "Usage: " << argv[0] << " <input file> <output file> <start, seconds> [end, seconds]" << std::endl;
+    return 1;
+  }
+
+  double start_seconds = atof(argv[3]);
+  double end_seconds = argc > 4 ? atof(argv[4]) : 0.0;
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  auto trimmer = avc::CreateAvcSmartTrimmer(avc_loader);
+  if (!trimmer) {
+    std::cerr << "Cannot create trimmer" << std::endl;
+    return 2;
+  }
+
+  int res = trimmer->Trim(argv[1], argv[2], start_seconds, end_seconds);
+  if (res < 0) {
+    std::cerr << "Trim " << argv[1] << " failed, error " << res << std::endl;
+    return 2;
+  }
+
+  avc::AvcSmartTrimmerStatistics stat = trimmer->GetStatistics();
+  std::cerr << "  GOPs copied " << stat.gops_copied_ << " (" << stat.packets_copied_ << " packets)"
+    << ", re-encoded " << stat.gops_reencoded_ << " (" << stat.frames_reencoded_ << " frames"
+    << ", " << static_cast<int>(stat.reencode_ms_) << " ms)" << std::endl;
+  std::cerr << "  packets written " << stat.packets_written_
+    << ", total " << static_cast<int>(stat.elapsed_ms_) << " ms" << std::endl;
+  return 0;
+}
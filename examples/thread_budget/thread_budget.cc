@@ -0,0 +1,100 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <media file> [sessions] [cores budget]" << std::endl;
+    return 1;
+  }
+
+  std::string url = argv[1];
+  int sessions_count = argc > 2 ? std::max(1, atoi(argv[2])) : 40;
+  bool use_budget = argc > 3;
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  // decoders opened with automatic threading take their threads from budget
+  std::shared_ptr<avc::IAvcThreadBudget> budget = avc_loader->GetThreadBudget();
+  if (use_budget) {
+    avc::AvcThreadBudgetConfig budget_config;
+    budget_config.cores_budget_ = atoi(argv[3]);
+    budget_config.expected_sessions_ = sessions_count;
+    budget->SetConfig(budget_config);
+    budget->SetEnabled(true);
+  }
+
+  avc::AvcDecodePipelineConfig config;
+  config.decoder_threads_ = 0;
+
+  std::vector<std::shared_ptr<avc::IAvcDecodePipeline>> pipelines;
+  for (int i = 0; i < sessions_count; i++) {
+    auto pipeline = avc::CreateAvcDecodePipeline(avc_loader, url, config);
+    if (!pipeline) {
+      std::cerr << "Cannot open " << url << std::endl;
+      return 2;
+    }
+    pipelines.push_back(pipeline);
+  }
+
+  avc::AvcThreadBudgetStatistics budget_stat = budget->GetStatistics();
+  std::atomic<uint64_t> frames{0};
+  std::atomic<int> failed{0};
+  auto start = Clock::now();
+
+  std::vector<std::thread> threads;
+  for (auto& pipeline : pipelines) {
+    threads.emplace_back([&avc_loader, &frames, &failed, pipeline]() {
+      avc::AVFrame* frame = avc_loader->av_frame_alloc();
+      int stream_index = -1;
+      int res;
+      while ((res = pipeline->ReceiveFrame(frame, &stream_index)) == 0) {
+        frames++;
+        avc_loader->av_frame_unref(frame);
+      }
+      if (res != AVERROR_EOF)
+        failed++;
+      avc_loader->av_frame_free(&frame);
+    });
+  }
+
+  for (auto& thread : threads)
+    thread.join();
+
+  double total_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  double fps = total_ms > 0 ? frames * 1000.0 / total_ms : 0;
+
+  std::cerr << "sessions " << sessions_count
+    << ", frames " << frames.load()
+    << ", " << static_cast<int>(total_ms) << " ms"
+    << ", " << static_cast<int>(fps) << " fps";
+  if (failed)
+    std::cerr << ", failed " << failed.load();
+  std::cerr << std::endl;
+
+  if (use_budget) {
+    std::cerr << "budget " << budget_stat.cores_budget_
+      << ", decoders " << budget_stat.sessions_
+      << ", decoder threads " << budget_stat.threads_
+      << ", peak " << budget_stat.peak_threads_
+      << ", oversubscribed threads " << budget_stat.oversubscribed_threads_
+      << ", oversubscribed starts " << budget_stat.oversubscribed_starts_ << std::endl;
+  }
+
+  pipelines.clear();
+  return failed ? 3 : 0;
+}
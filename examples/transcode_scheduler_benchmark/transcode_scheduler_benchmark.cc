@@ -0,0 +1,138 @@
+
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>  // some useful constants from ffmpeg
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const int kWidth = 640;
+static const int kHeight = 480;
+static const int kFps = 25;
+
+// Synthetic input like in generate_video example
+static bool generate_input(std::shared_ptr<avc::IAvcModuleProvider> avc_loader, const std::string& filename, int num_frames) {
+  auto d = avc_loader->d();
+  auto pipeline = avc::CreateAvcEncodePipeline(avc_loader, filename);
+  if (!pipeline)
+    return false;
+
+  const avc::AVCodec* codec = avc_loader->avcodec_find_encoder_by_name("libx264");
+  if (!codec)
+    return false;
+
+  avc::AVCodecContext* codec_ctx = avc_loader->avcodec_alloc_context3(codec);
+  d->AVCodecContextSetWidth(codec_ctx, kWidth);
+  d->AVCodecContextSetHeight(codec_ctx, kHeight);
+  d->AVCodecContextSetTimeBase(codec_ctx, cmf::MediaTimeBase(1, kFps));
+  d->AVCodecContextSetFrameRate(codec_ctx, cmf::MediaTimeBase(kFps, 1));
+  d->AVCodecContextSetPixFmt(codec_ctx, AV_PIX_FMT_YUV420P);
+  d->AVCodecContextSetGopSize(codec_ctx, 25);
+  pipeline->PrepareEncoder(codec_ctx);
+
+  if (avc_loader->avcodec_open2(codec_ctx, codec, nullptr) < 0) {
+    avc_loader->avcodec_free_context(&codec_ctx);
+    return false;
+  }
+
+  int stream_index = pipeline->AddStream(codec_ctx);
+  if (stream_index < 0 || pipeline->Start() < 0)
+    return false;
+
+  avc::AVFrame* frame = avc_loader->av_frame_alloc();
+  int ret = 0;
+  for (int i = 0; i < num_frames && ret >= 0; i++) {
+    avc_loader->av_frame_unref(frame);
+    d->AVFrameSetFormat(frame, AV_PIX_FMT_YUV420P);
+    d->AVFrameSetWidth(frame, kWidth);
+    d->AVFrameSetHeight(frame, kHeight);
+    avc_loader->av_frame_get_buffer(frame, 0);
+
+    for (int plane = 0; plane < 3; plane++) {
+      uint8_t* data = d->AVFrameGetData(frame, plane);
+      int line_size = d->AVFrameGetLineSize(frame, plane);
+      int plane_width = plane ? kWidth / 2 : kWidth;
+      int plane_height = plane ? kHeight / 2 : kHeight;
+      for (int y = 0; y < plane_height; y++)
+        for (int x = 0; x < plane_width; x++)
+          data[y * line_size + x] = static_cast<uint8_t>(x + y * (plane + 1) + i * (plane + 3));
+    }
+
+    d->AVFrameSetPts(frame, i);
+    while ((ret = pipeline->SubmitFrame(stream_index, frame)) == AVERROR(EAGAIN))
+      ret = pipeline->WaitForSubmit(stream_index);
+  }
+
+  avc_loader->av_frame_free(&frame);
+  return pipeline->Finish() >= 0 && ret >= 0;
+}
+
+int main(int argc, char* argv[]) {
+  int inputs_count = argc > 1 ? std::max(1, atoi(argv[1])) : 8;
+  int max_workers = argc > 2 ? std::max(1, atoi(argv[2])) : static_cast<int>(std::thread::hardware_concurrency());
+  if (max_workers < 1)
+    max_workers = 1;
+
+  auto avc_loader = avc::CreateAvcModuleProvider3();
+  if (!avc_loader->IsAvCodecLoaded() || !avc_loader->IsAvFormatLoaded()) {
+    std::cerr << "AVC dynamic libraries were not found. Please place AVC libraries in the same directory of this executable and run again" << std::endl;
+    return 254;
+  }
+
+  // lengths from 2 to 16 seconds, so some workers finish own jobs early and have to steal
+  std::vector<std::string> inputs;
+  uint64_t total_frames = 0;
+  for (int i = 0; i < inputs_count; i++) {
+    std::string filename = "scheduler_input_" + std::to_string(i) + ".mp4";
+    int num_frames = kFps * (2 + (i * 7) % 15);
+    std::cerr << "Generating " << filename << ", " << num_frames << " frames" << std::endl;
+    if (!generate_input(avc_loader, filename, num_frames)) {
+      std::cerr << "Cannot generate " << filename << std::endl;
+      return 2;
+    }
+    inputs.push_back(filename);
+    total_frames += num_frames;
+  }
+
+  double single_worker_ms = 0;
+  for (int workers = 1; workers <= max_workers; workers = workers < max_workers ? std::min(workers * 2, max_workers) : workers + 1) {
+    auto scheduler = avc::CreateAvcTranscodeScheduler(avc_loader, workers);
+    if (!scheduler) {
+      std::cerr << "Cannot create scheduler" << std::endl;
+      return 3;
+    }
+
+    auto start = Clock::now();
+    std::vector<int64_t> jobs;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      avc::AvcTranscodeJobConfig config;
+      config.input_url_ = inputs[i];
+      config.output_url_ = "scheduler_output_" + std::to_string(i) + ".mp4";
+      config.width_ = kWidth / 2;
+      config.height_ = kHeight / 2;
+      jobs.push_back(scheduler->SubmitJob(config));
+    }
+
+    int failed = 0;
+    for (int64_t job : jobs)
+      if (scheduler->WaitJob(job) < 0)
+        failed++;
+
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    if (workers == 1)
+      single_worker_ms = ms;
+
+    auto stat = scheduler->GetStatistics();
+    printf("workers %2d: %9.1f ms, %6.2f jobs/s, %8.1f frames/s, speedup %5.2f, tasks %llu, stolen %llu, failed %d\n",
+      workers, ms, inputs.size() * 1000.0 / ms, total_frames * 1000.0 / ms, single_worker_ms / ms,
+      static_cast<unsigned long long>(stat.tasks_executed_), static_cast<unsigned long long>(stat.tasks_stolen_), failed);
+  }
+
+  return 0;
+}
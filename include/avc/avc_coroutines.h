@@ -0,0 +1,567 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_COROUTINES_HEADER
+#define AVC_COROUTINES_HEADER
+
+// Optional C++20 coroutine layer over send/receive codec API. Library itself is built as C++17, so this header
+// is not included by ffmpeg-loader.h: application compiled as C++20 includes it explicitly.
+// Each session is a coroutine which suspends where blocking loop would wait (empty packet channel, full
+// packet channel, file I/O) and is resumed later on IAvcExecutor thread, so thousands of sessions run on few threads
+
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#error "avc_coroutines.h requires C++20 coroutines support"
+#endif
+
+#include <avc/i_avc_module_provider.h>
+#include <avc/i_avc_executor.h>
+#include <avc/avc_handles.h>
+#include <avc/libav_detached_common.h>
+
+#include <cerrno>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace avc {
+namespace coro {
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+struct TaskPromiseBase {
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    // Symmetric transfer to awaiting coroutine: no stack growth on long co_await chains
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+      std::coroutine_handle<> continuation = handle.promise().continuation_;
+      return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  FinalAwaiter final_suspend() const noexcept { return {}; }
+  void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+  std::coroutine_handle<> continuation_;
+  std::exception_ptr exception_;
+};
+
+template <typename T>
+struct TaskPromise : public TaskPromiseBase {
+  Task<T> get_return_object() noexcept;
+
+  template <typename U>
+  void return_value(U&& value) { value_.emplace(std::forward<U>(value)); }
+
+  T Result() {
+    if (exception_)
+      std::rethrow_exception(exception_);
+    return std::move(*value_);
+  }
+
+  std::optional<T> value_;
+};
+
+template <>
+struct TaskPromise<void> : public TaskPromiseBase {
+  Task<void> get_return_object() noexcept;
+
+  void return_void() const noexcept {}
+
+  void Result() {
+    if (exception_)
+      std::rethrow_exception(exception_);
+  }
+};
+
+// Coroutine which starts immediately and destroys own frame when finished
+struct DetachedTask {
+  struct promise_type {
+    DetachedTask get_return_object() const noexcept { return {}; }
+    std::suspend_never initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+    void return_void() const noexcept {}
+    void unhandled_exception() const noexcept { std::terminate(); }
+  };
+};
+
+}  // namespace detail
+
+/// \brief Lazy coroutine result. Body starts when task is awaited, awaiting coroutine is resumed on the thread
+/// which completed the task. Exception thrown by body is rethrown from co_await
+template <typename T>
+class [[nodiscard]] Task {
+ public:
+  using promise_type = detail::TaskPromise<T>;
+  using Handle = std::coroutine_handle<promise_type>;
+
+  Task() = default;
+  explicit Task(Handle handle) : handle_(handle) {}
+  ~Task() {
+    if (handle_)
+      handle_.destroy();
+  }
+
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+
+  Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      if (handle_)
+        handle_.destroy();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+
+  bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+    handle_.promise().continuation_ = awaiting;
+    return handle_;
+  }
+
+  T await_resume() { return handle_.promise().Result(); }
+
+ private:
+  Handle handle_;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+  return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+  return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+template <typename T>
+struct SyncWaitState {
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool done_ = false;
+  std::exception_ptr exception_;
+  std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> value_;
+};
+
+template <typename T>
+DetachedTask SyncWaitRun(Task<T> task, SyncWaitState<T>& state) {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(task);
+      state.value_.emplace(true);
+    } else {
+      state.value_.emplace(co_await std::move(task));
+    }
+  } catch (...) {
+    state.exception_ = std::current_exception();
+  }
+
+  // Notify under lock: waiter destroys state as soon as it sees done_
+  std::lock_guard<std::mutex> lock(state.mutex_);
+  state.done_ = true;
+  state.cv_.notify_all();
+}
+
+}  // namespace detail
+
+/// \brief Resume awaiting coroutine on executor thread
+class ScheduleOn {
+ public:
+  explicit ScheduleOn(IAvcExecutor& executor) : executor_(executor) {}
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> handle) { executor_.Post([handle]() { handle.resume(); }); }
+  void await_resume() const noexcept {}
+
+ private:
+  IAvcExecutor& executor_;
+};
+
+namespace detail {
+
+inline DetachedTask SpawnRun(IAvcExecutor& executor, Task<void> task, std::function<void(std::exception_ptr)> on_done) {
+  co_await ScheduleOn(executor);
+
+  std::exception_ptr error;
+  try {
+    co_await std::move(task);
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  if (on_done)
+    on_done(error);
+}
+
+}  // namespace detail
+
+/// \brief Start session on executor without waiting for it. on_done is called on executor thread when task
+/// is finished, with exception thrown by task or nullptr. Executor must outlive all spawned sessions
+inline void Spawn(IAvcExecutor& executor, Task<void> task, std::function<void(std::exception_ptr)> on_done = nullptr) {
+  detail::SpawnRun(executor, std::move(task), std::move(on_done));
+}
+
+/// \brief Block calling thread until task is finished. Must not be called from executor thread
+template <typename T>
+T SyncWait(Task<T> task) {
+  detail::SyncWaitState<T> state;
+  detail::SyncWaitRun(std::move(task), state);
+
+  std::unique_lock<std::mutex> lock(state.mutex_);
+  state.cv_.wait(lock, [&state]() { return state.done_; });
+
+  if (state.exception_)
+    std::rethrow_exception(state.exception_);
+  if constexpr (!std::is_void_v<T>)
+    return std::move(*state.value_);
+}
+
+/// \brief Bounded multi-producer multi-consumer channel between session coroutines. Push suspends when channel
+/// is full, Pop suspends when channel is empty. Suspended coroutines are resumed on executor.
+/// Capacity 0 makes channel rendezvous: every Push waits for its Pop
+template <typename T>
+class Channel {
+ public:
+  class PushAwaiter;
+  class PopAwaiter;
+
+  Channel(IAvcExecutor& executor, size_t capacity) : executor_(executor), capacity_(capacity) {}
+
+  Channel(const Channel&) = delete;
+  Channel& operator=(const Channel&) = delete;
+
+  /// \brief co_await returns false when channel is closed, value is dropped in this case
+  PushAwaiter Push(T value) { return PushAwaiter(*this, std::move(value)); }
+
+  /// \brief co_await returns empty optional when channel is closed and all values are consumed
+  PopAwaiter Pop() { return PopAwaiter(*this); }
+
+  /// \brief Wake all waiters. Values already in channel still may be popped
+  void Close() {
+    std::deque<PushAwaiter*> pushers;
+    std::deque<PopAwaiter*> poppers;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+      pushers.swap(pushers_);
+      poppers.swap(poppers_);
+    }
+
+    for (PushAwaiter* pusher : pushers)
+      Resume(pusher->handle_);
+    for (PopAwaiter* popper : poppers)
+      Resume(popper->handle_);
+  }
+
+  bool IsClosed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_;
+  }
+
+  size_t GetSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return items_.size();
+  }
+
+  class PushAwaiter {
+   public:
+    PushAwaiter(Channel& channel, T value) : channel_(channel), value_(std::move(value)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+      std::unique_lock<std::mutex> lock(channel_.mutex_);
+      if (channel_.closed_)
+        return false;
+
+      if (!channel_.poppers_.empty()) {
+        // Hand value directly to waiting consumer
+        PopAwaiter* popper = channel_.poppers_.front();
+        channel_.poppers_.pop_front();
+        popper->value_.emplace(std::move(value_));
+        result_ = true;
+        lock.unlock();
+        channel_.Resume(popper->handle_);
+        return false;
+      }
+
+      if (channel_.items_.size() < channel_.capacity_) {
+        channel_.items_.push_back(std::move(value_));
+        result_ = true;
+        return false;
+      }
+
+      handle_ = handle;
+      channel_.pushers_.push_back(this);
+      return true;
+    }
+
+    bool await_resume() const noexcept { return result_; }
+
+   private:
+    friend class Channel;
+
+    Channel& channel_;
+    T value_;
+    bool result_ = false;
+    std::coroutine_handle<> handle_;
+  };
+
+  class PopAwaiter {
+   public:
+    explicit PopAwaiter(Channel& channel) : channel_(channel) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+      std::unique_lock<std::mutex> lock(channel_.mutex_);
+      PushAwaiter* pusher = nullptr;
+      if (!channel_.pushers_.empty()) {
+        pusher = channel_.pushers_.front();
+        channel_.pushers_.pop_front();
+        pusher->result_ = true;
+      }
+
+      if (!channel_.items_.empty()) {
+        value_.emplace(std::move(channel_.items_.front()));
+        channel_.items_.pop_front();
+        // Freed slot goes to first waiting producer
+        if (pusher)
+          channel_.items_.push_back(std::move(pusher->value_));
+      } else if (pusher) {
+        value_.emplace(std::move(pusher->value_));
+      } else if (!channel_.closed_) {
+        handle_ = handle;
+        channel_.poppers_.push_back(this);
+        return true;
+      }
+
+      lock.unlock();
+      if (pusher)
+        channel_.Resume(pusher->handle_);
+      return false;
+    }
+
+    std::optional<T> await_resume() { return std::move(value_); }
+
+   private:
+    friend class Channel;
+
+    Channel& channel_;
+    std::optional<T> value_;
+    std::coroutine_handle<> handle_;
+  };
+
+ private:
+  void Resume(std::coroutine_handle<> handle) { executor_.Post([handle]() { handle.resume(); }); }
+
+  IAvcExecutor& executor_;
+  const size_t capacity_;
+
+  mutable std::mutex mutex_;
+  bool closed_ = false;
+  std::deque<T> items_;
+  std::deque<PushAwaiter*> pushers_;
+  std::deque<PopAwaiter*> poppers_;
+};
+
+/// \brief Runs blocking call on I/O executor and resumes awaiting coroutine on session executor.
+/// Without I/O executor call is made inline on current thread
+template <typename Func>
+class IoCall {
+ public:
+  IoCall(IAvcExecutor& executor, IAvcExecutor* io_executor, Func func)
+    : executor_(executor), io_executor_(io_executor), func_(std::move(func)) {}
+
+  bool await_ready() const noexcept { return io_executor_ == nullptr; }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    io_executor_->Post([this, handle]() {
+      result_ = func_();
+      executor_.Post([handle]() { handle.resume(); });
+    });
+  }
+
+  int await_resume() {
+    if (!io_executor_)
+      result_ = func_();
+    return result_;
+  }
+
+ private:
+  IAvcExecutor& executor_;
+  IAvcExecutor* io_executor_;
+  Func func_;
+  int result_ = 0;
+};
+
+/// \brief Packet source for session. Reads may go to separate I/O executor so slow network or disk
+/// does not hold codec threads
+class Demuxer {
+ public:
+  Demuxer(IAvcModuleProvider* provider, AVFormatContext* fmt_ctx, IAvcExecutor& executor, IAvcExecutor* io_executor = nullptr)
+    : provider_(provider), fmt_ctx_(fmt_ctx), executor_(executor), io_executor_(io_executor) {}
+
+  /// \brief Result of av_read_frame: 0 on success, AVERROR_EOF at end of input
+  Task<int> Read(AVPacket* packet) {
+    co_return co_await IoCall(executor_, io_executor_, [this, packet]() {
+      return provider_->av_read_frame(fmt_ctx_, packet);
+    });
+  }
+
+ private:
+  IAvcModuleProvider* provider_;
+  AVFormatContext* fmt_ctx_;
+  IAvcExecutor& executor_;
+  IAvcExecutor* io_executor_;
+};
+
+/// \brief Decoder fed from packet channel. Producer closes channel at end of stream, decoder is flushed then
+class Decoder {
+ public:
+  Decoder(IAvcModuleProvider* provider, AVCodecContext* codec_ctx, Channel<AvcPacketHandle>& packets)
+    : provider_(provider), codec_ctx_(codec_ctx), packets_(packets) {}
+
+  /// \brief Wait for next decoded frame. Result is 0 when frame is filled, AVERROR_EOF when decoder is
+  /// drained, or other negative error. Corrupted packets are skipped
+  Task<int> NextFrame(AVFrame* frame) {
+    for (;;) {
+      int res = provider_->avcodec_receive_frame(codec_ctx_, frame);
+      if (res != AVERROR(EAGAIN) || flushed_)
+        co_return res;
+
+      std::optional<AvcPacketHandle> packet = co_await packets_.Pop();
+      if (!packet) {
+        flushed_ = true;
+        res = provider_->avcodec_send_packet(codec_ctx_, nullptr);
+      } else {
+        res = provider_->avcodec_send_packet(codec_ctx_, packet->get());
+      }
+
+      if (res < 0 && res != AVERROR_INVALIDDATA && res != AVERROR_EOF)
+        co_return res;
+    }
+  }
+
+ private:
+  IAvcModuleProvider* provider_;
+  AVCodecContext* codec_ctx_;
+  Channel<AvcPacketHandle>& packets_;
+  bool flushed_ = false;
+};
+
+/// \brief Encoder which pushes produced packets to channel. Sending frame suspends while channel is full,
+/// so slow muxer slows down encoding session instead of growing memory
+class Encoder {
+ public:
+  Encoder(IAvcModuleProvider* provider, AVCodecContext* codec_ctx, Channel<AvcPacketHandle>& packets, IAvcFramePool* pool = nullptr)
+    : provider_(provider), codec_ctx_(codec_ctx), packets_(packets), pool_(pool) {}
+
+  /// \brief Encode frame and push all ready packets. nullptr frame flushes encoder and closes channel.
+  /// Result is 0, AVERROR_EOF when channel was closed by consumer, or other negative error
+  Task<int> SendFrame(const AVFrame* frame) {
+    int res = provider_->avcodec_send_frame(codec_ctx_, frame);
+    if (res < 0 && res != AVERROR_EOF)
+      co_return res;
+
+    for (;;) {
+      if (!spare_)
+        spare_ = pool_ ? AvcAcquirePacket(pool_, provider_) : AvcAllocPacket(provider_);
+      if (!spare_)
+        co_return AVERROR(ENOMEM);
+
+      res = provider_->avcodec_receive_packet(codec_ctx_, spare_.get());
+      if (res == AVERROR(EAGAIN))
+        co_return 0;
+
+      if (res == AVERROR_EOF) {
+        packets_.Close();
+        co_return 0;
+      }
+
+      if (res < 0)
+        co_return res;
+
+      if (!co_await packets_.Push(std::move(spare_)))
+        co_return AVERROR_EOF;
+    }
+  }
+
+ private:
+  IAvcModuleProvider* provider_;
+  AVCodecContext* codec_ctx_;
+  Channel<AvcPacketHandle>& packets_;
+  IAvcFramePool* pool_;
+  AvcPacketHandle spare_;
+};
+
+/// \brief Output of session. Writes go to I/O executor when it is set. Writes to one muxer must not overlap:
+/// await each write before next one, or feed muxer from single coroutine popping packet channel
+class Muxer {
+ public:
+  Muxer(IAvcModuleProvider* provider, AVFormatContext* fmt_ctx, IAvcExecutor& executor, IAvcExecutor* io_executor = nullptr)
+    : provider_(provider), fmt_ctx_(fmt_ctx), executor_(executor), io_executor_(io_executor) {}
+
+  /// \brief Write packet with av_interleaved_write_frame. Packet is returned to its owner when write is done
+  Task<int> Write(AvcPacketHandle packet) {
+    AVPacket* pkt = packet.get();
+    co_return co_await IoCall(executor_, io_executor_, [this, pkt]() {
+      return provider_->av_interleaved_write_frame(fmt_ctx_, pkt);
+    });
+  }
+
+  Task<int> WriteTrailer() {
+    co_return co_await IoCall(executor_, io_executor_, [this]() {
+      return provider_->av_write_trailer(fmt_ctx_);
+    });
+  }
+
+ private:
+  IAvcModuleProvider* provider_;
+  AVFormatContext* fmt_ctx_;
+  IAvcExecutor& executor_;
+  IAvcExecutor* io_executor_;
+};
+
+}  // namespace coro
+}//namespace avc
+
+#endif //AVC_COROUTINES_HEADER
@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_HANDLES_HEADER
+#define AVC_HANDLES_HEADER
+
+#include <avc/i_avc_module_provider.h>
+#include <avc/i_avc_frame_pool.h>
+#include <avc/i_avc_decoder_pool.h>
+
+#include <utility>
+
+namespace avc {
+
+/// \brief Move-only owner of FFmpeg object. Object is returned to pool when handle is bound to pool,
+/// otherwise it is freed through provider. Handle keeps raw provider/pool pointers, so moving handle between
+/// pipeline stages is plain pointer copy without any reference counting. Provider and pool must outlive handles
+template <typename T, typename Traits>
+class AvcHandle {
+ public:
+  using PoolType = typename Traits::PoolType;
+
+  AvcHandle() = default;
+  AvcHandle(IAvcModuleProvider* provider, T* obj, PoolType* pool = nullptr)
+    : provider_(provider), pool_(pool), obj_(obj) {}
+
+  ~AvcHandle() { reset(); }
+
+  AvcHandle(const AvcHandle&) = delete;
+  AvcHandle& operator=(const AvcHandle&) = delete;
+
+  AvcHandle(AvcHandle&& other) noexcept
+    : provider_(other.provider_), pool_(other.pool_), obj_(other.obj_) {
+    other.obj_ = nullptr;
+  }
+
+  AvcHandle& operator=(AvcHandle&& other) noexcept {
+    if (this != &other) {
+      reset();
+      provider_ = other.provider_;
+      pool_ = other.pool_;
+      obj_ = other.obj_;
+      other.obj_ = nullptr;
+    }
+    return *this;
+  }
+
+  T* get() const { return obj_; }
+  T* operator->() const { return obj_; }
+  explicit operator bool() const { return obj_ != nullptr; }
+
+  IAvcModuleProvider* provider() const { return provider_; }
+  PoolType* pool() const { return pool_; }
+
+  /// \brief Give up ownership without freeing
+  T* release() {
+    T* obj = obj_;
+    obj_ = nullptr;
+    return obj;
+  }
+
+  void reset() {
+    if (!obj_)
+      return;
+
+    T* obj = obj_;
+    obj_ = nullptr;
+    if (pool_)
+      Traits::Recycle(pool_, obj);
+    else if (provider_)
+      Traits::Free(provider_, obj);
+  }
+
+ private:
+  IAvcModuleProvider* provider_ = nullptr;
+  PoolType* pool_ = nullptr;
+  T* obj_ = nullptr;
+};
+
+struct AvcFrameHandleTraits {
+  using PoolType = IAvcFramePool;
+  static void Free(IAvcModuleProvider* provider, AVFrame* frame) { provider->av_frame_free(&frame); }
+  static void Recycle(IAvcFramePool* pool, AVFrame* frame) { pool->ReleaseFrame(frame); }
+};
+
+struct AvcPacketHandleTraits {
+  using PoolType = IAvcFramePool;
+  static void Free(IAvcModuleProvider* provider, AVPacket* packet) { provider->av_packet_free(&packet); }
+  static void Recycle(IAvcFramePool* pool, AVPacket* packet) { pool->ReleasePacket(packet); }
+};
+
+struct AvcCodecContextHandleTraits {
+  using PoolType = void;
+  static void Free(IAvcModuleProvider* provider, AVCodecContext* ctx) { provider->avcodec_free_context(&ctx); }
+  static void Recycle(void*, AVCodecContext*) {}
+};
+
+struct AvcDecoderHandleTraits {
+  using PoolType = IAvcDecoderPool;
+  static void Free(IAvcModuleProvider* provider, AVCodecContext* ctx) { provider->avcodec_free_context(&ctx); }
+  static void Recycle(IAvcDecoderPool* pool, AVCodecContext* ctx) { pool->Release(ctx); }
+};
+
+using AvcFrameHandle = AvcHandle<AVFrame, AvcFrameHandleTraits>;
+using AvcPacketHandle = AvcHandle<AVPacket, AvcPacketHandleTraits>;
+using AvcCodecContextHandle = AvcHandle<AVCodecContext, AvcCodecContextHandleTraits>;
+using AvcDecoderHandle = AvcHandle<AVCodecContext, AvcDecoderHandleTraits>;
+
+inline AvcFrameHandle AvcAllocFrame(IAvcModuleProvider* provider) {
+  return AvcFrameHandle(provider, provider->av_frame_alloc());
+}
+
+inline AvcFrameHandle AvcAcquireFrame(IAvcFramePool* pool, IAvcModuleProvider* provider = nullptr) {
+  return AvcFrameHandle(provider, pool->AcquireFrame(), pool);
+}
+
+inline AvcPacketHandle AvcAllocPacket(IAvcModuleProvider* provider) {
+  return AvcPacketHandle(provider, provider->av_packet_alloc());
+}
+
+inline AvcPacketHandle AvcAcquirePacket(IAvcFramePool* pool, IAvcModuleProvider* provider = nullptr) {
+  return AvcPacketHandle(provider, pool->AcquirePacket(), pool);
+}
+
+inline AvcCodecContextHandle AvcAllocCodecContext(IAvcModuleProvider* provider, const AVCodec* codec) {
+  return AvcCodecContextHandle(provider, provider->avcodec_alloc_context3(codec));
+}
+
+/// \brief Decoder from pool, handle returns it to pool. Handle is empty when decoder cannot be opened
+inline AvcDecoderHandle AvcAcquireDecoder(IAvcDecoderPool* pool, const AVCodecParameters* codecpar,
+                                          cmf::MediaTimeBase pkt_time_base, int* error = nullptr) {
+  return AvcDecoderHandle(nullptr, pool->Acquire(codecpar, pkt_time_base, error), pool);
+}
+
+}//namespace avc
+
+#endif //AVC_HANDLES_HEADER
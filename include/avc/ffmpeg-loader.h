@@ -25,6 +25,27 @@
 
 #include "i_avc_module_provider.h"
 #include "i_avc_module_load_handler.h"
+#include "i_avc_frame_pool.h"
+#include "i_avc_packet_batch.h"
+#include "i_avc_frame_cache.h"
+#include "i_avc_decode_pipeline.h"
+#include "i_avc_encode_pipeline.h"
+#include "i_avc_transcode_scheduler.h"
+#include "i_avc_chunked_encoder.h"
+#include "i_avc_executor.h"
+#include "i_avc_packet_interleaver.h"
+#include "i_avc_keyframe_index.h"
+#include "i_avc_keyframe_sampler.h"
+#include "i_avc_remuxer.h"
+#include "i_avc_abr_ladder.h"
+#include "i_avc_smart_trimmer.h"
+#include "i_avc_low_latency.h"
+#include "i_avc_media_prober.h"
+#include "i_avc_packetizer.h"
+#include "i_avc_nal_scanner.h"
+#include "i_avc_codec_autotuner.h"
+#include "i_avc_decoder_pool.h"
+#include "avc_handles.h"
 #include <memory>
 #include <string>
 
@@ -69,6 +90,153 @@ std::shared_ptr<IAvcModuleProvider> CreateAvcModuleProvider4(
   const std::string& swresample_module_name,
   bool auto_load = true,
   std::shared_ptr<avc::IAvcModuleLoadHandler> load_handler = nullptr);
+
+/// \brief Frame/packet pool. numa_node -1 disables NUMA placement
+std::shared_ptr<IAvcFramePool> CreateAvcFramePool(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  int numa_node = -1,
+  size_t max_cached_objects = 64);
+
+/// \brief One frame/packet pool per NUMA node of the system
+std::shared_ptr<IAvcNumaFramePools> CreateAvcNumaFramePools(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  size_t max_cached_objects_per_node = 64);
+
+/// \brief Arena size needed for count packets, 0 when AVPacket can not be placed in arena (libavcodec >= 59)
+size_t GetAvcPacketBatchArenaSize(IAvcModuleProvider* avc_module_provider, size_t count);
+
+/// \brief Batch of count packets. arena (aligned to max_align_t) may be null, then batch allocates own arena.
+/// Falls back to av_packet_alloc when arena is not supported by loaded FFmpeg or too small
+std::shared_ptr<IAvcPacketBatch> CreateAvcPacketBatch(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  size_t count,
+  void* arena = nullptr,
+  size_t arena_size = 0);
+
+/// \brief Decoded frames cache over media file url. Returns nullptr if url can not be opened
+std::shared_ptr<IAvcFrameCache> CreateAvcFrameCache(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const std::string& url,
+  size_t budget_bytes = 512 * 1024 * 1024,
+  int decoder_threads = 0);
+
+/// \brief Threaded demux and decode of media file url. Returns nullptr if url can not be opened
+/// or no stream can be decoded
+std::shared_ptr<IAvcDecodePipeline> CreateAvcDecodePipeline(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const std::string& url,
+  const AvcDecodePipelineConfig& config = AvcDecodePipelineConfig());
+
+/// \brief Threaded encode and mux to url. format_name may be empty, then format is guessed from url.
+/// Returns nullptr if output context can not be created
+std::shared_ptr<IAvcEncodePipeline> CreateAvcEncodePipeline(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const std::string& url,
+  const std::string& format_name = std::string(),
+  const AvcEncodePipelineConfig& config = AvcEncodePipelineConfig());
+
+/// \brief Batch transcoder on work-stealing pool. workers_count 0 means one worker per hardware thread
+std::shared_ptr<IAvcTranscodeScheduler> CreateAvcTranscodeScheduler(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  int workers_count = 0);
+
+/// \brief Encoder which splits input at keyframes and encodes chunks in parallel
+std::shared_ptr<IAvcChunkedEncoder> CreateAvcChunkedEncoder(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcChunkedEncoderConfig& config = AvcChunkedEncoderConfig());
+
+/// \brief Executor on work-stealing pool for coroutine sessions. threads_count 0 means one thread per hardware thread
+std::shared_ptr<IAvcExecutor> CreateAvcThreadPoolExecutor(int threads_count = 0);
+
+/// \brief DTS interleaver with bounded memory in front of av_write_frame. Create after avformat_write_header
+std::shared_ptr<IAvcPacketInterleaver> CreateAvcPacketInterleaver(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  AVFormatContext* output_context,
+  const AvcPacketInterleaverConfig& config = AvcPacketInterleaverConfig());
+
+/// \brief Keyframe index saved to sidecar file and injected to demuxer for fast seeking
+std::shared_ptr<IAvcKeyframeIndex> CreateAvcKeyframeIndex(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider);
+
+/// \brief Decodes one keyframe per interval for thumbnails and scene sampling
+std::shared_ptr<IAvcKeyframeSampler> CreateAvcKeyframeSampler(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcKeyframeSamplerConfig& config = AvcKeyframeSamplerConfig());
+
+/// \brief Stream copy remuxer with stream selection and trimming, packets are forwarded without payload copy
+std::shared_ptr<IAvcRemuxer> CreateAvcRemuxer(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcRemuxerConfig& config = AvcRemuxerConfig());
+
+/// \brief Decodes input once and encodes every rendition of adaptive bitrate ladder in parallel
+std::shared_ptr<IAvcAbrLadder> CreateAvcAbrLadder(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcAbrLadderConfig& config);
+
+/// \brief Cuts video at any frame, copies inner GOPs and re-encodes only GOPs on cut edges
+std::shared_ptr<IAvcSmartTrimmer> CreateAvcSmartTrimmer(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcSmartTrimmerConfig& config = AvcSmartTrimmerConfig());
+
+/// \brief Low-latency demuxer: AVFMT_FLAG_NOBUFFER, small probe size and analyze duration.
+/// Call for context from avformat_alloc_context before avformat_open_input
+void ApplyAvcLowLatencyInput(
+  IAvcModuleProvider* avc_module_provider,
+  AVFormatContext* format_context,
+  const AvcLowLatencyConfig& config = AvcLowLatencyConfig());
+
+/// \brief Low-latency decoder: AV_CODEC_FLAG_LOW_DELAY, optionally AV_CODEC_FLAG2_FAST, slice threads only.
+/// Call before avcodec_open2
+void ApplyAvcLowLatencyDecoder(
+  IAvcModuleProvider* avc_module_provider,
+  AVCodecContext* codec_context,
+  const AvcLowLatencyConfig& config = AvcLowLatencyConfig());
+
+/// \brief Low-latency encoder: AV_CODEC_FLAG_LOW_DELAY, no B-frames, slice threads only. Call before avcodec_open2.
+/// Encoder private options (e.g. libx264 tune zerolatency) are passed by caller to avcodec_open2
+void ApplyAvcLowLatencyEncoder(
+  IAvcModuleProvider* avc_module_provider,
+  AVCodecContext* codec_context);
+
+/// \brief Low-latency muxer: AVFMT_FLAG_FLUSH_PACKETS, output is flushed after every packet
+void ApplyAvcLowLatencyOutput(
+  IAvcModuleProvider* avc_module_provider,
+  AVFormatContext* format_context);
+
+/// \brief Measures latency from packet read to decoded frame given out, per stream
+std::shared_ptr<IAvcLatencyTracer> CreateAvcLatencyTracer(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcLatencyTracerConfig& config = AvcLatencyTracerConfig());
+
+/// \brief Probes media files concurrently with tight probe limits, caches summaries of unchanged local files
+std::shared_ptr<IAvcMediaProber> CreateAvcMediaProber(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcMediaProberConfig& config = AvcMediaProberConfig());
+
+/// \brief Splits raw elementary stream of codec_id (AVCodecID) to packets by parser, slices input without copy.
+/// Returns null when loaded libavcodec has no parser for codec
+std::shared_ptr<IAvcPacketizer> CreateAvcPacketizer(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  int codec_id);
+
+/// \brief Classifies H.264/HEVC NAL units of packets for keyframe detection without decoding.
+/// extradata of stream selects length-prefixed (avcC/hvcC) or Annex B format. Returns null for other codecs
+std::shared_ptr<IAvcNalScanner> CreateAvcNalScanner(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  int codec_id,
+  const uint8_t* extradata = nullptr,
+  int extradata_size = 0);
+
+/// \brief Calibrates encoder and decoder threading per codec, resolution and hardware threads count.
+/// Pass it to codec_autotuner_ of pipeline configs to use tuned settings for automatic threading
+std::shared_ptr<IAvcCodecAutotuner> CreateAvcCodecAutotuner(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcCodecAutotunerConfig& config = AvcCodecAutotunerConfig());
+
+/// \brief Keeps opened decoders and recycles them by avcodec_flush_buffers for streams with equal parameters
+std::shared_ptr<IAvcDecoderPool> CreateAvcDecoderPool(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcDecoderPoolConfig& config = AvcDecoderPoolConfig());
 	
 }//namespace avc
 
@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_ABR_LADDER_HEADER
+#define I_AVC_ABR_LADDER_HEADER
+
+#include <avc/i_avc_codec_autotuner.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace avc {
+
+/// \brief One output of ladder
+struct AvcAbrRendition {
+  std::string url_;                            ///< output url of rendition
+  std::string output_format_;                  ///< empty means format is guessed from url
+  int width_ = 0;                              ///< 0 keeps source size, when only one side is 0 it keeps aspect ratio
+  int height_ = 0;
+  int64_t bit_rate_ = 0;                       ///< 0 keeps encoder default
+  std::string encoder_name_ = "libx264";
+};
+
+struct AvcAbrLadderConfig {
+  std::vector<AvcAbrRendition> renditions_;
+  int gop_size_ = 0;                           ///< frames, equal for all renditions to keep segments aligned. 0 is 2 seconds
+  int decoder_threads_ = 0;                    ///< 0 is auto
+  int encoder_threads_ = 0;                    ///< codec threads of every rendition encoder, 0 is auto
+  size_t frame_queue_depth_ = 8;               ///< decoded frames per rendition waiting for scaler
+  std::vector<std::pair<std::string, std::string>> encoder_options_;  ///< passed to avcodec_open2 of every encoder
+  std::shared_ptr<IAvcCodecAutotuner> codec_autotuner_;  ///< tuned threading of codecs which have 0 threads
+};
+
+struct AvcAbrRenditionStatistics {
+  uint64_t frames_scaled_ = 0;                 ///< frames passed through sws_scale, others were sent as is
+  uint64_t frames_submitted_ = 0;
+  uint64_t packets_written_ = 0;
+  uint64_t bytes_written_ = 0;
+  double scale_ms_ = 0;
+};
+
+struct AvcAbrLadderStatistics {
+  uint64_t packets_read_ = 0;
+  uint64_t frames_decoded_ = 0;
+  uint64_t decoder_waits_ = 0;                 ///< decoder waited for free frame of slowest rendition
+  double elapsed_ms_ = 0;
+  std::vector<AvcAbrRenditionStatistics> renditions_;
+};
+
+/// \brief Adaptive bitrate ladder: video of input is decoded once and every decoded frame is passed by
+/// reference to all renditions. Each rendition scales on own thread and encodes and muxes in own
+/// encode pipeline, so renditions run in parallel and slowest rendition sets the pace.
+/// Only best video stream of input is transcoded
+struct IAvcAbrLadder {
+  virtual ~IAvcAbrLadder() = default;
+
+  /// \brief Transcode input_url to all renditions. Returns 0 or first AVERROR code of any stage
+  virtual int Run(const std::string& input_url) = 0;
+
+  /// \brief Statistics of last Run
+  virtual AvcAbrLadderStatistics GetStatistics() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_ABR_LADDER_HEADER
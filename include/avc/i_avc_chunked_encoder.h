@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_CHUNKED_ENCODER_HEADER
+#define I_AVC_CHUNKED_ENCODER_HEADER
+
+#include <avc/i_avc_codec_autotuner.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace avc {
+
+struct AvcChunkedEncoderConfig {
+  std::string output_format_;                  ///< empty means format is guessed from output url
+  std::string video_encoder_name_ = "libx264";
+  int width_ = 0;                              ///< output size, 0 keeps source size
+  int height_ = 0;
+  int64_t bit_rate_ = 0;                       ///< 0 keeps encoder default
+  int gop_size_ = 0;                           ///< 0 keeps encoder default
+  int threads_count_ = 0;                      ///< chunks encoded in parallel, 0 means one per hardware thread
+  int chunks_count_ = 0;                       ///< 0 means two chunks per thread, chunk sizes are not equal
+  int codec_threads_ = 1;                      ///< internal threads of chunk decoder and encoder, 0 is auto
+  double min_chunk_duration_ = 2.0;            ///< seconds, shorter chunks are merged with neighbours
+  bool copy_audio_ = true;                     ///< remux audio streams of input when chunks are joined
+  std::shared_ptr<IAvcCodecAutotuner> codec_autotuner_;  ///< tuned threading of decoders and encoders when codec_threads_ is 0
+};
+
+/// \brief Part of input from keyframe to keyframe of next chunk
+struct AvcEncodeChunk {
+  int64_t start_timestamp_ = 0;                ///< keyframe timestamp as in demuxer index, time base of video stream
+  int64_t start_pos_ = -1;                     ///< keyframe byte position, -1 when unknown
+  uint64_t frames_encoded_ = 0;
+  double encode_ms_ = 0;
+};
+
+struct AvcChunkedEncoderStatistics {
+  int threads_count_ = 0;
+  bool index_used_ = false;                    ///< false when keyframes were found by reading whole input
+  uint64_t frames_encoded_ = 0;
+  uint64_t packets_written_ = 0;
+  double split_ms_ = 0;
+  double encode_ms_ = 0;                       ///< wall time of parallel chunk encoding
+  double chunks_encode_ms_ = 0;                ///< sum of chunk encode times, equals encode_ms_ on one thread
+  double join_ms_ = 0;
+};
+
+/// \brief Encodes one long input on many cores. Input is split at keyframes into chunks, each chunk is
+/// decoded and encoded by own codec contexts (single-threaded by default) with closed GOPs, then chunks are joined
+/// into one output with continuous timestamps.
+/// Only first video stream is transcoded. B-frames are disabled, so decode and presentation order of
+/// joined packets match at chunk borders. Chunks are written to temporary files next to output
+struct IAvcChunkedEncoder {
+  virtual ~IAvcChunkedEncoder() = default;
+
+  /// \brief Transcode input_url to output_url. Returns 0 or AVERROR code
+  virtual int Encode(const std::string& input_url, const std::string& output_url) = 0;
+
+  /// \brief Chunks of last Encode call
+  virtual std::vector<AvcEncodeChunk> GetChunks() const = 0;
+
+  virtual AvcChunkedEncoderStatistics GetStatistics() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_CHUNKED_ENCODER_HEADER
@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_CODEC_AUTOTUNER_HEADER
+#define I_AVC_CODEC_AUTOTUNER_HEADER
+
+#include <cstddef>
+#include <string>
+
+namespace avc {
+
+struct AVCodecContext;
+
+/// \brief Codec threading which gave highest throughput in calibration
+struct AvcCodecThreadSettings {
+  int thread_count_ = 0;           ///< AVCodecContext thread_count
+  int thread_type_ = 0;            ///< FF_THREAD_FRAME or FF_THREAD_SLICE, 0 keeps codec default
+  int slices_ = 0;                 ///< AVCodecContext slices of encoder, 0 keeps encoder default
+  double frames_per_second_ = 0;   ///< measured throughput
+};
+
+struct AvcCodecAutotunerConfig {
+  int calibration_frames_ = 48;    ///< synthetic frames encoded or decoded for every grid point
+  int max_threads_count_ = 0;      ///< highest thread count of search grid, 0 is hardware threads count
+  bool calibrate_on_miss_ = false; ///< Apply calibrates codec when settings are not known, may block for seconds
+  std::string cache_url_;          ///< when set, settings are loaded on creation and saved after calibration
+};
+
+/// \brief Finds best thread_count, thread_type and slices of encoders and decoders by short calibration
+/// runs on synthetic frames. Settings are stored per (codec name, resolution bucket, hardware threads count),
+/// so one settings file may be shared by different machines. Thread safe, calibrations run one at a time
+struct IAvcCodecAutotuner {
+  virtual ~IAvcCodecAutotuner() = default;
+
+  /// \brief Calibrate encoder (e.g. "libx264") and default decoder of its codec at resolution.
+  /// pix_fmt -1 takes yuv420p when encoder supports it, otherwise first supported format
+  virtual int Calibrate(const std::string& encoder_name, int width, int height, int pix_fmt = -1) = 0;
+
+  /// \brief Settings of codec (AVCodec name) for resolution bucket of width x height on this machine
+  virtual bool GetSettings(const std::string& codec_name, bool encoder, int width, int height,
+                           AvcCodecThreadSettings& settings) const = 0;
+
+  /// \brief Set stored thread settings to codec context before avcodec_open2. Width and height must be set.
+  /// Returns 0 when settings were applied, AVERROR(ENOENT) when codec is not calibrated
+  virtual int Apply(AVCodecContext* codec_context, bool encoder) = 0;
+
+  /// \brief Merge settings from file
+  virtual int Load(const std::string& url) = 0;
+  virtual int Save(const std::string& url) const = 0;
+  virtual size_t GetSettingsCount() const = 0;
+  virtual void Clear() = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_CODEC_AUTOTUNER_HEADER
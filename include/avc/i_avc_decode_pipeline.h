@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_DECODE_PIPELINE_HEADER
+#define I_AVC_DECODE_PIPELINE_HEADER
+
+#include <media/media_timebase.h>
+#include <avc/i_avc_low_latency.h>
+#include <avc/i_avc_codec_autotuner.h>
+#include <avc/i_avc_decoder_pool.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace avc {
+
+struct AVFrame;
+
+struct AvcDecodePipelineConfig {
+  std::vector<int> stream_indexes_;   ///< streams to decode. Empty means all audio and video streams
+  size_t packet_queue_depth_ = 32;    ///< packets per stream between demuxer and decoder
+  size_t frame_queue_depth_ = 8;      ///< decoded frames per stream waiting for caller
+  int decoder_threads_ = 0;           ///< codec internal threads, 0 is auto
+  int numa_node_ = -1;                ///< bind pipeline threads to NUMA node, -1 does not bind
+  bool low_latency_ = false;          ///< open input and decoders with low-latency profile
+  AvcLowLatencyConfig low_latency_config_;
+  std::shared_ptr<IAvcLatencyTracer> latency_tracer_;  ///< stamps packets read and frames received by caller
+  std::shared_ptr<IAvcCodecAutotuner> codec_autotuner_;  ///< tuned threading of decoders when decoder_threads_ is 0
+  std::shared_ptr<IAvcDecoderPool> decoder_pool_;        ///< decoders are taken from pool and returned on destruction.
+                                                         ///< Not used with low_latency_, threading is set by pool
+};
+
+struct AvcDecodePipelineStatistics {
+  uint64_t packets_read_ = 0;
+  uint64_t packets_dropped_ = 0;      ///< packets of streams which are not decoded
+  uint64_t frames_decoded_ = 0;
+  uint64_t frames_received_ = 0;
+  uint64_t demuxer_waits_ = 0;        ///< demuxer had to wait for free packet (decoder is bottleneck)
+  uint64_t decoder_waits_ = 0;        ///< decoder had to wait for free frame (caller is bottleneck)
+};
+
+/// \brief Demuxer runs on own thread, each decoder on own thread. Stages are connected by bounded
+/// single-producer/single-consumer lock-free queues, packets and frames are preallocated and recycled.
+/// Demuxer fans packets out to decoders by stream index, streams which are not subscribed are discarded
+/// by demuxer (AVDISCARD_ALL) before any packet is read or copied.
+/// Caller pulls decoded frames either from all streams by one thread (ReceiveFrame), or from every stream
+/// by own thread (ReceiveStreamFrame). These two ways must not be mixed. Every subscribed stream must be
+/// pulled, otherwise its full queue stops demuxer
+struct IAvcDecodePipeline {
+  virtual ~IAvcDecodePipeline() = default;
+
+  /// \brief Move next decoded frame of any stream to dst (dst must be clean). Blocks while no frame ready.
+  /// Returns 0 on success, AVERROR_EOF when all streams are finished, AVERROR_EXIT after Stop
+  /// or demuxer error code. Decoding error of stream is returned once with its stream_index, then other
+  /// streams continue
+  virtual int ReceiveFrame(AVFrame* dst, int* stream_index) = 0;
+
+  /// \brief Same as ReceiveFrame but returns AVERROR(EAGAIN) instead of waiting
+  virtual int TryReceiveFrame(AVFrame* dst, int* stream_index) = 0;
+
+  /// \brief Move next decoded frame of stream to dst. Blocks while no frame ready. One thread per stream.
+  /// Returns AVERROR_EOF when stream is finished or unsubscribed, decoding error when stream ended with it
+  virtual int ReceiveStreamFrame(int stream_index, AVFrame* dst) = 0;
+  virtual int TryReceiveStreamFrame(int stream_index, AVFrame* dst) = 0;
+
+  /// \brief Stop decoding stream. Demuxer discards its packets, frames already decoded are dropped
+  virtual int Unsubscribe(int stream_index) = 0;
+
+  /// \brief Stop and join threads. Called by destructor
+  virtual void Stop() = 0;
+
+  virtual std::vector<int> GetStreamIndexes() const = 0;
+  virtual int GetStreamMediaType(int stream_index) const = 0;
+  virtual cmf::MediaTimeBase GetStreamTimeBase(int stream_index) const = 0;
+
+  virtual AvcDecodePipelineStatistics GetStatistics() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_DECODE_PIPELINE_HEADER
@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_DECODER_POOL_HEADER
+#define I_AVC_DECODER_POOL_HEADER
+
+#include <media/media_timebase.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace avc {
+
+struct AVCodecContext;
+struct AVCodecParameters;
+
+struct AvcDecoderPoolConfig {
+  size_t max_idle_ = 8;           ///< idle contexts kept by pool, least recently released are freed
+  size_t max_idle_per_key_ = 4;   ///< idle contexts kept for same parameters
+  int thread_count_ = 0;          ///< decoder threads of opened contexts, 0 is auto
+};
+
+struct AvcDecoderPoolStatistics {
+  uint64_t acquired_ = 0;
+  uint64_t reused_ = 0;           ///< acquired contexts taken from idle contexts
+  uint64_t opened_ = 0;           ///< acquired contexts opened by avcodec_open2
+  uint64_t released_ = 0;
+  uint64_t freed_ = 0;            ///< released or idle contexts freed: pool full, not reusable or Clear
+  size_t idle_ = 0;
+  size_t in_use_ = 0;
+  double open_ms_ = 0.0;          ///< time spent in opening of contexts
+};
+
+/// \brief Pool of opened decoders. Contexts are keyed by all codec parameters which decoders read on open:
+/// codec id and tag, media type, profile, dimensions, pixel or sample format, sample rate, channels and
+/// channel layout, bits per coded sample, block align and extradata. Released context is flushed by
+/// avcodec_flush_buffers and given to next Acquire with the same key, so avcodec_alloc_context3,
+/// avcodec_parameters_to_context and avcodec_open2 run only for new parameters. Thread safe.
+///
+/// With thread_count_ 0 and enabled thread budget (IAvcModuleProvider::GetThreadBudget) opened context
+/// takes budget session. Idle context leaves budget, its worker threads stay parked until it is reused or
+/// freed, and reused context joins budget again with threads it was opened with. Keep max_idle_ small when
+/// decoders run many threads
+struct IAvcDecoderPool {
+  virtual ~IAvcDecoderPool() = default;
+
+  /// \brief Opened decoder for stream parameters, pkt_time_base is set to context on every acquire.
+  /// Returns null on error, error code is in error when it is not null
+  virtual AVCodecContext* Acquire(const AVCodecParameters* codecpar, cmf::MediaTimeBase pkt_time_base,
+                                  int* error = nullptr) = 0;
+
+  /// \brief Return context to pool, pool takes ownership. Context which is not reusable (e.g. decoder
+  /// failed) or was not acquired from pool is freed
+  virtual void Release(AVCodecContext* codec_context, bool reusable = true) = 0;
+
+  /// \brief Free idle contexts
+  virtual void Clear() = 0;
+
+  virtual AvcDecoderPoolStatistics GetStatistics() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_DECODER_POOL_HEADER
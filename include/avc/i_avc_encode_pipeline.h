@@ -0,0 +1,100 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_ENCODE_PIPELINE_HEADER
+#define I_AVC_ENCODE_PIPELINE_HEADER
+
+#include <avc/i_avc_codec_autotuner.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace avc {
+
+struct AVFrame;
+struct AVCodecContext;
+
+struct AvcEncodePipelineConfig {
+  size_t frame_queue_depth_ = 8;      ///< frames per stream between caller and encoder
+  size_t packet_queue_depth_ = 32;    ///< packets per stream between encoder and muxer
+  int numa_node_ = -1;                ///< bind pipeline threads to NUMA node, -1 does not bind
+  int encoder_threads_ = 0;           ///< codec internal threads set by PrepareEncoder, 0 is auto
+  std::vector<std::pair<std::string, std::string>> muxer_options_;  ///< passed to avformat_write_header
+  std::shared_ptr<IAvcCodecAutotuner> codec_autotuner_;  ///< tuned threading of encoders when encoder_threads_ is 0
+};
+
+struct AvcEncodePipelineStatistics {
+  uint64_t frames_submitted_ = 0;
+  uint64_t frames_rejected_ = 0;       ///< SubmitFrame returned AVERROR(EAGAIN) because frame queue was full
+  uint64_t packets_encoded_ = 0;
+  uint64_t packets_written_ = 0;
+  uint64_t bytes_written_ = 0;
+  uint64_t encoder_waits_ = 0;         ///< encoder had to wait for free packet (muxer is bottleneck)
+  size_t frame_queue_depth_ = 0;       ///< frames waiting for encoders now, sum over streams
+  size_t frame_queue_peak_depth_ = 0;  ///< highest depth of single stream frame queue
+  size_t packet_queue_depth_ = 0;      ///< packets waiting for muxer now, sum over streams
+  size_t packet_queue_peak_depth_ = 0; ///< highest depth of single stream packet queue
+};
+
+/// \brief Each encoder runs on own thread, muxer (avformat_write_header, av_interleaved_write_frame,
+/// av_write_trailer) runs on separate thread. Stages are connected by bounded single-producer/single-consumer
+/// queues. SubmitFrame never blocks, full queue is reported as AVERROR(EAGAIN) (backpressure).
+/// SubmitFrame, WaitForSubmit and Finish must be called from one thread at a time
+struct IAvcEncodePipeline {
+  virtual ~IAvcEncodePipeline() = default;
+
+  /// \brief True when output format wants global header. Then AV_CODEC_FLAG_GLOBAL_HEADER must be set
+  /// to encoder before avcodec_open2
+  virtual bool IsGlobalHeaderRequired() const = 0;
+
+  /// \brief Set AV_CODEC_FLAG_GLOBAL_HEADER when required and threading from config to encoder before
+  /// avcodec_open2. Width and height must be set
+  virtual void PrepareEncoder(AVCodecContext* encoder_context) const = 0;
+
+  /// \brief Add output stream for opened encoder, must be called before Start. Pipeline takes ownership
+  /// of encoder context on success. Returns stream index or AVERROR code
+  virtual int AddStream(AVCodecContext* encoder_context) = 0;
+
+  /// \brief Start encoder and muxer threads. Output is opened and header is written on muxer thread
+  virtual int Start() = 0;
+
+  /// \brief Reference frame (pts in encoder time base) into stream queue. Null frame ends stream.
+  /// Returns AVERROR(EAGAIN) when queue is full, pipeline error code after failure
+  virtual int SubmitFrame(int stream_index, const AVFrame* frame) = 0;
+
+  /// \brief Block until SubmitFrame to stream can be accepted. Returns pipeline error code after failure
+  virtual int WaitForSubmit(int stream_index) = 0;
+
+  /// \brief End all streams, wait until encoders are flushed and trailer is written.
+  /// Returns first error of any stage. Called by destructor
+  virtual int Finish() = 0;
+
+  virtual AvcEncodePipelineStatistics GetStatistics() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_ENCODE_PIPELINE_HEADER
@@ -0,0 +1,43 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_EXECUTOR_HEADER
+#define I_AVC_EXECUTOR_HEADER
+
+#include <functional>
+
+namespace avc {
+
+/// \brief Runs posted tasks on own threads. Used by coroutine layer (avc_coroutines.h) to resume sessions,
+/// so many sessions share few threads. Application may implement it on top of own event loop
+struct IAvcExecutor {
+  virtual ~IAvcExecutor() = default;
+
+  /// \brief Run task later on one of executor threads. Must be callable from any thread, including executor threads
+  virtual void Post(std::function<void()> task) = 0;
+
+  virtual int GetThreadsCount() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_EXECUTOR_HEADER
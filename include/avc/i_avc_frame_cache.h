@@ -0,0 +1,69 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_FRAME_CACHE_HEADER
+#define I_AVC_FRAME_CACHE_HEADER
+
+#include <cstddef>
+#include <cstdint>
+
+namespace avc {
+
+struct AVFrame;
+
+struct AvcFrameCacheStatistics {
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t decoded_frames_ = 0;     ///< frames decoded by background worker, including prefetched ones
+  uint64_t evicted_frames_ = 0;
+  uint64_t evicted_gops_ = 0;
+  size_t cached_frames_ = 0;
+  size_t cached_gops_ = 0;
+  size_t cached_bytes_ = 0;
+  size_t budget_bytes_ = 0;
+};
+
+/// \brief Decoded frames cache for random access (scrubbing). Frames are keyed by (stream, pts), stream
+/// time base is used. On miss background worker seeks to previous keyframe, decodes GOP and caches all its
+/// frames. Least recently used GOPs are evicted as a whole when byte budget is exceeded
+struct IAvcFrameCache {
+  virtual ~IAvcFrameCache() = default;
+
+  /// \brief Reference frame shown at pts into dst. Blocks until frame is decoded on miss.
+  /// Returns 0 on success, AVERROR_EOF when pts is after end of stream, or other AVERROR code
+  virtual int GetFrame(int stream_index, int64_t pts, AVFrame* dst) = 0;
+
+  /// \brief Same as GetFrame but never blocks. Returns AVERROR(EAGAIN) and schedules decoding on miss
+  virtual int TryGetFrame(int stream_index, int64_t pts, AVFrame* dst) = 0;
+
+  /// \brief Schedule decoding of GOP containing pts without waiting
+  virtual void Prefetch(int stream_index, int64_t pts) = 0;
+
+  virtual void SetBudget(size_t budget_bytes) = 0;
+  virtual void Clear() = 0;
+
+  virtual AvcFrameCacheStatistics GetStatistics() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_FRAME_CACHE_HEADER
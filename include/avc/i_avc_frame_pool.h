@@ -0,0 +1,93 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_FRAME_POOL_HEADER
+#define I_AVC_FRAME_POOL_HEADER
+
+#include <cstdint>
+#include <memory>
+
+namespace avc {
+
+struct AVFrame;
+struct AVPacket;
+
+/// \brief Snapshot of frame/packet pool counters
+struct AvcPoolStatistics {
+  int numa_node_ = -1;
+
+  uint64_t frames_allocated_ = 0;   ///< AVFrame objects created by av_frame_alloc
+  uint64_t frames_reused_ = 0;      ///< AVFrame acquisitions served from cache
+  uint64_t frames_in_use_ = 0;      ///< AVFrame objects currently acquired
+  uint64_t frames_cached_ = 0;      ///< AVFrame objects waiting in cache
+
+  uint64_t packets_allocated_ = 0;
+  uint64_t packets_reused_ = 0;
+  uint64_t packets_in_use_ = 0;
+  uint64_t packets_cached_ = 0;
+
+  uint64_t buffer_bytes_allocated_ = 0; ///< bytes of frame buffers allocated and placed by pool
+};
+
+/// \brief Thread-safe cache of AVFrame/AVPacket objects bound to one NUMA node
+struct IAvcFramePool {
+  virtual ~IAvcFramePool() = default;
+
+  virtual AVFrame* AcquireFrame() = 0;
+
+  /// \brief Acquire frame with allocated video buffers. Buffer pages are placed on pool NUMA node
+  virtual AVFrame* AcquireVideoFrame(int width, int height, int pix_fmt, int align = 0) = 0;
+
+  /// \brief Unreference frame data and put frame object back to cache
+  virtual void ReleaseFrame(AVFrame* frame) = 0;
+
+  virtual AVPacket* AcquirePacket() = 0;
+  virtual void ReleasePacket(AVPacket* packet) = 0;
+
+  /// \brief Free all cached objects
+  virtual void Trim() = 0;
+
+  virtual int GetNumaNode() const = 0;
+  virtual AvcPoolStatistics GetStatistics() const = 0;
+};
+
+/// \brief Set of frame pools, one per NUMA node
+struct IAvcNumaFramePools {
+  virtual ~IAvcNumaFramePools() = default;
+
+  virtual int GetNodesCount() const = 0;
+  virtual std::shared_ptr<IAvcFramePool> GetPool(int numa_node) = 0;
+
+  /// \brief Pool of the node current thread is running on
+  virtual std::shared_ptr<IAvcFramePool> GetCurrentNodePool() = 0;
+  virtual int GetCurrentNumaNode() const = 0;
+
+  /// \brief Pin current thread to CPUs of node and prefer node-local memory for its allocations.
+  /// Pipeline workers call it with their affinity hint so decode, scale and encode of one stream share node
+  virtual bool BindCurrentThreadToNode(int numa_node) = 0;
+
+  virtual AvcPoolStatistics GetStatistics(int numa_node) const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_FRAME_POOL_HEADER
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_KEYFRAME_INDEX_HEADER
+#define I_AVC_KEYFRAME_INDEX_HEADER
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace avc {
+
+struct AVFormatContext;
+struct AVPacket;
+
+/// \brief Keyframe record as stored in sidecar file, timestamps are in stream time base
+struct AvcKeyframeEntry {
+  int64_t pts_;
+  int64_t dts_;
+  int64_t pos_;       ///< byte position in source, -1 when demuxer does not know it
+  int32_t size_;
+  int32_t flags_;     ///< AV_PKT_FLAG_* of packet
+};
+
+/// \brief Keyframe index of media file kept beside it in compact sidecar file. Index is collected by first
+/// pass (Build) or while packets are read anyway (Reset + AddPacket), saved once and later memory-mapped
+/// by Load and injected to demuxer by Apply, so seeking does not scan container with sparse or missing index.
+/// Not thread-safe
+struct IAvcKeyframeIndex {
+  virtual ~IAvcKeyframeIndex() = default;
+
+  /// \brief Read all packets of input without decoding and collect keyframes of every stream
+  virtual int Build(const std::string& input_url) = 0;
+
+  /// \brief Drop loaded entries and take streams and time bases from opened input
+  virtual void Reset(const AVFormatContext* format_context) = 0;
+
+  /// \brief Record packet read from input passed to Reset. Non-keyframe packets are ignored
+  virtual void AddPacket(const AVPacket* packet) = 0;
+
+  /// \brief Write sidecar file
+  virtual int Save(const std::string& sidecar_url) const = 0;
+
+  /// \brief Map sidecar file. When source_url is local file, its size must be equal to size recorded by Build,
+  /// otherwise AVERROR_INVALIDDATA is returned and index stays empty
+  virtual int Load(const std::string& sidecar_url, const std::string& source_url = std::string()) = 0;
+
+  /// \brief Add entries to streams of opened input by av_add_index_entry, rescaling timestamps when stream
+  /// time base differs from recorded one. Returns count of added entries or AVERROR code
+  virtual int Apply(AVFormatContext* format_context) const = 0;
+
+  virtual int GetStreamsCount() const = 0;
+  virtual size_t GetEntriesCount(int stream_index) const = 0;
+
+  /// \brief Entries of stream in DTS order. Pointer is valid until index is changed or destroyed
+  virtual const AvcKeyframeEntry* GetEntries(int stream_index) const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_KEYFRAME_INDEX_HEADER
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_KEYFRAME_SAMPLER_HEADER
+#define I_AVC_KEYFRAME_SAMPLER_HEADER
+
+#include <media/media_timebase.h>
+
+#include <cstdint>
+#include <string>
+
+namespace avc {
+
+struct AVFrame;
+
+struct AvcKeyframeSamplerConfig {
+  double interval_seconds_ = 10.0;  ///< distance between sampling points
+  double start_seconds_ = 0.0;      ///< first sampling point, from stream start
+  int max_frames_ = 0;              ///< stop after this count of frames, 0 samples whole stream
+  int threads_count_ = 0;           ///< slice threads of decoder, 0 is auto
+  bool skip_loop_filter_ = true;    ///< skip deblocking, visible only on close look, good enough for thumbnails
+  bool detect_keyframes_ = true;    ///< find H.264/HEVC keyframes not flagged by demuxer by NAL unit types
+};
+
+struct AvcKeyframeSamplerStatistics {
+  uint64_t frames_sampled_ = 0;
+  uint64_t seeks_ = 0;
+  uint64_t packets_read_ = 0;       ///< packets of sampled stream returned by demuxer
+  uint64_t packets_decoded_ = 0;    ///< key packets sent to decoder
+  uint64_t packets_skipped_ = 0;    ///< packets dropped without decoding
+  uint64_t keyframes_detected_ = 0; ///< key packets found by NAL unit scan, not flagged by demuxer
+  double decode_ms_ = 0;
+};
+
+/// \brief Extracts one keyframe per sampling interval without decoding frames in between: seeks backward
+/// to keyframe before every sampling point, sends only key packets to decoder with skip_frame set to
+/// AVDISCARD_NONKEY and stops after max frames. Sample may be earlier than sampling point by up to GOP
+/// length; when GOP is longer than interval, next keyframe is taken so samples never repeat
+struct IAvcKeyframeSampler {
+  virtual ~IAvcKeyframeSampler() = default;
+
+  /// \brief Open input and decoder. stream_index -1 selects best video stream
+  virtual int Open(const std::string& url, int stream_index = -1) = 0;
+  virtual void Close() = 0;
+
+  /// \brief Decode next sample into dst, frame pts is in stream time base.
+  /// Returns 0, AVERROR_EOF after last sample or other AVERROR code
+  virtual int NextFrame(AVFrame* dst) = 0;
+
+  virtual int GetStreamIndex() const = 0;
+  virtual cmf::MediaTimeBase GetTimeBase() const = 0;
+  virtual AvcKeyframeSamplerStatistics GetStatistics() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_KEYFRAME_SAMPLER_HEADER
@@ -0,0 +1,87 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_LOW_LATENCY_HEADER
+#define I_AVC_LOW_LATENCY_HEADER
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace avc {
+
+struct AVFormatContext;
+struct AVPacket;
+struct AVFrame;
+
+/// \brief Low-latency profile for live input. FFmpeg defaults (5 MB probe, 5 s analyze) delay first frame
+/// by seconds on live sources
+struct AvcLowLatencyConfig {
+  int64_t probe_size_ = 32768;              ///< bytes read to detect format and streams
+  int64_t max_analyze_duration_ = 100000;   ///< microseconds analyzed by avformat_find_stream_info
+  bool fast_decoding_ = true;               ///< AV_CODEC_FLAG2_FAST, allows non spec compliant speedups
+};
+
+struct AvcLatencyTracerConfig {
+  size_t samples_per_stream_ = 4096;        ///< last latencies kept per stream for percentiles
+  size_t max_pending_per_stream_ = 256;     ///< packets waiting for frame, oldest are dropped above limit
+};
+
+/// \brief Latency from packet read by demuxer to frame given out, microseconds.
+/// Percentiles are computed over last samples_per_stream_ frames, min, max and mean over all frames
+struct AvcLatencyStatistics {
+  uint64_t packets_stamped_ = 0;
+  uint64_t frames_measured_ = 0;
+  uint64_t frames_unmatched_ = 0;   ///< frames without stamped packet of the same timestamp
+  uint64_t stamps_dropped_ = 0;     ///< packets which gave no frame (dropped by decoder or pending limit)
+  int64_t min_us_ = 0;
+  int64_t p50_us_ = 0;
+  int64_t p90_us_ = 0;
+  int64_t p99_us_ = 0;
+  int64_t max_us_ = 0;
+  double mean_us_ = 0.0;
+};
+
+/// \brief Stamps packets when they are read and measures time until frame with the same timestamp
+/// leaves decoder. Packets and frames are matched per stream by pts (dts when pts is not set),
+/// so reordering decoders are measured correctly. Thread safe: packets usually are stamped on demuxer
+/// thread and frames reported by consumer threads
+struct IAvcLatencyTracer {
+  virtual ~IAvcLatencyTracer() = default;
+
+  /// \brief av_read_frame which stamps packet read
+  virtual int ReadFrame(AVFormatContext* format_context, AVPacket* packet) = 0;
+
+  /// \brief Stamp packet just read by caller own av_read_frame
+  virtual void StampPacket(const AVPacket* packet) = 0;
+
+  /// \brief Frame of stream is given out to consumer
+  virtual void OnFrameOut(int stream_index, const AVFrame* frame) = 0;
+
+  virtual std::vector<int> GetStreamIndexes() const = 0;
+  virtual AvcLatencyStatistics GetStreamStatistics(int stream_index) const = 0;
+  virtual void Reset() = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_LOW_LATENCY_HEADER
@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_MEDIA_PROBER_HEADER
+#define I_AVC_MEDIA_PROBER_HEADER
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace avc {
+
+const int kAvcProbeMaxStreams = 16;
+
+/// \brief Stream summary. Plain data, stored in cache file as is
+struct AvcProbeStreamInfo {
+  int32_t index_;
+  int32_t media_type_;        ///< AVMEDIA_TYPE_*
+  int32_t codec_id_;
+  int32_t profile_;
+  int32_t format_;            ///< pixel format for video, sample format for audio
+  int32_t width_;
+  int32_t height_;
+  int32_t sample_rate_;
+  int32_t channels_;
+  int32_t time_base_num_;
+  int32_t time_base_den_;
+  int32_t frame_rate_num_;    ///< average frame rate, 0/0 when unknown
+  int32_t frame_rate_den_;
+  int32_t reserved_;
+  int64_t bit_rate_;
+  int64_t start_time_;        ///< in stream time base, AV_NOPTS_VALUE when unknown
+};
+
+/// \brief File summary. Plain data, stored in cache file as is
+struct AvcProbeResult {
+  int32_t error_;             ///< 0 or AVERROR code of open or probe
+  int32_t streams_count_;     ///< streams in file, first kAvcProbeMaxStreams are described in streams_
+  int64_t duration_;          ///< AV_TIME_BASE units, AV_NOPTS_VALUE when unknown
+  int64_t start_time_;        ///< AV_TIME_BASE units, AV_NOPTS_VALUE when unknown
+  uint64_t file_size_;        ///< 0 for non-local urls
+  int64_t file_mtime_;        ///< nanoseconds since epoch, 0 for non-local urls
+  AvcProbeStreamInfo streams_[kAvcProbeMaxStreams];
+};
+
+struct AvcMediaProberConfig {
+  int threads_count_ = 0;                  ///< 0 is one thread per hardware thread
+  int64_t probe_size_ = 512 * 1024;        ///< bytes read to detect format and streams (FFmpeg default is 5 MB)
+  int64_t max_analyze_duration_ = 1000000; ///< microseconds analyzed by avformat_find_stream_info (FFmpeg default is 5 s)
+  bool find_stream_info_ = true;           ///< false reads container headers only, codec parameters may be incomplete
+};
+
+struct AvcMediaProberStatistics {
+  uint64_t files_opened_ = 0;
+  uint64_t cache_hits_ = 0;
+  uint64_t errors_ = 0;
+  double probe_ms_ = 0.0;                  ///< sum of time spent in opened files
+};
+
+/// \brief Reads duration, codecs and stream parameters of many media files concurrently on own thread pool.
+/// Results of local files are cached by (path, size, modification time), so unchanged files are not opened
+/// again. Cache may be saved to file and loaded by next run. Thread safe
+struct IAvcMediaProber {
+  virtual ~IAvcMediaProber() = default;
+
+  /// \brief Probe one url on caller thread. Returns result error_
+  virtual int Probe(const std::string& url, AvcProbeResult* result) = 0;
+
+  /// \brief Probe urls on prober threads and wait for all. results[i] is summary of urls[i].
+  /// Returns count of urls which failed
+  virtual size_t ProbeBatch(const std::vector<std::string>& urls, std::vector<AvcProbeResult>* results) = 0;
+
+  /// \brief Merge entries of cache file into cache
+  virtual int LoadCache(const std::string& cache_url) = 0;
+  virtual int SaveCache(const std::string& cache_url) const = 0;
+  virtual size_t GetCacheSize() const = 0;
+  virtual void ClearCache() = 0;
+
+  virtual AvcMediaProberStatistics GetStatistics() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_MEDIA_PROBER_HEADER
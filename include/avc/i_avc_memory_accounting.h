@@ -0,0 +1,100 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_MEMORY_ACCOUNTING_HEADER
+#define I_AVC_MEMORY_ACCOUNTING_HEADER
+
+#include <cstdint>
+#include <vector>
+
+namespace avc {
+
+enum AvcMemoryObjectType {
+  kAvcMemoryObject_Frame = 0,        ///< av_frame_alloc / av_frame_clone / av_frame_free
+  kAvcMemoryObject_FrameBuffer = 1,  ///< av_frame_get_buffer, released by av_frame_unref / av_frame_free
+  kAvcMemoryObject_Packet = 2,       ///< av_packet_alloc / av_packet_clone / av_packet_free
+  kAvcMemoryObject_Malloc = 3,       ///< av_malloc / av_free / av_freep
+  kAvcMemoryObject_Buffer = 4,       ///< av_buffer_create / av_buffer_realloc / av_buffer_unref of returned reference
+  kAvcMemoryObject_Count
+};
+
+struct AvcMemoryObjectCounters {
+  int64_t live_count_ = 0;
+  int64_t peak_count_ = 0;
+  int64_t live_bytes_ = 0;
+  int64_t peak_bytes_ = 0;
+};
+
+struct AvcMemoryCounters {
+  AvcMemoryObjectCounters objects_[kAvcMemoryObject_Count];
+  int64_t live_bytes_ = 0;
+  int64_t peak_bytes_ = 0;
+};
+
+/// \brief Optional accounting of FFmpeg objects allocated through provider. Disabled by default.
+/// Allocations are attributed to tag of allocating thread (0 when not set). Counters are atomics,
+/// so reading does not take locks
+struct IAvcMemoryAccounting {
+  virtual ~IAvcMemoryAccounting() = default;
+
+  virtual void SetEnabled(bool enabled) = 0;
+  virtual bool IsEnabled() const = 0;
+
+  /// \brief Tag for allocations made by current thread
+  virtual void SetThreadTag(uint32_t tag) = 0;
+  virtual uint32_t GetThreadTag() const = 0;
+
+  virtual AvcMemoryCounters GetTotalCounters() const = 0;
+  virtual bool GetTagCounters(uint32_t tag, AvcMemoryCounters& counters) const = 0;
+  virtual std::vector<uint32_t> GetTags() const = 0;
+
+  /// \brief Set peaks to current live values
+  virtual void ResetPeaks() = 0;
+};
+
+/// \brief Set thread tag for scope lifetime
+class AvcMemoryTagScope {
+ public:
+  AvcMemoryTagScope(IAvcMemoryAccounting* accounting, uint32_t tag)
+    : accounting_(accounting) {
+    if (accounting_) {
+      prev_tag_ = accounting_->GetThreadTag();
+      accounting_->SetThreadTag(tag);
+    }
+  }
+
+  ~AvcMemoryTagScope() {
+    if (accounting_)
+      accounting_->SetThreadTag(prev_tag_);
+  }
+
+  AvcMemoryTagScope(const AvcMemoryTagScope&) = delete;
+  AvcMemoryTagScope& operator=(const AvcMemoryTagScope&) = delete;
+
+ private:
+  IAvcMemoryAccounting* accounting_;
+  uint32_t prev_tag_ = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_MEMORY_ACCOUNTING_HEADER
@@ -82,6 +82,7 @@ struct IAvcModuleDataWrapper {
   virtual int64_t AVStreamGetStartTime(const AVStream* stream) const = 0;
   virtual int AVStreamGetIndex(const AVStream* stream) const = 0;
   virtual int AVStreamGetId(const AVStream* stream) const = 0;
+  virtual int AVStreamGetDiscard(const AVStream* stream) const = 0;
 
   virtual void AVStreamSetTimeBase(AVStream* stream, cmf::MediaTimeBase tb) const = 0;
   virtual void AVStreamSetFrameRate(AVStream* stream, cmf::MediaTimeBase framerate) const = 0;
@@ -89,6 +90,7 @@ struct IAvcModuleDataWrapper {
   virtual void AVStreamSetStartTime(AVStream* stream, int64_t start_time) const = 0;
   virtual void AVStreamSetIndex(AVStream* stream, int index) const = 0;
   virtual void AVStreamSetId(AVStream* stream, int id) const = 0;
+  virtual void AVStreamSetDiscard(AVStream* stream, int discard) const = 0;
 
   // AVFormatContext
   virtual int AVFormatContextGetAvoidNegativeTs(const AVFormatContext* ctx) const = 0;
@@ -122,6 +124,8 @@ struct IAvcModuleDataWrapper {
   virtual int AVOutputFormatGetFlags(const AVOutputFormat* oformat) const = 0;
 
   // AVPacket
+  /// \brief sizeof(AVPacket) when it is part of ABI (libavcodec < 59), otherwise 0
+  virtual size_t AVPacketSizeof() const = 0;
   virtual int64_t AVPacketGetPts(const AVPacket* pkt) const = 0;
   virtual int64_t AVPacketGetDts(const AVPacket* pkt) const = 0;
   virtual void* AVPacketGetData(const AVPacket* pkt) const = 0;
@@ -229,6 +233,9 @@ struct IAvcModuleDataWrapper {
   virtual void AVCodecContextSetProfile(AVCodecContext* codec_context, int profile) const = 0;
   virtual void AVCodecContextSetFlags(AVCodecContext* codec_context, int flags) const = 0;
   virtual void AVCodecContextSetFlags2(AVCodecContext* codec_context, int flags2) const = 0;
+  virtual void AVCodecContextSetSkipFrame(AVCodecContext* codec_context, int /*enum AVDiscard*/ skip_frame) const = 0;
+  virtual void AVCodecContextSetSkipLoopFilter(AVCodecContext* codec_context, int /*enum AVDiscard*/ skip_loop_filter) const = 0;
+  virtual void AVCodecContextSetSkipIdct(AVCodecContext* codec_context, int /*enum AVDiscard*/ skip_idct) const = 0;
   virtual void AVCodecContextSetSwPixFmt(AVCodecContext* codec_context, int sw_pix_fmt) const = 0;
   virtual void AVCodecContextSetQCompress(AVCodecContext* codec_context, float qcompress) const = 0;
   virtual void AVCodecContextSetFrameSize(AVCodecContext* codec_context, int frame_size) const = 0;
@@ -267,6 +274,8 @@ struct IAvcModuleDataWrapper {
   virtual int AVFrameGetPktSize(const AVFrame* avframe) const = 0;
   virtual int64_t AVFrameGetPktPos(const AVFrame* avframe) const = 0;
   virtual int64_t AVFrameGetPktDuration(const AVFrame* avframe) const = 0;
+  /// \brief AVFrame.duration, or pkt_duration for versions before 5.1
+  virtual int64_t AVFrameGetDuration(const AVFrame* avframe) const = 0;
   virtual int64_t AVFrameGetPktDts(const AVFrame* avframe) const = 0;
   virtual int64_t AVFrameGetPktPts(const AVFrame* avframe) const = 0;
   virtual AVBufferRef* AVFrameGetBuf(const AVFrame* avframe, int idx) const = 0;
@@ -293,6 +302,7 @@ struct IAvcModuleDataWrapper {
   virtual void AVFrameSetPktSize(AVFrame* avframe, int pkt_size) const = 0;
   virtual void AVFrameSetPktPos(AVFrame* avframe, int64_t pkt_pos) const = 0;
   virtual void AVFrameSetPktDuration(AVFrame* avframe, int64_t pkt_duration) const = 0;
+  virtual void AVFrameSetDuration(AVFrame* avframe, int64_t duration) const = 0;
   virtual void AVFrameSetPktDts(AVFrame* avframe, int64_t pkt_dts) const = 0;
   virtual void AVFrameSetPktPts(AVFrame* avframe, int64_t pkt_pts) const = 0;
   virtual void AVFrameSetBuf(AVFrame* avframe, int idx, AVBufferRef* buf) const = 0;
@@ -319,6 +329,7 @@ struct IAvcModuleDataWrapper {
   virtual int AVCodecParametersGetFrameSize(const AVCodecParameters* codecpar) const = 0;
   virtual int AVCodecParametersGetBitsPerCodedSample(const AVCodecParameters* codecpar) const = 0;
   virtual int AVCodecParametersGetBitsPerRawSample(const AVCodecParameters* codecpar) const = 0;
+  virtual int AVCodecParametersGetBlockAlign(const AVCodecParameters* codecpar) const = 0;
   virtual uint64_t AVCodecParametersGetChannelLayout(const AVCodecParameters* codecpar) const = 0;
   virtual AVChannelLayout* AVCodecParametersGetChLayout(AVCodecParameters* codecpar) const = 0;
 
@@ -345,11 +356,23 @@ struct IAvcModuleDataWrapper {
   virtual uint8_t* AVBufferRefGetData(const AVBufferRef* bufferref) const = 0;
   virtual int AVBufferRefGetSize(const AVBufferRef* bufferref) const = 0;
 
+  // AVCodecParserContext
+  virtual int AVCodecParserContextGetKeyFrame(const AVCodecParserContext* parser_context) const = 0;
+  virtual int64_t AVCodecParserContextGetPts(const AVCodecParserContext* parser_context) const = 0;
+  virtual int64_t AVCodecParserContextGetDts(const AVCodecParserContext* parser_context) const = 0;
+
   // AVHWConfig
   virtual int AVHWConfigGetPixFmt(const AVCodecHWConfig* hwconfig) const = 0;
   virtual int AVHWConfigGetDeviceType(const AVCodecHWConfig* hwconfig) const = 0;
   virtual int AVHWConfigGetMethods(const AVCodecHWConfig* hwconfig) const = 0;
 
+  // AVIndexEntry
+  virtual int64_t AVIndexEntryGetPos(const AVIndexEntry* entry) const = 0;
+  virtual int64_t AVIndexEntryGetTimestamp(const AVIndexEntry* entry) const = 0;
+  virtual int AVIndexEntryGetFlags(const AVIndexEntry* entry) const = 0;
+  virtual int AVIndexEntryGetSize(const AVIndexEntry* entry) const = 0;
+  virtual int AVIndexEntryGetMinDistance(const AVIndexEntry* entry) const = 0;
+
   // AVCPBProperties
   virtual size_t AVCPBPropertiesSizeof() const = 0;
   virtual int AVCPBPropertiesGetBufferSize(const AVCPBProperties* props) const = 0;
@@ -31,6 +31,8 @@
 
 #include <avc/i_avc_module_data_wrapper.h>
 #include <avc/i_avc_video_pixel_format_converter.h>
+#include <avc/i_avc_memory_accounting.h>
+#include <avc/i_avc_thread_budget.h>
 #include <media/media_timebase.h>
 #include <media/video_pixel_format.h>
 
@@ -111,6 +113,7 @@ struct IAvcModuleProvider {
   virtual int av_new_packet(AVPacket *pkt, int size) = 0;
   virtual void av_packet_ref(AVPacket *dst, const AVPacket* src) = 0;
   virtual void av_packet_unref(AVPacket *pkt) = 0;
+  virtual void av_packet_move_ref(AVPacket *dst, AVPacket *src) = 0;
   virtual void av_packet_rescale_ts(AVPacket* pkt, cmf::MediaTimeBase tb_src, cmf::MediaTimeBase tb_dst) = 0;
 
   virtual AVCodecContext *avcodec_alloc_context3(const AVCodec *codec) = 0;
@@ -494,11 +497,36 @@ struct IAvcModuleProvider {
   virtual unsigned avdevice_version() = 0;
   virtual void avdevice_register_all() = 0;
 
+  // batched codec calls: one dispatch and one module check for many send/receive calls. Useful for small
+  // packets (audio, thumbnails) where per-call overhead is visible
+
+  /// \brief avcodec_send_packet for packets in order, avcodec_receive_frame into frames when decoder is full
+  /// and after last packet. Null packet flushes decoder. send_results[i] is result of packet i, AVERROR(EAGAIN)
+  /// there means packet was not sent because all frames are filled: consume frames and submit it again.
+  /// frames_received is count of filled frames from beginning of array. Returns result of last
+  /// avcodec_receive_frame: 0 when all frames are filled, AVERROR(EAGAIN) when decoder needs more packets,
+  /// AVERROR_EOF when decoder is drained, or error. send_results and frames_received may be null
+  virtual int DecodeBatch(AVCodecContext* avctx, const AVPacket* const* packets, int packets_count, int* send_results,
+                          AVFrame* const* frames, int frames_count, int* frames_received) = 0;
+
+  /// \brief Same as DecodeBatch for encoder: avcodec_send_frame for frames, avcodec_receive_packet into packets.
+  /// Null frame flushes encoder
+  virtual int EncodeBatch(AVCodecContext* avctx, const AVFrame* const* frames, int frames_count, int* send_results,
+                          AVPacket* const* packets, int packets_count, int* packets_received) = 0;
+
 
   // wrap data structures
   virtual std::shared_ptr<IAvcModuleDataWrapper> d() const = 0;
 
   virtual std::shared_ptr<IAvcVideoPixelFormatConverter> GetVideoPixelFormatConverter() = 0;
+
+  /// \brief Accounting of frames, packets and buffers allocated through this provider. Disabled by default
+  virtual std::shared_ptr<IAvcMemoryAccounting> GetMemoryAccounting() = 0;
+
+  /// \brief Process-wide budget of codec threads for contexts opened with automatic threading. All providers
+  /// return the same instance, so static and dynamic providers in one process share one budget.
+  /// Disabled by default
+  virtual std::shared_ptr<IAvcThreadBudget> GetThreadBudget() = 0;
 };
 
 }  // namespace avc
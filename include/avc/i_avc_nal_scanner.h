@@ -0,0 +1,70 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_NAL_SCANNER_HEADER
+#define I_AVC_NAL_SCANNER_HEADER
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace avc {
+
+struct AVPacket;
+
+struct AvcNalUnit {
+  uint32_t offset_;           ///< byte offset of NAL unit header in scanned data
+  uint32_t size_;             ///< NAL unit size without start code or length prefix
+  int32_t type_;              ///< nal_unit_type of H.264 or HEVC
+  int32_t reserved_;
+};
+
+struct AvcNalScanResult {
+  bool keyframe_ = false;             ///< IDR (H.264) or IRAP (HEVC) slice found
+  bool parameter_sets_ = false;       ///< SPS, PPS (and VPS for HEVC) found before first slice
+  int32_t keyframe_offset_ = -1;      ///< byte offset of first IDR/IRAP NAL unit header, -1 when not found
+  int32_t nal_units_count_ = 0;       ///< NAL units scanned
+};
+
+/// \brief Classifies H.264/HEVC NAL units of packet without parser or decoder. Annex B data is searched
+/// for start codes (SSE2 where available), length-prefixed data (avcC/hvcC extradata, mp4 and mkv) is walked
+/// by lengths. Scan stops at first slice unless all units are requested, slice type tells whether access
+/// unit is keyframe. Thread safe, scanner has no state besides stream format
+struct IAvcNalScanner {
+  virtual ~IAvcNalScanner() = default;
+
+  /// \brief Scan data of one access unit. units receives every NAL unit when not null.
+  /// Returns 0 or AVERROR_INVALIDDATA for broken length-prefixed data
+  virtual int Scan(const uint8_t* data, size_t size, AvcNalScanResult* result,
+                   std::vector<AvcNalUnit>* units = nullptr) const = 0;
+
+  /// \brief Scan packet data and set AV_PKT_FLAG_KEY when it holds keyframe.
+  /// Returns 1 for keyframe, 0 for other packets or AVERROR code
+  virtual int ScanPacket(AVPacket* packet, AvcNalScanResult* result = nullptr) const = 0;
+
+  /// \brief NAL units are prefixed by length of this size (1, 2 or 4), 0 for Annex B start codes
+  virtual int GetLengthSize() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_NAL_SCANNER_HEADER
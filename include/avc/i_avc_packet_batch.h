@@ -0,0 +1,50 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_PACKET_BATCH_HEADER
+#define I_AVC_PACKET_BATCH_HEADER
+
+#include <cstddef>
+
+namespace avc {
+
+struct AVPacket;
+
+/// \brief Fixed set of AVPacket objects allocated together.
+/// On FFmpeg versions where sizeof(AVPacket) is part of ABI packets are placed into one arena,
+/// otherwise each packet is allocated by av_packet_alloc
+struct IAvcPacketBatch {
+  virtual ~IAvcPacketBatch() = default;
+
+  virtual size_t GetCount() const = 0;
+  virtual AVPacket* GetPacket(size_t idx) const = 0;
+
+  /// \brief true when packets live in arena, false when av_packet_alloc fallback was used
+  virtual bool IsArenaBacked() const = 0;
+
+  /// \brief av_packet_unref for all packets, objects remain usable
+  virtual void UnrefAll() = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_PACKET_BATCH_HEADER
@@ -0,0 +1,93 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_PACKET_INTERLEAVER_HEADER
+#define I_AVC_PACKET_INTERLEAVER_HEADER
+
+#include <cstddef>
+#include <cstdint>
+
+namespace avc {
+
+struct AVPacket;
+
+/// \brief What interleaver does when queued bytes exceed byte cap
+enum AvcInterleaverOverflowPolicy {
+  kAvcInterleaverOverflow_Flush = 0,  ///< write oldest packets without waiting for other streams
+  kAvcInterleaverOverflow_Drop = 1    ///< discard oldest packets
+};
+
+struct AvcPacketInterleaverConfig {
+  int64_t max_delay_us_ = 1000000;    ///< how long other streams wait for silent stream, in DTS time. Negative waits forever
+  size_t max_bytes_ = 16 * 1024 * 1024; ///< cap of queued packets payload, 0 disables cap
+  AvcInterleaverOverflowPolicy overflow_policy_ = kAvcInterleaverOverflow_Flush;
+};
+
+struct AvcPacketInterleaverStatistics {
+  uint64_t packets_written_ = 0;
+  uint64_t bytes_written_ = 0;
+  uint64_t packets_dropped_ = 0;        ///< discarded by kAvcInterleaverOverflow_Drop policy
+  uint64_t packets_forced_ = 0;         ///< written before other streams were ready because of byte cap
+  uint64_t packets_delay_expired_ = 0;  ///< written without waiting silent stream because of its max delay
+  size_t packets_queued_ = 0;           ///< packets waiting now
+  size_t bytes_queued_ = 0;
+  size_t packets_queued_peak_ = 0;
+  size_t bytes_queued_peak_ = 0;
+  int64_t queue_span_us_ = 0;           ///< DTS distance between oldest queued packet and newest received one
+};
+
+struct AvcInterleaverStreamStatistics {
+  uint64_t packets_written_ = 0;
+  uint64_t packets_dropped_ = 0;
+  size_t packets_queued_ = 0;
+  size_t bytes_queued_ = 0;
+  int64_t last_dts_us_ = 0;             ///< DTS of last received packet, microseconds
+  bool ended_ = false;
+};
+
+/// \brief Orders packets of all streams by DTS in front of av_write_frame, as av_interleaved_write_frame does,
+/// but memory is bounded by caller: stalled stream is waited not longer than its max delay and queued bytes
+/// never exceed byte cap. Streams are taken from output format context after avformat_write_header.
+/// Methods are thread-safe, packets are written on calling thread
+struct IAvcPacketInterleaver {
+  virtual ~IAvcPacketInterleaver() = default;
+
+  /// \brief Take packet data (packet is left blank, like av_interleaved_write_frame does) and write all
+  /// packets which are ready. Timestamps must be in output stream time base. Returns muxer error or 0
+  virtual int Write(AVPacket* packet) = 0;
+
+  /// \brief Stream will not get packets anymore, other streams do not wait for it
+  virtual void EndStream(int stream_index) = 0;
+
+  /// \brief Override config max delay for stream. Negative waits forever
+  virtual void SetStreamMaxDelay(int stream_index, int64_t max_delay_us) = 0;
+
+  /// \brief Write all queued packets in DTS order. Must be called before av_write_trailer
+  virtual int Flush() = 0;
+
+  virtual AvcPacketInterleaverStatistics GetStatistics() const = 0;
+  virtual AvcInterleaverStreamStatistics GetStreamStatistics(int stream_index) const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_PACKET_INTERLEAVER_HEADER
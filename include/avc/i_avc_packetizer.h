@@ -0,0 +1,66 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_PACKETIZER_HEADER
+#define I_AVC_PACKETIZER_HEADER
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace avc {
+
+struct AVBufferRef;
+struct AVPacket;
+
+struct AvcPacketizerStatistics {
+  uint64_t packets_ = 0;
+  uint64_t packets_referenced_ = 0;   ///< slices of input buffer, not copied
+  uint64_t packets_copied_ = 0;       ///< combined by parser from several inputs or too close to end of input buffer
+  uint64_t bytes_copied_ = 0;
+};
+
+/// \brief Splits raw elementary stream (H.264, HEVC, AAC, ...) to packets by libavcodec parser.
+/// Packet which lies entirely inside caller input is emitted as reference-counted slice of input buffer,
+/// only packets combined by parser from several inputs are copied. Padding after slice is not zeroed,
+/// it holds following stream bytes. Not thread safe
+struct IAvcPacketizer {
+  virtual ~IAvcPacketizer() = default;
+
+  /// \brief Set next input. data must point inside buffer and be followed by AV_INPUT_BUFFER_PADDING_SIZE
+  /// readable bytes. Emitted packets reference buffer, so it stays alive while they exist. Null buffer makes
+  /// every packet copied. Null data flushes parser. Returns AVERROR(EAGAIN) while previous input is not consumed
+  virtual int SendData(AVBufferRef* buffer, const uint8_t* data, size_t size,
+                       int64_t pts, int64_t dts, int64_t pos) = 0;
+
+  /// \brief Map local file and use its whole content as input followed by flush
+  virtual int SendFile(const std::string& url) = 0;
+
+  /// \brief Next packet to clean packet. Returns AVERROR(EAGAIN) when input is consumed, AVERROR_EOF after flush
+  virtual int ReceivePacket(AVPacket* packet) = 0;
+
+  virtual AvcPacketizerStatistics GetStatistics() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_PACKETIZER_HEADER
@@ -0,0 +1,69 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_REMUXER_HEADER
+#define I_AVC_REMUXER_HEADER
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace avc {
+
+struct AvcRemuxerConfig {
+  std::string output_format_;       ///< muxer short name, empty guesses format by output url
+  std::vector<int> streams_;        ///< input streams to copy, empty copies all video, audio and subtitle streams
+  double start_seconds_ = 0.0;      ///< trim start from beginning of input, 0 copies from beginning
+  double end_seconds_ = 0.0;        ///< trim end from beginning of input, 0 copies until end of input
+  size_t batch_size_ = 32;          ///< packets read before timestamps are rescaled and packets are written
+  std::vector<std::pair<std::string, std::string>> muxer_options_;  ///< passed to avformat_write_header
+};
+
+struct AvcRemuxerStatistics {
+  uint64_t packets_read_ = 0;
+  uint64_t packets_written_ = 0;
+  uint64_t packets_dropped_ = 0;    ///< packets of not selected streams or outside of trim range
+  uint64_t bytes_written_ = 0;
+  uint64_t batches_ = 0;
+  double elapsed_ms_ = 0;
+  double packets_per_second_ = 0;
+  double megabytes_per_second_ = 0;
+};
+
+/// \brief Stream copy from input to output container without decoding. Packets are forwarded by reference:
+/// demuxer buffer is passed to muxer as is, only timestamps and stream indexes are changed.
+/// Trimming is done on packet boundaries: video starts from keyframe before start point, so output may
+/// begin slightly earlier than requested and its first timestamps may be negative
+struct IAvcRemuxer {
+  virtual ~IAvcRemuxer() = default;
+
+  /// \brief Copy selected streams from input_url to output_url. Returns 0 or AVERROR code
+  virtual int Remux(const std::string& input_url, const std::string& output_url) = 0;
+
+  virtual AvcRemuxerStatistics GetStatistics() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_REMUXER_HEADER
@@ -0,0 +1,78 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_SMART_TRIMMER_HEADER
+#define I_AVC_SMART_TRIMMER_HEADER
+
+#include <avc/i_avc_codec_autotuner.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace avc {
+
+struct AvcSmartTrimmerConfig {
+  std::string output_format_;                  ///< empty means format is guessed from output url
+  bool copy_audio_ = true;                     ///< copy audio streams, trimmed on packet boundaries
+  int64_t bit_rate_ = 0;                       ///< bit rate of re-encoded parts, 0 takes bit rate of input stream
+  int encoder_threads_ = 0;                    ///< 0 is auto
+  std::vector<std::pair<std::string, std::string>> encoder_options_;  ///< passed to avcodec_open2 of encoder
+  std::shared_ptr<IAvcCodecAutotuner> codec_autotuner_;  ///< tuned threading of decoder, and of encoder when encoder_threads_ is 0
+};
+
+struct AvcSmartTrimmerStatistics {
+  uint64_t gops_copied_ = 0;
+  uint64_t gops_reencoded_ = 0;
+  uint64_t packets_copied_ = 0;                ///< video packets written without decoding
+  uint64_t frames_reencoded_ = 0;
+  uint64_t packets_written_ = 0;               ///< all streams
+  double reencode_ms_ = 0;
+  double elapsed_ms_ = 0;
+};
+
+/// \brief Cuts best video stream of input at any frame without full re-encode. GOPs which are completely
+/// inside of cut range are copied as is, only GOPs on both edges are decoded and encoded again.
+/// Encoder is found by codec id of input and configured from its AVCodecParameters (size, pixel format,
+/// profile, bit rate). Re-encoded parts have no B-frames, their DTS are aligned to neighbouring copied
+/// packets, so DTS stay continuous over splice points.
+/// Re-encoded H.264 and HEVC packets get NAL layout of input packets (length prefixes of avcC / hvcC or Annex B).
+/// Re-encoded parts carry own parameter sets in-band, output container must allow it (MPEG-TS, Matroska).
+/// Encoder reuses parameter set ids of input, so parameter sets of input extradata are put in-band again
+/// before first copied keyframe which follows re-encoded part
+/// Leading pictures of open GOPs at splice points are dropped
+struct IAvcSmartTrimmer {
+  virtual ~IAvcSmartTrimmer() = default;
+
+  /// \brief Write part of input_url from start_seconds to end_seconds to output_url. end_seconds 0 cuts
+  /// until end of input. Output timestamps start from 0. Returns 0 or AVERROR code
+  virtual int Trim(const std::string& input_url, const std::string& output_url,
+                   double start_seconds, double end_seconds) = 0;
+
+  virtual AvcSmartTrimmerStatistics GetStatistics() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_SMART_TRIMMER_HEADER
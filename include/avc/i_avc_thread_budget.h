@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_THREAD_BUDGET_HEADER
+#define I_AVC_THREAD_BUDGET_HEADER
+
+#include <cstdint>
+
+namespace avc {
+
+struct AvcThreadBudgetConfig {
+  int cores_budget_ = 0;        ///< codec threads of all sessions together, 0 is hardware threads count
+  int min_threads_ = 1;         ///< every session gets at least this, also when budget is spent
+  int max_threads_ = 0;         ///< upper limit of one session, 0 is cores budget
+  int expected_sessions_ = 0;   ///< shares are computed for at least this many sessions, so first sessions
+                                ///< of burst do not take whole budget
+};
+
+struct AvcThreadBudgetStatistics {
+  int cores_budget_ = 0;
+  int sessions_ = 0;                    ///< live sessions
+  int threads_ = 0;                     ///< threads assigned to live sessions
+  int peak_threads_ = 0;
+  int oversubscribed_threads_ = 0;      ///< threads over budget now
+  uint64_t sessions_started_ = 0;
+  uint64_t oversubscribed_starts_ = 0;  ///< sessions which got min_threads_ because budget was spent
+};
+
+/// \brief Process-wide budget of codec threads, one instance is shared by all providers (with FFMPEG_LOADER_DLL
+/// one per loaded library). Disabled by default. When enabled, provider avcodec_open2
+/// starts session for every codec context with automatic threading (thread_count 0, no "threads" option)
+/// and sets its thread_count to share of budget, avcodec_free_context stops session.
+/// Threads of opened context cannot change, so shares are rebalanced on every session start and stop
+/// and apply to contexts opened next. Threads over budget are reported as oversubscription. Thread safe
+struct IAvcThreadBudget {
+  virtual ~IAvcThreadBudget() = default;
+
+  virtual void SetEnabled(bool enabled) = 0;
+  virtual bool IsEnabled() const = 0;
+
+  virtual void SetConfig(const AvcThreadBudgetConfig& config) = 0;
+  virtual AvcThreadBudgetConfig GetConfig() const = 0;
+
+  /// \brief Register session of key (e.g. codec context) and return its threads count.
+  /// Starting session of registered key returns its threads
+  virtual int StartSession(const void* key) = 0;
+  virtual void StopSession(const void* key) = 0;
+
+  /// \brief Register session of key which already has threads, e.g. opened context reused from pool.
+  /// Threads over budget are counted as oversubscribed start. Returns threads of session
+  virtual int AttachSession(const void* key, int threads) = 0;
+
+  /// \brief Threads which session started now would get
+  virtual int GetShare() const = 0;
+  virtual bool IsOversubscribed() const = 0;
+
+  virtual AvcThreadBudgetStatistics GetStatistics() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_THREAD_BUDGET_HEADER
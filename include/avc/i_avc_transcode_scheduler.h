@@ -0,0 +1,100 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef I_AVC_TRANSCODE_SCHEDULER_HEADER
+#define I_AVC_TRANSCODE_SCHEDULER_HEADER
+
+#include <avc/i_avc_codec_autotuner.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace avc {
+
+struct AvcTranscodeJobConfig {
+  std::string input_url_;
+  std::string output_url_;
+  std::string output_format_;                  ///< empty means format is guessed from output url
+  std::string video_encoder_name_ = "libx264";
+  int width_ = 0;                              ///< output size, 0 keeps source size
+  int height_ = 0;
+  int64_t bit_rate_ = 0;                       ///< 0 keeps encoder default
+  int gop_size_ = 0;                           ///< 0 keeps encoder default
+  int codec_threads_ = 1;                      ///< internal threads of job decoder and encoder, 0 is auto
+  bool copy_audio_ = true;                     ///< remux audio streams without transcoding
+  std::shared_ptr<IAvcCodecAutotuner> codec_autotuner_;  ///< tuned threading of decoder and encoder when codec_threads_ is 0
+};
+
+enum AvcTranscodeJobState {
+  kAvcTranscodeJob_Queued = 0,
+  kAvcTranscodeJob_Running = 1,
+  kAvcTranscodeJob_Done = 2,
+  kAvcTranscodeJob_Failed = 3
+};
+
+struct AvcTranscodeJobStatus {
+  AvcTranscodeJobState state_ = kAvcTranscodeJob_Queued;
+  int error_ = 0;                 ///< AVERROR code when failed, AVERROR_EXIT when canceled
+  uint64_t frames_decoded_ = 0;
+  uint64_t frames_encoded_ = 0;
+  uint64_t packets_written_ = 0;
+};
+
+struct AvcTranscodeSchedulerStatistics {
+  int workers_count_ = 0;
+  uint64_t tasks_executed_ = 0;
+  uint64_t tasks_stolen_ = 0;     ///< tasks taken by idle worker from queue of other worker
+  uint64_t jobs_submitted_ = 0;
+  uint64_t jobs_done_ = 0;
+  uint64_t jobs_failed_ = 0;
+};
+
+/// \brief Runs many transcode jobs (open input, decode, scale, encode, mux) on fixed pool of worker threads.
+/// Every job is split into stage tasks. Stages of one job run one batch at a time each, but different stages
+/// and different jobs run in parallel. Idle workers steal tasks from busy ones, so cores stay busy when
+/// job sizes vary. Only first video stream is transcoded, codecs run single-threaded unless codec_threads_ is changed
+struct IAvcTranscodeScheduler {
+  virtual ~IAvcTranscodeScheduler() = default;
+
+  /// \brief Queue job. Returns job id
+  virtual int64_t SubmitJob(const AvcTranscodeJobConfig& config) = 0;
+
+  /// \brief Wait until job is finished and forget it. Returns 0 or job error code
+  virtual int WaitJob(int64_t job_id) = 0;
+
+  /// \brief Wait until all submitted jobs are finished
+  virtual void WaitAll() = 0;
+
+  /// \brief Stop job as soon as possible, it fails with AVERROR_EXIT
+  virtual void CancelJob(int64_t job_id) = 0;
+
+  /// \brief Status is available until WaitJob returns. Returns false for unknown job
+  virtual bool GetJobStatus(int64_t job_id, AvcTranscodeJobStatus& status) const = 0;
+
+  virtual AvcTranscodeSchedulerStatistics GetStatistics() const = 0;
+};
+
+}//namespace avc
+
+#endif //I_AVC_TRANSCODE_SCHEDULER_HEADER
@@ -38,6 +38,10 @@
 #define AVERROR_EOF                FFERRTAG( 'E','O','F',' ') ///< End of file
 #define AVERROR_EXIT               FFERRTAG( 'E','X','I','T') ///< Exit requested
 #define AVERROR_INVALIDDATA        FFERRTAG('I','N','D','A') // Invalid data on input
+#define AVERROR_DECODER_NOT_FOUND  FFERRTAG(0xF8,'D','E','C') ///< Decoder not found
+#define AVERROR_DEMUXER_NOT_FOUND  FFERRTAG(0xF8,'D','E','M') ///< Demuxer not found
+#define AVERROR_ENCODER_NOT_FOUND  FFERRTAG(0xF8,'E','N','C') ///< Encoder not found
+#define AVERROR_STREAM_NOT_FOUND   FFERRTAG(0xF8,'S','T','R') ///< Stream not found
 #define AVERROR(e) (-(e))   ///< Returns a negative error code from a POSIX error code, to return from library functions.
 
 #define 	AVSEEK_SIZE   0x10000
@@ -46,10 +50,16 @@
 #define AVSEEK_FLAG_BACKWARD 1 ///< seek backward
 #define AVSEEK_FLAG_ANY      4 ///< seek to any frame, even non-keyframes
 
+#define AVINDEX_KEYFRAME        0x0001
+#define AVINDEX_DISCARD_FRAME   0x0002
+
 #define FF_PROFILE_H264_MAIN                 77
 #define FF_THREAD_FRAME   1 ///< Decode more than one frame at once
 #define FF_THREAD_SLICE   2 ///< Decode more than one part of a single frame at once
 
+#define AV_CHANNEL_ORDER_NATIVE   1 ///< AVChannelLayout.u.mask is bitmask of channels
+#define AV_CHANNEL_ORDER_CUSTOM   2 ///< AVChannelLayout.u.map is array of channels
+
 
 #define AVFMT_FLAG_NOBUFFER     0x0040 ///< Do not buffer frames when possible
 #define AVFMT_FLAG_CUSTOM_IO    0x0080 ///< The caller has supplied a custom AVIOContext, don't avio_close() it.
@@ -76,11 +86,17 @@
 #define AVFMT_AVOID_NEG_TS_MAKE_ZERO         2 ///< Shift timestamps so that they start at 0
 
 #define AV_PKT_FLAG_KEY     0x0001 ///< The packet contains a keyframe
+#define AV_FRAME_FLAG_KEY   (1 << 1) ///< Frame is keyframe, replaces AVFrame.key_frame since 6.1
+#define AV_CODEC_CAP_FRAME_THREADS (1 << 12)
+#define AV_CODEC_CAP_SLICE_THREADS (1 << 13)
+#define AV_CODEC_CAP_OTHER_THREADS (1 << 15)
 #define AV_CODEC_CAP_VARIABLE_FRAME_SIZE (1 << 16)
 
 #define AV_TIME_BASE            1000000
 
 #define AV_INPUT_BUFFER_PADDING_SIZE 64
+#define AV_BUFFER_FLAG_READONLY (1 << 0) ///< Buffer is never writable
+#define AV_NUM_DATA_POINTERS 8
 
 /* values for the flags, the stuff on the command line is different */
 #define SWS_FAST_BILINEAR     1
@@ -562,6 +578,16 @@ enum AVMediaType {
     AVMEDIA_TYPE_NB
 };
 
+enum AVDiscard {
+    AVDISCARD_NONE    = -16, ///< discard nothing
+    AVDISCARD_DEFAULT =   0, ///< discard useless packets like 0 size packets in avi
+    AVDISCARD_NONREF  =   8, ///< discard all non reference
+    AVDISCARD_BIDIR   =  16, ///< discard all bidirectional frames
+    AVDISCARD_NONINTRA=  24, ///< discard all non intra frames
+    AVDISCARD_NONKEY  =  32, ///< discard all frames except keyframes
+    AVDISCARD_ALL     =  48  ///< discard all
+};
+
 enum {
   AV_PIX_FMT_YUVJ420P = 12,  ///< planar YUV 4:2:0, 12bpp, full scale (JPEG), deprecated in favor of AV_PIX_FMT_YUV420P and setting color_range
   AV_PIX_FMT_YUVJ422P = 13,  ///< planar YUV 4:2:2, 16bpp, full scale (JPEG), deprecated in favor of AV_PIX_FMT_YUV422P and setting color_range
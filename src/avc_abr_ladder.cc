@@ -0,0 +1,492 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_abr_ladder.h"
+#include "avc_media_utils.h"
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+
+std::shared_ptr<IAvcAbrLadder> API_EXPORT CreateAvcAbrLadder(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcAbrLadderConfig& config) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  if (!avc_module_provider->IsAvFormatLoaded() || !avc_module_provider->IsAvCodecLoaded())
+    return nullptr;
+
+  return std::make_shared<avc::detail::AvcAbrLadder>(avc_module_provider, config);
+}
+
+namespace detail {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const int kDefaultGopSeconds = 2;
+
+double ElapsedMs(Clock::time_point from) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - from).count();
+}
+
+// 0 in one dimension keeps source aspect ratio, size is even for 4:2:0 encoders
+void GetRenditionSize(int src_width, int src_height, int width, int height, int& dst_width, int& dst_height) {
+  dst_width = width;
+  dst_height = height;
+  if (width <= 0 && height <= 0) {
+    dst_width = src_width;
+    dst_height = src_height;
+  } else if (width <= 0 && src_height > 0) {
+    dst_width = static_cast<int>((static_cast<int64_t>(src_width) * height / src_height + 1) & ~1);
+  } else if (height <= 0 && src_width > 0) {
+    dst_height = static_cast<int>((static_cast<int64_t>(src_height) * width / src_width + 1) & ~1);
+  }
+}
+
+}  // namespace
+
+AvcAbrLadder::Rendition::Rendition(size_t frame_queue_depth)
+  : frames_(frame_queue_depth + 1)
+  , free_frames_(frame_queue_depth) {
+}
+
+AvcAbrLadder::AvcAbrLadder(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcAbrLadderConfig& config)
+  : avc_module_provider_(avc_module_provider)
+  , config_(config)
+  , input_(avc_module_provider) {
+  if (config_.frame_queue_depth_ < 1)
+    config_.frame_queue_depth_ = 1;
+}
+
+int AvcAbrLadder::Run(const std::string& input_url) {
+  auto start = Clock::now();
+  auto d = avc_module_provider_->d();
+  stat_ = AvcAbrLadderStatistics();
+  stop_.store(false, std::memory_order_release);
+  error_.store(0, std::memory_order_release);
+  if (config_.renditions_.empty())
+    return AVERROR(EINVAL);
+
+  int ret = input_.Open(input_url);
+  if (ret < 0)
+    return ret;
+
+  stream_index_ = input_.FindBestStream(AVMEDIA_TYPE_VIDEO);
+  if (stream_index_ < 0)
+    ret = AVERROR_STREAM_NOT_FOUND;
+
+  AVCodecContext* decoder_context = nullptr;
+  if (ret >= 0) {
+    for (int i = 0; i < input_.GetStreamsCount(); i++)
+      if (i != stream_index_)
+        d->AVStreamSetDiscard(input_.GetStream(i), AVDISCARD_ALL);
+
+    decoder_context = input_.OpenDecoder(stream_index_, config_.decoder_threads_, nullptr, 0, nullptr,
+                                         config_.codec_autotuner_.get());
+    if (!decoder_context)
+      ret = AVERROR_DECODER_NOT_FOUND;
+  }
+
+  if (ret >= 0) {
+    stream_time_base_ = input_.GetStreamTimeBase(stream_index_);
+    frame_rate_ = GetStreamFrameRate(d.get(), input_.GetStream(stream_index_));
+  }
+
+  for (size_t i = 0; ret >= 0 && i < config_.renditions_.size(); i++) {
+    renditions_.emplace_back(new Rendition(config_.frame_queue_depth_));
+    renditions_.back()->config_ = config_.renditions_[i];
+    ret = OpenRendition(*renditions_.back(), decoder_context);
+  }
+
+  AVPacket* packet = avc_module_provider_->av_packet_alloc();
+  AVFrame* frame = avc_module_provider_->av_frame_alloc();
+  if (ret >= 0 && (!packet || !frame))
+    ret = AVERROR(ENOMEM);
+
+  // every output has written nothing yet, so any failure here stops whole ladder
+  for (size_t i = 0; ret >= 0 && i < renditions_.size(); i++)
+    ret = renditions_[i]->pipeline_->Start();
+
+  if (ret >= 0) {
+    for (auto& rendition : renditions_)
+      rendition->thread_ = std::thread(&AvcAbrLadder::RenditionThread, this, rendition.get());
+  }
+
+  while (ret >= 0 && !IsStopped()) {
+    ret = avc_module_provider_->av_read_frame(input_.GetFormatContext(), packet);
+    if (ret == AVERROR_EOF) {
+      ret = 0;
+      break;
+    }
+
+    if (ret < 0)
+      break;
+
+    if (d->AVPacketGetStreamIndex(packet) != stream_index_) {
+      avc_module_provider_->av_packet_unref(packet);
+      continue;
+    }
+
+    stat_.packets_read_++;
+    while ((ret = avc_module_provider_->avcodec_send_packet(decoder_context, packet)) == AVERROR(EAGAIN)) {
+      ret = DrainDecoder(decoder_context, frame);
+      if (ret < 0)
+        break;
+    }
+    avc_module_provider_->av_packet_unref(packet);
+
+    // damaged packet loses some frames only, like in ffmpeg tool
+    if (ret == AVERROR_INVALIDDATA)
+      ret = 0;
+    if (ret >= 0)
+      ret = DrainDecoder(decoder_context, frame);
+  }
+
+  if (ret >= 0 && !IsStopped()) {
+    ret = avc_module_provider_->avcodec_send_packet(decoder_context, nullptr);
+    if (ret >= 0)
+      ret = DrainDecoder(decoder_context, frame);
+  }
+
+  if (ret < 0) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcAbrLadder: decode %s failed %d\n", input_url.c_str(), ret);
+#endif //DEBUG_PRINT
+    SetError(ret);
+  }
+
+  // Finish flushes encoder and writes trailer of every output
+  EndRenditions();
+  for (auto& rendition : renditions_) {
+    bool started = rendition->thread_.joinable();
+    if (started)
+      rendition->thread_.join();
+
+    AvcAbrRenditionStatistics rendition_stat = rendition->stat_;
+    if (started) {
+      int res = rendition->pipeline_->Finish();
+      if (res < 0)
+        SetError(res);
+
+      AvcEncodePipelineStatistics pipeline_stat = rendition->pipeline_->GetStatistics();
+      rendition_stat.packets_written_ = pipeline_stat.packets_written_;
+      rendition_stat.bytes_written_ = pipeline_stat.bytes_written_;
+    }
+    stat_.renditions_.push_back(rendition_stat);
+  }
+
+  avc_module_provider_->av_frame_free(&frame);
+  avc_module_provider_->av_packet_free(&packet);
+  avc_module_provider_->avcodec_free_context(&decoder_context);
+  ReleaseRenditions();
+  input_.Close();
+
+  stat_.elapsed_ms_ = ElapsedMs(start);
+  return error_.load(std::memory_order_acquire);
+}
+
+int AvcAbrLadder::OpenRendition(Rendition& rendition, AVCodecContext* decoder_context) {
+  auto d = avc_module_provider_->d();
+  rendition.pipeline_ = CreateAvcEncodePipeline(avc_module_provider_, rendition.config_.url_, rendition.config_.output_format_);
+  if (!rendition.pipeline_)
+    return AVERROR(EINVAL);
+
+  AVCodec* codec = avc_module_provider_->avcodec_find_encoder_by_name(rendition.config_.encoder_name_.c_str());
+  if (!codec)
+    return AVERROR_ENCODER_NOT_FOUND;
+
+  AVCodecContext* encoder_context = avc_module_provider_->avcodec_alloc_context3(codec);
+  if (!encoder_context)
+    return AVERROR(ENOMEM);
+
+  int width = 0, height = 0;
+  GetRenditionSize(d->AVCodecContextGetWidth(decoder_context), d->AVCodecContextGetHeight(decoder_context),
+    rendition.config_.width_, rendition.config_.height_, width, height);
+
+  // keep decoder pixel format when encoder supports it, otherwise first supported format
+  int pix_fmt = SelectEncoderPixelFormat(d.get(), codec, d->AVCodecContextGetPixFmt(decoder_context));
+
+  // equal GOP in all renditions, so segments of every rendition start at same frame
+  int gop_size = config_.gop_size_;
+  if (gop_size <= 0)
+    gop_size = std::max(1, kDefaultGopSeconds * frame_rate_.num_ / frame_rate_.den_);
+
+  d->AVCodecContextSetWidth(encoder_context, width);
+  d->AVCodecContextSetHeight(encoder_context, height);
+  d->AVCodecContextSetPixFmt(encoder_context, pix_fmt);
+  d->AVCodecContextSetTimeBase(encoder_context, cmf::MediaTimeBase(frame_rate_.den_, frame_rate_.num_));
+  d->AVCodecContextSetFrameRate(encoder_context, frame_rate_);
+  d->AVCodecContextSetGopSize(encoder_context, gop_size);
+  d->AVCodecContextSetKeyintMin(encoder_context, gop_size);
+  if (config_.encoder_threads_ > 0)
+    d->AVCodecContextSetThreadCount(encoder_context, config_.encoder_threads_);
+  else if (config_.codec_autotuner_)
+    config_.codec_autotuner_->Apply(encoder_context, true);
+  if (rendition.config_.bit_rate_ > 0)
+    d->AVCodecContextSetBitRate(encoder_context, rendition.config_.bit_rate_);
+
+  int flags = d->AVCodecContextGetFlags(encoder_context) | static_cast<int>(AV_CODEC_FLAG_CLOSED_GOP);
+  if (rendition.pipeline_->IsGlobalHeaderRequired())
+    flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+  d->AVCodecContextSetFlags(encoder_context, flags);
+
+  AVDictionary* options = nullptr;
+  for (auto& option : config_.encoder_options_)
+    avc_module_provider_->av_dict_set(&options, option.first.c_str(), option.second.c_str(), 0);
+
+  int ret = avc_module_provider_->avcodec_open2(encoder_context, codec, &options);
+  avc_module_provider_->av_dict_free(&options);
+
+  // pipeline takes encoder context on success
+  if (ret >= 0)
+    ret = rendition.pipeline_->AddStream(encoder_context);
+  if (ret < 0) {
+    avc_module_provider_->avcodec_free_context(&encoder_context);
+    return ret;
+  }
+
+  rendition.stream_index_ = ret;
+  rendition.width_ = width;
+  rendition.height_ = height;
+  rendition.pix_fmt_ = pix_fmt;
+  rendition.time_base_ = d->AVCodecContextGetTimeBase(encoder_context);
+
+  for (size_t i = 0; i < config_.frame_queue_depth_; i++) {
+    AVFrame* frame = avc_module_provider_->av_frame_alloc();
+    if (!frame)
+      return AVERROR(ENOMEM);
+
+    rendition.all_frames_.push_back(frame);
+    rendition.free_frames_.TryPush(frame);
+  }
+
+  rendition.scaled_ = avc_module_provider_->av_frame_alloc();
+  return rendition.scaled_ ? 0 : AVERROR(ENOMEM);
+}
+
+int AvcAbrLadder::DrainDecoder(AVCodecContext* decoder_context, AVFrame* frame) {
+  while (true) {
+    int ret = avc_module_provider_->avcodec_receive_frame(decoder_context, frame);
+    if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF)
+      return 0;
+    if (ret < 0)
+      return ret;
+
+    ret = FanOut(frame);
+    avc_module_provider_->av_frame_unref(frame);
+    if (ret < 0)
+      return ret;
+  }
+}
+
+int AvcAbrLadder::FanOut(AVFrame* frame) {
+  stat_.frames_decoded_++;
+  for (auto& rendition : renditions_) {
+    AVFrame* queued_frame = nullptr;
+    while (!rendition->free_frames_.TryPop(queued_frame)) {
+      if (IsStopped())
+        return AVERROR_EXIT;
+
+      stat_.decoder_waits_++;
+      Rendition* current = rendition.get();
+      decoder_waiter_.Wait([this, current] { return IsStopped() || !current->free_frames_.IsEmpty(); });
+    }
+
+    // renditions share decoded picture buffers, nothing is copied. Frame stays in all_frames_ on error
+    int ret = avc_module_provider_->av_frame_ref(queued_frame, frame);
+    if (ret < 0)
+      return ret;
+
+    rendition->frames_.TryPush(queued_frame);  // never full, queue has room for all frames and end marker
+    rendition->waiter_.Notify();
+  }
+  return 0;
+}
+
+void AvcAbrLadder::EndRenditions() {
+  for (auto& rendition : renditions_) {
+    if (rendition->ended_)
+      continue;
+
+    rendition->ended_ = true;
+    rendition->frames_.TryPush(nullptr);
+    rendition->waiter_.Notify();
+  }
+}
+
+void AvcAbrLadder::RenditionThread(Rendition* rendition) {
+  int ret = 0;
+  while (true) {
+    AVFrame* frame = nullptr;
+    if (!rendition->frames_.TryPop(frame)) {
+      if (IsStopped())
+        break;
+
+      rendition->waiter_.Wait([this, rendition] { return IsStopped() || !rendition->frames_.IsEmpty(); });
+      continue;
+    }
+
+    if (!frame)
+      break;
+
+    if (!IsStopped())
+      ret = ScaleAndSubmit(rendition, frame);
+
+    avc_module_provider_->av_frame_unref(frame);
+    rendition->free_frames_.TryPush(frame);
+    decoder_waiter_.Notify();
+
+    if (ret < 0) {
+#if DEBUG_PRINT
+      fprintf(stderr, "AvcAbrLadder: rendition %s failed %d\n", rendition->config_.url_.c_str(), ret);
+#endif //DEBUG_PRINT
+      SetError(ret);
+      break;
+    }
+  }
+
+  // null frame flushes encoder, trailer is written by Finish
+  if (ret >= 0 && !IsStopped())
+    rendition->pipeline_->SubmitFrame(rendition->stream_index_, nullptr);
+}
+
+int AvcAbrLadder::ScaleAndSubmit(Rendition* rendition, AVFrame* frame) {
+  auto d = avc_module_provider_->d();
+  AVFrame* source = frame;
+  int width = d->AVFrameGetWidth(frame);
+  int height = d->AVFrameGetHeight(frame);
+  int format = d->AVFrameGetFormat(frame);
+  if (width != rendition->width_ || height != rendition->height_ || format != rendition->pix_fmt_) {
+    if (!avc_module_provider_->IsSwScaleLoaded())
+      return AVERROR(ENOSYS);
+
+    auto start = Clock::now();
+    if (!rendition->sws_context_ || rendition->sws_width_ != width || rendition->sws_height_ != height ||
+        rendition->sws_format_ != format) {
+      if (rendition->sws_context_)
+        avc_module_provider_->sws_freeContext(rendition->sws_context_);
+      rendition->sws_context_ = avc_module_provider_->sws_getContext(width, height, format,
+        rendition->width_, rendition->height_, rendition->pix_fmt_, SWS_BICUBIC, nullptr, nullptr, nullptr);
+      if (!rendition->sws_context_)
+        return AVERROR(EINVAL);
+      rendition->sws_width_ = width;
+      rendition->sws_height_ = height;
+      rendition->sws_format_ = format;
+    }
+
+    // encoder may still hold previous buffer, so every scaled frame gets new one from buffer pool
+    AVFrame* scaled = rendition->scaled_;
+    d->AVFrameSetWidth(scaled, rendition->width_);
+    d->AVFrameSetHeight(scaled, rendition->height_);
+    d->AVFrameSetFormat(scaled, rendition->pix_fmt_);
+    int ret = avc_module_provider_->av_frame_get_buffer(scaled, 0);
+    if (ret < 0)
+      return ret;
+
+    ret = avc_module_provider_->sws_scale(rendition->sws_context_, d->AVFrameGetDataPtr(frame), d->AVFrameGetLineSizePtr(frame),
+      0, height, d->AVFrameGetDataPtr(scaled), d->AVFrameGetLineSizePtr(scaled));
+    if (ret < 0) {
+      avc_module_provider_->av_frame_unref(scaled);
+      return ret;
+    }
+
+    source = scaled;
+    rendition->stat_.frames_scaled_++;
+    rendition->stat_.scale_ms_ += ElapsedMs(start);
+  }
+
+  int64_t pts = d->AVFrameGetPts(frame);
+  if (pts != AV_NOPTS_VALUE)
+    pts = avc_module_provider_->av_rescale_q_rnd(pts, ToAVRational(stream_time_base_), ToAVRational(rendition->time_base_),
+      AV_ROUND_NEAR_INF | AV_ROUND_PASS_MINMAX);
+  if (pts == AV_NOPTS_VALUE || pts < rendition->next_pts_)
+    pts = rendition->next_pts_;
+  rendition->next_pts_ = pts + 1;
+
+  d->AVFrameSetPts(source, pts);
+  d->AVFrameSetPictType(source, AV_PICTURE_TYPE_NONE);
+
+  int ret = 0;
+  while ((ret = rendition->pipeline_->SubmitFrame(rendition->stream_index_, source)) == AVERROR(EAGAIN)) {
+    ret = rendition->pipeline_->WaitForSubmit(rendition->stream_index_);
+    if (ret < 0)
+      break;
+  }
+
+  // pipeline holds own reference
+  if (source != frame)
+    avc_module_provider_->av_frame_unref(source);
+
+  if (ret >= 0)
+    rendition->stat_.frames_submitted_++;
+  return ret;
+}
+
+void AvcAbrLadder::ReleaseRenditions() {
+  for (auto& rendition : renditions_) {
+    for (AVFrame* frame : rendition->all_frames_)
+      avc_module_provider_->av_frame_free(&frame);
+    avc_module_provider_->av_frame_free(&rendition->scaled_);
+    if (rendition->sws_context_)
+      avc_module_provider_->sws_freeContext(rendition->sws_context_);
+    rendition->pipeline_.reset();
+  }
+  renditions_.clear();
+}
+
+void AvcAbrLadder::SetError(int error) {
+  int expected = 0;
+  error_.compare_exchange_strong(expected, error, std::memory_order_acq_rel);
+
+  // any failed rendition stops whole ladder
+  stop_.store(true, std::memory_order_release);
+  decoder_waiter_.Notify();
+  for (auto& rendition : renditions_)
+    rendition->waiter_.Notify();
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_ABR_LADDER_HEADER
+#define AVC_ABR_LADDER_HEADER
+
+#include <avc/i_avc_abr_ladder.h>
+#include <avc/i_avc_encode_pipeline.h>
+#include <avc/i_avc_module_provider.h>
+#include "avc_media_input.h"
+#include "avc_spsc_queue.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcAbrLadder
+  : public virtual IAvcAbrLadder {
+ public:
+  AvcAbrLadder(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcAbrLadderConfig& config);
+  virtual ~AvcAbrLadder() = default;
+
+  int Run(const std::string& input_url) override;
+  AvcAbrLadderStatistics GetStatistics() const override { return stat_; }
+
+ private:
+  // null frame in queue marks end of input
+  struct Rendition {
+    explicit Rendition(size_t frame_queue_depth);
+
+    AvcAbrRendition config_;
+    std::shared_ptr<IAvcEncodePipeline> pipeline_;
+    int stream_index_ = -1;
+    int width_ = 0;
+    int height_ = 0;
+    int pix_fmt_ = -1;
+    cmf::MediaTimeBase time_base_;
+
+    AvcSpscQueue<AVFrame*> frames_;          // decoder -> scaler
+    AvcSpscQueue<AVFrame*> free_frames_;     // scaler -> decoder
+    std::vector<AVFrame*> all_frames_;
+    AvcThreadWaiter waiter_;
+    std::thread thread_;
+    bool ended_ = false;                     // decoder side
+
+    SwsContext* sws_context_ = nullptr;      // scaler side
+    int sws_width_ = 0;
+    int sws_height_ = 0;
+    int sws_format_ = -1;
+    AVFrame* scaled_ = nullptr;
+    int64_t next_pts_ = 0;
+
+    AvcAbrRenditionStatistics stat_;         // scaler side until thread is joined
+  };
+
+  int OpenRendition(Rendition& rendition, AVCodecContext* decoder_context);
+  void RenditionThread(Rendition* rendition);
+  int ScaleAndSubmit(Rendition* rendition, AVFrame* frame);
+  int FanOut(AVFrame* frame);
+  int DrainDecoder(AVCodecContext* decoder_context, AVFrame* frame);
+  void EndRenditions();
+  void ReleaseRenditions();
+  void SetError(int error);
+  bool IsStopped() const { return stop_.load(std::memory_order_acquire); }
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AvcAbrLadderConfig config_;
+
+  AvcMediaInput input_;
+  int stream_index_ = -1;
+  cmf::MediaTimeBase stream_time_base_;
+  cmf::MediaTimeBase frame_rate_;
+  std::vector<std::unique_ptr<Rendition>> renditions_;
+
+  AvcThreadWaiter decoder_waiter_;
+  std::atomic<bool> stop_{false};
+  std::atomic<int> error_{0};
+  AvcAbrLadderStatistics stat_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_ABR_LADDER_HEADER
@@ -0,0 +1,793 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_chunked_encoder.h"
+#include "avc_media_utils.h"
+#include <avc/libav_detached_common.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace avc {
+
+std::shared_ptr<IAvcChunkedEncoder> API_EXPORT CreateAvcChunkedEncoder(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcChunkedEncoderConfig& config) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  if (!avc_module_provider->IsAvFormatLoaded() || !avc_module_provider->IsAvCodecLoaded())
+    return nullptr;
+
+  return std::make_shared<avc::detail::AvcChunkedEncoder>(avc_module_provider, config);
+}
+
+namespace detail {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double ElapsedMs(Clock::time_point from) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - from).count();
+}
+
+}  // namespace
+
+AvcChunkedEncoder::AvcChunkedEncoder(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcChunkedEncoderConfig& config)
+  : avc_module_provider_(avc_module_provider)
+  , config_(config) {
+  if (config_.threads_count_ <= 0)
+    config_.threads_count_ = static_cast<int>(std::thread::hardware_concurrency());
+  if (config_.threads_count_ <= 0)
+    config_.threads_count_ = 1;
+  if (config_.chunks_count_ <= 0)
+    config_.chunks_count_ = config_.threads_count_ * 2;
+}
+
+std::vector<AvcEncodeChunk> AvcChunkedEncoder::GetChunks() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<AvcEncodeChunk> chunks;
+  for (const ChunkState& state : chunks_)
+    chunks.push_back(state.chunk_);
+  return chunks;
+}
+
+AvcChunkedEncoderStatistics AvcChunkedEncoder::GetStatistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stat_;
+}
+
+int AvcChunkedEncoder::Encode(const std::string& input_url, const std::string& output_url) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    chunks_.clear();
+    keyframes_.clear();
+    stat_ = AvcChunkedEncoderStatistics();
+    stat_.threads_count_ = config_.threads_count_;
+  }
+
+  auto start = Clock::now();
+  int ret = Split(input_url, output_url);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stat_.split_ms_ = ElapsedMs(start);
+  }
+  if (ret < 0)
+    return ret;
+
+  start = Clock::now();
+  EncodeChunks(input_url, output_url);
+  ret = error_.load(std::memory_order_acquire);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stat_.encode_ms_ = ElapsedMs(start);
+    for (const ChunkState& state : chunks_) {
+      stat_.frames_encoded_ += state.chunk_.frames_encoded_;
+      stat_.chunks_encode_ms_ += state.chunk_.encode_ms_;
+    }
+  }
+
+  if (ret >= 0) {
+    start = Clock::now();
+    ret = Join(input_url, output_url);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stat_.join_ms_ = ElapsedMs(start);
+  }
+
+  for (const ChunkState& state : chunks_)
+    std::remove(state.url_.c_str());
+
+  return ret;
+}
+
+bool AvcChunkedEncoder::IsIndexApiAvailable() const {
+  // avformat_index_get_entry appeared in libavformat 58.78
+  unsigned version = avc_module_provider_->avformat_version();
+  unsigned major = version >> 16;
+  unsigned minor = (version >> 8) & 0xff;
+  return major > 58 || (major == 58 && minor >= 78);
+}
+
+int AvcChunkedEncoder::FindKeyframes(AvcMediaInput& input, int stream_index, int64_t& end_timestamp) {
+  auto d = avc_module_provider_->d();
+  AVStream* stream = input.GetStream(stream_index);
+  end_timestamp = AV_NOPTS_VALUE;
+
+  if (IsIndexApiAvailable()) {
+    int count = avc_module_provider_->avformat_index_get_entries_count(stream);
+    for (int i = 0; i < count; i++) {
+      const AVIndexEntry* entry = avc_module_provider_->avformat_index_get_entry(stream, i);
+      if (!entry)
+        break;
+
+      int flags = d->AVIndexEntryGetFlags(entry);
+      if ((flags & AVINDEX_DISCARD_FRAME) != 0)
+        continue;
+
+      int64_t timestamp = d->AVIndexEntryGetTimestamp(entry);
+      end_timestamp = end_timestamp == AV_NOPTS_VALUE ? timestamp + 1 : std::max(end_timestamp, timestamp + 1);
+      if ((flags & AVINDEX_KEYFRAME) != 0) {
+        KeyframePoint point;
+        point.timestamp_ = timestamp;
+        point.pos_ = d->AVIndexEntryGetPos(entry);
+        keyframes_.push_back(point);
+      }
+    }
+
+    if (!keyframes_.empty()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stat_.index_used_ = true;
+      return 0;
+    }
+  }
+
+  // demuxer has no index (or it is built while reading), read packets without decoding
+  for (int i = 0; i < input.GetStreamsCount(); i++)
+    if (i != stream_index)
+      d->AVStreamSetDiscard(input.GetStream(i), AVDISCARD_ALL);
+
+  AVPacket* packet = avc_module_provider_->av_packet_alloc();
+  if (!packet)
+    return AVERROR(ENOMEM);
+
+  int ret = 0;
+  while ((ret = avc_module_provider_->av_read_frame(input.GetFormatContext(), packet)) >= 0) {
+    if (d->AVPacketGetStreamIndex(packet) == stream_index) {
+      int64_t timestamp = GetPacketTimestamp(d.get(), packet);
+      if (timestamp != AV_NOPTS_VALUE) {
+        int64_t duration = std::max<int64_t>(d->AVPacketGetDuration(packet), 1);
+        end_timestamp = end_timestamp == AV_NOPTS_VALUE ? timestamp + duration : std::max(end_timestamp, timestamp + duration);
+        if ((d->AVPacketGetFlags(packet) & AV_PKT_FLAG_KEY) != 0) {
+          KeyframePoint point;
+          point.timestamp_ = timestamp;
+          point.pos_ = d->AVPacketGetPos(packet);
+          keyframes_.push_back(point);
+        }
+      }
+    }
+    avc_module_provider_->av_packet_unref(packet);
+  }
+
+  avc_module_provider_->av_packet_free(&packet);
+  return ret == AVERROR_EOF ? 0 : ret;
+}
+
+int AvcChunkedEncoder::Split(const std::string& input_url, const std::string& output_url) {
+  AvcMediaInput input(avc_module_provider_);
+  int ret = input.Open(input_url);
+  if (ret < 0)
+    return ret;
+
+  int stream_index = input.FindBestStream(AVMEDIA_TYPE_VIDEO);
+  if (stream_index < 0)
+    return AVERROR_STREAM_NOT_FOUND;
+
+  int64_t end_timestamp = AV_NOPTS_VALUE;
+  ret = FindKeyframes(input, stream_index, end_timestamp);
+  if (ret < 0)
+    return ret;
+
+  std::sort(keyframes_.begin(), keyframes_.end(),
+    [](const KeyframePoint& a, const KeyframePoint& b) { return a.timestamp_ < b.timestamp_; });
+
+  // first chunk always starts from beginning of input, other chunks start at keyframes close to
+  // equal parts of timeline. Chunks shorter than min duration are not created
+  std::vector<size_t> starts(1, 0);
+  if (!keyframes_.empty() && end_timestamp != AV_NOPTS_VALUE) {
+    cmf::MediaTimeBase time_base = input.GetStreamTimeBase(stream_index);
+    int64_t min_distance = time_base.num_ > 0
+      ? static_cast<int64_t>(config_.min_chunk_duration_ * time_base.den_ / time_base.num_) : 0;
+    int64_t first = keyframes_.front().timestamp_;
+    int64_t duration = end_timestamp - first;
+
+    for (int i = 1; i < config_.chunks_count_; i++) {
+      int64_t target = first + duration * i / config_.chunks_count_;
+      auto it = std::lower_bound(keyframes_.begin(), keyframes_.end(), target,
+        [](const KeyframePoint& point, int64_t value) { return point.timestamp_ < value; });
+      if (it == keyframes_.end())
+        break;
+
+      size_t index = static_cast<size_t>(it - keyframes_.begin());
+      if (index <= starts.back() ||
+          it->timestamp_ - keyframes_[starts.back()].timestamp_ < min_distance ||
+          end_timestamp - it->timestamp_ < min_distance)
+        continue;
+
+      starts.push_back(index);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < starts.size(); i++) {
+    ChunkState state;
+    state.keyframe_index_ = starts[i];
+    state.url_ = output_url + ".chunk" + std::to_string(i);
+    state.first_pts_ = AV_NOPTS_VALUE;
+    if (!keyframes_.empty()) {
+      state.chunk_.start_timestamp_ = keyframes_[starts[i]].timestamp_;
+      state.chunk_.start_pos_ = keyframes_[starts[i]].pos_;
+    }
+    chunks_.push_back(state);
+  }
+  return 0;
+}
+
+void AvcChunkedEncoder::EncodeChunks(const std::string& input_url, const std::string& output_url) {
+  next_chunk_.store(0, std::memory_order_relaxed);
+  error_.store(0, std::memory_order_relaxed);
+
+  // chunks are taken in order, long encodes of first chunks overlap with later ones
+  auto worker = [this, &input_url, &output_url] {
+    size_t index = 0;
+    while ((index = next_chunk_.fetch_add(1, std::memory_order_relaxed)) < chunks_.size()) {
+      if (error_.load(std::memory_order_acquire) < 0)
+        break;
+
+      int ret = EncodeChunk(input_url, output_url, index);
+      if (ret < 0) {
+#if DEBUG_PRINT
+        fprintf(stderr, "AvcChunkedEncoder: chunk %d failed %d\n", static_cast<int>(index), ret);
+#endif //DEBUG_PRINT
+        int expected = 0;
+        error_.compare_exchange_strong(expected, ret, std::memory_order_acq_rel);
+      }
+    }
+  };
+
+  size_t threads_count = std::min(static_cast<size_t>(config_.threads_count_), chunks_.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < threads_count; i++)
+    threads.emplace_back(worker);
+
+  worker();
+  for (auto& thread : threads)
+    thread.join();
+}
+
+bool AvcChunkedEncoder::IsAtOrAfter(const AVPacket* packet, const KeyframePoint& point) const {
+  auto d = avc_module_provider_->d();
+  int64_t pos = d->AVPacketGetPos(packet);
+  if (pos >= 0 && point.pos_ >= 0)
+    return pos >= point.pos_;
+
+  int64_t timestamp = GetPacketTimestamp(d.get(), packet);
+  return timestamp != AV_NOPTS_VALUE && timestamp >= point.timestamp_;
+}
+
+int AvcChunkedEncoder::OpenEncoder(AvcMediaInput& input, int stream_index, AVCodecContext* decoder_context,
+                                   const AvcMediaOutput& output, AVCodecContext*& encoder_context) {
+  auto d = avc_module_provider_->d();
+  AVCodec* codec = avc_module_provider_->avcodec_find_encoder_by_name(config_.video_encoder_name_.c_str());
+  if (!codec)
+    return AVERROR_ENCODER_NOT_FOUND;
+
+  encoder_context = avc_module_provider_->avcodec_alloc_context3(codec);
+  if (!encoder_context)
+    return AVERROR(ENOMEM);
+
+  int width = config_.width_ > 0 ? config_.width_ : d->AVCodecContextGetWidth(decoder_context);
+  int height = config_.height_ > 0 ? config_.height_ : d->AVCodecContextGetHeight(decoder_context);
+
+  // keep decoder pixel format when encoder supports it, otherwise first supported format
+  int pix_fmt = SelectEncoderPixelFormat(d.get(), codec, d->AVCodecContextGetPixFmt(decoder_context));
+  cmf::MediaTimeBase frame_rate = GetStreamFrameRate(d.get(), input.GetStream(stream_index));
+
+  d->AVCodecContextSetWidth(encoder_context, width);
+  d->AVCodecContextSetHeight(encoder_context, height);
+  d->AVCodecContextSetPixFmt(encoder_context, pix_fmt);
+  d->AVCodecContextSetTimeBase(encoder_context, cmf::MediaTimeBase(frame_rate.den_, frame_rate.num_));
+  d->AVCodecContextSetFrameRate(encoder_context, frame_rate);
+  d->AVCodecContextSetThreadCount(encoder_context, config_.codec_threads_);
+  if (config_.codec_threads_ == 0 && config_.codec_autotuner_)
+    config_.codec_autotuner_->Apply(encoder_context, true);
+  // every chunk is decodable alone, and dts equals pts, so chunks are joined without timestamp overlap
+  d->AVCodecContextSetMaxBFrames(encoder_context, 0);
+  if (config_.bit_rate_ > 0)
+    d->AVCodecContextSetBitRate(encoder_context, config_.bit_rate_);
+  if (config_.gop_size_ > 0)
+    d->AVCodecContextSetGopSize(encoder_context, config_.gop_size_);
+
+  int flags = d->AVCodecContextGetFlags(encoder_context) | static_cast<int>(AV_CODEC_FLAG_CLOSED_GOP);
+  if (output.IsGlobalHeader())
+    flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+  d->AVCodecContextSetFlags(encoder_context, flags);
+
+  return avc_module_provider_->avcodec_open2(encoder_context, codec, nullptr);
+}
+
+int AvcChunkedEncoder::EncodeChunk(const std::string& input_url, const std::string& output_url, size_t index) {
+  ChunkState& state = chunks_[index];
+  auto start = Clock::now();
+  auto d = avc_module_provider_->d();
+
+  AvcMediaInput input(avc_module_provider_);
+  int ret = input.Open(input_url);
+  if (ret < 0)
+    return ret;
+
+  int stream_index = input.FindBestStream(AVMEDIA_TYPE_VIDEO);
+  if (stream_index < 0)
+    return AVERROR_STREAM_NOT_FOUND;
+
+  for (int i = 0; i < input.GetStreamsCount(); i++)
+    if (i != stream_index)
+      d->AVStreamSetDiscard(input.GetStream(i), AVDISCARD_ALL);
+
+  // chunk owns whole decode-encode chain, codecs are single-threaded by default, parallelism comes from chunks
+  AVCodecContext* decoder_context = input.OpenDecoder(stream_index, config_.codec_threads_, nullptr, 0, nullptr,
+                                                      config_.codec_autotuner_.get());
+  if (!decoder_context)
+    return AVERROR_DECODER_NOT_FOUND;
+
+  AvcMediaOutput output(avc_module_provider_);
+  AVCodecContext* encoder_context = nullptr;
+  SwsContext* sws_context = nullptr;
+  AVPacket* packet = avc_module_provider_->av_packet_alloc();
+  AVPacket* out_packet = avc_module_provider_->av_packet_alloc();
+  AVFrame* frame = avc_module_provider_->av_frame_alloc();
+  AVFrame* scaled = avc_module_provider_->av_frame_alloc();
+  AVStream* out_stream = nullptr;
+
+  const KeyframePoint* begin = index > 0 ? &keyframes_[state.keyframe_index_] : nullptr;
+  const KeyframePoint* end = index + 1 < chunks_.size() ? &keyframes_[chunks_[index + 1].keyframe_index_] : nullptr;
+
+  if (!packet || !out_packet || !frame || !scaled)
+    ret = AVERROR(ENOMEM);
+
+  // format is guessed from final output url, chunk is written to own file
+  if (ret >= 0)
+    ret = output.Create(state.url_, config_.output_format_, output_url);
+  AVFormatContext* output_context = output.GetFormatContext();
+
+  if (ret >= 0)
+    ret = OpenEncoder(input, stream_index, decoder_context, output, encoder_context);
+
+  if (ret >= 0) {
+    out_stream = avc_module_provider_->avformat_new_stream(output_context, nullptr);
+    ret = out_stream ? avc_module_provider_->avcodec_parameters_from_context(d->AVStreamGetCodecPar(out_stream), encoder_context)
+                     : AVERROR(ENOMEM);
+  }
+
+  if (ret >= 0) {
+    d->AVStreamSetTimeBase(out_stream, d->AVCodecContextGetTimeBase(encoder_context));
+    ret = output.OpenFile();
+  }
+
+  if (ret >= 0)
+    ret = avc_module_provider_->avformat_write_header(output_context, nullptr);
+
+  // seek a bit before chunk start, demuxers without index may land after requested timestamp
+  if (ret >= 0 && begin) {
+    const KeyframePoint& seek_point = state.keyframe_index_ > 0 ? keyframes_[state.keyframe_index_ - 1] : *begin;
+    ret = avc_module_provider_->av_seek_frame(input.GetFormatContext(), stream_index, seek_point.timestamp_, AVSEEK_FLAG_BACKWARD);
+  }
+
+  cmf::MediaTimeBase stream_time_base = input.GetStreamTimeBase(stream_index);
+  cmf::MediaTimeBase encoder_time_base = encoder_context ? d->AVCodecContextGetTimeBase(encoder_context) : cmf::MediaTimeBase();
+  int dst_width = encoder_context ? d->AVCodecContextGetWidth(encoder_context) : 0;
+  int dst_height = encoder_context ? d->AVCodecContextGetHeight(encoder_context) : 0;
+  int dst_format = encoder_context ? d->AVCodecContextGetPixFmt(encoder_context) : AV_PIX_FMT_NONE;
+  int sws_width = 0, sws_height = 0, sws_format = AV_PIX_FMT_NONE;
+  int64_t next_pts = 0;
+  bool started = begin == nullptr;
+
+  // receive all ready packets of encoder and write them to chunk file
+  auto write_packets = [&]() -> int {
+    while (true) {
+      int r = avc_module_provider_->avcodec_receive_packet(encoder_context, out_packet);
+      if (r == AVERROR(EAGAIN) || r == AVERROR_EOF)
+        return 0;
+      if (r < 0)
+        return r;
+
+      d->AVPacketSetStreamIndex(out_packet, 0);
+      avc_module_provider_->av_packet_rescale_ts(out_packet, encoder_time_base, d->AVStreamGetTimeBase(out_stream));
+      r = avc_module_provider_->av_interleaved_write_frame(output_context, out_packet);
+      avc_module_provider_->av_packet_unref(out_packet);
+      if (r < 0)
+        return r;
+    }
+  };
+
+  auto encode_frame = [&](AVFrame* decoded) -> int {
+    AVFrame* source = decoded;
+    int width = d->AVFrameGetWidth(decoded);
+    int height = d->AVFrameGetHeight(decoded);
+    int format = d->AVFrameGetFormat(decoded);
+    if (width != dst_width || height != dst_height || format != dst_format) {
+      if (!avc_module_provider_->IsSwScaleLoaded())
+        return AVERROR(ENOSYS);
+
+      if (!sws_context || sws_width != width || sws_height != height || sws_format != format) {
+        if (sws_context)
+          avc_module_provider_->sws_freeContext(sws_context);
+        sws_context = avc_module_provider_->sws_getContext(width, height, format,
+          dst_width, dst_height, dst_format, SWS_BICUBIC, nullptr, nullptr, nullptr);
+        if (!sws_context)
+          return AVERROR(EINVAL);
+        sws_width = width;
+        sws_height = height;
+        sws_format = format;
+      }
+
+      avc_module_provider_->av_frame_unref(scaled);
+      d->AVFrameSetWidth(scaled, dst_width);
+      d->AVFrameSetHeight(scaled, dst_height);
+      d->AVFrameSetFormat(scaled, dst_format);
+      int r = avc_module_provider_->av_frame_get_buffer(scaled, 0);
+      if (r < 0)
+        return r;
+
+      r = avc_module_provider_->sws_scale(sws_context, d->AVFrameGetDataPtr(decoded), d->AVFrameGetLineSizePtr(decoded),
+        0, height, d->AVFrameGetDataPtr(scaled), d->AVFrameGetLineSizePtr(scaled));
+      if (r < 0)
+        return r;
+      source = scaled;
+    }
+
+    // frames keep position on input timeline, so chunks continue each other after join
+    int64_t pts = d->AVFrameGetPts(decoded);
+    if (pts != AV_NOPTS_VALUE)
+      pts = avc_module_provider_->av_rescale_q_rnd(pts, ToAVRational(stream_time_base), ToAVRational(encoder_time_base),
+        AV_ROUND_NEAR_INF | AV_ROUND_PASS_MINMAX);
+    if (state.first_pts_ == AV_NOPTS_VALUE)
+      next_pts = pts != AV_NOPTS_VALUE ? pts : 0;
+    if (pts == AV_NOPTS_VALUE || pts < next_pts)
+      pts = next_pts;
+    next_pts = pts + 1;
+    if (state.first_pts_ == AV_NOPTS_VALUE)
+      state.first_pts_ = pts;
+
+    d->AVFrameSetPts(source, pts);
+    d->AVFrameSetPictType(source, AV_PICTURE_TYPE_NONE);
+    int r = avc_module_provider_->avcodec_send_frame(encoder_context, source);
+    if (r < 0)
+      return r;
+
+    state.chunk_.frames_encoded_++;
+    return write_packets();
+  };
+
+  auto drain_decoder = [&]() -> int {
+    while (true) {
+      int r = avc_module_provider_->avcodec_receive_frame(decoder_context, frame);
+      if (r == AVERROR(EAGAIN) || r == AVERROR_EOF)
+        return 0;
+      if (r < 0)
+        return r;
+
+      r = encode_frame(frame);
+      avc_module_provider_->av_frame_unref(frame);
+      if (r < 0)
+        return r;
+    }
+  };
+
+  // read until end of input or keyframe of next chunk, then flush codecs
+  while (ret >= 0) {
+    if (error_.load(std::memory_order_relaxed) < 0) {
+      ret = AVERROR_EXIT;
+      break;
+    }
+
+    ret = avc_module_provider_->av_read_frame(input.GetFormatContext(), packet);
+    if (ret == AVERROR_EOF) {
+      ret = 0;
+      break;
+    }
+
+    if (ret < 0)
+      break;
+
+    if (d->AVPacketGetStreamIndex(packet) != stream_index) {
+      avc_module_provider_->av_packet_unref(packet);
+      continue;
+    }
+
+    bool key = (d->AVPacketGetFlags(packet) & AV_PKT_FLAG_KEY) != 0;
+    if (key && end && IsAtOrAfter(packet, *end)) {
+      avc_module_provider_->av_packet_unref(packet);
+      break;
+    }
+
+    if (!started) {
+      started = key && IsAtOrAfter(packet, *begin);
+      if (!started) {
+        avc_module_provider_->av_packet_unref(packet);
+        continue;
+      }
+    }
+
+    while ((ret = avc_module_provider_->avcodec_send_packet(decoder_context, packet)) == AVERROR(EAGAIN)) {
+      ret = drain_decoder();
+      if (ret < 0)
+        break;
+    }
+    avc_module_provider_->av_packet_unref(packet);
+
+    // damaged packet loses some frames only, like in ffmpeg tool
+    if (ret == AVERROR_INVALIDDATA)
+      ret = 0;
+    if (ret >= 0)
+      ret = drain_decoder();
+  }
+
+  // seek has missed chunk start, frames of chunk would be lost
+  if (ret >= 0 && !started)
+    ret = AVERROR(EINVAL);
+
+  if (ret >= 0) {
+    ret = avc_module_provider_->avcodec_send_packet(decoder_context, nullptr);
+    if (ret >= 0)
+      ret = drain_decoder();
+    if (ret >= 0)
+      ret = avc_module_provider_->avcodec_send_frame(encoder_context, nullptr);
+    if (ret >= 0)
+      ret = write_packets();
+    if (ret >= 0)
+      ret = avc_module_provider_->av_write_trailer(output_context);
+  }
+
+  if (sws_context)
+    avc_module_provider_->sws_freeContext(sws_context);
+  avc_module_provider_->av_frame_free(&scaled);
+  avc_module_provider_->av_frame_free(&frame);
+  avc_module_provider_->av_packet_free(&out_packet);
+  avc_module_provider_->av_packet_free(&packet);
+  avc_module_provider_->avcodec_free_context(&encoder_context);
+  avc_module_provider_->avcodec_free_context(&decoder_context);
+  output.Close();
+
+  if (ret >= 0)
+    state.time_base_ = encoder_time_base;
+  state.chunk_.encode_ms_ = ElapsedMs(start);
+  return ret;
+}
+
+int AvcChunkedEncoder::Join(const std::string& input_url, const std::string& output_url) {
+  auto d = avc_module_provider_->d();
+  AvcMediaOutput output(avc_module_provider_);
+  int ret = output.Create(output_url, config_.output_format_);
+  if (ret < 0)
+    return ret;
+
+  AVFormatContext* output_context = output.GetFormatContext();
+
+  // audio is taken from original input and interleaved with joined video by time
+  AvcMediaInput audio_input(avc_module_provider_);
+  std::vector<int> audio_indexes;
+  if (config_.copy_audio_ && audio_input.Open(input_url) >= 0) {
+    audio_indexes.assign(audio_input.GetStreamsCount(), -1);
+    for (int i = 0; i < audio_input.GetStreamsCount(); i++) {
+      AVStream* input_stream = audio_input.GetStream(i);
+      if (audio_input.GetStreamMediaType(i) != AVMEDIA_TYPE_AUDIO) {
+        d->AVStreamSetDiscard(input_stream, AVDISCARD_ALL);
+        continue;
+      }
+      audio_indexes[i] = 0;  // output stream is created below
+    }
+  }
+
+  AvcMediaInput chunk_input(avc_module_provider_);
+  ret = chunk_input.Open(chunks_.front().url_);
+  AVStream* video_stream = nullptr;
+  if (ret >= 0) {
+    // all chunks are encoded with equal settings, so first chunk describes stream
+    video_stream = avc_module_provider_->avformat_new_stream(output_context, nullptr);
+    ret = video_stream ? avc_module_provider_->avcodec_parameters_copy(d->AVStreamGetCodecPar(video_stream),
+      d->AVStreamGetCodecPar(chunk_input.GetStream(0))) : AVERROR(ENOMEM);
+  }
+
+  if (ret >= 0) {
+    d->AVCodecParametersSetCodecTag(d->AVStreamGetCodecPar(video_stream), 0);
+    d->AVStreamSetTimeBase(video_stream, chunks_.front().time_base_);
+  }
+
+  for (size_t i = 0; ret >= 0 && i < audio_indexes.size(); i++) {
+    if (audio_indexes[i] < 0)
+      continue;
+
+    AVStream* input_stream = audio_input.GetStream(static_cast<int>(i));
+    AVStream* stream = avc_module_provider_->avformat_new_stream(output_context, nullptr);
+    if (!stream) {
+      ret = AVERROR(ENOMEM);
+      break;
+    }
+
+    ret = avc_module_provider_->avcodec_parameters_copy(d->AVStreamGetCodecPar(stream), d->AVStreamGetCodecPar(input_stream));
+    d->AVCodecParametersSetCodecTag(d->AVStreamGetCodecPar(stream), 0);
+    d->AVStreamSetTimeBase(stream, d->AVStreamGetTimeBase(input_stream));
+    audio_indexes[i] = d->AVStreamGetIndex(stream);
+  }
+
+  if (ret >= 0)
+    ret = output.OpenFile();
+  if (ret >= 0)
+    ret = avc_module_provider_->avformat_write_header(output_context, nullptr);
+
+  AVPacket* packet = avc_module_provider_->av_packet_alloc();
+  AVPacket* audio_packet = avc_module_provider_->av_packet_alloc();
+  if (!packet || !audio_packet)
+    ret = AVERROR(ENOMEM);
+
+  const AVRational kMicroseconds = { 1, 1000000 };
+  cmf::MediaTimeBase video_time_base = ret >= 0 ? d->AVStreamGetTimeBase(video_stream) : cmf::MediaTimeBase();
+  bool audio_pending = false;
+  bool audio_eof = audio_indexes.empty();
+  uint64_t packets_written = 0;
+
+  // write audio packets which are not later than limit_us, all of them when limit is INT64_MAX
+  auto write_audio = [&](int64_t limit_us) -> int {
+    while (!audio_eof) {
+      if (!audio_pending) {
+        int r = avc_module_provider_->av_read_frame(audio_input.GetFormatContext(), audio_packet);
+        if (r == AVERROR_EOF) {
+          audio_eof = true;
+          return 0;
+        }
+        if (r < 0)
+          return r;
+
+        int index = d->AVPacketGetStreamIndex(audio_packet);
+        if (index < 0 || index >= static_cast<int>(audio_indexes.size()) || audio_indexes[index] < 0) {
+          avc_module_provider_->av_packet_unref(audio_packet);
+          continue;
+        }
+        audio_pending = true;
+      }
+
+      int index = d->AVPacketGetStreamIndex(audio_packet);
+      cmf::MediaTimeBase time_base = audio_input.GetStreamTimeBase(index);
+      int64_t timestamp = GetPacketTimestamp(d.get(), audio_packet);
+      if (timestamp != AV_NOPTS_VALUE && limit_us != INT64_MAX &&
+          avc_module_provider_->av_rescale_q_rnd(timestamp, ToAVRational(time_base), kMicroseconds, AV_ROUND_NEAR_INF) > limit_us)
+        return 0;
+
+      AVStream* stream = d->AVFormatContextGetStreamByIdx(output_context, audio_indexes[index]);
+      d->AVPacketSetStreamIndex(audio_packet, audio_indexes[index]);
+      d->AVPacketSetPos(audio_packet, -1);
+      avc_module_provider_->av_packet_rescale_ts(audio_packet, time_base, d->AVStreamGetTimeBase(stream));
+      audio_pending = false;
+      int r = avc_module_provider_->av_interleaved_write_frame(output_context, audio_packet);
+      avc_module_provider_->av_packet_unref(audio_packet);
+      if (r < 0)
+        return r;
+      packets_written++;
+    }
+    return 0;
+  };
+
+  int64_t last_dts = AV_NOPTS_VALUE;
+  for (size_t i = 0; ret >= 0 && i < chunks_.size(); i++) {
+    if (i > 0) {
+      chunk_input.Close();
+      ret = chunk_input.Open(chunks_[i].url_);
+      if (ret < 0)
+        break;
+    }
+
+    cmf::MediaTimeBase chunk_time_base = chunk_input.GetStreamTimeBase(0);
+    int64_t offset = AV_NOPTS_VALUE;
+    while (ret >= 0) {
+      ret = avc_module_provider_->av_read_frame(chunk_input.GetFormatContext(), packet);
+      if (ret == AVERROR_EOF) {
+        ret = 0;
+        break;
+      }
+      if (ret < 0)
+        break;
+
+      avc_module_provider_->av_packet_rescale_ts(packet, chunk_time_base, video_time_base);
+
+      // chunk container may shift timestamps, place chunk where its first frame was on input timeline
+      int64_t pts = d->AVPacketGetPts(packet);
+      int64_t dts = d->AVPacketGetDts(packet);
+      if (offset == AV_NOPTS_VALUE) {
+        int64_t first = avc_module_provider_->av_rescale_q_rnd(chunks_[i].first_pts_,
+          ToAVRational(chunks_[i].time_base_), ToAVRational(video_time_base), AV_ROUND_NEAR_INF | AV_ROUND_PASS_MINMAX);
+        int64_t packet_first = pts != AV_NOPTS_VALUE ? pts : dts;
+        offset = first != AV_NOPTS_VALUE && packet_first != AV_NOPTS_VALUE ? first - packet_first : 0;
+      }
+
+      if (pts != AV_NOPTS_VALUE)
+        pts += offset;
+      if (dts != AV_NOPTS_VALUE)
+        dts += offset;
+      if (dts != AV_NOPTS_VALUE && last_dts != AV_NOPTS_VALUE && dts <= last_dts)
+        dts = last_dts + 1;
+      if (pts != AV_NOPTS_VALUE && dts != AV_NOPTS_VALUE && pts < dts)
+        pts = dts;
+      if (dts != AV_NOPTS_VALUE)
+        last_dts = dts;
+
+      d->AVPacketSetPts(packet, pts);
+      d->AVPacketSetDts(packet, dts);
+      d->AVPacketSetStreamIndex(packet, d->AVStreamGetIndex(video_stream));
+      d->AVPacketSetPos(packet, -1);
+
+      if (dts != AV_NOPTS_VALUE)
+        ret = write_audio(avc_module_provider_->av_rescale_q_rnd(dts, ToAVRational(video_time_base), kMicroseconds, AV_ROUND_NEAR_INF));
+
+      if (ret >= 0) {
+        ret = avc_module_provider_->av_interleaved_write_frame(output_context, packet);
+        if (ret >= 0)
+          packets_written++;
+      }
+      avc_module_provider_->av_packet_unref(packet);
+    }
+  }
+
+  if (ret >= 0)
+    ret = write_audio(INT64_MAX);
+  if (ret >= 0)
+    ret = avc_module_provider_->av_write_trailer(output_context);
+
+  if (audio_pending)
+    avc_module_provider_->av_packet_unref(audio_packet);
+  avc_module_provider_->av_packet_free(&audio_packet);
+  avc_module_provider_->av_packet_free(&packet);
+  output.Close();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  stat_.packets_written_ = packets_written;
+  return ret;
+}
+
+}  // namespace detail
+}//namespace avc
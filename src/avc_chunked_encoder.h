@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_CHUNKED_ENCODER_HEADER
+#define AVC_CHUNKED_ENCODER_HEADER
+
+#include <avc/i_avc_chunked_encoder.h>
+#include <avc/i_avc_module_provider.h>
+#include "avc_media_input.h"
+#include "avc_media_output.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcChunkedEncoder
+  : public virtual IAvcChunkedEncoder {
+ public:
+  AvcChunkedEncoder(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcChunkedEncoderConfig& config);
+  virtual ~AvcChunkedEncoder() = default;
+
+  int Encode(const std::string& input_url, const std::string& output_url) override;
+  std::vector<AvcEncodeChunk> GetChunks() const override;
+  AvcChunkedEncoderStatistics GetStatistics() const override;
+
+ private:
+  /// \brief Keyframe packet. Position is compared when demuxer knows it, otherwise timestamp
+  struct KeyframePoint {
+    int64_t timestamp_ = 0;
+    int64_t pos_ = -1;
+  };
+
+  struct ChunkState {
+    AvcEncodeChunk chunk_;
+    size_t keyframe_index_ = 0;
+    std::string url_;
+    int64_t first_pts_;                 ///< first encoded frame, in time base of encoder
+    cmf::MediaTimeBase time_base_;
+  };
+
+  bool IsIndexApiAvailable() const;
+  int FindKeyframes(AvcMediaInput& input, int stream_index, int64_t& end_timestamp);
+  int Split(const std::string& input_url, const std::string& output_url);
+  void EncodeChunks(const std::string& input_url, const std::string& output_url);
+  int EncodeChunk(const std::string& input_url, const std::string& output_url, size_t index);
+  int OpenEncoder(AvcMediaInput& input, int stream_index, AVCodecContext* decoder_context,
+                  const AvcMediaOutput& output, AVCodecContext*& encoder_context);
+  int Join(const std::string& input_url, const std::string& output_url);
+
+  bool IsAtOrAfter(const AVPacket* packet, const KeyframePoint& point) const;
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AvcChunkedEncoderConfig config_;
+
+  std::vector<KeyframePoint> keyframes_;
+  std::vector<ChunkState> chunks_;
+  std::atomic<size_t> next_chunk_{0};
+  std::atomic<int> error_{0};
+
+  mutable std::mutex mutex_;
+  AvcChunkedEncoderStatistics stat_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_CHUNKED_ENCODER_HEADER
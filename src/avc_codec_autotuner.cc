@@ -0,0 +1,500 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_codec_autotuner.h"
+#include "avc_media_utils.h"
+#include <avc/libav_detached_common.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace avc {
+
+std::shared_ptr<IAvcCodecAutotuner> API_EXPORT CreateAvcCodecAutotuner(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcCodecAutotunerConfig& config) {
+  if (!avc_module_provider || !avc_module_provider->IsAvCodecLoaded())
+    return nullptr;
+
+  return std::make_shared<detail::AvcCodecAutotuner>(avc_module_provider, config);
+}
+
+namespace detail {
+
+namespace {
+
+const char kSettingsMagic[] = "AVCTUNE";
+const int kSettingsVersion = 1;
+const size_t kMaxCodecNameSize = 127;
+
+const int kCalibrationFrameRate = 25;
+const int kCalibrationPatterns = 8;   ///< distinct synthetic frames, repeated to calibration length
+
+/// \brief Diagonal gradient moving by frame index with noise, so encoders do motion search and residual coding
+void FillPattern(uint8_t* plane, int linesize, int rows, int index, uint32_t& seed) {
+  for (int y = 0; y < rows; y++) {
+    uint8_t* row = plane + static_cast<size_t>(y) * linesize;
+    for (int x = 0; x < linesize; x++) {
+      seed = seed * 1664525u + 1013904223u;
+      row[x] = static_cast<uint8_t>(((x + y + index * 4) & 0xff) ^ ((seed >> 24) & 0x0f));
+    }
+  }
+}
+
+}  // namespace
+
+AvcCodecAutotuner::AvcCodecAutotuner(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcCodecAutotunerConfig& config)
+  : avc_module_provider_(avc_module_provider)
+  , config_(config)
+  , hardware_threads_(std::max(1, static_cast<int>(std::thread::hardware_concurrency()))) {
+  config_.calibration_frames_ = std::max(config_.calibration_frames_, 1);
+  if (!config_.cache_url_.empty())
+    Load(config_.cache_url_);
+}
+
+int AvcCodecAutotuner::GetResolutionBucket(int width, int height) {
+  int64_t pixels = static_cast<int64_t>(std::max(width, 0)) * std::max(height, 0);
+  static const int64_t kBucketLimits[] = { 640 * 360, 1280 * 720, 1920 * 1080, 2560 * 1440, 3840 * 2160 };
+  int bucket = 0;
+  while (bucket < 5 && pixels > kBucketLimits[bucket])
+    bucket++;
+  return bucket;
+}
+
+int AvcCodecAutotuner::Calibrate(const std::string& encoder_name, int width, int height, int pix_fmt) {
+  if (width <= 0 || height <= 0)
+    return AVERROR(EINVAL);
+
+  auto d = avc_module_provider_->d();
+  const AVCodec* encoder = avc_module_provider_->avcodec_find_encoder_by_name(encoder_name.c_str());
+  if (!encoder || d->AVCodecGetType(encoder) != AVMEDIA_TYPE_VIDEO)
+    return AVERROR_ENCODER_NOT_FOUND;
+
+  if (pix_fmt == AV_PIX_FMT_NONE)
+    pix_fmt = SelectEncoderPixelFormat(d.get(), encoder, AV_PIX_FMT_YUV420P);
+
+  std::lock_guard<std::mutex> lock(calibration_mutex_);
+  std::vector<AVFrame*> frames;
+  int ret = MakeFrames(width, height, pix_fmt, frames);
+
+  // encoded packets of first successful run are input of decoder calibration
+  std::vector<AVPacket*> packets;
+  AvcCodecThreadSettings best;
+  if (ret >= 0) {
+    for (const GridPoint& point : MakeGrid(encoder, true)) {
+      AVCodecContext* encoder_context = OpenCodec(encoder, true, width, height, pix_fmt, point);
+      if (!encoder_context)
+        continue;  // codec does not support this threading
+
+      double fps = RunEncoder(encoder_context, frames, packets.empty() ? &packets : nullptr);
+      avc_module_provider_->avcodec_free_context(&encoder_context);
+#if DEBUG_PRINT
+      fprintf(stderr, "AvcCodecAutotuner: %s %dx%d threads %d type %d slices %d: %.1f fps\n", encoder_name.c_str(),
+              width, height, point.thread_count_, point.thread_type_, point.slices_, fps);
+#endif //DEBUG_PRINT
+      if (fps > best.frames_per_second_) {
+        best.thread_count_ = point.thread_count_;
+        best.thread_type_ = point.thread_type_;
+        best.slices_ = point.slices_;
+        best.frames_per_second_ = fps;
+      }
+    }
+  }
+
+  for (AVFrame* frame : frames)
+    avc_module_provider_->av_frame_free(&frame);
+
+  if (ret >= 0 && best.thread_count_ == 0)
+    ret = AVERROR(EINVAL);  // encoder was not opened at any grid point
+
+  int bucket = GetResolutionBucket(width, height);
+  if (ret >= 0) {
+    Store(Key(d->AVCodecGetName(encoder), true, bucket, hardware_threads_), best);
+
+    const AVCodec* decoder = avc_module_provider_->avcodec_find_decoder(d->AVCodecGetId(encoder));
+    if (decoder && !packets.empty()) {
+      AvcCodecThreadSettings best_decoder;
+      for (const GridPoint& point : MakeGrid(decoder, false)) {
+        AVCodecContext* decoder_context = OpenCodec(decoder, false, width, height, pix_fmt, point);
+        if (!decoder_context)
+          continue;
+
+        double fps = RunDecoder(decoder_context, packets);
+        avc_module_provider_->avcodec_free_context(&decoder_context);
+        if (fps > best_decoder.frames_per_second_) {
+          best_decoder.thread_count_ = point.thread_count_;
+          best_decoder.thread_type_ = point.thread_type_;
+          best_decoder.frames_per_second_ = fps;
+        }
+      }
+
+      if (best_decoder.thread_count_ > 0)
+        Store(Key(d->AVCodecGetName(decoder), false, bucket, hardware_threads_), best_decoder);
+    }
+  }
+
+  for (AVPacket* packet : packets)
+    avc_module_provider_->av_packet_free(&packet);
+
+  if (ret >= 0 && !config_.cache_url_.empty())
+    Save(config_.cache_url_);
+  return ret;
+}
+
+bool AvcCodecAutotuner::GetSettings(const std::string& codec_name, bool encoder, int width, int height,
+                                    AvcCodecThreadSettings& settings) const {
+  std::lock_guard<std::mutex> lock(settings_mutex_);
+  auto it = settings_.find(Key(codec_name, encoder, GetResolutionBucket(width, height), hardware_threads_));
+  if (it == settings_.end())
+    return false;
+
+  settings = it->second;
+  return true;
+}
+
+int AvcCodecAutotuner::Apply(AVCodecContext* codec_context, bool encoder) {
+  if (!codec_context)
+    return AVERROR(EINVAL);
+
+  auto d = avc_module_provider_->d();
+  const AVCodec* codec = d->AVCodecContextGetCodec(codec_context);
+  if (!codec)
+    return AVERROR(EINVAL);
+
+  const char* codec_name = d->AVCodecGetName(codec);
+  int width = d->AVCodecContextGetWidth(codec_context);
+  int height = d->AVCodecContextGetHeight(codec_context);
+
+  AvcCodecThreadSettings settings;
+  if (!GetSettings(codec_name, encoder, width, height, settings)) {
+    if (!config_.calibrate_on_miss_)
+      return AVERROR(ENOENT);
+
+    // decoders are calibrated on output of default encoder of their codec
+    const AVCodec* encoder_codec = encoder ? codec : avc_module_provider_->avcodec_find_encoder(d->AVCodecGetId(codec));
+    int pix_fmt = encoder ? d->AVCodecContextGetPixFmt(codec_context) : AV_PIX_FMT_NONE;
+    if (!encoder_codec || Calibrate(d->AVCodecGetName(encoder_codec), width, height, pix_fmt) < 0 ||
+        !GetSettings(codec_name, encoder, width, height, settings))
+      return AVERROR(ENOENT);
+  }
+
+  d->AVCodecContextSetThreadCount(codec_context, settings.thread_count_);
+  if (settings.thread_type_ != 0)
+    d->AVCodecContextSetThreadType(codec_context, settings.thread_type_);
+  if (encoder && settings.slices_ > 0)
+    d->AVCodecContextSetSlices(codec_context, settings.slices_);
+  return 0;
+}
+
+int AvcCodecAutotuner::Load(const std::string& url) {
+  FILE* file = fopen(url.c_str(), "r");
+  if (!file)
+    return AVERROR(ENOENT);
+
+  char magic[sizeof(kSettingsMagic)] = {};
+  int version = 0;
+  if (fscanf(file, "%7s %d", magic, &version) != 2 || strcmp(magic, kSettingsMagic) != 0 ||
+      version != kSettingsVersion) {
+    fclose(file);
+    return AVERROR_INVALIDDATA;
+  }
+
+  // entries are parsed before settings are locked, broken file does not change settings
+  std::vector<std::pair<Key, AvcCodecThreadSettings>> entries;
+  int ret = 0;
+  for (;;) {
+    char name[kMaxCodecNameSize + 1] = {};
+    int encoder = 0, bucket = 0, threads = 0;
+    AvcCodecThreadSettings settings;
+    int fields = fscanf(file, "%127s %d %d %d %d %d %d %lf", name, &encoder, &bucket, &threads,
+                        &settings.thread_count_, &settings.thread_type_, &settings.slices_,
+                        &settings.frames_per_second_);
+    if (fields == EOF)
+      break;
+    if (fields != 8 || settings.thread_count_ <= 0 || threads <= 0) {
+      ret = AVERROR_INVALIDDATA;
+      break;
+    }
+    entries.emplace_back(Key(name, encoder != 0, bucket, threads), settings);
+  }
+  fclose(file);
+
+  if (ret < 0) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcCodecAutotuner: settings file %s is broken\n", url.c_str());
+#endif //DEBUG_PRINT
+    return ret;
+  }
+
+  std::lock_guard<std::mutex> lock(settings_mutex_);
+  for (auto& entry : entries)
+    settings_[entry.first] = entry.second;
+  return 0;
+}
+
+int AvcCodecAutotuner::Save(const std::string& url) const {
+  std::map<Key, AvcCodecThreadSettings> settings;
+  {
+    std::lock_guard<std::mutex> lock(settings_mutex_);
+    settings = settings_;
+  }
+
+  FILE* file = fopen(url.c_str(), "w");
+  if (!file)
+    return AVERROR(errno ? errno : EIO);
+
+  // one entry per line: codec name, encoder, resolution bucket, hardware threads, thread count, type, slices, fps
+  bool ok = fprintf(file, "%s %d\n", kSettingsMagic, kSettingsVersion) > 0;
+  for (auto it = settings.begin(); ok && it != settings.end(); ++it) {
+    ok = fprintf(file, "%s %d %d %d %d %d %d %.2f\n", std::get<0>(it->first).c_str(), std::get<1>(it->first) ? 1 : 0,
+                 std::get<2>(it->first), std::get<3>(it->first), it->second.thread_count_, it->second.thread_type_,
+                 it->second.slices_, it->second.frames_per_second_) > 0;
+  }
+
+  if (fclose(file) != 0)
+    ok = false;
+
+  if (!ok) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcCodecAutotuner: cannot write settings %s\n", url.c_str());
+#endif //DEBUG_PRINT
+    remove(url.c_str());
+    return AVERROR(EIO);
+  }
+  return 0;
+}
+
+size_t AvcCodecAutotuner::GetSettingsCount() const {
+  std::lock_guard<std::mutex> lock(settings_mutex_);
+  return settings_.size();
+}
+
+void AvcCodecAutotuner::Clear() {
+  std::lock_guard<std::mutex> lock(settings_mutex_);
+  settings_.clear();
+}
+
+std::vector<AvcCodecAutotuner::GridPoint> AvcCodecAutotuner::MakeGrid(const AVCodec* codec, bool encoder) const {
+  int caps = avc_module_provider_->d()->AVCodecGetCapabilities(codec);
+  int max_threads = config_.max_threads_count_ > 0 ? config_.max_threads_count_ : hardware_threads_;
+
+  // 1, 2, 4 ... and max_threads
+  std::vector<int> counts;
+  for (int count = 2; count < max_threads; count *= 2)
+    counts.push_back(count);
+  if (max_threads > 1)
+    counts.push_back(max_threads);
+
+  std::vector<GridPoint> grid;
+  grid.push_back(GridPoint{ 1, 0, 0 });
+  for (int count : counts) {
+    if (caps & AV_CODEC_CAP_FRAME_THREADS)
+      grid.push_back(GridPoint{ count, FF_THREAD_FRAME, 0 });
+    if (caps & AV_CODEC_CAP_SLICE_THREADS) {
+      grid.push_back(GridPoint{ count, FF_THREAD_SLICE, 0 });
+      if (encoder)
+        grid.push_back(GridPoint{ count, FF_THREAD_SLICE, count });
+    }
+    // external libraries (libx264, libx265, libdav1d) thread internally, only count matters
+    if ((caps & (AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS)) == 0 && (caps & AV_CODEC_CAP_OTHER_THREADS))
+      grid.push_back(GridPoint{ count, 0, 0 });
+  }
+  return grid;
+}
+
+AVCodecContext* AvcCodecAutotuner::OpenCodec(const AVCodec* codec, bool encoder, int width, int height, int pix_fmt,
+                                             const GridPoint& point) const {
+  AVCodecContext* codec_context = avc_module_provider_->avcodec_alloc_context3(codec);
+  if (!codec_context)
+    return nullptr;
+
+  auto d = avc_module_provider_->d();
+  d->AVCodecContextSetWidth(codec_context, width);
+  d->AVCodecContextSetHeight(codec_context, height);
+  if (encoder) {
+    d->AVCodecContextSetPixFmt(codec_context, pix_fmt);
+    d->AVCodecContextSetTimeBase(codec_context, cmf::MediaTimeBase(1, kCalibrationFrameRate));
+    d->AVCodecContextSetFrameRate(codec_context, cmf::MediaTimeBase(kCalibrationFrameRate, 1));
+    d->AVCodecContextSetGopSize(codec_context, kCalibrationFrameRate);
+  }
+
+  d->AVCodecContextSetThreadCount(codec_context, point.thread_count_);
+  if (point.thread_type_ != 0)
+    d->AVCodecContextSetThreadType(codec_context, point.thread_type_);
+  if (point.slices_ > 0)
+    d->AVCodecContextSetSlices(codec_context, point.slices_);
+
+  if (avc_module_provider_->avcodec_open2(codec_context, codec, nullptr) < 0)
+    avc_module_provider_->avcodec_free_context(&codec_context);
+  return codec_context;
+}
+
+int AvcCodecAutotuner::MakeFrames(int width, int height, int pix_fmt, std::vector<AVFrame*>& frames) const {
+  int image_size = avc_module_provider_->av_image_get_buffer_size(pix_fmt, width, height, 1);
+  if (image_size <= 0)
+    return image_size < 0 ? image_size : AVERROR(EINVAL);
+
+  // packed layout with align 1 gives row count of every plane
+  std::vector<uint8_t> image(static_cast<size_t>(image_size));
+  uint8_t* planes[4] = {};
+  int linesizes[4] = {};
+  int ret = avc_module_provider_->av_image_fill_arrays(planes, linesizes, image.data(), pix_fmt, width, height, 1);
+  if (ret < 0)
+    return ret;
+
+  auto d = avc_module_provider_->d();
+  int planes_count = std::min(avc_module_provider_->av_pix_fmt_count_planes(pix_fmt), 4);
+  uint32_t seed = 1;
+  for (int i = 0; i < kCalibrationPatterns; i++) {
+    AVFrame* frame = avc_module_provider_->av_frame_alloc();
+    if (!frame)
+      return AVERROR(ENOMEM);
+
+    frames.push_back(frame);
+    d->AVFrameSetFormat(frame, pix_fmt);
+    d->AVFrameSetWidth(frame, width);
+    d->AVFrameSetHeight(frame, height);
+    ret = avc_module_provider_->av_frame_get_buffer(frame, 0);
+    if (ret < 0)
+      return ret;
+
+    for (int plane = 0; plane < planes_count; plane++) {
+      if (!planes[plane] || linesizes[plane] <= 0)
+        continue;
+
+      const uint8_t* plane_end = plane + 1 < planes_count && planes[plane + 1] ? planes[plane + 1] :
+                                 image.data() + image.size();
+      int rows = static_cast<int>((plane_end - planes[plane]) / linesizes[plane]);
+      FillPattern(planes[plane], linesizes[plane], rows, i, seed);
+
+      uint8_t* data = d->AVFrameGetData(frame, plane);
+      int linesize = d->AVFrameGetLineSize(frame, plane);
+      for (int y = 0; data && y < rows; y++)
+        memcpy(data + static_cast<size_t>(y) * linesize, planes[plane] + static_cast<size_t>(y) * linesizes[plane],
+               static_cast<size_t>(std::min(linesize, linesizes[plane])));
+    }
+  }
+  return 0;
+}
+
+double AvcCodecAutotuner::RunEncoder(AVCodecContext* encoder_context, const std::vector<AVFrame*>& frames,
+                                     std::vector<AVPacket*>* packets) const {
+  AVPacket* packet = avc_module_provider_->av_packet_alloc();
+  if (!packet)
+    return 0;
+
+  auto d = avc_module_provider_->d();
+  auto start = std::chrono::steady_clock::now();
+  int frames_count = config_.calibration_frames_;
+  int ret = 0;
+  for (int i = 0; ret >= 0 && i <= frames_count; i++) {
+    AVFrame* frame = nullptr;
+    if (i < frames_count) {
+      frame = frames[static_cast<size_t>(i) % frames.size()];
+      d->AVFrameSetPts(frame, i);  // encoder takes reference with properties at send
+    }
+
+    ret = avc_module_provider_->avcodec_send_frame(encoder_context, frame);  // null frame drains encoder
+    while (ret >= 0) {
+      ret = avc_module_provider_->avcodec_receive_packet(encoder_context, packet);
+      if (ret < 0)
+        break;
+
+      AVPacket* kept = packets ? avc_module_provider_->av_packet_alloc() : nullptr;
+      if (kept) {
+        avc_module_provider_->av_packet_move_ref(kept, packet);
+        packets->push_back(kept);
+      } else {
+        avc_module_provider_->av_packet_unref(packet);
+      }
+    }
+    if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF)
+      ret = 0;
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  avc_module_provider_->av_packet_free(&packet);
+  if (ret < 0) {
+    if (packets) {
+      for (AVPacket* kept : *packets)
+        avc_module_provider_->av_packet_free(&kept);
+      packets->clear();
+    }
+    return 0;
+  }
+  return frames_count / std::max(seconds, 1e-6);
+}
+
+double AvcCodecAutotuner::RunDecoder(AVCodecContext* decoder_context, const std::vector<AVPacket*>& packets) const {
+  AVFrame* frame = avc_module_provider_->av_frame_alloc();
+  if (!frame)
+    return 0;
+
+  auto start = std::chrono::steady_clock::now();
+  int frames_decoded = 0;
+  int ret = 0;
+  for (size_t i = 0; ret >= 0 && i <= packets.size(); i++) {
+    // decoder references packet data, same packets are sent to every grid point
+    ret = avc_module_provider_->avcodec_send_packet(decoder_context, i < packets.size() ? packets[i] : nullptr);
+    while (ret >= 0) {
+      ret = avc_module_provider_->avcodec_receive_frame(decoder_context, frame);
+      if (ret < 0)
+        break;
+
+      frames_decoded++;
+      avc_module_provider_->av_frame_unref(frame);
+    }
+    if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF)
+      ret = 0;
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  avc_module_provider_->av_frame_free(&frame);
+  return ret < 0 ? 0 : frames_decoded / std::max(seconds, 1e-6);
+}
+
+void AvcCodecAutotuner::Store(const Key& key, const AvcCodecThreadSettings& settings) {
+  std::lock_guard<std::mutex> lock(settings_mutex_);
+  settings_[key] = settings;
+}
+
+}  // namespace detail
+}//namespace avc
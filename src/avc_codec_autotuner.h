@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_CODEC_AUTOTUNER_HEADER
+#define AVC_CODEC_AUTOTUNER_HEADER
+
+#include <avc/i_avc_codec_autotuner.h>
+#include <avc/i_avc_module_provider.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcCodecAutotuner
+  : public virtual IAvcCodecAutotuner {
+ public:
+  AvcCodecAutotuner(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcCodecAutotunerConfig& config);
+  virtual ~AvcCodecAutotuner() = default;
+
+  int Calibrate(const std::string& encoder_name, int width, int height, int pix_fmt = -1) override;
+  bool GetSettings(const std::string& codec_name, bool encoder, int width, int height,
+                   AvcCodecThreadSettings& settings) const override;
+  int Apply(AVCodecContext* codec_context, bool encoder) override;
+
+  int Load(const std::string& url) override;
+  int Save(const std::string& url) const override;
+  size_t GetSettingsCount() const override;
+  void Clear() override;
+
+  /// \brief 0: up to 640x360, 1: 720p, 2: 1080p, 3: 1440p, 4: 2160p, 5: larger
+  static int GetResolutionBucket(int width, int height);
+
+ private:
+  /// \brief codec name, encoder, resolution bucket, hardware threads count
+  typedef std::tuple<std::string, bool, int, int> Key;
+
+  struct GridPoint {
+    int thread_count_;
+    int thread_type_;
+    int slices_;
+  };
+
+  std::vector<GridPoint> MakeGrid(const AVCodec* codec, bool encoder) const;
+  AVCodecContext* OpenCodec(const AVCodec* codec, bool encoder, int width, int height, int pix_fmt,
+                            const GridPoint& point) const;
+  int MakeFrames(int width, int height, int pix_fmt, std::vector<AVFrame*>& frames) const;
+  /// \brief Returns frames per second, packets are kept when not null
+  double RunEncoder(AVCodecContext* encoder_context, const std::vector<AVFrame*>& frames,
+                    std::vector<AVPacket*>* packets) const;
+  double RunDecoder(AVCodecContext* decoder_context, const std::vector<AVPacket*>& packets) const;
+  void Store(const Key& key, const AvcCodecThreadSettings& settings);
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AvcCodecAutotunerConfig config_;
+  int hardware_threads_;
+
+  std::mutex calibration_mutex_;      ///< one calibration at a time, parallel runs would spoil measurements
+  mutable std::mutex settings_mutex_;
+  std::map<Key, AvcCodecThreadSettings> settings_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_CODEC_AUTOTUNER_HEADER
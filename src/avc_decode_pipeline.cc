@@ -0,0 +1,582 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_decode_pipeline.h"
+#include "avc_numa_topology.h"
+#include <avc/libav_detached_common.h>
+#include <cerrno>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+
+std::shared_ptr<IAvcDecodePipeline> API_EXPORT CreateAvcDecodePipeline(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const std::string& url,
+  const AvcDecodePipelineConfig& config) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  auto pipeline = std::make_shared<avc::detail::AvcDecodePipeline>(avc_module_provider, config);
+  if (pipeline->Open(url) < 0)
+    return nullptr;
+
+  return pipeline;
+}
+
+namespace detail {
+
+AvcDecodePipeline::StreamDecoder::StreamDecoder(size_t packet_queue_depth, size_t frame_queue_depth)
+  : packets_(packet_queue_depth + 1)
+  , free_packets_(packet_queue_depth)
+  , frames_(frame_queue_depth + 1)
+  , free_frames_(frame_queue_depth) {
+}
+
+AvcDecodePipeline::AvcDecodePipeline(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcDecodePipelineConfig& config)
+  : avc_module_provider_(avc_module_provider)
+  , config_(config)
+  , input_(avc_module_provider) {
+  if (config_.packet_queue_depth_ < 1)
+    config_.packet_queue_depth_ = 1;
+  if (config_.frame_queue_depth_ < 1)
+    config_.frame_queue_depth_ = 1;
+}
+
+AvcDecodePipeline::~AvcDecodePipeline() {
+  Stop();
+
+  for (auto& decoder : decoders_) {
+    for (AVPacket* packet : decoder->all_packets_)
+      avc_module_provider_->av_packet_free(&packet);
+    for (AVFrame* frame : decoder->all_frames_)
+      avc_module_provider_->av_frame_free(&frame);
+    if (decoder->pooled_) {
+      // context after decoding error may keep broken state, it is not given to next clip
+      bool reusable = !decoder->failed_ && decoder->decoder_error_.load(std::memory_order_acquire) == 0;
+      config_.decoder_pool_->Release(decoder->codec_context_, reusable);
+    } else {
+      avc_module_provider_->avcodec_free_context(&decoder->codec_context_);
+    }
+  }
+  decoders_.clear();
+}
+
+int AvcDecodePipeline::Open(const std::string& url) {
+  const AvcLowLatencyConfig* low_latency = config_.low_latency_ ? &config_.low_latency_config_ : nullptr;
+  int ret = input_.Open(url, nullptr, true, low_latency);
+  if (ret < 0)
+    return ret;
+
+  int streams_count = input_.GetStreamsCount();
+  std::vector<int> stream_indexes = config_.stream_indexes_;
+  bool auto_select = stream_indexes.empty();
+  if (auto_select) {
+    for (int i = 0; i < streams_count; i++) {
+      int media_type = input_.GetStreamMediaType(i);
+      if (media_type == AVMEDIA_TYPE_VIDEO || media_type == AVMEDIA_TYPE_AUDIO)
+        stream_indexes.push_back(i);
+    }
+  }
+
+  stream_to_decoder_.assign(streams_count, -1);
+  for (int stream_index : stream_indexes) {
+    if (stream_index < 0 || stream_index >= streams_count)
+      return AVERROR_STREAM_NOT_FOUND;
+
+    if (stream_to_decoder_[stream_index] >= 0)
+      continue;
+
+    std::unique_ptr<StreamDecoder> decoder(new StreamDecoder(config_.packet_queue_depth_, config_.frame_queue_depth_));
+    decoder->stream_index_ = stream_index;
+    if (config_.decoder_pool_ && !low_latency) {
+      // short clips with same codec parameters skip decoder opening
+      auto d = avc_module_provider_->d();
+      decoder->codec_context_ = config_.decoder_pool_->Acquire(d->AVStreamGetCodecPar(input_.GetStream(stream_index)),
+                                                               input_.GetStreamTimeBase(stream_index));
+      decoder->pooled_ = decoder->codec_context_ != nullptr;
+    } else {
+      decoder->codec_context_ = input_.OpenDecoder(stream_index, config_.decoder_threads_, nullptr, 0, low_latency,
+                                                   config_.codec_autotuner_.get());
+    }
+    if (!decoder->codec_context_) {
+      // streams without decoder are skipped when selected automatically
+      if (auto_select)
+        continue;
+      return AVERROR_DECODER_NOT_FOUND;
+    }
+
+    ret = AllocateStream(*decoder);
+    stream_to_decoder_[stream_index] = static_cast<int>(decoders_.size());
+    decoders_.push_back(std::move(decoder));
+    if (ret < 0)
+      return ret;
+  }
+
+  if (decoders_.empty())
+    return AVERROR_STREAM_NOT_FOUND;
+
+  // demuxer does not produce packets for discarded streams, so nothing is read into packet and copied
+  auto d = avc_module_provider_->d();
+  for (int i = 0; i < streams_count; i++)
+    if (stream_to_decoder_[i] < 0)
+      d->AVStreamSetDiscard(input_.GetStream(i), AVDISCARD_ALL);
+
+  for (auto& decoder : decoders_)
+    decoder->thread_ = std::thread(&AvcDecodePipeline::DecoderThread, this, decoder.get());
+
+  demuxer_thread_ = std::thread(&AvcDecodePipeline::DemuxerThread, this);
+  return 0;
+}
+
+int AvcDecodePipeline::AllocateStream(StreamDecoder& decoder) {
+  for (size_t i = 0; i < config_.packet_queue_depth_; i++) {
+    AVPacket* packet = avc_module_provider_->av_packet_alloc();
+    if (!packet)
+      return AVERROR(ENOMEM);
+
+    decoder.all_packets_.push_back(packet);
+    decoder.free_packets_.TryPush(packet);
+  }
+
+  for (size_t i = 0; i < config_.frame_queue_depth_; i++) {
+    AVFrame* frame = avc_module_provider_->av_frame_alloc();
+    if (!frame)
+      return AVERROR(ENOMEM);
+
+    decoder.all_frames_.push_back(frame);
+    decoder.free_frames_.TryPush(frame);
+  }
+  return 0;
+}
+
+void AvcDecodePipeline::Stop() {
+  stop_.store(true, std::memory_order_release);
+
+  demuxer_waiter_.Notify();
+  caller_waiter_.Notify();
+  for (auto& decoder : decoders_) {
+    decoder->waiter_.Notify();
+    decoder->consumer_waiter_.Notify();
+  }
+
+  if (demuxer_thread_.joinable())
+    demuxer_thread_.join();
+
+  for (auto& decoder : decoders_)
+    if (decoder->thread_.joinable())
+      decoder->thread_.join();
+}
+
+int AvcDecodePipeline::ReceiveFrame(AVFrame* dst, int* stream_index) {
+  while (true) {
+    int ret = PopReadyFrame(dst, stream_index);
+    if (ret != AVERROR(EAGAIN))
+      return ret;
+
+    caller_waiter_.Wait([this] { return IsStopped() || IsFrameReady(); });
+  }
+}
+
+int AvcDecodePipeline::TryReceiveFrame(AVFrame* dst, int* stream_index) {
+  return PopReadyFrame(dst, stream_index);
+}
+
+int AvcDecodePipeline::ReceiveStreamFrame(int stream_index, AVFrame* dst) {
+  StreamDecoder* decoder = GetDecoder(stream_index);
+  if (!decoder)
+    return AVERROR(EINVAL);
+
+  while (true) {
+    int ret = PopStreamFrame(decoder, dst);
+    if (ret != AVERROR(EAGAIN))
+      return ret;
+
+    decoder->consumer_waiter_.Wait([this, decoder] { return IsStopped(decoder) || !decoder->frames_.IsEmpty(); });
+  }
+}
+
+int AvcDecodePipeline::TryReceiveStreamFrame(int stream_index, AVFrame* dst) {
+  StreamDecoder* decoder = GetDecoder(stream_index);
+  if (!decoder)
+    return AVERROR(EINVAL);
+
+  return PopStreamFrame(decoder, dst);
+}
+
+int AvcDecodePipeline::PopStreamFrame(StreamDecoder* decoder, AVFrame* dst) {
+  if (IsStopped())
+    return AVERROR_EXIT;
+
+  if (!dst)
+    return AVERROR(EINVAL);
+
+  if (decoder->finished_ || !decoder->subscribed_.load(std::memory_order_acquire))
+    return AVERROR_EOF;
+
+  AVFrame* frame = nullptr;
+  if (!decoder->frames_.TryPop(frame))
+    return AVERROR(EAGAIN);
+
+  if (!frame) {
+    decoder->finished_ = true;
+    int decoder_error = decoder->decoder_error_.load(std::memory_order_acquire);
+    if (decoder_error < 0)
+      return decoder_error;
+
+    int demuxer_error = demuxer_error_.load(std::memory_order_acquire);
+    return demuxer_error < 0 ? demuxer_error : AVERROR_EOF;
+  }
+
+  avc_module_provider_->av_frame_move_ref(dst, frame);
+  decoder->free_frames_.TryPush(frame);
+  decoder->waiter_.Notify();
+  if (config_.latency_tracer_)
+    config_.latency_tracer_->OnFrameOut(decoder->stream_index_, dst);
+
+  frames_received_.fetch_add(1, std::memory_order_relaxed);
+  return 0;
+}
+
+int AvcDecodePipeline::Unsubscribe(int stream_index) {
+  StreamDecoder* decoder = GetDecoder(stream_index);
+  if (!decoder)
+    return AVERROR(EINVAL);
+
+  decoder->subscribed_.store(false, std::memory_order_release);
+  subscription_changed_.store(true, std::memory_order_release);
+
+  demuxer_waiter_.Notify();
+  decoder->waiter_.Notify();
+  decoder->consumer_waiter_.Notify();
+  caller_waiter_.Notify();
+  return 0;
+}
+
+AvcDecodePipeline::StreamDecoder* AvcDecodePipeline::GetDecoder(int stream_index) const {
+  if (stream_index < 0 || stream_index >= static_cast<int>(stream_to_decoder_.size()))
+    return nullptr;
+
+  int decoder_index = stream_to_decoder_[stream_index];
+  return decoder_index < 0 ? nullptr : decoders_[decoder_index].get();
+}
+
+int AvcDecodePipeline::PopReadyFrame(AVFrame* dst, int* stream_index) {
+  if (IsStopped())
+    return AVERROR_EXIT;
+
+  if (!dst)
+    return AVERROR(EINVAL);
+
+  // round robin over decoders, so one fast stream does not starve others
+  size_t count = decoders_.size();
+  bool all_finished = true;
+  for (size_t i = 0; i < count; i++) {
+    size_t idx = (next_decoder_ + i) % count;
+    StreamDecoder* decoder = decoders_[idx].get();
+    if (decoder->finished_)
+      continue;
+
+    AVFrame* frame = nullptr;
+    if (!decoder->frames_.TryPop(frame)) {
+      all_finished = false;
+      continue;
+    }
+
+    if (!frame) {
+      decoder->finished_ = true;
+      int decoder_error = decoder->decoder_error_.load(std::memory_order_acquire);
+      if (decoder_error < 0 && decoder->subscribed_.load(std::memory_order_acquire)) {
+        // error is reported once, other streams are decoded further
+        if (stream_index)
+          *stream_index = decoder->stream_index_;
+        return decoder_error;
+      }
+      continue;
+    }
+
+    if (!decoder->subscribed_.load(std::memory_order_acquire)) {
+      // frames decoded before unsubscribe are dropped
+      avc_module_provider_->av_frame_unref(frame);
+      decoder->free_frames_.TryPush(frame);
+      decoder->waiter_.Notify();
+      all_finished = false;
+      continue;
+    }
+
+    avc_module_provider_->av_frame_move_ref(dst, frame);
+    decoder->free_frames_.TryPush(frame);
+    decoder->waiter_.Notify();
+    if (config_.latency_tracer_)
+      config_.latency_tracer_->OnFrameOut(decoder->stream_index_, dst);
+
+    next_decoder_ = (idx + 1) % count;
+    frames_received_.fetch_add(1, std::memory_order_relaxed);
+    if (stream_index)
+      *stream_index = decoder->stream_index_;
+    return 0;
+  }
+
+  if (!all_finished)
+    return AVERROR(EAGAIN);
+
+  int demuxer_error = demuxer_error_.load(std::memory_order_acquire);
+  return demuxer_error < 0 ? demuxer_error : AVERROR_EOF;
+}
+
+bool AvcDecodePipeline::IsFrameReady() const {
+  for (auto& decoder : decoders_)
+    if (!decoder->finished_ && !decoder->frames_.IsEmpty())
+      return true;
+
+  return false;
+}
+
+void AvcDecodePipeline::NotifyFrameReady(StreamDecoder* decoder) {
+  caller_waiter_.Notify();
+  decoder->consumer_waiter_.Notify();
+}
+
+void AvcDecodePipeline::ApplyDiscard() {
+  if (!subscription_changed_.exchange(false, std::memory_order_acq_rel))
+    return;
+
+  // AVStream is changed only on demuxer thread, it is read by av_read_frame
+  auto d = avc_module_provider_->d();
+  for (auto& decoder : decoders_) {
+    if (!decoder->discarded_ && IsStopped(decoder.get())) {
+      d->AVStreamSetDiscard(input_.GetStream(decoder->stream_index_), AVDISCARD_ALL);
+      decoder->discarded_ = true;
+    }
+  }
+}
+
+void AvcDecodePipeline::BindThread() const {
+  if (config_.numa_node_ >= 0)
+    AvcNumaTopology::Instance().BindCurrentThreadToNode(config_.numa_node_);
+}
+
+void AvcDecodePipeline::DemuxerThread() {
+  BindThread();
+
+  auto d = avc_module_provider_->d();
+  AVPacket* packet = avc_module_provider_->av_packet_alloc();
+  int ret = packet ? 0 : AVERROR(ENOMEM);
+
+  while (ret >= 0 && !IsStopped()) {
+    ApplyDiscard();
+
+    ret = avc_module_provider_->av_read_frame(input_.GetFormatContext(), packet);
+    if (ret < 0)
+      break;
+
+    if (config_.latency_tracer_)
+      config_.latency_tracer_->StampPacket(packet);
+
+    packets_read_.fetch_add(1, std::memory_order_relaxed);
+
+    int stream_index = d->AVPacketGetStreamIndex(packet);
+    int decoder_index = (stream_index >= 0 && stream_index < static_cast<int>(stream_to_decoder_.size()))
+      ? stream_to_decoder_[stream_index] : -1;
+    if (decoder_index < 0) {
+      packets_dropped_.fetch_add(1, std::memory_order_relaxed);
+      avc_module_provider_->av_packet_unref(packet);
+      continue;
+    }
+
+    StreamDecoder* decoder = decoders_[decoder_index].get();
+    AVPacket* queued_packet = nullptr;
+    while (!decoder->free_packets_.TryPop(queued_packet)) {
+      if (IsStopped(decoder))
+        break;
+
+      demuxer_waits_.fetch_add(1, std::memory_order_relaxed);
+      demuxer_waiter_.Wait([this, decoder] { return IsStopped(decoder) || !decoder->free_packets_.IsEmpty(); });
+    }
+
+    if (!queued_packet) {
+      // stopped, or stream was unsubscribed while demuxer waited
+      packets_dropped_.fetch_add(1, std::memory_order_relaxed);
+      avc_module_provider_->av_packet_unref(packet);
+      if (IsStopped())
+        break;
+      continue;
+    }
+
+    avc_module_provider_->av_packet_move_ref(queued_packet, packet);
+    decoder->packets_.TryPush(queued_packet);  // never full, queue has room for all packets and end marker
+    decoder->waiter_.Notify();
+  }
+
+  if (ret < 0 && ret != AVERROR_EOF) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcDecodePipeline: demuxer error %d\n", ret);
+#endif //DEBUG_PRINT
+    demuxer_error_.store(ret, std::memory_order_release);
+  }
+
+  avc_module_provider_->av_packet_free(&packet);
+
+  for (auto& decoder : decoders_) {
+    decoder->packets_.TryPush(nullptr);
+    decoder->waiter_.Notify();
+  }
+}
+
+void AvcDecodePipeline::DecoderThread(StreamDecoder* decoder) {
+  BindThread();
+
+  // frame taken from free queue and not filled by decoder yet
+  AVFrame* spare_frame = nullptr;
+
+  while (!IsStopped(decoder)) {
+    AVPacket* packet = nullptr;
+    if (!decoder->packets_.TryPop(packet)) {
+      decoder->waiter_.Wait([this, decoder] { return IsStopped(decoder) || !decoder->packets_.IsEmpty(); });
+      continue;
+    }
+
+    // null packet flushes decoder, flush is not needed when stream is unsubscribed
+    if (!packet && IsStopped(decoder))
+      break;
+
+    int ret = 0;
+    int drain_ret = 0;
+    while (true) {
+      ret = avc_module_provider_->avcodec_send_packet(decoder->codec_context_, packet);
+      if (ret != AVERROR(EAGAIN))
+        break;
+
+      // decoder output is full, frames must be received before packet is accepted
+      drain_ret = DrainDecoder(decoder, spare_frame);
+      if (drain_ret < 0)
+        break;
+    }
+
+    if (packet) {
+      avc_module_provider_->av_packet_unref(packet);
+      decoder->free_packets_.TryPush(packet);
+      demuxer_waiter_.Notify();
+    }
+
+    if (drain_ret == 0) {
+      if (ret < 0 && ret != AVERROR_EOF) {
+#if DEBUG_PRINT
+        fprintf(stderr, "AvcDecodePipeline: avcodec_send_packet error %d stream %d, packet skipped\n", ret, decoder->stream_index_);
+#endif //DEBUG_PRINT
+        decoder->failed_ = true;
+      }
+
+      drain_ret = DrainDecoder(decoder, spare_frame);
+    }
+
+    // decoding error ends stream, caller receives it instead of AVERROR_EOF
+    if (drain_ret < 0 && drain_ret != AVERROR_EOF && drain_ret != AVERROR_EXIT) {
+      // stream is discarded by demuxer like unsubscribed one
+      decoder->decoder_error_.store(drain_ret, std::memory_order_release);
+      subscription_changed_.store(true, std::memory_order_release);
+      demuxer_waiter_.Notify();
+      break;
+    }
+
+    if (drain_ret == AVERROR_EXIT || !packet)
+      break;
+  }
+
+  decoder->frames_.TryPush(nullptr);
+  NotifyFrameReady(decoder);
+}
+
+int AvcDecodePipeline::DrainDecoder(StreamDecoder* decoder, AVFrame*& spare_frame) {
+  while (true) {
+    if (!spare_frame && !decoder->free_frames_.TryPop(spare_frame)) {
+      if (IsStopped(decoder))
+        return AVERROR_EXIT;
+
+      decoder_waits_.fetch_add(1, std::memory_order_relaxed);
+      decoder->waiter_.Wait([this, decoder] { return IsStopped(decoder) || !decoder->free_frames_.IsEmpty(); });
+      continue;
+    }
+
+    int ret = avc_module_provider_->avcodec_receive_frame(decoder->codec_context_, spare_frame);
+    if (ret == AVERROR(EAGAIN))
+      return 0;
+
+    if (ret < 0) {
+#if DEBUG_PRINT
+      if (ret != AVERROR_EOF)
+        fprintf(stderr, "AvcDecodePipeline: avcodec_receive_frame error %d stream %d\n", ret, decoder->stream_index_);
+#endif //DEBUG_PRINT
+      return ret;
+    }
+
+    frames_decoded_.fetch_add(1, std::memory_order_relaxed);
+    decoder->frames_.TryPush(spare_frame);  // never full, queue has room for all frames and end marker
+    spare_frame = nullptr;
+    NotifyFrameReady(decoder);
+  }
+}
+
+std::vector<int> AvcDecodePipeline::GetStreamIndexes() const {
+  std::vector<int> stream_indexes;
+  for (auto& decoder : decoders_)
+    stream_indexes.push_back(decoder->stream_index_);
+  return stream_indexes;
+}
+
+int AvcDecodePipeline::GetStreamMediaType(int stream_index) const {
+  return input_.GetStreamMediaType(stream_index);
+}
+
+cmf::MediaTimeBase AvcDecodePipeline::GetStreamTimeBase(int stream_index) const {
+  return input_.GetStreamTimeBase(stream_index);
+}
+
+AvcDecodePipelineStatistics AvcDecodePipeline::GetStatistics() const {
+  AvcDecodePipelineStatistics stat;
+  stat.packets_read_ = packets_read_.load(std::memory_order_relaxed);
+  stat.packets_dropped_ = packets_dropped_.load(std::memory_order_relaxed);
+  stat.frames_decoded_ = frames_decoded_.load(std::memory_order_relaxed);
+  stat.frames_received_ = frames_received_.load(std::memory_order_relaxed);
+  stat.demuxer_waits_ = demuxer_waits_.load(std::memory_order_relaxed);
+  stat.decoder_waits_ = decoder_waits_.load(std::memory_order_relaxed);
+  return stat;
+}
+
+}  // namespace detail
+}//namespace avc
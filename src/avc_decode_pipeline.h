@@ -0,0 +1,129 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_DECODE_PIPELINE_HEADER
+#define AVC_DECODE_PIPELINE_HEADER
+
+#include <avc/i_avc_decode_pipeline.h>
+#include <avc/i_avc_module_provider.h>
+#include "avc_media_input.h"
+#include "avc_spsc_queue.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcDecodePipeline
+  : public virtual IAvcDecodePipeline {
+ public:
+  AvcDecodePipeline(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcDecodePipelineConfig& config);
+  virtual ~AvcDecodePipeline();
+
+  int Open(const std::string& url);
+
+  int ReceiveFrame(AVFrame* dst, int* stream_index) override;
+  int TryReceiveFrame(AVFrame* dst, int* stream_index) override;
+  int ReceiveStreamFrame(int stream_index, AVFrame* dst) override;
+  int TryReceiveStreamFrame(int stream_index, AVFrame* dst) override;
+  int Unsubscribe(int stream_index) override;
+  void Stop() override;
+
+  std::vector<int> GetStreamIndexes() const override;
+  int GetStreamMediaType(int stream_index) const override;
+  cmf::MediaTimeBase GetStreamTimeBase(int stream_index) const override;
+
+  AvcDecodePipelineStatistics GetStatistics() const override;
+
+ private:
+  // null packet or frame in queue marks end of stream
+  struct StreamDecoder {
+    StreamDecoder(size_t packet_queue_depth, size_t frame_queue_depth);
+
+    int stream_index_ = -1;
+    AVCodecContext* codec_context_ = nullptr;
+    bool pooled_ = false;  // codec_context_ is returned to decoder pool
+    bool failed_ = false;  // avcodec_send_packet failed, decoder thread side
+
+    AvcSpscQueue<AVPacket*> packets_;        // demuxer -> decoder
+    AvcSpscQueue<AVPacket*> free_packets_;   // decoder -> demuxer
+    AvcSpscQueue<AVFrame*> frames_;          // decoder -> caller
+    AvcSpscQueue<AVFrame*> free_frames_;     // caller -> decoder
+    std::vector<AVPacket*> all_packets_;
+    std::vector<AVFrame*> all_frames_;
+
+    AvcThreadWaiter waiter_;
+    AvcThreadWaiter consumer_waiter_;  // stream consumer of ReceiveStreamFrame
+    std::thread thread_;
+    std::atomic<bool> subscribed_{true};
+    std::atomic<int> decoder_error_{0};  // avcodec_receive_frame error which ended stream
+    bool discarded_ = false;  // demuxer side
+    bool finished_ = false;   // caller side
+  };
+
+  int AllocateStream(StreamDecoder& decoder);
+  void DemuxerThread();
+  void DecoderThread(StreamDecoder* decoder);
+  int DrainDecoder(StreamDecoder* decoder, AVFrame*& spare_frame);
+  int PopReadyFrame(AVFrame* dst, int* stream_index);
+  int PopStreamFrame(StreamDecoder* decoder, AVFrame* dst);
+  bool IsFrameReady() const;
+  void ApplyDiscard();
+  void NotifyFrameReady(StreamDecoder* decoder);
+  StreamDecoder* GetDecoder(int stream_index) const;
+  bool IsStopped() const { return stop_.load(std::memory_order_acquire); }
+  bool IsStopped(const StreamDecoder* decoder) const {
+    return IsStopped() || !decoder->subscribed_.load(std::memory_order_acquire) ||
+      decoder->decoder_error_.load(std::memory_order_acquire) < 0;
+  }
+  void BindThread() const;
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AvcDecodePipelineConfig config_;
+  AvcMediaInput input_;
+
+  std::vector<std::unique_ptr<StreamDecoder>> decoders_;
+  std::vector<int> stream_to_decoder_;
+  size_t next_decoder_ = 0;
+
+  std::thread demuxer_thread_;
+  AvcThreadWaiter demuxer_waiter_;
+  AvcThreadWaiter caller_waiter_;
+  std::atomic<bool> stop_{false};
+  std::atomic<int> demuxer_error_{0};
+  std::atomic<bool> subscription_changed_{false};
+
+  std::atomic<uint64_t> packets_read_{0};
+  std::atomic<uint64_t> packets_dropped_{0};
+  std::atomic<uint64_t> frames_decoded_{0};
+  std::atomic<uint64_t> frames_received_{0};
+  std::atomic<uint64_t> demuxer_waits_{0};
+  std::atomic<uint64_t> decoder_waits_{0};
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_DECODE_PIPELINE_HEADER
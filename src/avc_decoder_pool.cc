@@ -0,0 +1,299 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_decoder_pool.h"
+#include <avc/libav_detached_common.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+
+namespace avc {
+
+std::shared_ptr<IAvcDecoderPool> API_EXPORT CreateAvcDecoderPool(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcDecoderPoolConfig& config) {
+  if (!avc_module_provider || !avc_module_provider->IsAvCodecLoaded())
+    return nullptr;
+
+  return std::make_shared<detail::AvcDecoderPool>(avc_module_provider, config);
+}
+
+namespace detail {
+
+bool AvcDecoderPool::Key::operator==(const Key& other) const {
+  return codec_id_ == other.codec_id_ && codec_tag_ == other.codec_tag_ && media_type_ == other.media_type_ &&
+         profile_ == other.profile_ && width_ == other.width_ && height_ == other.height_ &&
+         format_ == other.format_ && sample_rate_ == other.sample_rate_ && channels_ == other.channels_ &&
+         channel_order_ == other.channel_order_ && channel_layout_ == other.channel_layout_ &&
+         bits_per_coded_sample_ == other.bits_per_coded_sample_ && block_align_ == other.block_align_ &&
+         extradata_ == other.extradata_;
+}
+
+AvcDecoderPool::AvcDecoderPool(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcDecoderPoolConfig& config)
+  : avc_module_provider_(avc_module_provider)
+  , config_(config) {
+}
+
+AvcDecoderPool::~AvcDecoderPool() {
+  // contexts which are still in use belong to callers, they must not be released after pool is destroyed
+  FreeEntries(idle_);
+}
+
+AVCodecContext* AvcDecoderPool::Acquire(const AVCodecParameters* codecpar, cmf::MediaTimeBase pkt_time_base,
+                                        int* error) {
+  if (!codecpar) {
+    if (error)
+      *error = AVERROR(EINVAL);
+    return nullptr;
+  }
+
+  Key key = MakeKey(codecpar);
+  Entry entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stat_.acquired_++;
+    for (auto it = idle_.begin(); it != idle_.end(); ++it) {
+      if (it->key_ == key) {
+        entry = std::move(*it);
+        idle_.erase(it);
+        break;
+      }
+    }
+
+    if (entry.codec_context_)
+      stat_.reused_++;
+  }
+
+  AVCodecContext* codec_context = entry.codec_context_;
+  if (codec_context) {
+    avc_module_provider_->d()->AVCodecContextSetPktTimeBase(codec_context, pkt_time_base);
+    entry.budget_threads_ = AttachBudget(codec_context, entry.budget_threads_);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    in_use_.emplace(codec_context, std::move(entry));
+    if (error)
+      *error = 0;
+    return codec_context;
+  }
+
+  // provider starts thread budget session for automatic threading
+  std::shared_ptr<IAvcThreadBudget> budget = avc_module_provider_->GetThreadBudget();
+  bool budgeted = config_.thread_count_ == 0 && budget && budget->IsEnabled();
+
+  auto start = std::chrono::steady_clock::now();
+  codec_context = Open(codecpar, pkt_time_base, error);
+  double open_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  if (!codec_context)
+    return nullptr;
+
+  entry.key_ = std::move(key);
+  entry.codec_context_ = codec_context;
+  if (budgeted)
+    entry.budget_threads_ = std::max(avc_module_provider_->d()->AVCodecContextGetThreadCount(codec_context), 1);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  stat_.opened_++;
+  stat_.open_ms_ += open_ms;
+  in_use_.emplace(codec_context, std::move(entry));
+  return codec_context;
+}
+
+void AvcDecoderPool::Release(AVCodecContext* codec_context, bool reusable) {
+  if (!codec_context)
+    return;
+
+  Entry entry;
+  bool acquired = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = in_use_.find(codec_context);
+    if (it != in_use_.end()) {
+      entry = std::move(it->second);
+      in_use_.erase(it);
+      stat_.released_++;
+      acquired = true;
+    }
+  }
+
+  if (!acquired || !reusable || config_.max_idle_ == 0 || config_.max_idle_per_key_ == 0) {
+    avc_module_provider_->avcodec_free_context(&codec_context);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stat_.freed_++;
+    return;
+  }
+
+  // idle context leaves thread budget, so it does not shrink shares of running sessions
+  if (entry.budget_threads_ > 0) {
+    std::shared_ptr<IAvcThreadBudget> budget = avc_module_provider_->GetThreadBudget();
+    if (budget)
+      budget->StopSession(codec_context);
+  }
+
+  // drops buffered frames and draining state, waits for frame threads, so it runs outside of lock
+  avc_module_provider_->avcodec_flush_buffers(codec_context);
+
+  std::list<Entry> evicted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.push_front(std::move(entry));
+
+    // least recently released contexts over per-key limit, then over pool limit
+    const Key& released_key = idle_.front().key_;
+    size_t same_key = 0;
+    for (auto it = idle_.begin(); it != idle_.end();) {
+      auto next = std::next(it);
+      if (it->key_ == released_key && ++same_key > config_.max_idle_per_key_)
+        evicted.splice(evicted.end(), idle_, it);
+      it = next;
+    }
+
+    while (idle_.size() > config_.max_idle_)
+      evicted.splice(evicted.end(), idle_, std::prev(idle_.end()));
+    stat_.freed_ += evicted.size();
+  }
+
+  FreeEntries(evicted);
+}
+
+void AvcDecoderPool::Clear() {
+  std::list<Entry> idle;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle.swap(idle_);
+    stat_.freed_ += idle.size();
+  }
+
+  FreeEntries(idle);
+}
+
+AvcDecoderPoolStatistics AvcDecoderPool::GetStatistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AvcDecoderPoolStatistics stat = stat_;
+  stat.idle_ = idle_.size();
+  stat.in_use_ = in_use_.size();
+  return stat;
+}
+
+AvcDecoderPool::Key AvcDecoderPool::MakeKey(const AVCodecParameters* codecpar) const {
+  auto d = avc_module_provider_->d();
+  Key key;
+  key.codec_id_ = d->AVCodecParametersGetCodecId(codecpar);
+  key.codec_tag_ = d->AVCodecParametersGetCodecTag(codecpar);
+  key.media_type_ = d->AVCodecParametersGetCodecType(codecpar);
+  key.profile_ = d->AVCodecParametersGetProfile(codecpar);
+  key.width_ = d->AVCodecParametersGetWidth(codecpar);
+  key.height_ = d->AVCodecParametersGetHeight(codecpar);
+  key.format_ = d->AVCodecParametersGetFormat(codecpar);
+  key.sample_rate_ = d->AVCodecParametersGetSampleRate(codecpar);
+  key.channels_ = d->AVCodecParametersGetChannels(codecpar);
+  key.bits_per_coded_sample_ = d->AVCodecParametersGetBitsPerCodedSample(codecpar);
+  key.block_align_ = d->AVCodecParametersGetBlockAlign(codecpar);
+
+  // AVChannelLayout since 5.1, legacy bitmask before. Custom order keeps channels map instead of mask
+  key.channel_layout_ = d->AVCodecParametersGetChannelLayout(codecpar);
+  AVChannelLayout* ch_layout = d->AVCodecParametersGetChLayout(const_cast<AVCodecParameters*>(codecpar));
+  if (ch_layout) {
+    key.channel_order_ = d->AVChannelLayoutGetOrder(ch_layout);
+    if (key.channel_order_ != AV_CHANNEL_ORDER_CUSTOM)
+      key.channel_layout_ = d->AVChannelLayoutGetMask(ch_layout);
+  }
+
+  const uint8_t* extradata = d->AVCodecParametersGetExtraData(codecpar);
+  int extradata_size = d->AVCodecParametersGetExtraDataSize(codecpar);
+  if (extradata && extradata_size > 0)
+    key.extradata_.assign(extradata, extradata + extradata_size);
+  return key;
+}
+
+AVCodecContext* AvcDecoderPool::Open(const AVCodecParameters* codecpar, cmf::MediaTimeBase pkt_time_base, int* error) {
+  auto d = avc_module_provider_->d();
+  AVCodec* codec = avc_module_provider_->avcodec_find_decoder(d->AVCodecParametersGetCodecId(codecpar));
+  if (!codec) {
+    if (error)
+      *error = AVERROR_DECODER_NOT_FOUND;
+    return nullptr;
+  }
+
+  AVCodecContext* codec_context = avc_module_provider_->avcodec_alloc_context3(codec);
+  if (!codec_context) {
+    if (error)
+      *error = AVERROR(ENOMEM);
+    return nullptr;
+  }
+
+  int ret = avc_module_provider_->avcodec_parameters_to_context(codec_context, codecpar);
+  if (ret >= 0) {
+    d->AVCodecContextSetPktTimeBase(codec_context, pkt_time_base);
+    d->AVCodecContextSetThreadCount(codec_context, config_.thread_count_);
+    ret = avc_module_provider_->avcodec_open2(codec_context, codec, nullptr);
+  }
+
+  if (ret < 0) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcDecoderPool: failed to open decoder %d\n", ret);
+#endif //DEBUG_PRINT
+    avc_module_provider_->avcodec_free_context(&codec_context);
+  }
+
+  if (error)
+    *error = ret < 0 ? ret : 0;
+  return codec_context;
+}
+
+int AvcDecoderPool::AttachBudget(AVCodecContext* codec_context, int budget_threads) {
+  if (budget_threads <= 0)
+    return 0;
+
+  std::shared_ptr<IAvcThreadBudget> budget = avc_module_provider_->GetThreadBudget();
+  if (!budget || !budget->IsEnabled())
+    return 0;
+
+  // threads of opened context cannot change, session gets them regardless of current share
+  return budget->AttachSession(codec_context, budget_threads);
+}
+
+void AvcDecoderPool::FreeEntries(std::list<Entry>& entries) {
+  for (Entry& entry : entries)
+    avc_module_provider_->avcodec_free_context(&entry.codec_context_);
+  entries.clear();
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,94 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_DECODER_POOL_HEADER
+#define AVC_DECODER_POOL_HEADER
+
+#include <avc/i_avc_decoder_pool.h>
+#include <avc/i_avc_module_provider.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcDecoderPool
+  : public virtual IAvcDecoderPool {
+ public:
+  AvcDecoderPool(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcDecoderPoolConfig& config);
+  virtual ~AvcDecoderPool();
+
+  AVCodecContext* Acquire(const AVCodecParameters* codecpar, cmf::MediaTimeBase pkt_time_base,
+                          int* error = nullptr) override;
+  void Release(AVCodecContext* codec_context, bool reusable = true) override;
+  void Clear() override;
+  AvcDecoderPoolStatistics GetStatistics() const override;
+
+ private:
+  /// \brief Parameters which require another decoder context when they differ
+  struct Key {
+    int codec_id_ = 0;
+    uint32_t codec_tag_ = 0;
+    int media_type_ = 0;
+    int profile_ = 0;
+    int width_ = 0;
+    int height_ = 0;
+    int format_ = 0;
+    int sample_rate_ = 0;
+    int channels_ = 0;
+    int channel_order_ = 0;
+    uint64_t channel_layout_ = 0;
+    int bits_per_coded_sample_ = 0;
+    int block_align_ = 0;
+    std::vector<uint8_t> extradata_;
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct Entry {
+    Key key_;
+    AVCodecContext* codec_context_ = nullptr;
+    int budget_threads_ = 0;  ///< threads of thread budget session, 0 when context is not budgeted
+  };
+
+  Key MakeKey(const AVCodecParameters* codecpar) const;
+  AVCodecContext* Open(const AVCodecParameters* codecpar, cmf::MediaTimeBase pkt_time_base, int* error);
+  void FreeEntries(std::list<Entry>& entries);
+  int AttachBudget(AVCodecContext* codec_context, int budget_threads);
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AvcDecoderPoolConfig config_;
+
+  mutable std::mutex mutex_;
+  std::list<Entry> idle_;                                   ///< most recently released first
+  std::unordered_map<const AVCodecContext*, Entry> in_use_;
+  AvcDecoderPoolStatistics stat_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_DECODER_POOL_HEADER
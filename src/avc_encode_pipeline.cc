@@ -0,0 +1,495 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_encode_pipeline.h"
+#include "avc_numa_topology.h"
+#include <avc/libav_detached_common.h>
+#include <cerrno>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+
+std::shared_ptr<IAvcEncodePipeline> API_EXPORT CreateAvcEncodePipeline(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const std::string& url,
+  const std::string& format_name,
+  const AvcEncodePipelineConfig& config) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  auto pipeline = std::make_shared<avc::detail::AvcEncodePipeline>(avc_module_provider, config);
+  if (pipeline->Open(url, format_name) < 0)
+    return nullptr;
+
+  return pipeline;
+}
+
+namespace detail {
+
+AvcEncodePipeline::StreamEncoder::StreamEncoder(size_t frame_queue_depth, size_t packet_queue_depth)
+  : frames_(frame_queue_depth + 1)
+  , free_frames_(frame_queue_depth)
+  , packets_(packet_queue_depth + 1)
+  , free_packets_(packet_queue_depth) {
+}
+
+AvcEncodePipeline::AvcEncodePipeline(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcEncodePipelineConfig& config)
+  : avc_module_provider_(avc_module_provider)
+  , config_(config)
+  , output_(avc_module_provider) {
+  if (config_.frame_queue_depth_ < 1)
+    config_.frame_queue_depth_ = 1;
+  if (config_.packet_queue_depth_ < 1)
+    config_.packet_queue_depth_ = 1;
+}
+
+AvcEncodePipeline::~AvcEncodePipeline() {
+  if (started_)
+    Finish();
+
+  output_.CloseFile();
+
+  for (auto& encoder : encoders_) {
+    for (AVFrame* frame : encoder->all_frames_)
+      avc_module_provider_->av_frame_free(&frame);
+    for (AVPacket* packet : encoder->all_packets_)
+      avc_module_provider_->av_packet_free(&packet);
+    avc_module_provider_->avcodec_free_context(&encoder->codec_context_);
+  }
+  encoders_.clear();
+  output_.Close();
+}
+
+int AvcEncodePipeline::Open(const std::string& url, const std::string& format_name) {
+  if (!avc_module_provider_->IsAvFormatLoaded() || !avc_module_provider_->IsAvCodecLoaded())
+    return AVERROR(ENOSYS);
+
+  return output_.Create(url, format_name);
+}
+
+bool AvcEncodePipeline::IsGlobalHeaderRequired() const {
+  return output_.IsGlobalHeader();
+}
+
+void AvcEncodePipeline::PrepareEncoder(AVCodecContext* encoder_context) const {
+  if (!encoder_context)
+    return;
+
+  auto d = avc_module_provider_->d();
+  if (config_.encoder_threads_ > 0)
+    d->AVCodecContextSetThreadCount(encoder_context, config_.encoder_threads_);
+  else if (config_.codec_autotuner_)
+    config_.codec_autotuner_->Apply(encoder_context, true);
+
+  if (output_.IsGlobalHeader()) {
+    d->AVCodecContextSetFlags(encoder_context,
+      d->AVCodecContextGetFlags(encoder_context) | AV_CODEC_FLAG_GLOBAL_HEADER);
+  }
+}
+
+int AvcEncodePipeline::AddStream(AVCodecContext* encoder_context) {
+  if (!encoder_context || started_)
+    return AVERROR(EINVAL);
+
+  auto d = avc_module_provider_->d();
+  AVStream* stream = avc_module_provider_->avformat_new_stream(output_.GetFormatContext(), nullptr);
+  if (!stream)
+    return AVERROR(ENOMEM);
+
+  int ret = avc_module_provider_->avcodec_parameters_from_context(d->AVStreamGetCodecPar(stream), encoder_context);
+  if (ret < 0)
+    return ret;
+
+  // muxer may choose other time base in avformat_write_header, packets are rescaled on muxer thread
+  d->AVStreamSetTimeBase(stream, d->AVCodecContextGetTimeBase(encoder_context));
+
+  std::unique_ptr<StreamEncoder> encoder(new StreamEncoder(config_.frame_queue_depth_, config_.packet_queue_depth_));
+  encoder->stream_index_ = d->AVStreamGetIndex(stream);
+  encoder->stream_ = stream;
+
+  ret = AllocateStream(*encoder);
+  if (ret < 0) {
+    for (AVFrame* frame : encoder->all_frames_)
+      avc_module_provider_->av_frame_free(&frame);
+    for (AVPacket* packet : encoder->all_packets_)
+      avc_module_provider_->av_packet_free(&packet);
+    return ret;
+  }
+
+  encoder->codec_context_ = encoder_context;
+  encoders_.push_back(std::move(encoder));
+  return encoders_.back()->stream_index_;
+}
+
+int AvcEncodePipeline::AllocateStream(StreamEncoder& encoder) {
+  for (size_t i = 0; i < config_.frame_queue_depth_; i++) {
+    AVFrame* frame = avc_module_provider_->av_frame_alloc();
+    if (!frame)
+      return AVERROR(ENOMEM);
+
+    encoder.all_frames_.push_back(frame);
+    encoder.free_frames_.TryPush(frame);
+  }
+
+  for (size_t i = 0; i < config_.packet_queue_depth_; i++) {
+    AVPacket* packet = avc_module_provider_->av_packet_alloc();
+    if (!packet)
+      return AVERROR(ENOMEM);
+
+    encoder.all_packets_.push_back(packet);
+    encoder.free_packets_.TryPush(packet);
+  }
+  return 0;
+}
+
+int AvcEncodePipeline::Start() {
+  if (started_ || encoders_.empty())
+    return AVERROR(EINVAL);
+
+  started_ = true;
+  for (auto& encoder : encoders_)
+    encoder->thread_ = std::thread(&AvcEncodePipeline::EncoderThread, this, encoder.get());
+
+  muxer_thread_ = std::thread(&AvcEncodePipeline::MuxerThread, this);
+  return 0;
+}
+
+int AvcEncodePipeline::SubmitFrame(int stream_index, const AVFrame* frame) {
+  if (!started_ || finished_ || stream_index < 0 || stream_index >= static_cast<int>(encoders_.size()))
+    return AVERROR(EINVAL);
+
+  int error = error_.load(std::memory_order_acquire);
+  if (error < 0)
+    return error;
+
+  StreamEncoder* encoder = encoders_[stream_index].get();
+  if (encoder->ended_)
+    return AVERROR_EOF;
+
+  if (!frame) {
+    encoder->ended_ = true;
+    encoder->frames_.TryPush(nullptr);  // never full, queue has room for all frames and end marker
+    encoder->waiter_.Notify();
+    return 0;
+  }
+
+  AVFrame* queued_frame = encoder->submit_spare_;
+  encoder->submit_spare_ = nullptr;
+  if (!queued_frame && !encoder->free_frames_.TryPop(queued_frame)) {
+    frames_rejected_.fetch_add(1, std::memory_order_relaxed);
+    return AVERROR(EAGAIN);
+  }
+
+  int ret = avc_module_provider_->av_frame_ref(queued_frame, frame);
+  if (ret < 0) {
+    encoder->submit_spare_ = queued_frame;
+    return ret;
+  }
+
+  encoder->frames_.TryPush(queued_frame);
+  encoder->waiter_.Notify();
+
+  frames_submitted_.fetch_add(1, std::memory_order_relaxed);
+  UpdatePeak(frame_queue_peak_depth_, encoder->frames_.GetSize());
+  return 0;
+}
+
+int AvcEncodePipeline::WaitForSubmit(int stream_index) {
+  if (!started_ || finished_ || stream_index < 0 || stream_index >= static_cast<int>(encoders_.size()))
+    return AVERROR(EINVAL);
+
+  StreamEncoder* encoder = encoders_[stream_index].get();
+  caller_waiter_.Wait([this, encoder] {
+    return IsStopped() || encoder->submit_spare_ || !encoder->free_frames_.IsEmpty();
+  });
+
+  int error = error_.load(std::memory_order_acquire);
+  if (error < 0)
+    return error;
+
+  return IsStopped() ? AVERROR_EXIT : 0;
+}
+
+int AvcEncodePipeline::Finish() {
+  if (!started_)
+    return AVERROR(EINVAL);
+
+  if (!finished_) {
+    finished_ = true;
+    for (auto& encoder : encoders_) {
+      if (!encoder->ended_) {
+        encoder->ended_ = true;
+        encoder->frames_.TryPush(nullptr);
+        encoder->waiter_.Notify();
+      }
+    }
+
+    for (auto& encoder : encoders_)
+      if (encoder->thread_.joinable())
+        encoder->thread_.join();
+
+    if (muxer_thread_.joinable())
+      muxer_thread_.join();
+  }
+
+  return error_.load(std::memory_order_acquire);
+}
+
+void AvcEncodePipeline::SetError(int error) {
+  int expected = 0;
+  error_.compare_exchange_strong(expected, error, std::memory_order_acq_rel);
+
+  // any failed stage stops whole pipeline
+  stop_.store(true, std::memory_order_release);
+  muxer_waiter_.Notify();
+  caller_waiter_.Notify();
+  for (auto& encoder : encoders_)
+    encoder->waiter_.Notify();
+}
+
+void AvcEncodePipeline::BindThread() const {
+  if (config_.numa_node_ >= 0)
+    AvcNumaTopology::Instance().BindCurrentThreadToNode(config_.numa_node_);
+}
+
+void AvcEncodePipeline::UpdatePeak(std::atomic<size_t>& peak, size_t value) {
+  size_t current = peak.load(std::memory_order_relaxed);
+  while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+void AvcEncodePipeline::EncoderThread(StreamEncoder* encoder) {
+  BindThread();
+
+  // packet taken from free queue and not filled by encoder yet
+  AVPacket* spare_packet = nullptr;
+
+  while (!IsStopped()) {
+    AVFrame* frame = nullptr;
+    if (!encoder->frames_.TryPop(frame)) {
+      encoder->waiter_.Wait([this, encoder] { return IsStopped() || !encoder->frames_.IsEmpty(); });
+      continue;
+    }
+
+    // null frame flushes encoder
+    int ret = 0;
+    while (true) {
+      ret = avc_module_provider_->avcodec_send_frame(encoder->codec_context_, frame);
+      if (ret != AVERROR(EAGAIN))
+        break;
+
+      // encoder output is full, packets must be received before frame is accepted
+      ret = DrainEncoder(encoder, spare_packet);
+      if (ret < 0)
+        break;
+    }
+
+    if (frame) {
+      avc_module_provider_->av_frame_unref(frame);
+      encoder->free_frames_.TryPush(frame);
+      caller_waiter_.Notify();
+    }
+
+    if (ret == AVERROR_EXIT)
+      break;
+
+    if (ret < 0 && ret != AVERROR_EOF) {
+#if DEBUG_PRINT
+      fprintf(stderr, "AvcEncodePipeline: avcodec_send_frame error %d stream %d\n", ret, encoder->stream_index_);
+#endif //DEBUG_PRINT
+      SetError(ret);
+      break;
+    }
+
+    ret = DrainEncoder(encoder, spare_packet);
+    if (ret < 0 && ret != AVERROR_EOF && ret != AVERROR_EXIT)
+      SetError(ret);
+
+    if (ret < 0 || !frame)
+      break;
+  }
+
+  encoder->packets_.TryPush(nullptr);
+  muxer_waiter_.Notify();
+}
+
+int AvcEncodePipeline::DrainEncoder(StreamEncoder* encoder, AVPacket*& spare_packet) {
+  auto d = avc_module_provider_->d();
+  while (true) {
+    if (!spare_packet && !encoder->free_packets_.TryPop(spare_packet)) {
+      if (IsStopped())
+        return AVERROR_EXIT;
+
+      encoder_waits_.fetch_add(1, std::memory_order_relaxed);
+      encoder->waiter_.Wait([this, encoder] { return IsStopped() || !encoder->free_packets_.IsEmpty(); });
+      continue;
+    }
+
+    int ret = avc_module_provider_->avcodec_receive_packet(encoder->codec_context_, spare_packet);
+    if (ret == AVERROR(EAGAIN))
+      return 0;
+
+    if (ret < 0)
+      return ret;
+
+    d->AVPacketSetStreamIndex(spare_packet, encoder->stream_index_);
+    encoder->packets_.TryPush(spare_packet);  // never full, queue has room for all packets and end marker
+    spare_packet = nullptr;
+    muxer_waiter_.Notify();
+
+    packets_encoded_.fetch_add(1, std::memory_order_relaxed);
+    UpdatePeak(packet_queue_peak_depth_, encoder->packets_.GetSize());
+  }
+}
+
+bool AvcEncodePipeline::IsPacketReady() const {
+  for (auto& encoder : encoders_)
+    if (!encoder->finished_ && !encoder->packets_.IsEmpty())
+      return true;
+
+  return false;
+}
+
+int AvcEncodePipeline::PopPacket(AVPacket*& packet, StreamEncoder*& encoder) {
+  // round robin over encoders, av_interleaved_write_frame orders packets by dts anyway
+  size_t count = encoders_.size();
+  bool all_finished = true;
+  for (size_t i = 0; i < count; i++) {
+    size_t idx = (next_encoder_ + i) % count;
+    StreamEncoder* current = encoders_[idx].get();
+    if (current->finished_)
+      continue;
+
+    AVPacket* current_packet = nullptr;
+    if (!current->packets_.TryPop(current_packet)) {
+      all_finished = false;
+      continue;
+    }
+
+    if (!current_packet) {
+      current->finished_ = true;
+      continue;
+    }
+
+    next_encoder_ = (idx + 1) % count;
+    packet = current_packet;
+    encoder = current;
+    return 0;
+  }
+
+  return all_finished ? AVERROR_EOF : AVERROR(EAGAIN);
+}
+
+void AvcEncodePipeline::MuxerThread() {
+  BindThread();
+
+  auto d = avc_module_provider_->d();
+  AVFormatContext* format_context = output_.GetFormatContext();
+  int ret = output_.OpenFile();
+  if (ret >= 0) {
+    AVDictionary* options = nullptr;
+    for (auto& option : config_.muxer_options_)
+      avc_module_provider_->av_dict_set(&options, option.first.c_str(), option.second.c_str(), 0);
+
+    ret = avc_module_provider_->avformat_write_header(format_context, &options);
+    avc_module_provider_->av_dict_free(&options);
+  }
+
+  while (ret >= 0 && !IsStopped()) {
+    AVPacket* packet = nullptr;
+    StreamEncoder* encoder = nullptr;
+    ret = PopPacket(packet, encoder);
+    if (ret == AVERROR(EAGAIN)) {
+      muxer_waiter_.Wait([this] { return IsStopped() || IsPacketReady(); });
+      ret = 0;
+      continue;
+    }
+
+    if (ret < 0)
+      break;
+
+    avc_module_provider_->av_packet_rescale_ts(packet,
+      d->AVCodecContextGetTimeBase(encoder->codec_context_), d->AVStreamGetTimeBase(encoder->stream_));
+    int size = d->AVPacketGetSize(packet);
+
+    // packet reference is taken by muxer and packet is reset
+    ret = avc_module_provider_->av_interleaved_write_frame(format_context, packet);
+    avc_module_provider_->av_packet_unref(packet);
+    encoder->free_packets_.TryPush(packet);
+    encoder->waiter_.Notify();
+
+    if (ret >= 0) {
+      packets_written_.fetch_add(1, std::memory_order_relaxed);
+      bytes_written_.fetch_add(size > 0 ? static_cast<uint64_t>(size) : 0, std::memory_order_relaxed);
+    }
+  }
+
+  if (ret == AVERROR_EOF && !IsStopped())
+    ret = avc_module_provider_->av_write_trailer(format_context);
+
+  if (ret < 0 && ret != AVERROR_EOF) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcEncodePipeline: muxer error %d url %s\n", ret, output_.GetUrl().c_str());
+#endif //DEBUG_PRINT
+    SetError(ret);
+  }
+
+  output_.CloseFile();
+}
+
+AvcEncodePipelineStatistics AvcEncodePipeline::GetStatistics() const {
+  AvcEncodePipelineStatistics stat;
+  stat.frames_submitted_ = frames_submitted_.load(std::memory_order_relaxed);
+  stat.frames_rejected_ = frames_rejected_.load(std::memory_order_relaxed);
+  stat.packets_encoded_ = packets_encoded_.load(std::memory_order_relaxed);
+  stat.packets_written_ = packets_written_.load(std::memory_order_relaxed);
+  stat.bytes_written_ = bytes_written_.load(std::memory_order_relaxed);
+  stat.encoder_waits_ = encoder_waits_.load(std::memory_order_relaxed);
+  stat.frame_queue_peak_depth_ = frame_queue_peak_depth_.load(std::memory_order_relaxed);
+  stat.packet_queue_peak_depth_ = packet_queue_peak_depth_.load(std::memory_order_relaxed);
+
+  for (auto& encoder : encoders_) {
+    stat.frame_queue_depth_ += encoder->frames_.GetSize();
+    stat.packet_queue_depth_ += encoder->packets_.GetSize();
+  }
+  return stat;
+}
+
+}  // namespace detail
+}//namespace avc
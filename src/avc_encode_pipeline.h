@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_ENCODE_PIPELINE_HEADER
+#define AVC_ENCODE_PIPELINE_HEADER
+
+#include <avc/i_avc_encode_pipeline.h>
+#include <avc/i_avc_module_provider.h>
+#include "avc_media_output.h"
+#include "avc_spsc_queue.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcEncodePipeline
+  : public virtual IAvcEncodePipeline {
+ public:
+  AvcEncodePipeline(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcEncodePipelineConfig& config);
+  virtual ~AvcEncodePipeline();
+
+  int Open(const std::string& url, const std::string& format_name);
+
+  bool IsGlobalHeaderRequired() const override;
+  void PrepareEncoder(AVCodecContext* encoder_context) const override;
+  int AddStream(AVCodecContext* encoder_context) override;
+  int Start() override;
+  int SubmitFrame(int stream_index, const AVFrame* frame) override;
+  int WaitForSubmit(int stream_index) override;
+  int Finish() override;
+
+  AvcEncodePipelineStatistics GetStatistics() const override;
+
+ private:
+  // null frame or packet in queue marks end of stream
+  struct StreamEncoder {
+    StreamEncoder(size_t frame_queue_depth, size_t packet_queue_depth);
+
+    int stream_index_ = -1;
+    AVCodecContext* codec_context_ = nullptr;
+    AVStream* stream_ = nullptr;
+
+    AvcSpscQueue<AVFrame*> frames_;          // caller -> encoder
+    AvcSpscQueue<AVFrame*> free_frames_;     // encoder -> caller
+    AvcSpscQueue<AVPacket*> packets_;        // encoder -> muxer
+    AvcSpscQueue<AVPacket*> free_packets_;   // muxer -> encoder
+    std::vector<AVFrame*> all_frames_;
+    std::vector<AVPacket*> all_packets_;
+
+    AvcThreadWaiter waiter_;
+    std::thread thread_;
+    AVFrame* submit_spare_ = nullptr;  // caller side
+    bool ended_ = false;               // caller side
+    bool finished_ = false;            // muxer side
+  };
+
+  int AllocateStream(StreamEncoder& encoder);
+  void EncoderThread(StreamEncoder* encoder);
+  int DrainEncoder(StreamEncoder* encoder, AVPacket*& spare_packet);
+  void MuxerThread();
+  int PopPacket(AVPacket*& packet, StreamEncoder*& encoder);
+  bool IsPacketReady() const;
+  void SetError(int error);
+  bool IsStopped() const { return stop_.load(std::memory_order_acquire); }
+  void BindThread() const;
+  static void UpdatePeak(std::atomic<size_t>& peak, size_t value);
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AvcEncodePipelineConfig config_;
+  AvcMediaOutput output_;
+
+  std::vector<std::unique_ptr<StreamEncoder>> encoders_;
+  size_t next_encoder_ = 0;  // muxer side
+
+  std::thread muxer_thread_;
+  AvcThreadWaiter muxer_waiter_;
+  AvcThreadWaiter caller_waiter_;
+  bool started_ = false;
+  bool finished_ = false;
+  std::atomic<bool> stop_{false};
+  std::atomic<int> error_{0};
+
+  std::atomic<uint64_t> frames_submitted_{0};
+  std::atomic<uint64_t> frames_rejected_{0};
+  std::atomic<uint64_t> packets_encoded_{0};
+  std::atomic<uint64_t> packets_written_{0};
+  std::atomic<uint64_t> bytes_written_{0};
+  std::atomic<uint64_t> encoder_waits_{0};
+  std::atomic<size_t> frame_queue_peak_depth_{0};
+  std::atomic<size_t> packet_queue_peak_depth_{0};
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_ENCODE_PIPELINE_HEADER
@@ -0,0 +1,513 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_frame_cache.h"
+#include <avc/libav_detached_common.h>
+#include <cerrno>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+
+std::shared_ptr<IAvcFrameCache> API_EXPORT CreateAvcFrameCache(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const std::string& url,
+  size_t budget_bytes,
+  int decoder_threads) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  auto cache = std::make_shared<avc::detail::AvcFrameCache>(avc_module_provider, budget_bytes, decoder_threads);
+  if (cache->Open(url) < 0)
+    return nullptr;
+
+  return cache;
+}
+
+namespace detail {
+
+AvcFrameCache::AvcFrameCache(std::shared_ptr<IAvcModuleProvider> avc_module_provider, size_t budget_bytes, int decoder_threads)
+  : avc_module_provider_(avc_module_provider)
+  , input_(avc_module_provider)
+  , decoder_threads_(decoder_threads)
+  , budget_bytes_(budget_bytes) {
+}
+
+AvcFrameCache::~AvcFrameCache() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  worker_cond_.notify_all();
+  frames_cond_.notify_all();
+
+  if (worker_.joinable())
+    worker_.join();
+
+  Clear();
+
+  for (auto& it : decoders_)
+    avc_module_provider_->avcodec_free_context(&it.second.codec_context_);
+  decoders_.clear();
+}
+
+int AvcFrameCache::Open(const std::string& url) {
+  int ret = input_.Open(url);
+  if (ret < 0)
+    return ret;
+
+  worker_ = std::thread(&AvcFrameCache::WorkerThread, this);
+  return 0;
+}
+
+int AvcFrameCache::GetFrame(int stream_index, int64_t pts, AVFrame* dst) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const CachedFrame* cached = LookupLocked(stream_index, pts, true);
+  if (cached) {
+    stat_.hits_++;
+    return RefFrameLocked(cached, dst);
+  }
+
+  stat_.misses_++;
+  Key key(stream_index, pts);
+
+  // decoded GOP may be evicted by other requests before waiter wakes up when budget is small, so retry
+  const int kMaxAttempts = 3;
+  for (int attempt = 0; attempt < kMaxAttempts; attempt++) {
+    EnqueueLocked(stream_index, pts);
+
+    frames_cond_.wait(lock, [&] {
+      return stop_ || LookupLocked(stream_index, pts, true) != nullptr || results_.count(key) != 0;
+    });
+
+    cached = LookupLocked(stream_index, pts, true);
+    if (cached)
+      return RefFrameLocked(cached, dst);
+
+    if (stop_)
+      return AVERROR_EXIT;
+
+    int ret = results_[key];
+    if (ret < 0)
+      return ret;
+  }
+
+  // no frame exactly covering pts (broken timestamps), take nearest one
+  cached = LookupLocked(stream_index, pts, false);
+  if (!cached)
+    return AVERROR_EOF;
+
+  return RefFrameLocked(cached, dst);
+}
+
+int AvcFrameCache::TryGetFrame(int stream_index, int64_t pts, AVFrame* dst) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const CachedFrame* cached = LookupLocked(stream_index, pts, true);
+  if (cached) {
+    stat_.hits_++;
+    return RefFrameLocked(cached, dst);
+  }
+
+  stat_.misses_++;
+  EnqueueLocked(stream_index, pts);
+  return AVERROR(EAGAIN);
+}
+
+void AvcFrameCache::Prefetch(int stream_index, int64_t pts) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!LookupLocked(stream_index, pts, true))
+    EnqueueLocked(stream_index, pts);
+}
+
+void AvcFrameCache::SetBudget(size_t budget_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  budget_bytes_ = budget_bytes;
+  EvictLocked(Key(-1, AV_NOPTS_VALUE));
+}
+
+void AvcFrameCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (!gops_.empty())
+    RemoveGopLocked(gops_.begin());
+
+  frames_.clear();
+  results_.clear();
+}
+
+AvcFrameCacheStatistics AvcFrameCache::GetStatistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AvcFrameCacheStatistics stat = stat_;
+  stat.cached_gops_ = gops_.size();
+  stat.budget_bytes_ = budget_bytes_;
+  return stat;
+}
+
+const AvcFrameCache::CachedFrame* AvcFrameCache::LookupLocked(int stream_index, int64_t pts, bool strict) {
+  auto stream_it = frames_.find(stream_index);
+  if (stream_it == frames_.end() || stream_it->second.empty())
+    return nullptr;
+
+  auto& stream_frames = stream_it->second;
+  auto it = stream_frames.upper_bound(pts);
+  if (it == stream_frames.begin()) {
+    // pts is before first decoded frame
+    return strict ? nullptr : &it->second;
+  }
+
+  auto next = it;
+  --it;
+  const CachedFrame& cached = it->second;
+  bool found = !strict;
+
+  // frame is shown until next frame of same GOP (GOP frames are decoded contiguously) or until its duration ends
+  if (!found && next != stream_frames.end() && next->second.gop_pts_ == cached.gop_pts_)
+    found = true;
+  if (!found && pts < it->first + (cached.duration_ > 0 ? cached.duration_ : 1))
+    found = true;
+
+  if (!found)
+    return nullptr;
+
+  auto gop_it = gops_.find(Key(stream_index, cached.gop_pts_));
+  if (gop_it != gops_.end())
+    gop_it->second.last_used_ = ++use_tick_;
+
+  return &cached;
+}
+
+int AvcFrameCache::RefFrameLocked(const CachedFrame* cached, AVFrame* dst) {
+  if (!dst)
+    return AVERROR(EINVAL);
+
+  return avc_module_provider_->av_frame_ref(dst, cached->frame_);
+}
+
+void AvcFrameCache::EnqueueLocked(int stream_index, int64_t pts) {
+  Key key(stream_index, pts);
+  results_.erase(key);
+
+  // results are read by waiters right after notification, old ones are not needed
+  if (results_.size() > 4096)
+    results_.clear();
+
+  for (const Key& queued : requests_)
+    if (queued == key)
+      return;
+
+  requests_.push_back(key);
+  worker_cond_.notify_one();
+}
+
+void AvcFrameCache::EvictLocked(const Key& pinned_gop) {
+  while (stat_.cached_bytes_ > budget_bytes_) {
+    auto victim = gops_.end();
+    for (auto it = gops_.begin(); it != gops_.end(); ++it) {
+      if (it->first == pinned_gop)
+        continue;
+      if (victim == gops_.end() || it->second.last_used_ < victim->second.last_used_)
+        victim = it;
+    }
+
+    if (victim == gops_.end())
+      break;
+
+    RemoveGopLocked(victim);
+  }
+}
+
+void AvcFrameCache::RemoveGopLocked(std::map<Key, GopInfo>::iterator gop_it) {
+  auto& stream_frames = frames_[gop_it->first.first];
+  for (int64_t pts : gop_it->second.frames_pts_) {
+    auto frame_it = stream_frames.find(pts);
+    if (frame_it == stream_frames.end())
+      continue;
+
+    avc_module_provider_->av_frame_free(&frame_it->second.frame_);
+    stat_.cached_bytes_ -= frame_it->second.bytes_;
+    stat_.cached_frames_--;
+    stat_.evicted_frames_++;
+    stream_frames.erase(frame_it);
+  }
+
+  stat_.evicted_gops_++;
+  gops_.erase(gop_it);
+}
+
+////
+// worker thread
+
+void AvcFrameCache::WorkerThread() {
+  while (true) {
+    Key request;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      worker_cond_.wait(lock, [this] { return stop_ || !requests_.empty(); });
+      if (stop_)
+        break;
+
+      request = requests_.front();
+      requests_.pop_front();
+
+      // may be already decoded as part of previous GOP
+      if (LookupLocked(request.first, request.second, true)) {
+        results_[request] = 0;
+        frames_cond_.notify_all();
+        continue;
+      }
+    }
+
+    int ret = DecodeGop(request.first, request.second);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      results_[request] = ret;
+    }
+    frames_cond_.notify_all();
+  }
+}
+
+AvcFrameCache::StreamDecoder* AvcFrameCache::GetDecoder(int stream_index) {
+  auto it = decoders_.find(stream_index);
+  if (it != decoders_.end())
+    return &it->second;
+
+  StreamDecoder decoder;
+  decoder.codec_context_ = input_.OpenDecoder(stream_index, decoder_threads_);
+  if (!decoder.codec_context_)
+    return nullptr;
+
+  // used when decoder does not provide frame duration
+  auto d = avc_module_provider_->d();
+  cmf::MediaTimeBase tb = input_.GetStreamTimeBase(stream_index);
+  cmf::MediaTimeBase frame_rate = d->AVStreamGetAvgFrameRage(input_.GetStream(stream_index));
+  if (tb.num_ > 0 && frame_rate.num_ > 0) {
+    int64_t duration = static_cast<int64_t>(tb.den_) * frame_rate.den_ / (static_cast<int64_t>(tb.num_) * frame_rate.num_);
+    if (duration > 0)
+      decoder.default_duration_ = duration;
+  }
+
+  return &decoders_.emplace(stream_index, decoder).first->second;
+}
+
+int AvcFrameCache::DecodeGop(int stream_index, int64_t target_pts) {
+  StreamDecoder* decoder = GetDecoder(stream_index);
+  if (!decoder)
+    return AVERROR(EINVAL);
+
+  auto d = avc_module_provider_->d();
+  int ret = avc_module_provider_->av_seek_frame(input_.GetFormatContext(), stream_index, target_pts, AVSEEK_FLAG_BACKWARD);
+  if (ret < 0)
+    return ret;
+
+  // all opened decoders have stale state after seek
+  for (auto& it : decoders_)
+    avc_module_provider_->avcodec_flush_buffers(it.second.codec_context_);
+
+  AVPacket* packet = avc_module_provider_->av_packet_alloc();
+  AVFrame* frame = avc_module_provider_->av_frame_alloc();
+  if (!packet || !frame) {
+    avc_module_provider_->av_packet_free(&packet);
+    avc_module_provider_->av_frame_free(&frame);
+    return AVERROR(ENOMEM);
+  }
+
+  int64_t gop_pts = AV_NOPTS_VALUE;
+  int64_t last_pts = AV_NOPTS_VALUE;
+  bool target_passed = false;
+  bool done = false;
+  bool eof = false;
+  ret = 0;
+
+  while (!done) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stop_)
+        break;
+    }
+
+    ret = avc_module_provider_->av_read_frame(input_.GetFormatContext(), packet);
+    if (ret == AVERROR_EOF) {
+      eof = true;
+    } else if (ret < 0) {
+      break;
+    } else if (d->AVPacketGetStreamIndex(packet) != stream_index) {
+      avc_module_provider_->av_packet_unref(packet);
+      continue;
+    }
+
+    ret = avc_module_provider_->avcodec_send_packet(decoder->codec_context_, eof ? nullptr : packet);
+    avc_module_provider_->av_packet_unref(packet);
+    if (ret < 0 && ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) {
+#if DEBUG_PRINT
+      fprintf(stderr, "AvcFrameCache: avcodec_send_packet error %d, packet skipped\n", ret);
+#endif //DEBUG_PRINT
+    }
+
+    while (true) {
+      ret = avc_module_provider_->avcodec_receive_frame(decoder->codec_context_, frame);
+      if (ret == AVERROR(EAGAIN))
+        break;
+
+      if (ret < 0) {
+        done = true;
+        break;
+      }
+
+      int64_t pts = d->AVFrameGetPts(frame);
+      if (pts == AV_NOPTS_VALUE)
+        pts = d->AVFrameGetPktDts(frame);
+
+      if (pts == AV_NOPTS_VALUE) {
+        avc_module_provider_->av_frame_unref(frame);
+        continue;
+      }
+
+      bool key_frame = d->AVFrameGetKeyFrame(frame) || (d->AVFrameGetFlags(frame) & AV_FRAME_FLAG_KEY);
+      if (key_frame || gop_pts == AV_NOPTS_VALUE) {
+        if (key_frame && gop_pts != AV_NOPTS_VALUE && target_passed) {
+          // next GOP starts, requested GOP is complete. Last frame is shown until next keyframe
+          ExtendFrameDuration(stream_index, last_pts, pts);
+          avc_module_provider_->av_frame_unref(frame);
+          done = true;
+          break;
+        }
+
+        gop_pts = pts;
+      }
+
+      int64_t duration = d->AVFrameGetDuration(frame);
+      if (duration <= 0)
+        duration = decoder->default_duration_;
+
+      InsertFrame(stream_index, gop_pts, pts, duration, frame);
+      if (last_pts == AV_NOPTS_VALUE || pts > last_pts)
+        last_pts = pts;
+      if (pts >= target_pts)
+        target_passed = true;
+    }
+
+    if (eof)
+      done = true;
+  }
+
+  avc_module_provider_->av_packet_free(&packet);
+  avc_module_provider_->av_frame_free(&frame);
+
+  if (ret == AVERROR_EOF || ret == AVERROR(EAGAIN))
+    ret = 0;
+
+  if (ret < 0)
+    return ret;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const CachedFrame* cached = LookupLocked(stream_index, target_pts, false);
+  if (!cached)
+    return AVERROR_EOF;
+
+  if (eof && !target_passed && !LookupLocked(stream_index, target_pts, true))
+    return AVERROR_EOF;
+
+  return 0;
+}
+
+void AvcFrameCache::InsertFrame(int stream_index, int64_t gop_pts, int64_t pts, int64_t duration, AVFrame* frame) {
+  AVFrame* cached_frame = avc_module_provider_->av_frame_alloc();
+  if (!cached_frame) {
+    avc_module_provider_->av_frame_unref(frame);
+    return;
+  }
+
+  avc_module_provider_->av_frame_move_ref(cached_frame, frame);
+  size_t bytes = GetFrameBytes(cached_frame);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stat_.decoded_frames_++;
+
+    auto& stream_frames = frames_[stream_index];
+    if (stream_frames.count(pts)) {
+      avc_module_provider_->av_frame_free(&cached_frame);
+      return;
+    }
+
+    CachedFrame cached;
+    cached.frame_ = cached_frame;
+    cached.duration_ = duration;
+    cached.gop_pts_ = gop_pts;
+    cached.bytes_ = bytes;
+    stream_frames[pts] = cached;
+
+    Key gop_key(stream_index, gop_pts);
+    GopInfo& gop = gops_[gop_key];
+    gop.frames_pts_.push_back(pts);
+    gop.bytes_ += bytes;
+    gop.last_used_ = ++use_tick_;
+
+    stat_.cached_frames_++;
+    stat_.cached_bytes_ += bytes;
+    EvictLocked(gop_key);
+  }
+
+  frames_cond_.notify_all();
+}
+
+void AvcFrameCache::ExtendFrameDuration(int stream_index, int64_t pts, int64_t next_pts) {
+  if (pts == AV_NOPTS_VALUE || next_pts <= pts)
+    return;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& stream_frames = frames_[stream_index];
+  auto it = stream_frames.find(pts);
+  if (it != stream_frames.end() && it->second.duration_ < next_pts - pts)
+    it->second.duration_ = next_pts - pts;
+}
+
+size_t AvcFrameCache::GetFrameBytes(const AVFrame* frame) const {
+  auto d = avc_module_provider_->d();
+  size_t bytes = d->AVFrameSizeof();
+  for (int i = 0; i < AV_NUM_DATA_POINTERS; i++) {
+    AVBufferRef* buf = d->AVFrameGetBuf(frame, i);
+    if (!buf)
+      break;
+    bytes += static_cast<size_t>(d->AVBufferRefGetSize(buf));
+  }
+  return bytes;
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_FRAME_CACHE_HEADER
+#define AVC_FRAME_CACHE_HEADER
+
+#include <avc/i_avc_frame_cache.h>
+#include <avc/i_avc_module_provider.h>
+#include "avc_media_input.h"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcFrameCache
+  : public virtual IAvcFrameCache {
+ public:
+  AvcFrameCache(std::shared_ptr<IAvcModuleProvider> avc_module_provider, size_t budget_bytes, int decoder_threads);
+  virtual ~AvcFrameCache();
+
+  int Open(const std::string& url);
+
+  int GetFrame(int stream_index, int64_t pts, AVFrame* dst) override;
+  int TryGetFrame(int stream_index, int64_t pts, AVFrame* dst) override;
+  void Prefetch(int stream_index, int64_t pts) override;
+
+  void SetBudget(size_t budget_bytes) override;
+  void Clear() override;
+
+  AvcFrameCacheStatistics GetStatistics() const override;
+
+ private:
+  typedef std::pair<int, int64_t> Key;  // stream index, pts
+
+  struct CachedFrame {
+    AVFrame* frame_ = nullptr;
+    int64_t duration_ = 0;
+    int64_t gop_pts_ = 0;
+    size_t bytes_ = 0;
+  };
+
+  struct GopInfo {
+    std::vector<int64_t> frames_pts_;
+    size_t bytes_ = 0;
+    uint64_t last_used_ = 0;
+  };
+
+  struct StreamDecoder {
+    AVCodecContext* codec_context_ = nullptr;
+    int64_t default_duration_ = 1;
+  };
+
+  // must be called with mutex_ locked
+  const CachedFrame* LookupLocked(int stream_index, int64_t pts, bool strict);
+  int RefFrameLocked(const CachedFrame* cached, AVFrame* dst);
+  void EnqueueLocked(int stream_index, int64_t pts);
+  void EvictLocked(const Key& pinned_gop);
+  void RemoveGopLocked(std::map<Key, GopInfo>::iterator gop_it);
+
+  // worker thread
+  void WorkerThread();
+  StreamDecoder* GetDecoder(int stream_index);
+  int DecodeGop(int stream_index, int64_t target_pts);
+  void InsertFrame(int stream_index, int64_t gop_pts, int64_t pts, int64_t duration, AVFrame* frame);
+  void ExtendFrameDuration(int stream_index, int64_t pts, int64_t next_pts);
+  size_t GetFrameBytes(const AVFrame* frame) const;
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AvcMediaInput input_;
+  int decoder_threads_;
+  std::map<int, StreamDecoder> decoders_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable worker_cond_;
+  std::condition_variable frames_cond_;
+  std::thread worker_;
+  bool stop_ = false;
+
+  std::map<int, std::map<int64_t, CachedFrame>> frames_;
+  std::map<Key, GopInfo> gops_;
+  std::deque<Key> requests_;
+  std::map<Key, int> results_;
+  uint64_t use_tick_ = 0;
+
+  size_t budget_bytes_;
+  AvcFrameCacheStatistics stat_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_FRAME_CACHE_HEADER
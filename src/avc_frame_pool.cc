@@ -0,0 +1,283 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_frame_pool.h"
+#include "avc_numa_topology.h"
+#include <avc/libav_detached_common.h>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+
+std::shared_ptr<IAvcFramePool> API_EXPORT CreateAvcFramePool(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  int numa_node,
+  size_t max_cached_objects) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  return std::make_shared<avc::detail::AvcFramePool>(avc_module_provider, numa_node, max_cached_objects);
+}
+
+std::shared_ptr<IAvcNumaFramePools> API_EXPORT CreateAvcNumaFramePools(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  size_t max_cached_objects_per_node) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  return std::make_shared<avc::detail::AvcNumaFramePools>(avc_module_provider, max_cached_objects_per_node);
+}
+
+namespace detail {
+
+////
+// AvcFramePool
+
+AvcFramePool::AvcFramePool(std::shared_ptr<IAvcModuleProvider> avc_module_provider, int numa_node, size_t max_cached_objects)
+  : avc_module_provider_(avc_module_provider)
+  , numa_node_(numa_node)
+  , max_cached_objects_(max_cached_objects) {
+  if (numa_node_ >= AvcNumaTopology::Instance().GetNodesCount())
+    numa_node_ = -1;
+
+  frames_.reserve(max_cached_objects_);
+  packets_.reserve(max_cached_objects_);
+}
+
+AvcFramePool::~AvcFramePool() {
+  Trim();
+}
+
+AVFrame* AvcFramePool::AcquireFrame() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!frames_.empty()) {
+      AVFrame* frame = frames_.back();
+      frames_.pop_back();
+      frames_reused_++;
+      frames_in_use_++;
+      return frame;
+    }
+  }
+
+  AvcScopedNumaMemoryPolicy policy(numa_node_);
+  AVFrame* frame = avc_module_provider_->av_frame_alloc();
+  if (!frame)
+    return nullptr;
+
+  frames_allocated_++;
+  frames_in_use_++;
+  return frame;
+}
+
+AVFrame* AvcFramePool::AcquireVideoFrame(int width, int height, int pix_fmt, int align) {
+  AVFrame* frame = AcquireFrame();
+  if (!frame)
+    return nullptr;
+
+  auto d = avc_module_provider_->d();
+  d->AVFrameSetWidth(frame, width);
+  d->AVFrameSetHeight(frame, height);
+  d->AVFrameSetFormat(frame, pix_fmt);
+
+  AvcScopedNumaMemoryPolicy policy(numa_node_);
+  int ret = avc_module_provider_->av_frame_get_buffer(frame, align);
+  if (ret < 0) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcFramePool: av_frame_get_buffer failed %d (%dx%d fmt %d)\n", ret, width, height, pix_fmt);
+#endif //DEBUG_PRINT
+    ReleaseFrame(frame);
+    return nullptr;
+  }
+
+  // Buffers are not written by av_frame_get_buffer. Fault pages now, while preferred node policy is active
+  for (int i = 0; i < AV_NUM_DATA_POINTERS; i++) {
+    AVBufferRef* buf = d->AVFrameGetBuf(frame, i);
+    if (!buf)
+      break;
+
+    int size = d->AVBufferRefGetSize(buf);
+    if (numa_node_ >= 0)
+      AvcNumaTouchPages(d->AVBufferRefGetData(buf), static_cast<size_t>(size));
+    buffer_bytes_allocated_ += static_cast<uint64_t>(size);
+  }
+  return frame;
+}
+
+void AvcFramePool::ReleaseFrame(AVFrame* frame) {
+  if (!frame)
+    return;
+
+  avc_module_provider_->av_frame_unref(frame);
+  frames_in_use_--;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (frames_.size() < max_cached_objects_) {
+      frames_.push_back(frame);
+      return;
+    }
+  }
+
+  avc_module_provider_->av_frame_free(&frame);
+}
+
+AVPacket* AvcFramePool::AcquirePacket() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!packets_.empty()) {
+      AVPacket* packet = packets_.back();
+      packets_.pop_back();
+      packets_reused_++;
+      packets_in_use_++;
+      return packet;
+    }
+  }
+
+  AvcScopedNumaMemoryPolicy policy(numa_node_);
+  AVPacket* packet = avc_module_provider_->av_packet_alloc();
+  if (!packet)
+    return nullptr;
+
+  packets_allocated_++;
+  packets_in_use_++;
+  return packet;
+}
+
+void AvcFramePool::ReleasePacket(AVPacket* packet) {
+  if (!packet)
+    return;
+
+  avc_module_provider_->av_packet_unref(packet);
+  packets_in_use_--;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (packets_.size() < max_cached_objects_) {
+      packets_.push_back(packet);
+      return;
+    }
+  }
+
+  avc_module_provider_->av_packet_free(&packet);
+}
+
+void AvcFramePool::Trim() {
+  std::vector<AVFrame*> frames;
+  std::vector<AVPacket*> packets;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frames.swap(frames_);
+    packets.swap(packets_);
+  }
+
+  for (AVFrame* frame : frames)
+    avc_module_provider_->av_frame_free(&frame);
+
+  for (AVPacket* packet : packets)
+    avc_module_provider_->av_packet_free(&packet);
+}
+
+AvcPoolStatistics AvcFramePool::GetStatistics() const {
+  AvcPoolStatistics stat;
+  stat.numa_node_ = numa_node_;
+  stat.frames_allocated_ = frames_allocated_;
+  stat.frames_reused_ = frames_reused_;
+  stat.frames_in_use_ = frames_in_use_;
+  stat.packets_allocated_ = packets_allocated_;
+  stat.packets_reused_ = packets_reused_;
+  stat.packets_in_use_ = packets_in_use_;
+  stat.buffer_bytes_allocated_ = buffer_bytes_allocated_;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  stat.frames_cached_ = frames_.size();
+  stat.packets_cached_ = packets_.size();
+  return stat;
+}
+
+////
+// AvcNumaFramePools
+
+AvcNumaFramePools::AvcNumaFramePools(std::shared_ptr<IAvcModuleProvider> avc_module_provider, size_t max_cached_objects_per_node) {
+  const AvcNumaTopology& topology = AvcNumaTopology::Instance();
+  int nodes_count = topology.GetNodesCount();
+
+  // on single node system memory policy is useless, pool works as plain cache
+  for (int node = 0; node < nodes_count; node++) {
+    pools_.push_back(std::make_shared<AvcFramePool>(avc_module_provider,
+      nodes_count > 1 ? node : -1, max_cached_objects_per_node));
+  }
+}
+
+std::shared_ptr<IAvcFramePool> AvcNumaFramePools::GetPool(int numa_node) {
+  if (numa_node < 0 || numa_node >= static_cast<int>(pools_.size()))
+    return GetCurrentNodePool();
+
+  return pools_[numa_node];
+}
+
+std::shared_ptr<IAvcFramePool> AvcNumaFramePools::GetCurrentNodePool() {
+  int node = GetCurrentNumaNode();
+  if (node < 0 || node >= static_cast<int>(pools_.size()))
+    node = 0;
+
+  return pools_[node];
+}
+
+int AvcNumaFramePools::GetCurrentNumaNode() const {
+  return AvcNumaTopology::Instance().GetCurrentNode();
+}
+
+bool AvcNumaFramePools::BindCurrentThreadToNode(int numa_node) {
+  if (pools_.size() < 2)
+    return false;
+
+  return AvcNumaTopology::Instance().BindCurrentThreadToNode(numa_node);
+}
+
+AvcPoolStatistics AvcNumaFramePools::GetStatistics(int numa_node) const {
+  if (numa_node < 0 || numa_node >= static_cast<int>(pools_.size()))
+    return AvcPoolStatistics();
+
+  AvcPoolStatistics stat = pools_[numa_node]->GetStatistics();
+  stat.numa_node_ = numa_node;
+  return stat;
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_FRAME_POOL_HEADER
+#define AVC_FRAME_POOL_HEADER
+
+#include <avc/i_avc_frame_pool.h>
+#include <avc/i_avc_module_provider.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcFramePool
+  : public virtual IAvcFramePool {
+ public:
+  AvcFramePool(std::shared_ptr<IAvcModuleProvider> avc_module_provider, int numa_node, size_t max_cached_objects);
+  virtual ~AvcFramePool();
+
+  AVFrame* AcquireFrame() override;
+  AVFrame* AcquireVideoFrame(int width, int height, int pix_fmt, int align = 0) override;
+  void ReleaseFrame(AVFrame* frame) override;
+
+  AVPacket* AcquirePacket() override;
+  void ReleasePacket(AVPacket* packet) override;
+
+  void Trim() override;
+
+  int GetNumaNode() const override { return numa_node_; }
+  AvcPoolStatistics GetStatistics() const override;
+
+ private:
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  int numa_node_;
+  size_t max_cached_objects_;
+
+  mutable std::mutex mutex_;
+  std::vector<AVFrame*> frames_;
+  std::vector<AVPacket*> packets_;
+
+  std::atomic<uint64_t> frames_allocated_{0};
+  std::atomic<uint64_t> frames_reused_{0};
+  std::atomic<uint64_t> frames_in_use_{0};
+  std::atomic<uint64_t> packets_allocated_{0};
+  std::atomic<uint64_t> packets_reused_{0};
+  std::atomic<uint64_t> packets_in_use_{0};
+  std::atomic<uint64_t> buffer_bytes_allocated_{0};
+};
+
+class AvcNumaFramePools
+  : public virtual IAvcNumaFramePools {
+ public:
+  AvcNumaFramePools(std::shared_ptr<IAvcModuleProvider> avc_module_provider, size_t max_cached_objects_per_node);
+  virtual ~AvcNumaFramePools() = default;
+
+  int GetNodesCount() const override { return static_cast<int>(pools_.size()); }
+  std::shared_ptr<IAvcFramePool> GetPool(int numa_node) override;
+  std::shared_ptr<IAvcFramePool> GetCurrentNodePool() override;
+  int GetCurrentNumaNode() const override;
+  bool BindCurrentThreadToNode(int numa_node) override;
+  AvcPoolStatistics GetStatistics(int numa_node) const override;
+
+ private:
+  std::vector<std::shared_ptr<AvcFramePool>> pools_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_FRAME_POOL_HEADER
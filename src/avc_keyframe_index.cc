@@ -0,0 +1,358 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_keyframe_index.h"
+#include "avc_media_input.h"
+#include "avc_media_utils.h"
+#include <avc/libav_detached_common.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace avc {
+
+std::shared_ptr<IAvcKeyframeIndex> API_EXPORT CreateAvcKeyframeIndex(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  return std::make_shared<avc::detail::AvcKeyframeIndex>(avc_module_provider);
+}
+
+namespace detail {
+
+namespace {
+
+// Sidecar layout: header, table of streams, entries of every stream. Integers are in host byte order,
+// file is rejected on host with other order. All blocks are 8 bytes aligned, so mapped entries are used in place
+const char kSidecarMagic[8] = { 'A', 'V', 'C', 'K', 'F', 'I', 'D', 'X' };
+const uint32_t kSidecarVersion = 1;
+const uint32_t kSidecarByteOrder = 0x01020304;
+
+struct SidecarHeader {
+  char magic_[8];
+  uint32_t version_;
+  uint32_t byte_order_;
+  uint64_t source_size_;     ///< size of indexed file, 0 when unknown
+  uint32_t streams_count_;
+  uint32_t reserved_;
+};
+
+struct SidecarStream {
+  int32_t time_base_num_;
+  int32_t time_base_den_;
+  uint64_t entries_offset_;
+  uint64_t entries_count_;
+};
+
+static_assert(sizeof(SidecarHeader) == 32, "sidecar header layout");
+static_assert(sizeof(SidecarStream) == 24, "sidecar stream layout");
+static_assert(sizeof(AvcKeyframeEntry) == 32, "sidecar entry layout");
+
+int64_t EntryTimestamp(const AvcKeyframeEntry& entry) {
+  return entry.dts_ != AV_NOPTS_VALUE ? entry.dts_ : entry.pts_;
+}
+
+uint64_t GetLocalFileSize(const std::string& url) {
+  std::string path = url;
+  if (path.compare(0, 5, "file:") == 0)
+    path = path.substr(5);
+
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file)
+    return 0;
+
+  std::streamoff size = file.tellg();
+  return size > 0 ? static_cast<uint64_t>(size) : 0;
+}
+
+}  // namespace
+
+AvcKeyframeIndex::AvcKeyframeIndex(std::shared_ptr<IAvcModuleProvider> avc_module_provider)
+  : avc_module_provider_(avc_module_provider) {
+}
+
+int AvcKeyframeIndex::Build(const std::string& input_url) {
+  AvcMediaInput input(avc_module_provider_);
+  // Stream info is not needed to find keyframes, skipping it avoids decoding
+  int res = input.Open(input_url, nullptr, false);
+  if (res < 0)
+    return res;
+
+  Reset(input.GetFormatContext());
+  source_size_ = GetLocalFileSize(input_url);
+
+  AVPacket* packet = avc_module_provider_->av_packet_alloc();
+  if (!packet)
+    return AVERROR(ENOMEM);
+
+  while ((res = avc_module_provider_->av_read_frame(input.GetFormatContext(), packet)) >= 0) {
+    AddPacket(packet);
+    avc_module_provider_->av_packet_unref(packet);
+  }
+  avc_module_provider_->av_packet_free(&packet);
+
+  return res == AVERROR_EOF ? 0 : res;
+}
+
+void AvcKeyframeIndex::Reset(const AVFormatContext* format_context) {
+  Clear();
+  if (!format_context)
+    return;
+
+  auto d = avc_module_provider_->d();
+  int streams_count = d->AVFormatContextGetNbStreams(format_context);
+  streams_.resize(static_cast<size_t>(std::max(streams_count, 0)));
+  for (int i = 0; i < streams_count; i++) {
+    AVStream* stream = d->AVFormatContextGetStreamByIdx(format_context, i);
+    AVCodecParameters* codecpar = d->AVStreamGetCodecPar(stream);
+    streams_[i].time_base_ = d->AVStreamGetTimeBase(stream);
+    streams_[i].nal_scanner_.Init(avc_module_provider_, d->AVCodecParametersGetCodecId(codecpar),
+                                  d->AVCodecParametersGetExtraData(codecpar),
+                                  d->AVCodecParametersGetExtraDataSize(codecpar));
+  }
+}
+
+void AvcKeyframeIndex::AddPacket(const AVPacket* packet) {
+  auto d = avc_module_provider_->d();
+  if (!packet)
+    return;
+
+  int stream_index = d->AVPacketGetStreamIndex(packet);
+  if (stream_index < 0 || stream_index >= static_cast<int>(streams_.size()))
+    return;
+
+  StreamIndex& stream = streams_[stream_index];
+  if (stream.mapped_entries_)
+    return;  // loaded index is read-only, Reset starts new one
+
+  int flags = d->AVPacketGetFlags(packet);
+  if ((flags & AV_PKT_FLAG_KEY) == 0) {
+    // Raw and transport stream demuxers may not flag H.264/HEVC keyframes, slice type tells
+    AvcNalScanResult scan;
+    int size = d->AVPacketGetSize(packet);
+    if (!stream.nal_scanner_.IsEnabled() || size <= 0 ||
+        stream.nal_scanner_.Scan(static_cast<const uint8_t*>(d->AVPacketGetData(packet)), size, &scan) < 0 ||
+        !scan.keyframe_)
+      return;
+    flags |= AV_PKT_FLAG_KEY;
+  }
+
+  AvcKeyframeEntry entry;
+  entry.pts_ = d->AVPacketGetPts(packet);
+  entry.dts_ = d->AVPacketGetDts(packet);
+  entry.pos_ = d->AVPacketGetPos(packet);
+  entry.size_ = d->AVPacketGetSize(packet);
+  entry.flags_ = flags;
+
+  int64_t timestamp = EntryTimestamp(entry);
+  if (timestamp == AV_NOPTS_VALUE)
+    return;
+
+  // Packets come in order while streaming, after seek back they may repeat
+  auto& entries = stream.entries_;
+  if (entries.empty() || EntryTimestamp(entries.back()) < timestamp) {
+    entries.push_back(entry);
+    return;
+  }
+
+  auto it = std::lower_bound(entries.begin(), entries.end(), timestamp,
+    [](const AvcKeyframeEntry& e, int64_t ts) { return EntryTimestamp(e) < ts; });
+  if (it != entries.end() && EntryTimestamp(*it) == timestamp && it->pos_ == entry.pos_)
+    return;
+
+  entries.insert(it, entry);
+}
+
+int AvcKeyframeIndex::Save(const std::string& sidecar_url) const {
+  SidecarHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic_, kSidecarMagic, sizeof(kSidecarMagic));
+  header.version_ = kSidecarVersion;
+  header.byte_order_ = kSidecarByteOrder;
+  header.source_size_ = source_size_;
+  header.streams_count_ = static_cast<uint32_t>(streams_.size());
+
+  std::vector<SidecarStream> table(streams_.size());
+  uint64_t offset = sizeof(SidecarHeader) + sizeof(SidecarStream) * table.size();
+  for (size_t i = 0; i < streams_.size(); i++) {
+    table[i].time_base_num_ = streams_[i].time_base_.num_;
+    table[i].time_base_den_ = streams_[i].time_base_.den_;
+    table[i].entries_offset_ = offset;
+    table[i].entries_count_ = GetEntriesCount(static_cast<int>(i));
+    offset += table[i].entries_count_ * sizeof(AvcKeyframeEntry);
+  }
+
+  FILE* file = fopen(sidecar_url.c_str(), "wb");
+  if (!file)
+    return AVERROR(errno ? errno : EIO);
+
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+  if (ok && !table.empty())
+    ok = fwrite(table.data(), sizeof(SidecarStream), table.size(), file) == table.size();
+
+  for (size_t i = 0; ok && i < streams_.size(); i++) {
+    size_t count = static_cast<size_t>(table[i].entries_count_);
+    if (count > 0)
+      ok = fwrite(GetEntries(static_cast<int>(i)), sizeof(AvcKeyframeEntry), count, file) == count;
+  }
+
+  if (fclose(file) != 0)
+    ok = false;
+
+  if (!ok) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcKeyframeIndex: cannot write sidecar %s\n", sidecar_url.c_str());
+#endif //DEBUG_PRINT
+    remove(sidecar_url.c_str());
+    return AVERROR(EIO);
+  }
+  return 0;
+}
+
+int AvcKeyframeIndex::Load(const std::string& sidecar_url, const std::string& source_url) {
+  Clear();
+  if (!mapped_file_.Open(sidecar_url))
+    return AVERROR(ENOENT);
+
+  const uint8_t* data = mapped_file_.GetData();
+  size_t size = mapped_file_.GetSize();
+
+  SidecarHeader header;
+  if (size < sizeof(header)) {
+    Clear();
+    return AVERROR_INVALIDDATA;
+  }
+
+  memcpy(&header, data, sizeof(header));
+  if (memcmp(header.magic_, kSidecarMagic, sizeof(kSidecarMagic)) != 0 || header.version_ != kSidecarVersion ||
+      header.byte_order_ != kSidecarByteOrder ||
+      header.streams_count_ > (size - sizeof(header)) / sizeof(SidecarStream)) {
+    Clear();
+    return AVERROR_INVALIDDATA;
+  }
+
+  // Changed source invalidates byte positions
+  if (!source_url.empty() && header.source_size_ != 0) {
+    uint64_t source_size = GetLocalFileSize(source_url);
+    if (source_size != 0 && source_size != header.source_size_) {
+      Clear();
+      return AVERROR_INVALIDDATA;
+    }
+  }
+
+  const SidecarStream* table = reinterpret_cast<const SidecarStream*>(data + sizeof(header));
+  streams_.resize(header.streams_count_);
+  for (uint32_t i = 0; i < header.streams_count_; i++) {
+    const SidecarStream& desc = table[i];
+    if (desc.entries_offset_ > size || desc.entries_offset_ % alignof(AvcKeyframeEntry) != 0 ||
+        desc.entries_count_ > (size - desc.entries_offset_) / sizeof(AvcKeyframeEntry)) {
+      Clear();
+      return AVERROR_INVALIDDATA;
+    }
+
+    streams_[i].time_base_ = cmf::MediaTimeBase(desc.time_base_num_, desc.time_base_den_);
+    streams_[i].mapped_entries_ = reinterpret_cast<const AvcKeyframeEntry*>(data + desc.entries_offset_);
+    streams_[i].mapped_count_ = static_cast<size_t>(desc.entries_count_);
+  }
+
+  source_size_ = header.source_size_;
+  return 0;
+}
+
+int AvcKeyframeIndex::Apply(AVFormatContext* format_context) const {
+  if (!format_context)
+    return AVERROR(EINVAL);
+
+  auto d = avc_module_provider_->d();
+  int streams_count = std::min(d->AVFormatContextGetNbStreams(format_context), GetStreamsCount());
+  int added = 0;
+
+  for (int i = 0; i < streams_count; i++) {
+    AVStream* stream = d->AVFormatContextGetStreamByIdx(format_context, i);
+    cmf::MediaTimeBase time_base = d->AVStreamGetTimeBase(stream);
+    const cmf::MediaTimeBase& recorded_time_base = streams_[i].time_base_;
+    bool rescale = time_base.num_ != recorded_time_base.num_ || time_base.den_ != recorded_time_base.den_;
+
+    AVRational src_time_base = ToAVRational(recorded_time_base);
+    AVRational dst_time_base = ToAVRational(time_base);
+
+    const AvcKeyframeEntry* entries = GetEntries(i);
+    size_t count = GetEntriesCount(i);
+    for (size_t j = 0; j < count; j++) {
+      const AvcKeyframeEntry& entry = entries[j];
+      if (entry.pos_ < 0)
+        continue;  // demuxer can not seek to entry without position
+
+      int64_t timestamp = EntryTimestamp(entry);
+      if (rescale)
+        timestamp = avc_module_provider_->av_rescale_q_rnd(timestamp, src_time_base, dst_time_base,
+          AV_ROUND_NEAR_INF | AV_ROUND_PASS_MINMAX);
+
+      if (avc_module_provider_->av_add_index_entry(stream, entry.pos_, timestamp, entry.size_, 0, AVINDEX_KEYFRAME) >= 0)
+        added++;
+    }
+  }
+
+  return added;
+}
+
+size_t AvcKeyframeIndex::GetEntriesCount(int stream_index) const {
+  if (stream_index < 0 || stream_index >= GetStreamsCount())
+    return 0;
+
+  const StreamIndex& stream = streams_[stream_index];
+  return stream.mapped_entries_ ? stream.mapped_count_ : stream.entries_.size();
+}
+
+const AvcKeyframeEntry* AvcKeyframeIndex::GetEntries(int stream_index) const {
+  if (stream_index < 0 || stream_index >= GetStreamsCount())
+    return nullptr;
+
+  const StreamIndex& stream = streams_[stream_index];
+  return stream.mapped_entries_ ? stream.mapped_entries_ : stream.entries_.data();
+}
+
+void AvcKeyframeIndex::Clear() {
+  streams_.clear();
+  source_size_ = 0;
+  mapped_file_.Close();
+}
+
+}  // namespace detail
+}//namespace avc
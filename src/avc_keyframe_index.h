@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_KEYFRAME_INDEX_HEADER
+#define AVC_KEYFRAME_INDEX_HEADER
+
+#include <avc/i_avc_keyframe_index.h>
+#include <avc/i_avc_module_provider.h>
+#include "avc_mapped_file.h"
+#include "avc_nal_scanner.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcKeyframeIndex
+  : public virtual IAvcKeyframeIndex {
+ public:
+  explicit AvcKeyframeIndex(std::shared_ptr<IAvcModuleProvider> avc_module_provider);
+  virtual ~AvcKeyframeIndex() = default;
+
+  int Build(const std::string& input_url) override;
+  void Reset(const AVFormatContext* format_context) override;
+  void AddPacket(const AVPacket* packet) override;
+  int Save(const std::string& sidecar_url) const override;
+  int Load(const std::string& sidecar_url, const std::string& source_url) override;
+  int Apply(AVFormatContext* format_context) const override;
+
+  int GetStreamsCount() const override { return static_cast<int>(streams_.size()); }
+  size_t GetEntriesCount(int stream_index) const override;
+  const AvcKeyframeEntry* GetEntries(int stream_index) const override;
+
+ private:
+  struct StreamIndex {
+    cmf::MediaTimeBase time_base_;
+    std::vector<AvcKeyframeEntry> entries_;           ///< collected by AddPacket
+    const AvcKeyframeEntry* mapped_entries_ = nullptr; ///< points to sidecar mapping after Load
+    size_t mapped_count_ = 0;
+    AvcNalScanner nal_scanner_;                        ///< finds keyframes not flagged by demuxer
+  };
+
+  void Clear();
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  std::vector<StreamIndex> streams_;
+  uint64_t source_size_ = 0;
+  AvcMappedFile mapped_file_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_KEYFRAME_INDEX_HEADER
@@ -0,0 +1,257 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_keyframe_sampler.h"
+#include <avc/libav_detached_common.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+
+std::shared_ptr<IAvcKeyframeSampler> API_EXPORT CreateAvcKeyframeSampler(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcKeyframeSamplerConfig& config) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  if (!avc_module_provider->IsAvFormatLoaded() || !avc_module_provider->IsAvCodecLoaded())
+    return nullptr;
+
+  return std::make_shared<avc::detail::AvcKeyframeSampler>(avc_module_provider, config);
+}
+
+namespace detail {
+
+AvcKeyframeSampler::AvcKeyframeSampler(std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+                                       const AvcKeyframeSamplerConfig& config)
+  : avc_module_provider_(avc_module_provider)
+  , config_(config)
+  , input_(avc_module_provider)
+  , last_sample_timestamp_(AV_NOPTS_VALUE) {
+  if (config_.interval_seconds_ <= 0)
+    config_.interval_seconds_ = AvcKeyframeSamplerConfig().interval_seconds_;
+}
+
+AvcKeyframeSampler::~AvcKeyframeSampler() {
+  Close();
+}
+
+int AvcKeyframeSampler::Open(const std::string& url, int stream_index) {
+  Close();
+
+  int res = input_.Open(url);
+  if (res < 0)
+    return res;
+
+  if (stream_index < 0)
+    stream_index = input_.FindBestStream(AVMEDIA_TYPE_VIDEO);
+  if (stream_index < 0 || stream_index >= input_.GetStreamsCount()) {
+    Close();
+    return AVERROR_STREAM_NOT_FOUND;
+  }
+
+  // Frame threading delays output by threads count packets, slice threading returns frame of every packet
+  decoder_context_ = input_.OpenDecoder(stream_index, config_.threads_count_, nullptr, FF_THREAD_SLICE);
+  packet_ = avc_module_provider_->av_packet_alloc();
+  if (!decoder_context_ || !packet_) {
+    Close();
+    return decoder_context_ ? AVERROR(ENOMEM) : AVERROR_DECODER_NOT_FOUND;
+  }
+
+  auto d = avc_module_provider_->d();
+  d->AVCodecContextSetSkipFrame(decoder_context_, AVDISCARD_NONKEY);
+  if (config_.skip_loop_filter_)
+    d->AVCodecContextSetSkipLoopFilter(decoder_context_, AVDISCARD_ALL);
+  d->AVCodecContextSetSkipIdct(decoder_context_, AVDISCARD_NONKEY);
+
+  // Other streams are not read at all. Demuxers which support it (mov/mp4) also skip non-key samples
+  for (int i = 0; i < input_.GetStreamsCount(); i++)
+    d->AVStreamSetDiscard(input_.GetStream(i), i == stream_index ? AVDISCARD_NONKEY : AVDISCARD_ALL);
+
+  if (config_.detect_keyframes_) {
+    AVCodecParameters* codecpar = d->AVStreamGetCodecPar(input_.GetStream(stream_index));
+    nal_scanner_.Init(avc_module_provider_, d->AVCodecParametersGetCodecId(codecpar),
+                      d->AVCodecParametersGetExtraData(codecpar), d->AVCodecParametersGetExtraDataSize(codecpar));
+  }
+
+  stream_index_ = stream_index;
+  time_base_ = input_.GetStreamTimeBase(stream_index);
+  int64_t start_time = d->AVStreamGetStartTime(input_.GetStream(stream_index));
+  start_timestamp_ = start_time != AV_NOPTS_VALUE ? start_time : 0;
+  return 0;
+}
+
+void AvcKeyframeSampler::Close() {
+  if (decoder_context_)
+    avc_module_provider_->avcodec_free_context(&decoder_context_);
+  if (packet_)
+    avc_module_provider_->av_packet_free(&packet_);
+  input_.Close();
+  nal_scanner_ = AvcNalScanner();
+
+  stream_index_ = -1;
+  next_point_ = 0;
+  last_sample_timestamp_ = AV_NOPTS_VALUE;
+  stat_ = AvcKeyframeSamplerStatistics();
+}
+
+int AvcKeyframeSampler::NextFrame(AVFrame* dst) {
+  if (!decoder_context_ || !dst)
+    return AVERROR(EINVAL);
+
+  if (config_.max_frames_ > 0 && stat_.frames_sampled_ >= static_cast<uint64_t>(config_.max_frames_))
+    return AVERROR_EOF;
+
+  for (;;) {
+    int64_t target = GetPointTimestamp(next_point_++);
+    int res = avc_module_provider_->av_seek_frame(input_.GetFormatContext(), stream_index_, target, AVSEEK_FLAG_BACKWARD);
+    stat_.seeks_++;
+    if (res < 0) {
+      // Seek after last keyframe fails on most demuxers: there are no more samples
+      return stat_.frames_sampled_ > 0 ? AVERROR_EOF : res;
+    }
+
+    // Keyframe before sampling point may be already returned when GOP is longer than interval,
+    // then next keyframe is sample
+    int64_t timestamp;
+    for (;;) {
+      res = ReadKeyPacket();
+      if (res < 0)
+        return res;
+
+      timestamp = GetPacketTimestamp(packet_);
+      if (last_sample_timestamp_ == AV_NOPTS_VALUE || timestamp > last_sample_timestamp_)
+        break;
+
+      stat_.packets_skipped_++;
+      avc_module_provider_->av_packet_unref(packet_);
+    }
+
+    last_sample_timestamp_ = timestamp;
+    // Sampling points covered by this keyframe do not need own seek
+    while (GetPointTimestamp(next_point_) <= timestamp)
+      next_point_++;
+
+    res = DecodeKeyPacket(dst);
+    if (res == AVERROR_INVALIDDATA || res == AVERROR(EAGAIN))
+      continue;  // broken keyframe, take next sampling point
+    if (res < 0)
+      return res;
+
+    auto d = avc_module_provider_->d();
+    if (d->AVFrameGetPts(dst) == AV_NOPTS_VALUE)
+      d->AVFrameSetPts(dst, timestamp);
+
+    stat_.frames_sampled_++;
+    return 0;
+  }
+}
+
+int64_t AvcKeyframeSampler::GetPointTimestamp(int point) const {
+  double seconds = config_.start_seconds_ + config_.interval_seconds_ * point;
+  if (time_base_.num_ <= 0 || time_base_.den_ <= 0)
+    return start_timestamp_ + static_cast<int64_t>(seconds);
+
+  return start_timestamp_ + static_cast<int64_t>(seconds * time_base_.den_ / time_base_.num_);
+}
+
+int64_t AvcKeyframeSampler::GetPacketTimestamp(const AVPacket* packet) const {
+  auto d = avc_module_provider_->d();
+  int64_t timestamp = d->AVPacketGetPts(packet);
+  return timestamp != AV_NOPTS_VALUE ? timestamp : d->AVPacketGetDts(packet);
+}
+
+int AvcKeyframeSampler::ReadKeyPacket() {
+  auto d = avc_module_provider_->d();
+  for (;;) {
+    int res = avc_module_provider_->av_read_frame(input_.GetFormatContext(), packet_);
+    if (res < 0)
+      return res;
+
+    if (d->AVPacketGetStreamIndex(packet_) == stream_index_) {
+      stat_.packets_read_++;
+      bool keyframe = (d->AVPacketGetFlags(packet_) & AV_PKT_FLAG_KEY) != 0;
+      if (!keyframe && nal_scanner_.IsEnabled() && nal_scanner_.ScanPacket(packet_) > 0) {
+        keyframe = true;
+        stat_.keyframes_detected_++;
+      }
+
+      if (keyframe && GetPacketTimestamp(packet_) != AV_NOPTS_VALUE)
+        return 0;
+      stat_.packets_skipped_++;
+    }
+
+    avc_module_provider_->av_packet_unref(packet_);
+  }
+}
+
+int AvcKeyframeSampler::DecodeKeyPacket(AVFrame* dst) {
+  auto start = std::chrono::steady_clock::now();
+
+  // Decoder state belongs to previous position, every sample is decoded from clean state
+  avc_module_provider_->avcodec_flush_buffers(decoder_context_);
+  int res = avc_module_provider_->avcodec_send_packet(decoder_context_, packet_);
+  avc_module_provider_->av_packet_unref(packet_);
+  stat_.packets_decoded_++;
+
+  if (res >= 0) {
+    res = avc_module_provider_->avcodec_receive_frame(decoder_context_, dst);
+    if (res == AVERROR(EAGAIN)) {
+      // Decoder with reorder delay holds frame until more packets come, drain it instead
+      avc_module_provider_->avcodec_send_packet(decoder_context_, nullptr);
+      res = avc_module_provider_->avcodec_receive_frame(decoder_context_, dst);
+      if (res == AVERROR_EOF)
+        res = AVERROR(EAGAIN);
+    }
+  }
+
+  avc_module_provider_->avcodec_flush_buffers(decoder_context_);
+  stat_.decode_ms_ += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+#if DEBUG_PRINT
+  if (res < 0)
+    fprintf(stderr, "AvcKeyframeSampler: key packet is not decoded %d\n", res);
+#endif //DEBUG_PRINT
+  return res;
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_KEYFRAME_SAMPLER_HEADER
+#define AVC_KEYFRAME_SAMPLER_HEADER
+
+#include <avc/i_avc_keyframe_sampler.h>
+#include <avc/i_avc_module_provider.h>
+#include "avc_media_input.h"
+#include "avc_nal_scanner.h"
+
+#include <memory>
+#include <string>
+
+namespace avc {
+namespace detail {
+
+class AvcKeyframeSampler
+  : public virtual IAvcKeyframeSampler {
+ public:
+  AvcKeyframeSampler(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcKeyframeSamplerConfig& config);
+  virtual ~AvcKeyframeSampler();
+
+  int Open(const std::string& url, int stream_index) override;
+  void Close() override;
+  int NextFrame(AVFrame* dst) override;
+
+  int GetStreamIndex() const override { return stream_index_; }
+  cmf::MediaTimeBase GetTimeBase() const override { return time_base_; }
+  AvcKeyframeSamplerStatistics GetStatistics() const override { return stat_; }
+
+ private:
+  int64_t GetPointTimestamp(int point) const;
+  int64_t GetPacketTimestamp(const AVPacket* packet) const;
+  int ReadKeyPacket();
+  int DecodeKeyPacket(AVFrame* dst);
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AvcKeyframeSamplerConfig config_;
+
+  AvcMediaInput input_;
+  AVCodecContext* decoder_context_ = nullptr;
+  AVPacket* packet_ = nullptr;
+  AvcNalScanner nal_scanner_;
+  int stream_index_ = -1;
+  cmf::MediaTimeBase time_base_;
+  int64_t start_timestamp_ = 0;
+
+  int next_point_ = 0;              ///< index of next sampling point
+  int64_t last_sample_timestamp_;   ///< packet timestamp of last returned keyframe
+  AvcKeyframeSamplerStatistics stat_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_KEYFRAME_SAMPLER_HEADER
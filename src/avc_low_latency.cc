@@ -0,0 +1,244 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_low_latency.h"
+#include <avc/libav_detached_common.h>
+#include <algorithm>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+
+void API_EXPORT ApplyAvcLowLatencyInput(
+  IAvcModuleProvider* avc_module_provider,
+  AVFormatContext* format_context,
+  const AvcLowLatencyConfig& config) {
+  if (!avc_module_provider || !format_context)
+    return;
+
+  auto d = avc_module_provider->d();
+  d->AVFormatContextSetFlags(format_context, d->AVFormatContextGetFlags(format_context) | AVFMT_FLAG_NOBUFFER);
+  if (config.probe_size_ > 0)
+    d->AVFormatContextSetProbeSize(format_context, config.probe_size_);
+  if (config.max_analyze_duration_ > 0)
+    d->AVFormatContextSetMaxAnalyzeDuration(format_context, config.max_analyze_duration_);
+}
+
+void API_EXPORT ApplyAvcLowLatencyDecoder(
+  IAvcModuleProvider* avc_module_provider,
+  AVCodecContext* codec_context,
+  const AvcLowLatencyConfig& config) {
+  if (!avc_module_provider || !codec_context)
+    return;
+
+  auto d = avc_module_provider->d();
+  d->AVCodecContextSetFlags(codec_context, d->AVCodecContextGetFlags(codec_context) | AV_CODEC_FLAG_LOW_DELAY);
+  if (config.fast_decoding_)
+    d->AVCodecContextSetFlags2(codec_context, d->AVCodecContextGetFlags2(codec_context) | AV_CODEC_FLAG2_FAST);
+
+  // frame threads hold one frame per thread before output
+  d->AVCodecContextSetThreadType(codec_context, FF_THREAD_SLICE);
+}
+
+void API_EXPORT ApplyAvcLowLatencyEncoder(
+  IAvcModuleProvider* avc_module_provider,
+  AVCodecContext* codec_context) {
+  if (!avc_module_provider || !codec_context)
+    return;
+
+  auto d = avc_module_provider->d();
+  d->AVCodecContextSetFlags(codec_context, d->AVCodecContextGetFlags(codec_context) | AV_CODEC_FLAG_LOW_DELAY);
+  d->AVCodecContextSetMaxBFrames(codec_context, 0);
+  d->AVCodecContextSetThreadType(codec_context, FF_THREAD_SLICE);
+}
+
+void API_EXPORT ApplyAvcLowLatencyOutput(
+  IAvcModuleProvider* avc_module_provider,
+  AVFormatContext* format_context) {
+  if (!avc_module_provider || !format_context)
+    return;
+
+  auto d = avc_module_provider->d();
+  d->AVFormatContextSetFlags(format_context, d->AVFormatContextGetFlags(format_context) | AVFMT_FLAG_FLUSH_PACKETS);
+}
+
+std::shared_ptr<IAvcLatencyTracer> API_EXPORT CreateAvcLatencyTracer(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcLatencyTracerConfig& config) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  return std::make_shared<avc::detail::AvcLatencyTracer>(avc_module_provider, config);
+}
+
+namespace detail {
+
+AvcLatencyTracer::AvcLatencyTracer(std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+                                   const AvcLatencyTracerConfig& config)
+  : avc_module_provider_(avc_module_provider)
+  , config_(config) {
+  config_.samples_per_stream_ = std::max<size_t>(config_.samples_per_stream_, 1);
+  config_.max_pending_per_stream_ = std::max<size_t>(config_.max_pending_per_stream_, 1);
+}
+
+int AvcLatencyTracer::ReadFrame(AVFormatContext* format_context, AVPacket* packet) {
+  int ret = avc_module_provider_->av_read_frame(format_context, packet);
+  if (ret >= 0)
+    StampPacket(packet);
+  return ret;
+}
+
+void AvcLatencyTracer::StampPacket(const AVPacket* packet) {
+  if (!packet)
+    return;
+
+  Clock::time_point now = Clock::now();
+  auto d = avc_module_provider_->d();
+  int64_t timestamp = d->AVPacketGetPts(packet);
+  if (timestamp == AV_NOPTS_VALUE)
+    timestamp = d->AVPacketGetDts(packet);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  StreamLatency& stream = streams_[d->AVPacketGetStreamIndex(packet)];
+  stream.stat_.packets_stamped_++;
+  if (timestamp == AV_NOPTS_VALUE)
+    return;
+
+  if (stream.pending_.size() >= config_.max_pending_per_stream_) {
+    stream.pending_.pop_front();
+    stream.stat_.stamps_dropped_++;
+  }
+  stream.pending_.push_back(Stamp{ timestamp, now });
+}
+
+void AvcLatencyTracer::OnFrameOut(int stream_index, const AVFrame* frame) {
+  if (!frame)
+    return;
+
+  Clock::time_point now = Clock::now();
+  auto d = avc_module_provider_->d();
+  int64_t timestamp = d->AVFrameGetPts(frame);
+  if (timestamp == AV_NOPTS_VALUE)
+    timestamp = d->AVFrameGetPktDts(frame);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  StreamLatency& stream = streams_[stream_index];
+
+  // stamps older than frame will not get own frame any more: decoder outputs frames in pts order
+  bool found = false;
+  Clock::time_point read_time;
+  for (auto it = stream.pending_.begin(); it != stream.pending_.end();) {
+    if (!found && it->timestamp_ == timestamp) {
+      read_time = it->time_;
+      found = true;
+      it = stream.pending_.erase(it);
+    } else if (timestamp != AV_NOPTS_VALUE && it->timestamp_ < timestamp) {
+      stream.stat_.stamps_dropped_++;
+      it = stream.pending_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  if (!found) {
+    stream.stat_.frames_unmatched_++;
+    return;
+  }
+
+  int64_t latency_us = std::chrono::duration_cast<std::chrono::microseconds>(now - read_time).count();
+  if (stream.samples_.size() < config_.samples_per_stream_) {
+    stream.samples_.push_back(latency_us);
+  } else {
+    stream.samples_[stream.next_sample_] = latency_us;
+    stream.next_sample_ = (stream.next_sample_ + 1) % stream.samples_.size();
+  }
+
+  AvcLatencyStatistics& stat = stream.stat_;
+  if (!stat.frames_measured_ || latency_us < stat.min_us_)
+    stat.min_us_ = latency_us;
+  if (!stat.frames_measured_ || latency_us > stat.max_us_)
+    stat.max_us_ = latency_us;
+  stat.frames_measured_++;
+  stream.sum_us_ += latency_us;
+}
+
+std::vector<int> AvcLatencyTracer::GetStreamIndexes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<int> stream_indexes;
+  for (auto& stream : streams_)
+    stream_indexes.push_back(stream.first);
+  return stream_indexes;
+}
+
+AvcLatencyStatistics AvcLatencyTracer::GetStreamStatistics(int stream_index) const {
+  std::vector<int64_t> samples;
+  AvcLatencyStatistics stat;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(stream_index);
+    if (it == streams_.end())
+      return stat;
+
+    stat = it->second.stat_;
+    samples = it->second.samples_;
+    if (stat.frames_measured_)
+      stat.mean_us_ = static_cast<double>(it->second.sum_us_) / stat.frames_measured_;
+  }
+
+  if (samples.empty())
+    return stat;
+
+  // nearest rank percentiles
+  std::sort(samples.begin(), samples.end());
+  auto percentile = [&samples](size_t percent) {
+    size_t rank = (samples.size() * percent + 99) / 100;
+    return samples[rank > 0 ? rank - 1 : 0];
+  };
+  stat.p50_us_ = percentile(50);
+  stat.p90_us_ = percentile(90);
+  stat.p99_us_ = percentile(99);
+  return stat;
+}
+
+void AvcLatencyTracer::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  streams_.clear();
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,78 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_LOW_LATENCY_HEADER
+#define AVC_LOW_LATENCY_HEADER
+
+#include <avc/i_avc_low_latency.h>
+#include <avc/i_avc_module_provider.h>
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcLatencyTracer
+  : public virtual IAvcLatencyTracer {
+ public:
+  AvcLatencyTracer(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcLatencyTracerConfig& config);
+  virtual ~AvcLatencyTracer() = default;
+
+  int ReadFrame(AVFormatContext* format_context, AVPacket* packet) override;
+  void StampPacket(const AVPacket* packet) override;
+  void OnFrameOut(int stream_index, const AVFrame* frame) override;
+
+  std::vector<int> GetStreamIndexes() const override;
+  AvcLatencyStatistics GetStreamStatistics(int stream_index) const override;
+  void Reset() override;
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Stamp {
+    int64_t timestamp_;
+    Clock::time_point time_;
+  };
+
+  struct StreamLatency {
+    std::deque<Stamp> pending_;
+    std::vector<int64_t> samples_;    ///< ring of last latencies, microseconds
+    size_t next_sample_ = 0;
+    AvcLatencyStatistics stat_;
+    int64_t sum_us_ = 0;
+  };
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AvcLatencyTracerConfig config_;
+  mutable std::mutex mutex_;
+  std::map<int, StreamLatency> streams_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_LOW_LATENCY_HEADER
@@ -0,0 +1,180 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#include "avc_media_input.h"
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>
+#include <cerrno>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+namespace detail {
+
+AvcMediaInput::AvcMediaInput(std::shared_ptr<IAvcModuleProvider> avc_module_provider)
+  : avc_module_provider_(avc_module_provider) {
+}
+
+AvcMediaInput::~AvcMediaInput() {
+  Close();
+}
+
+int AvcMediaInput::Open(const std::string& url, AVDictionary** options, bool find_stream_info,
+                        const AvcLowLatencyConfig* low_latency) {
+  Close();
+
+  if (!avc_module_provider_ || !avc_module_provider_->IsAvFormatLoaded() || !avc_module_provider_->IsAvCodecLoaded())
+    return AVERROR(ENOSYS);
+
+  if (low_latency) {
+    // flags and probe limits are read by avformat_open_input, so context is allocated before
+    format_context_ = avc_module_provider_->avformat_alloc_context();
+    if (!format_context_)
+      return AVERROR(ENOMEM);
+
+    ApplyAvcLowLatencyInput(avc_module_provider_.get(), format_context_, *low_latency);
+  }
+
+  // avformat_open_input frees context allocated by caller on failure
+  int ret = avc_module_provider_->avformat_open_input(&format_context_, url.c_str(), nullptr, options);
+  if (ret < 0) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcMediaInput: avformat_open_input failed %d url %s\n", ret, url.c_str());
+#endif //DEBUG_PRINT
+    format_context_ = nullptr;
+    return ret;
+  }
+
+  if (find_stream_info) {
+    ret = avc_module_provider_->avformat_find_stream_info(format_context_, nullptr);
+    if (ret < 0) {
+#if DEBUG_PRINT
+      fprintf(stderr, "AvcMediaInput: avformat_find_stream_info failed %d url %s\n", ret, url.c_str());
+#endif //DEBUG_PRINT
+      Close();
+      return ret;
+    }
+  }
+
+  url_ = url;
+  return 0;
+}
+
+void AvcMediaInput::Close() {
+  if (format_context_)
+    avc_module_provider_->avformat_close_input(&format_context_);
+
+  format_context_ = nullptr;
+  url_.clear();
+}
+
+int AvcMediaInput::GetStreamsCount() const {
+  if (!format_context_)
+    return 0;
+
+  return avc_module_provider_->d()->AVFormatContextGetNbStreams(format_context_);
+}
+
+AVStream* AvcMediaInput::GetStream(int stream_index) const {
+  if (stream_index < 0 || stream_index >= GetStreamsCount())
+    return nullptr;
+
+  return avc_module_provider_->d()->AVFormatContextGetStreamByIdx(format_context_, stream_index);
+}
+
+int AvcMediaInput::GetStreamMediaType(int stream_index) const {
+  AVStream* stream = GetStream(stream_index);
+  if (!stream)
+    return AVMEDIA_TYPE_UNKNOWN;
+
+  auto d = avc_module_provider_->d();
+  return d->AVCodecParametersGetCodecType(d->AVStreamGetCodecPar(stream));
+}
+
+cmf::MediaTimeBase AvcMediaInput::GetStreamTimeBase(int stream_index) const {
+  AVStream* stream = GetStream(stream_index);
+  if (!stream)
+    return cmf::MediaTimeBase{ 0, 0 };
+
+  return avc_module_provider_->d()->AVStreamGetTimeBase(stream);
+}
+
+int AvcMediaInput::FindBestStream(int media_type) const {
+  if (!format_context_)
+    return AVERROR(EINVAL);
+
+  return avc_module_provider_->av_find_best_stream(format_context_, media_type, -1, -1, nullptr, 0);
+}
+
+AVCodecContext* AvcMediaInput::OpenDecoder(int stream_index, int thread_count, AVDictionary** options,
+                                           int thread_type, const AvcLowLatencyConfig* low_latency,
+                                           IAvcCodecAutotuner* autotuner) const {
+  AVStream* stream = GetStream(stream_index);
+  if (!stream)
+    return nullptr;
+
+  auto d = avc_module_provider_->d();
+  AVCodecParameters* codecpar = d->AVStreamGetCodecPar(stream);
+  AVCodec* codec = avc_module_provider_->avcodec_find_decoder(d->AVCodecParametersGetCodecId(codecpar));
+  if (!codec) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcMediaInput: decoder not found for stream %d\n", stream_index);
+#endif //DEBUG_PRINT
+    return nullptr;
+  }
+
+  AVCodecContext* codec_context = avc_module_provider_->avcodec_alloc_context3(codec);
+  if (!codec_context)
+    return nullptr;
+
+  int ret = avc_module_provider_->avcodec_parameters_to_context(codec_context, codecpar);
+  if (ret >= 0) {
+    d->AVCodecContextSetPktTimeBase(codec_context, d->AVStreamGetTimeBase(stream));
+    d->AVCodecContextSetThreadCount(codec_context, thread_count);
+    if (thread_type != 0)
+      d->AVCodecContextSetThreadType(codec_context, thread_type);
+    else if (autotuner && thread_count == 0 && !low_latency)
+      autotuner->Apply(codec_context, false);
+    if (low_latency)
+      ApplyAvcLowLatencyDecoder(avc_module_provider_.get(), codec_context, *low_latency);
+    ret = avc_module_provider_->avcodec_open2(codec_context, codec, options);
+  }
+
+  if (ret < 0) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcMediaInput: failed to open decoder %d for stream %d\n", ret, stream_index);
+#endif //DEBUG_PRINT
+    avc_module_provider_->avcodec_free_context(&codec_context);
+    return nullptr;
+  }
+
+  return codec_context;
+}
+
+}  // namespace detail
+}//namespace avc
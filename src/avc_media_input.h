@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_MEDIA_INPUT_HEADER
+#define AVC_MEDIA_INPUT_HEADER
+
+#include <avc/i_avc_codec_autotuner.h>
+#include <avc/i_avc_low_latency.h>
+#include <avc/i_avc_module_provider.h>
+
+#include <memory>
+#include <string>
+
+namespace avc {
+namespace detail {
+
+/// \brief Opened demuxer with helpers to create stream decoders. Used by frame cache, pipelines and tools
+class AvcMediaInput {
+ public:
+  explicit AvcMediaInput(std::shared_ptr<IAvcModuleProvider> avc_module_provider);
+  ~AvcMediaInput();
+
+  AvcMediaInput(const AvcMediaInput&) = delete;
+  AvcMediaInput& operator=(const AvcMediaInput&) = delete;
+
+  /// \brief low_latency applies low-latency demuxer profile before input is opened
+  int Open(const std::string& url, AVDictionary** options = nullptr, bool find_stream_info = true,
+           const AvcLowLatencyConfig* low_latency = nullptr);
+  void Close();
+  bool IsOpened() const { return format_context_ != nullptr; }
+
+  const std::string& GetUrl() const { return url_; }
+  AVFormatContext* GetFormatContext() const { return format_context_; }
+  int GetStreamsCount() const;
+  AVStream* GetStream(int stream_index) const;
+  int GetStreamMediaType(int stream_index) const;
+  cmf::MediaTimeBase GetStreamTimeBase(int stream_index) const;
+  int FindBestStream(int media_type) const;
+
+  /// \brief Allocate and open decoder for stream. Caller frees context by avcodec_free_context.
+  /// thread_type 0 keeps decoder default (FF_THREAD_FRAME | FF_THREAD_SLICE), low_latency overrides it.
+  /// autotuner replaces automatic threading (thread_count and thread_type 0) by calibrated settings
+  AVCodecContext* OpenDecoder(int stream_index, int thread_count = 0, AVDictionary** options = nullptr,
+                              int thread_type = 0, const AvcLowLatencyConfig* low_latency = nullptr,
+                              IAvcCodecAutotuner* autotuner = nullptr) const;
+
+ private:
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AVFormatContext* format_context_ = nullptr;
+  std::string url_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_MEDIA_INPUT_HEADER
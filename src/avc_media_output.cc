@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#include "avc_media_output.h"
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>
+#include <cerrno>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+namespace detail {
+
+AvcMediaOutput::AvcMediaOutput(std::shared_ptr<IAvcModuleProvider> avc_module_provider)
+  : avc_module_provider_(avc_module_provider) {
+}
+
+AvcMediaOutput::~AvcMediaOutput() {
+  Close();
+}
+
+int AvcMediaOutput::Create(const std::string& url, const std::string& format_name, const std::string& format_url) {
+  Close();
+
+  if (!avc_module_provider_ || !avc_module_provider_->IsAvFormatLoaded())
+    return AVERROR(ENOSYS);
+
+  const std::string& guess_url = format_url.empty() ? url : format_url;
+  int ret = avc_module_provider_->avformat_alloc_output_context2(&format_context_, nullptr,
+    format_name.empty() ? nullptr : format_name.c_str(), guess_url.c_str());
+  if (ret < 0 || !format_context_) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcMediaOutput: avformat_alloc_output_context2 failed %d url %s\n", ret, url.c_str());
+#endif //DEBUG_PRINT
+    format_context_ = nullptr;
+    return ret < 0 ? ret : AVERROR(EINVAL);
+  }
+
+  url_ = url;
+  return 0;
+}
+
+int AvcMediaOutput::OpenFile() {
+  if (!format_context_)
+    return AVERROR(EINVAL);
+
+  if (file_opened_)
+    return 0;
+
+  auto d = avc_module_provider_->d();
+  const AVOutputFormat* oformat = d->AVFormatContextGetOutputFormat(format_context_);
+  if (oformat && (d->AVOutputFormatGetFlags(oformat) & AVFMT_NOFILE) != 0)
+    return 0;
+
+  // avio_open2 changes pointer inside structure, so get it and set it back
+  AVIOContext* ioctx = d->AVFormatContextGetPb(format_context_);
+  int ret = avc_module_provider_->avio_open2(&ioctx, url_.c_str(), AVIO_FLAG_WRITE, nullptr, nullptr);
+  if (ret < 0) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcMediaOutput: avio_open2 failed %d url %s\n", ret, url_.c_str());
+#endif //DEBUG_PRINT
+    return ret;
+  }
+
+  d->AVFormatContextSetPb(format_context_, ioctx);
+  file_opened_ = true;
+  return 0;
+}
+
+void AvcMediaOutput::CloseFile() {
+  if (!file_opened_ || !format_context_)
+    return;
+
+  auto d = avc_module_provider_->d();
+  AVIOContext* ioctx = d->AVFormatContextGetPb(format_context_);
+  avc_module_provider_->avio_closep(&ioctx);
+  d->AVFormatContextSetPb(format_context_, ioctx);
+  file_opened_ = false;
+}
+
+void AvcMediaOutput::Close() {
+  if (!format_context_)
+    return;
+
+  CloseFile();
+  avc_module_provider_->avformat_free_context(format_context_);
+  format_context_ = nullptr;
+  url_.clear();
+}
+
+bool AvcMediaOutput::IsGlobalHeader() const {
+  if (!format_context_)
+    return false;
+
+  auto d = avc_module_provider_->d();
+  const AVOutputFormat* oformat = d->AVFormatContextGetOutputFormat(format_context_);
+  return oformat && (d->AVOutputFormatGetFlags(oformat) & AVFMT_GLOBALHEADER) != 0;
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_MEDIA_OUTPUT_HEADER
+#define AVC_MEDIA_OUTPUT_HEADER
+
+#include <avc/i_avc_module_provider.h>
+
+#include <memory>
+#include <string>
+
+namespace avc {
+namespace detail {
+
+/// \brief Muxer context with its output file. Used by encode pipeline, remuxer, transcoders and tools
+class AvcMediaOutput {
+ public:
+  explicit AvcMediaOutput(std::shared_ptr<IAvcModuleProvider> avc_module_provider);
+  ~AvcMediaOutput();
+
+  AvcMediaOutput(const AvcMediaOutput&) = delete;
+  AvcMediaOutput& operator=(const AvcMediaOutput&) = delete;
+
+  /// \brief Allocate muxer. Empty format_name guesses format by format_url, empty format_url uses url.
+  /// File is not opened until OpenFile, so streams can be added before
+  int Create(const std::string& url, const std::string& format_name = std::string(),
+             const std::string& format_url = std::string());
+  /// \brief Open output file for writing, muxers with AVFMT_NOFILE flag need no file
+  int OpenFile();
+  /// \brief Close file after trailer is written, muxer is kept until Close
+  void CloseFile();
+  /// \brief Close file and free muxer
+  void Close();
+  bool IsCreated() const { return format_context_ != nullptr; }
+
+  /// \brief true when muxer wants codec headers in extradata (AVFMT_GLOBALHEADER)
+  bool IsGlobalHeader() const;
+
+  const std::string& GetUrl() const { return url_; }
+  AVFormatContext* GetFormatContext() const { return format_context_; }
+
+ private:
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AVFormatContext* format_context_ = nullptr;
+  std::string url_;
+  bool file_opened_ = false;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_MEDIA_OUTPUT_HEADER
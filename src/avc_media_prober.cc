@@ -0,0 +1,393 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_media_prober.h"
+#include "avc_media_input.h"
+#include <avc/libav_detached_common.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include <sys/stat.h>
+
+namespace avc {
+
+std::shared_ptr<IAvcMediaProber> API_EXPORT CreateAvcMediaProber(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcMediaProberConfig& config) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  if (!avc_module_provider->IsAvFormatLoaded() || !avc_module_provider->IsAvCodecLoaded())
+    return nullptr;
+
+  return std::make_shared<avc::detail::AvcMediaProber>(avc_module_provider, config);
+}
+
+namespace detail {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Cache file layout: header, then entries of result followed by path bytes. Integers are in host byte order,
+// file is rejected on host with other order or when result layout was changed
+const char kCacheMagic[8] = { 'A', 'V', 'C', 'P', 'R', 'O', 'B', 'E' };
+const uint32_t kCacheVersion = 1;
+const uint32_t kCacheByteOrder = 0x01020304;
+const uint32_t kCacheMaxPathSize = 64 * 1024;
+
+struct CacheHeader {
+  char magic_[8];
+  uint32_t version_;
+  uint32_t byte_order_;
+  uint32_t result_size_;      ///< sizeof(AvcProbeResult)
+  uint32_t reserved_;
+  uint64_t entries_count_;
+};
+
+struct CacheEntryHeader {
+  uint32_t path_size_;
+  uint32_t reserved_;
+};
+
+int ResolveThreadsCount(int threads_count) {
+  if (threads_count <= 0)
+    threads_count = static_cast<int>(std::thread::hardware_concurrency());
+  return threads_count > 0 ? threads_count : 1;
+}
+
+/// \brief Path, size and modification time of local regular file. Urls with other protocols are not cached
+bool GetLocalFileStat(const std::string& url, std::string* path, uint64_t* size, int64_t* mtime) {
+  *path = url;
+  if (path->compare(0, 5, "file:") == 0)
+    *path = path->substr(5);
+  else if (path->find("://") != std::string::npos)
+    return false;
+
+#ifdef _WIN32
+  struct _stat64 st;
+  if (_stat64(path->c_str(), &st) != 0 || (st.st_mode & _S_IFMT) != _S_IFREG)
+    return false;
+
+  *mtime = static_cast<int64_t>(st.st_mtime) * 1000000000;
+#else //_WIN32
+  struct stat st;
+  if (stat(path->c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+    return false;
+
+#if defined(__APPLE__)
+  *mtime = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else //__APPLE__
+  *mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif //__APPLE__
+#endif //_WIN32
+
+  *size = static_cast<uint64_t>(st.st_size);
+  return true;
+}
+
+/// \brief Failures which will repeat for unchanged file are cached too
+bool IsCacheable(int ret) {
+  return ret >= 0 || ret == AVERROR_INVALIDDATA || ret == AVERROR_DEMUXER_NOT_FOUND;
+}
+
+void FillResult(const IAvcModuleDataWrapper* d, const AVFormatContext* format_context, AvcProbeResult* result) {
+  result->duration_ = d->AVFormatContextGetDuration(format_context);
+  result->start_time_ = d->AVFormatContextGetStartTime(format_context);
+  result->streams_count_ = d->AVFormatContextGetNbStreams(format_context);
+
+  int count = std::min(result->streams_count_, kAvcProbeMaxStreams);
+  for (int i = 0; i < count; i++) {
+    AVStream* stream = d->AVFormatContextGetStreamByIdx(format_context, i);
+    AVCodecParameters* codecpar = d->AVStreamGetCodecPar(stream);
+    cmf::MediaTimeBase time_base = d->AVStreamGetTimeBase(stream);
+    cmf::MediaTimeBase frame_rate = d->AVStreamGetAvgFrameRage(stream);
+
+    AvcProbeStreamInfo& info = result->streams_[i];
+    info.index_ = i;
+    info.media_type_ = d->AVCodecParametersGetCodecType(codecpar);
+    info.codec_id_ = d->AVCodecParametersGetCodecId(codecpar);
+    info.profile_ = d->AVCodecParametersGetProfile(codecpar);
+    info.format_ = d->AVCodecParametersGetFormat(codecpar);
+    info.bit_rate_ = d->AVCodecParametersGetBitRate(codecpar);
+    info.time_base_num_ = time_base.num_;
+    info.time_base_den_ = time_base.den_;
+    info.start_time_ = d->AVStreamGetStartTime(stream);
+    if (info.media_type_ == AVMEDIA_TYPE_VIDEO) {
+      info.width_ = d->AVCodecParametersGetWidth(codecpar);
+      info.height_ = d->AVCodecParametersGetHeight(codecpar);
+      info.frame_rate_num_ = frame_rate.num_;
+      info.frame_rate_den_ = frame_rate.den_;
+    } else if (info.media_type_ == AVMEDIA_TYPE_AUDIO) {
+      info.sample_rate_ = d->AVCodecParametersGetSampleRate(codecpar);
+      info.channels_ = d->AVCodecParametersGetChannels(codecpar);
+    }
+  }
+}
+
+}  // namespace
+
+AvcMediaProber::AvcMediaProber(std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+                               const AvcMediaProberConfig& config)
+  : avc_module_provider_(avc_module_provider)
+  , config_(config)
+  , pool_(ResolveThreadsCount(config.threads_count_)) {
+}
+
+int AvcMediaProber::Probe(const std::string& url, AvcProbeResult* result) {
+  if (!result)
+    return AVERROR(EINVAL);
+
+  int ret = ProbeFile(url, result);
+  if (ret < 0)
+    errors_.fetch_add(1, std::memory_order_relaxed);
+  return ret;
+}
+
+int AvcMediaProber::ProbeFile(const std::string& url, AvcProbeResult* result) {
+  memset(result, 0, sizeof(*result));
+  result->duration_ = AV_NOPTS_VALUE;
+  result->start_time_ = AV_NOPTS_VALUE;
+
+  std::string path;
+  uint64_t size = 0;
+  int64_t mtime = 0;
+  bool local = GetLocalFileStat(url, &path, &size, &mtime);
+  if (local && FindCached(path, size, mtime, result)) {
+    cache_hits_.fetch_add(1, std::memory_order_relaxed);
+    return result->error_;
+  }
+
+  auto start = Clock::now();
+  AVDictionary* options = nullptr;
+  if (config_.probe_size_ > 0)
+    avc_module_provider_->av_dict_set_int(&options, "probesize", config_.probe_size_, 0);
+  if (config_.max_analyze_duration_ > 0)
+    avc_module_provider_->av_dict_set_int(&options, "analyzeduration", config_.max_analyze_duration_, 0);
+
+  AvcMediaInput input(avc_module_provider_);
+  int ret = input.Open(url, &options, config_.find_stream_info_);
+  avc_module_provider_->av_dict_free(&options);
+  files_opened_.fetch_add(1, std::memory_order_relaxed);
+
+  if (ret >= 0) {
+    FillResult(avc_module_provider_->d().get(), input.GetFormatContext(), result);
+    input.Close();
+  } else {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcMediaProber: cannot open %s, error %d\n", url.c_str(), ret);
+#endif //DEBUG_PRINT
+  }
+
+  result->error_ = ret < 0 ? ret : 0;
+  probe_us_.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count(),
+                      std::memory_order_relaxed);
+
+  if (local) {
+    result->file_size_ = size;
+    result->file_mtime_ = mtime;
+    if (IsCacheable(ret))
+      AddCached(path, *result);
+  }
+  return result->error_;
+}
+
+size_t AvcMediaProber::ProbeBatch(const std::vector<std::string>& urls, std::vector<AvcProbeResult>* results) {
+  if (!results)
+    return urls.size();
+
+  results->assign(urls.size(), AvcProbeResult());
+  if (urls.empty())
+    return 0;
+
+  // fixed number of tasks takes urls in order, so huge batch does not queue task per url
+  std::atomic<size_t> next_url{0};
+  std::atomic<size_t> failed{0};
+  std::mutex done_mutex;
+  std::condition_variable done;
+  size_t running = std::min(static_cast<size_t>(pool_.GetWorkersCount()), urls.size());
+
+  size_t tasks_count = running;
+  for (size_t i = 0; i < tasks_count; i++) {
+    pool_.Submit([&] {
+      size_t index = 0;
+      while ((index = next_url.fetch_add(1, std::memory_order_relaxed)) < urls.size())
+        if (Probe(urls[index], &(*results)[index]) < 0)
+          failed.fetch_add(1, std::memory_order_relaxed);
+
+      // notify under lock: caller destroys batch state as soon as it sees running 0
+      std::lock_guard<std::mutex> lock(done_mutex);
+      if (--running == 0)
+        done.notify_all();
+    });
+  }
+
+  std::unique_lock<std::mutex> lock(done_mutex);
+  done.wait(lock, [&running] { return running == 0; });
+  return failed.load(std::memory_order_relaxed);
+}
+
+bool AvcMediaProber::FindCached(const std::string& path, uint64_t size, int64_t mtime, AvcProbeResult* result) const {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto it = cache_.find(path);
+  if (it == cache_.end() || it->second.file_size_ != size || it->second.file_mtime_ != mtime)
+    return false;
+
+  *result = it->second;
+  return true;
+}
+
+void AvcMediaProber::AddCached(const std::string& path, const AvcProbeResult& result) {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  cache_[path] = result;
+}
+
+int AvcMediaProber::LoadCache(const std::string& cache_url) {
+  FILE* file = fopen(cache_url.c_str(), "rb");
+  if (!file)
+    return AVERROR(ENOENT);
+
+  CacheHeader header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      memcmp(header.magic_, kCacheMagic, sizeof(kCacheMagic)) != 0 || header.version_ != kCacheVersion ||
+      header.byte_order_ != kCacheByteOrder || header.result_size_ != sizeof(AvcProbeResult)) {
+    fclose(file);
+    return AVERROR_INVALIDDATA;
+  }
+
+  // entries are parsed before cache is locked, broken file does not change cache
+  std::vector<std::pair<std::string, AvcProbeResult>> entries;
+  int ret = 0;
+  for (uint64_t i = 0; i < header.entries_count_; i++) {
+    CacheEntryHeader entry_header;
+    AvcProbeResult result;
+    if (fread(&entry_header, sizeof(entry_header), 1, file) != 1 ||
+        entry_header.path_size_ == 0 || entry_header.path_size_ > kCacheMaxPathSize ||
+        fread(&result, sizeof(result), 1, file) != 1) {
+      ret = AVERROR_INVALIDDATA;
+      break;
+    }
+
+    std::string path(entry_header.path_size_, '\0');
+    if (fread(&path[0], 1, path.size(), file) != path.size()) {
+      ret = AVERROR_INVALIDDATA;
+      break;
+    }
+    entries.emplace_back(std::move(path), result);
+  }
+  fclose(file);
+
+  if (ret < 0) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcMediaProber: cache %s is broken\n", cache_url.c_str());
+#endif //DEBUG_PRINT
+    return ret;
+  }
+
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  for (auto& entry : entries)
+    cache_[entry.first] = entry.second;
+  return 0;
+}
+
+int AvcMediaProber::SaveCache(const std::string& cache_url) const {
+  std::vector<std::pair<std::string, AvcProbeResult>> entries;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    entries.assign(cache_.begin(), cache_.end());
+  }
+
+  CacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic_, kCacheMagic, sizeof(kCacheMagic));
+  header.version_ = kCacheVersion;
+  header.byte_order_ = kCacheByteOrder;
+  header.result_size_ = sizeof(AvcProbeResult);
+  header.entries_count_ = entries.size();
+
+  FILE* file = fopen(cache_url.c_str(), "wb");
+  if (!file)
+    return AVERROR(errno ? errno : EIO);
+
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+  for (size_t i = 0; ok && i < entries.size(); i++) {
+    CacheEntryHeader entry_header;
+    entry_header.path_size_ = static_cast<uint32_t>(entries[i].first.size());
+    entry_header.reserved_ = 0;
+    ok = fwrite(&entry_header, sizeof(entry_header), 1, file) == 1 &&
+         fwrite(&entries[i].second, sizeof(AvcProbeResult), 1, file) == 1 &&
+         fwrite(entries[i].first.data(), 1, entries[i].first.size(), file) == entries[i].first.size();
+  }
+
+  if (fclose(file) != 0)
+    ok = false;
+
+  if (!ok) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcMediaProber: cannot write cache %s\n", cache_url.c_str());
+#endif //DEBUG_PRINT
+    remove(cache_url.c_str());
+    return AVERROR(EIO);
+  }
+  return 0;
+}
+
+size_t AvcMediaProber::GetCacheSize() const {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return cache_.size();
+}
+
+void AvcMediaProber::ClearCache() {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  cache_.clear();
+}
+
+AvcMediaProberStatistics AvcMediaProber::GetStatistics() const {
+  AvcMediaProberStatistics stat;
+  stat.files_opened_ = files_opened_.load(std::memory_order_relaxed);
+  stat.cache_hits_ = cache_hits_.load(std::memory_order_relaxed);
+  stat.errors_ = errors_.load(std::memory_order_relaxed);
+  stat.probe_ms_ = probe_us_.load(std::memory_order_relaxed) / 1000.0;
+  return stat;
+}
+
+}  // namespace detail
+}//namespace avc
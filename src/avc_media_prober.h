@@ -0,0 +1,78 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_MEDIA_PROBER_HEADER
+#define AVC_MEDIA_PROBER_HEADER
+
+#include <avc/i_avc_media_prober.h>
+#include <avc/i_avc_module_provider.h>
+#include "avc_work_stealing_pool.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcMediaProber
+  : public virtual IAvcMediaProber {
+ public:
+  AvcMediaProber(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcMediaProberConfig& config);
+  virtual ~AvcMediaProber() = default;
+
+  int Probe(const std::string& url, AvcProbeResult* result) override;
+  size_t ProbeBatch(const std::vector<std::string>& urls, std::vector<AvcProbeResult>* results) override;
+
+  int LoadCache(const std::string& cache_url) override;
+  int SaveCache(const std::string& cache_url) const override;
+  size_t GetCacheSize() const override;
+  void ClearCache() override;
+
+  AvcMediaProberStatistics GetStatistics() const override;
+
+ private:
+  int ProbeFile(const std::string& url, AvcProbeResult* result);
+  bool FindCached(const std::string& path, uint64_t size, int64_t mtime, AvcProbeResult* result) const;
+  void AddCached(const std::string& path, const AvcProbeResult& result);
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AvcMediaProberConfig config_;
+
+  mutable std::mutex cache_mutex_;
+  std::unordered_map<std::string, AvcProbeResult> cache_;  ///< by local path, size and mtime are in result
+
+  std::atomic<uint64_t> files_opened_{0};
+  std::atomic<uint64_t> cache_hits_{0};
+  std::atomic<uint64_t> errors_{0};
+  std::atomic<int64_t> probe_us_{0};
+
+  AvcWorkStealingPool pool_;                               ///< last member: stopped first on destruction
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_MEDIA_PROBER_HEADER
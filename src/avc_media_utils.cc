@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "avc_media_utils.h"
+#include <avc/libav_detached_common.h>
+
+namespace avc {
+namespace detail {
+
+AVRational ToAVRational(const cmf::MediaTimeBase& time_base) {
+  AVRational r;
+  r.num = time_base.num_;
+  r.den = time_base.den_;
+  return r;
+}
+
+int64_t GetPacketTimestamp(const IAvcModuleDataWrapper* d, const AVPacket* packet) {
+  int64_t dts = d->AVPacketGetDts(packet);
+  return dts != AV_NOPTS_VALUE ? dts : d->AVPacketGetPts(packet);
+}
+
+int64_t GetPacketPresentationTimestamp(const IAvcModuleDataWrapper* d, const AVPacket* packet) {
+  int64_t pts = d->AVPacketGetPts(packet);
+  return pts != AV_NOPTS_VALUE ? pts : d->AVPacketGetDts(packet);
+}
+
+cmf::MediaTimeBase GetStreamFrameRate(const IAvcModuleDataWrapper* d, const AVStream* stream) {
+  cmf::MediaTimeBase frame_rate = d->AVStreamGetAvgFrameRage(stream);
+  if (frame_rate.num_ <= 0 || frame_rate.den_ <= 0)
+    frame_rate = cmf::MediaTimeBase(kAvcDefaultFrameRate, 1);
+  return frame_rate;
+}
+
+int SelectEncoderPixelFormat(const IAvcModuleDataWrapper* d, const AVCodec* codec, int pix_fmt) {
+  const int* pix_fmts = d->AVCodecGetPixFmts(codec);
+  if (pix_fmts && pix_fmts[0] != AV_PIX_FMT_NONE) {
+    const int* supported = pix_fmts;
+    while (*supported != AV_PIX_FMT_NONE && *supported != pix_fmt)
+      supported++;
+    return *supported != AV_PIX_FMT_NONE ? pix_fmt : pix_fmts[0];
+  }
+
+  return pix_fmt != AV_PIX_FMT_NONE ? pix_fmt : AV_PIX_FMT_YUV420P;
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,54 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef AVC_MEDIA_UTILS_HEADER
+#define AVC_MEDIA_UTILS_HEADER
+
+#include <avc/i_avc_module_provider.h>
+
+#include <cstdint>
+
+namespace avc {
+namespace detail {
+
+const int kAvcDefaultFrameRate = 25;
+
+AVRational ToAVRational(const cmf::MediaTimeBase& time_base);
+
+/// \brief Decode timestamp of packet, presentation timestamp when packet has no dts
+int64_t GetPacketTimestamp(const IAvcModuleDataWrapper* d, const AVPacket* packet);
+
+/// \brief Presentation timestamp of packet, decode timestamp when packet has no pts
+int64_t GetPacketPresentationTimestamp(const IAvcModuleDataWrapper* d, const AVPacket* packet);
+
+/// \brief Average frame rate of stream, kAvcDefaultFrameRate fps when stream does not know it
+cmf::MediaTimeBase GetStreamFrameRate(const IAvcModuleDataWrapper* d, const AVStream* stream);
+
+/// \brief pix_fmt when encoder supports it, otherwise first pixel format of encoder.
+/// Encoder without list of formats keeps pix_fmt, AV_PIX_FMT_NONE becomes AV_PIX_FMT_YUV420P
+int SelectEncoderPixelFormat(const IAvcModuleDataWrapper* d, const AVCodec* codec, int pix_fmt);
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_MEDIA_UTILS_HEADER
@@ -0,0 +1,248 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "avc_memory_accounting.h"
+
+#include <cstdint>
+#include <functional>
+
+namespace avc {
+namespace detail {
+
+// Tag is per thread and is common for all providers
+static thread_local uint32_t g_thread_memory_tag = 0;
+
+static void update_peak(std::atomic<int64_t>& peak, int64_t value) {
+  int64_t current = peak.load(std::memory_order_relaxed);
+  while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+////
+// AtomicCounters
+
+AvcMemoryAccounting::AtomicCounters::AtomicCounters() {
+  for (int i = 0; i < kAvcMemoryObject_Count; i++) {
+    live_count_[i] = 0;
+    peak_count_[i] = 0;
+    live_bytes_[i] = 0;
+    peak_bytes_[i] = 0;
+  }
+  total_live_bytes_ = 0;
+  total_peak_bytes_ = 0;
+}
+
+void AvcMemoryAccounting::AtomicCounters::Add(AvcMemoryObjectType type, int64_t bytes) {
+  int64_t count = live_count_[type].fetch_add(1, std::memory_order_relaxed) + 1;
+  update_peak(peak_count_[type], count);
+
+  int64_t type_bytes = live_bytes_[type].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  update_peak(peak_bytes_[type], type_bytes);
+
+  int64_t total_bytes = total_live_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  update_peak(total_peak_bytes_, total_bytes);
+}
+
+void AvcMemoryAccounting::AtomicCounters::Sub(AvcMemoryObjectType type, int64_t bytes) {
+  live_count_[type].fetch_sub(1, std::memory_order_relaxed);
+  live_bytes_[type].fetch_sub(bytes, std::memory_order_relaxed);
+  total_live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void AvcMemoryAccounting::AtomicCounters::Read(AvcMemoryCounters& counters) const {
+  for (int i = 0; i < kAvcMemoryObject_Count; i++) {
+    counters.objects_[i].live_count_ = live_count_[i].load(std::memory_order_relaxed);
+    counters.objects_[i].peak_count_ = peak_count_[i].load(std::memory_order_relaxed);
+    counters.objects_[i].live_bytes_ = live_bytes_[i].load(std::memory_order_relaxed);
+    counters.objects_[i].peak_bytes_ = peak_bytes_[i].load(std::memory_order_relaxed);
+  }
+  counters.live_bytes_ = total_live_bytes_.load(std::memory_order_relaxed);
+  counters.peak_bytes_ = total_peak_bytes_.load(std::memory_order_relaxed);
+}
+
+void AvcMemoryAccounting::AtomicCounters::ResetPeaks() {
+  for (int i = 0; i < kAvcMemoryObject_Count; i++) {
+    peak_count_[i] = live_count_[i].load(std::memory_order_relaxed);
+    peak_bytes_[i] = live_bytes_[i].load(std::memory_order_relaxed);
+  }
+  total_peak_bytes_ = total_live_bytes_.load(std::memory_order_relaxed);
+}
+
+////
+// AvcMemoryAccounting
+
+AvcMemoryAccounting::AvcMemoryAccounting() {
+  for (size_t i = 0; i < kMaxTags; i++) {
+    slots_[i].tag_ = 0;
+    slots_[i].used_ = false;
+  }
+
+  // slot 0 is for untagged allocations and for tags which do not fit into table
+  slots_[0].used_ = true;
+}
+
+void AvcMemoryAccounting::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void AvcMemoryAccounting::SetThreadTag(uint32_t tag) {
+  g_thread_memory_tag = tag;
+}
+
+uint32_t AvcMemoryAccounting::GetThreadTag() const {
+  return g_thread_memory_tag;
+}
+
+AvcMemoryCounters AvcMemoryAccounting::GetTotalCounters() const {
+  AvcMemoryCounters counters;
+  total_.Read(counters);
+  return counters;
+}
+
+bool AvcMemoryAccounting::GetTagCounters(uint32_t tag, AvcMemoryCounters& counters) const {
+  size_t slot = FindSlot(tag);
+  if (slot >= kMaxTags)
+    return false;
+
+  slots_[slot].counters_.Read(counters);
+  return true;
+}
+
+std::vector<uint32_t> AvcMemoryAccounting::GetTags() const {
+  std::vector<uint32_t> tags;
+  for (size_t i = 0; i < kMaxTags; i++)
+    if (slots_[i].used_.load(std::memory_order_acquire))
+      tags.push_back(slots_[i].tag_.load(std::memory_order_relaxed));
+  return tags;
+}
+
+void AvcMemoryAccounting::ResetPeaks() {
+  total_.ResetPeaks();
+  for (size_t i = 0; i < kMaxTags; i++)
+    if (slots_[i].used_.load(std::memory_order_acquire))
+      slots_[i].counters_.ResetPeaks();
+}
+
+size_t AvcMemoryAccounting::FindSlot(uint32_t tag) const {
+  if (tag == 0)
+    return 0;
+
+  size_t start = 1 + std::hash<uint32_t>()(tag) % (kMaxTags - 1);
+  for (size_t i = 0; i < kMaxTags - 1; i++) {
+    size_t slot = 1 + (start - 1 + i) % (kMaxTags - 1);
+    if (!slots_[slot].used_.load(std::memory_order_acquire))
+      return kMaxTags;
+    if (slots_[slot].tag_.load(std::memory_order_relaxed) == tag)
+      return slot;
+  }
+  return kMaxTags;
+}
+
+size_t AvcMemoryAccounting::GetSlot(uint32_t tag) {
+  if (tag == 0)
+    return 0;
+
+  // open addressing, slots are never released, so lookup is lock-free
+  size_t start = 1 + std::hash<uint32_t>()(tag) % (kMaxTags - 1);
+  for (size_t i = 0; i < kMaxTags - 1; i++) {
+    size_t slot = 1 + (start - 1 + i) % (kMaxTags - 1);
+    TagSlot& tag_slot = slots_[slot];
+    if (tag_slot.used_.load(std::memory_order_acquire)) {
+      if (tag_slot.tag_.load(std::memory_order_relaxed) == tag)
+        return slot;
+      continue;
+    }
+
+    // claim empty slot: tag is written first, then slot is published
+    uint32_t expected = 0;
+    if (tag_slot.tag_.compare_exchange_strong(expected, tag, std::memory_order_relaxed)) {
+      tag_slot.used_.store(true, std::memory_order_release);
+      return slot;
+    }
+
+    if (expected == tag) {
+      // claimed concurrently by other thread with same tag
+      while (!tag_slot.used_.load(std::memory_order_acquire)) {
+      }
+      return slot;
+    }
+  }
+  return 0;
+}
+
+AvcMemoryAccounting::Shard& AvcMemoryAccounting::GetShard(const void* ptr) {
+  // allocations are at least 16 bytes aligned, low bits carry no entropy
+  uintptr_t value = reinterpret_cast<uintptr_t>(ptr) >> 4;
+  return shards_[(value ^ (value >> 6)) % kShardsCount];
+}
+
+void AvcMemoryAccounting::OnAllocate(const void* ptr, AvcMemoryObjectType type, size_t bytes) {
+  if (!ptr || !IsEnabled())
+    return;
+
+  size_t slot = GetSlot(g_thread_memory_tag);
+  Allocation allocation;
+  allocation.bytes_ = bytes;
+  allocation.slot_ = slot;
+
+  Shard& shard = GetShard(ptr);
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    auto result = shard.allocations_.emplace(AllocationKey{ ptr, type }, allocation);
+    if (!result.second) {
+      // re-allocation of tracked object (av_frame_get_buffer twice), replace previous record
+      Allocation prev = result.first->second;
+      total_.Sub(type, static_cast<int64_t>(prev.bytes_));
+      slots_[prev.slot_].counters_.Sub(type, static_cast<int64_t>(prev.bytes_));
+      result.first->second = allocation;
+    } else {
+      tracked_objects_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  total_.Add(type, static_cast<int64_t>(bytes));
+  slots_[slot].counters_.Add(type, static_cast<int64_t>(bytes));
+}
+
+void AvcMemoryAccounting::OnRelease(const void* ptr, AvcMemoryObjectType type) {
+  if (!ptr || tracked_objects_.load(std::memory_order_relaxed) == 0)
+    return;
+
+  Allocation allocation;
+  Shard& shard = GetShard(ptr);
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    auto it = shard.allocations_.find(AllocationKey{ ptr, type });
+    if (it == shard.allocations_.end())
+      return;
+
+    allocation = it->second;
+    shard.allocations_.erase(it);
+  }
+
+  tracked_objects_.fetch_sub(1, std::memory_order_relaxed);
+  total_.Sub(type, static_cast<int64_t>(allocation.bytes_));
+  slots_[allocation.slot_].counters_.Sub(type, static_cast<int64_t>(allocation.bytes_));
+}
+
+}  // namespace detail
+}//namespace avc
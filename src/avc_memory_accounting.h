@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_MEMORY_ACCOUNTING_HEADER
+#define AVC_MEMORY_ACCOUNTING_HEADER
+
+#include <avc/i_avc_memory_accounting.h>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
+namespace avc {
+namespace detail {
+
+class AvcMemoryAccounting final
+  : public virtual IAvcMemoryAccounting {
+ public:
+  AvcMemoryAccounting();
+  virtual ~AvcMemoryAccounting() = default;
+
+  void SetEnabled(bool enabled) override;
+  bool IsEnabled() const override { return enabled_.load(std::memory_order_relaxed); }
+
+  void SetThreadTag(uint32_t tag) override;
+  uint32_t GetThreadTag() const override;
+
+  AvcMemoryCounters GetTotalCounters() const override;
+  bool GetTagCounters(uint32_t tag, AvcMemoryCounters& counters) const override;
+  std::vector<uint32_t> GetTags() const override;
+  void ResetPeaks() override;
+
+  /// \brief Release hooks must run while accounting is enabled or some objects are still tracked
+  bool IsActive() const {
+    return enabled_.load(std::memory_order_relaxed) || tracked_objects_.load(std::memory_order_relaxed) > 0;
+  }
+
+  void OnAllocate(const void* ptr, AvcMemoryObjectType type, size_t bytes);
+  void OnRelease(const void* ptr, AvcMemoryObjectType type);
+
+ private:
+  static const size_t kMaxTags = 256;
+  static const size_t kShardsCount = 64;
+
+  struct AtomicCounters {
+    std::atomic<int64_t> live_count_[kAvcMemoryObject_Count];
+    std::atomic<int64_t> peak_count_[kAvcMemoryObject_Count];
+    std::atomic<int64_t> live_bytes_[kAvcMemoryObject_Count];
+    std::atomic<int64_t> peak_bytes_[kAvcMemoryObject_Count];
+    std::atomic<int64_t> total_live_bytes_;
+    std::atomic<int64_t> total_peak_bytes_;
+
+    AtomicCounters();
+    void Add(AvcMemoryObjectType type, int64_t bytes);
+    void Sub(AvcMemoryObjectType type, int64_t bytes);
+    void Read(AvcMemoryCounters& counters) const;
+    void ResetPeaks();
+  };
+
+  struct TagSlot {
+    std::atomic<uint32_t> tag_;
+    std::atomic<bool> used_;
+    AtomicCounters counters_;
+  };
+
+  struct Allocation {
+    size_t bytes_ = 0;
+    size_t slot_ = 0;
+  };
+
+  struct AllocationKey {
+    const void* ptr_;
+    int type_;
+    bool operator==(const AllocationKey& other) const { return ptr_ == other.ptr_ && type_ == other.type_; }
+  };
+
+  struct AllocationKeyHash {
+    size_t operator()(const AllocationKey& key) const {
+      return std::hash<const void*>()(key.ptr_) ^ static_cast<size_t>(key.type_);
+    }
+  };
+
+  struct Shard {
+    std::mutex mutex_;
+    std::unordered_map<AllocationKey, Allocation, AllocationKeyHash> allocations_;
+  };
+
+  size_t GetSlot(uint32_t tag);
+  size_t FindSlot(uint32_t tag) const;
+  Shard& GetShard(const void* ptr);
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<int64_t> tracked_objects_{0};
+  AtomicCounters total_;
+  TagSlot slots_[kMaxTags];
+  Shard shards_[kShardsCount];
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_MEMORY_ACCOUNTING_HEADER
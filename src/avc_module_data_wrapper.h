@@ -56,6 +56,7 @@ public:
   int64_t AVStreamGetStartTime(const AVStream* stream) const override;
   int AVStreamGetIndex(const AVStream* stream) const override;
   int AVStreamGetId(const AVStream* stream) const override;
+  int AVStreamGetDiscard(const AVStream* stream) const override;
   AVCodecParameters* AVStreamGetCodecPar(const AVStream* stream) const override;
 
   void AVStreamSetTimeBase(AVStream* stream, cmf::MediaTimeBase tb) const override;
@@ -64,6 +65,7 @@ public:
   void AVStreamSetStartTime(AVStream* stream, int64_t start_time) const override;
   void AVStreamSetIndex(AVStream* stream, int index) const override;
   void AVStreamSetId(AVStream* stream, int id) const override;
+  void AVStreamSetDiscard(AVStream* stream, int discard) const override;
 
   unsigned char* AVIOContextGetBuffer(const AVIOContext* ctx) const override;
   void AVIOContextSetBuffer(AVIOContext* ctx, unsigned char* buffer) const override;
@@ -92,6 +94,7 @@ public:
   int AVInputFormatGetFlags(const AVInputFormat* iformat) const override;
   int AVOutputFormatGetFlags(const AVOutputFormat* oformat) const override;
 
+  size_t AVPacketSizeof() const override;
   int64_t AVPacketGetPts(const AVPacket* pkt) const override;
   int64_t AVPacketGetDts(const AVPacket* pkt) const override;
   void* AVPacketGetData(const AVPacket* pkt) const override;
@@ -196,6 +199,9 @@ public:
   void AVCodecContextSetProfile(AVCodecContext* codec_context, int profile) const override;
   void AVCodecContextSetFlags(AVCodecContext* codec_context, int flags) const override;
   void AVCodecContextSetFlags2(AVCodecContext* codec_context, int flags2) const override;
+  void AVCodecContextSetSkipFrame(AVCodecContext* codec_context, int skip_frame) const override;
+  void AVCodecContextSetSkipLoopFilter(AVCodecContext* codec_context, int skip_loop_filter) const override;
+  void AVCodecContextSetSkipIdct(AVCodecContext* codec_context, int skip_idct) const override;
   void AVCodecContextSetOpaque(AVCodecContext* codec_context, void* opaque) const override;
   void AVCodecContextSetHwFramesCtx(AVCodecContext* codec_context, AVBufferRef* hw_frames_ctx_buf) const override;
   void AVCodecContextSetHwDeviceCtx(AVCodecContext* codec_context, AVBufferRef* hw_device_ctx_buf) const override;
@@ -234,6 +240,7 @@ public:
   int AVFrameGetPktSize(const AVFrame* avframe) const override;
   int64_t AVFrameGetPktPos(const AVFrame* avframe) const override;
   int64_t AVFrameGetPktDuration(const AVFrame* avframe) const override;
+  int64_t AVFrameGetDuration(const AVFrame* avframe) const override;
   int64_t AVFrameGetPktDts(const AVFrame* avframe) const override;
   int64_t AVFrameGetPktPts(const AVFrame* avframe) const override;
   AVBufferRef* AVFrameGetBuf(const AVFrame* avframe, int idx) const override;
@@ -258,6 +265,7 @@ public:
   void AVFrameSetPktSize(AVFrame* avframe, int pkt_size) const override;
   void AVFrameSetPktPos(AVFrame* avframe, int64_t pkt_pos) const override;
   void AVFrameSetPktDuration(AVFrame* avframe, int64_t pkt_duration) const override;
+  void AVFrameSetDuration(AVFrame* avframe, int64_t duration) const override;
   void AVFrameSetPktDts(AVFrame* avframe, int64_t pkt_dts) const override;
   void AVFrameSetPktPts(AVFrame* avframe, int64_t pkt_pts) const override;
   void AVFrameSetData(AVFrame* avframe, int idx, uint8_t* data) const override;
@@ -287,6 +295,7 @@ public:
   int AVCodecParametersGetFrameSize(const AVCodecParameters* codecpar) const override;
   int AVCodecParametersGetBitsPerCodedSample(const AVCodecParameters* codecpar) const override;
   int AVCodecParametersGetBitsPerRawSample(const AVCodecParameters* codecpar) const override;
+  int AVCodecParametersGetBlockAlign(const AVCodecParameters* codecpar) const override;
   uint64_t AVCodecParametersGetChannelLayout(const AVCodecParameters* codecpar) const override;
   AVChannelLayout* AVCodecParametersGetChLayout(AVCodecParameters* codecpar) const override;
 
@@ -311,10 +320,20 @@ public:
   uint8_t* AVBufferRefGetData(const AVBufferRef* bufferref) const override;
   int AVBufferRefGetSize(const AVBufferRef* bufferref) const override;
 
+  int AVCodecParserContextGetKeyFrame(const AVCodecParserContext* parser_context) const override;
+  int64_t AVCodecParserContextGetPts(const AVCodecParserContext* parser_context) const override;
+  int64_t AVCodecParserContextGetDts(const AVCodecParserContext* parser_context) const override;
+
   int AVHWConfigGetPixFmt(const AVCodecHWConfig* hwconfig) const override;
   int AVHWConfigGetDeviceType(const AVCodecHWConfig* hwconfig) const override;
   int AVHWConfigGetMethods(const AVCodecHWConfig* hwconfig) const override;
 
+  int64_t AVIndexEntryGetPos(const AVIndexEntry* entry) const override;
+  int64_t AVIndexEntryGetTimestamp(const AVIndexEntry* entry) const override;
+  int AVIndexEntryGetFlags(const AVIndexEntry* entry) const override;
+  int AVIndexEntryGetSize(const AVIndexEntry* entry) const override;
+  int AVIndexEntryGetMinDistance(const AVIndexEntry* entry) const override;
+
   size_t AVCPBPropertiesSizeof() const override;
   int AVCPBPropertiesGetBufferSize(const AVCPBProperties* props) const override;
   uint64_t AVCPBPropertiesGetVbvDelay(const AVCPBProperties* props) const override;
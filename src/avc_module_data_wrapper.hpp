@@ -155,6 +155,16 @@ void AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVStreamSetId(AVStream* stream, int id)
   stream_d->id = id;
 }
 
+int AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVStreamGetDiscard(const AVStream* stream) const {
+  auto stream_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVStream*>(stream);
+  return static_cast<int>(stream_d->discard);
+}
+
+void AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVStreamSetDiscard(AVStream* stream, int discard) const {
+  auto stream_d = reinterpret_cast<AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVStream*>(stream);
+  stream_d->discard = static_cast<AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVDiscard>(discard);
+}
+
 cmf::MediaTimeBase AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVStreamGetTimeBase(const AVStream* stream) const {
   auto stream_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVStream*>(stream);
   return cmf::MediaTimeBase(stream_d->time_base.num, stream_d->time_base.den);
@@ -299,6 +309,14 @@ int AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVOutputFormatGetFlags(const AVOutputForm
 
 ////
 // AVPacket data structure interaction
+size_t AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVPacketSizeof() const {
+#if (LIBAVCODEC_VERSION_MAJOR < 59) // sizeof(AVPacket) is not part of public ABI since 4.4 deprecation
+  return sizeof(AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVPacket);
+#else
+  return 0;
+#endif
+}
+
 int64_t AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVPacketGetPts(const AVPacket* pkt) const {
   auto pkt_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVPacket*>(pkt);
   return pkt_d->pts;
@@ -540,6 +558,21 @@ void AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVCodecContextSetFlags2(AVCodecContext*
   codec_context_d->flags2 = flags2;
 }
 
+void AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVCodecContextSetSkipFrame(AVCodecContext* codec_context, int skip_frame) const {
+  auto codec_context_d = reinterpret_cast<AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVCodecContext*>(codec_context);
+  codec_context_d->skip_frame = static_cast<AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVDiscard>(skip_frame);
+}
+
+void AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVCodecContextSetSkipLoopFilter(AVCodecContext* codec_context, int skip_loop_filter) const {
+  auto codec_context_d = reinterpret_cast<AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVCodecContext*>(codec_context);
+  codec_context_d->skip_loop_filter = static_cast<AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVDiscard>(skip_loop_filter);
+}
+
+void AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVCodecContextSetSkipIdct(AVCodecContext* codec_context, int skip_idct) const {
+  auto codec_context_d = reinterpret_cast<AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVCodecContext*>(codec_context);
+  codec_context_d->skip_idct = static_cast<AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVDiscard>(skip_idct);
+}
+
 void AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVCodecContextSetOpaque(AVCodecContext* codec_context, void* opaque) const {
   auto codec_context_d = reinterpret_cast<AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVCodecContext*>(codec_context);
   codec_context_d->opaque = opaque;
@@ -1082,6 +1115,17 @@ int64_t AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVFrameGetPktDuration(const AVFrame*
 #endif
 }
 
+int64_t AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVFrameGetDuration(const AVFrame* avframe) const {
+  auto avframe_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVFrame*>(avframe);
+#if (LIBAVUTIL_VERSION_MAJOR > 57) || (LIBAVUTIL_VERSION_MAJOR == 57 && LIBAVUTIL_VERSION_MINOR >= 30) // added in libavutil 57.30, first release 6.0
+  return avframe_d->duration;
+#else
+  DISABLE_DEPRECATION_WARNING
+  return avframe_d->pkt_duration;
+  RESTORE_DEPRECATION_WARNING
+#endif
+}
+
 int64_t AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVFrameGetPktDts(const AVFrame* avframe) const {
   auto avframe_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVFrame*>(avframe);
   return avframe_d->pkt_dts;
@@ -1232,6 +1276,17 @@ void AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVFrameSetPktDuration(AVFrame* avframe,
 #endif
 }
 
+void AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVFrameSetDuration(AVFrame* avframe, int64_t duration) const {
+  auto avframe_d = reinterpret_cast<AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVFrame*>(avframe);
+#if (LIBAVUTIL_VERSION_MAJOR > 57) || (LIBAVUTIL_VERSION_MAJOR == 57 && LIBAVUTIL_VERSION_MINOR >= 30) // added in libavutil 57.30, first release 6.0
+  avframe_d->duration = duration;
+#else
+  DISABLE_DEPRECATION_WARNING
+  avframe_d->pkt_duration = duration;
+  RESTORE_DEPRECATION_WARNING
+#endif
+}
+
 void AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVFrameSetPktDts(AVFrame* avframe, int64_t pkt_dts) const {
   auto avframe_d = reinterpret_cast<AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVFrame*>(avframe);
   avframe_d->pkt_dts = pkt_dts;
@@ -1379,6 +1434,11 @@ int AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVCodecParametersGetBitsPerRawSample(cons
   return codecpar_d->bits_per_raw_sample;
 }
 
+int AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVCodecParametersGetBlockAlign(const AVCodecParameters* codecpar) const {
+  auto codecpar_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVCodecParameters*>(codecpar);
+  return codecpar_d->block_align;
+}
+
 uint64_t AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVCodecParametersGetChannelLayout(const AVCodecParameters* codecpar) const {
   auto codecpar_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVCodecParameters*>(codecpar);
 #if (LIBAVCODEC_VERSION_MAJOR < 61) // last implemented in 6.x
@@ -1506,6 +1566,24 @@ int AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVBufferRefGetSize(const AVBufferRef* buf
   return static_cast<int>(bufferref_d->size);
 }
 
+////
+// AVCodecParserContext
+
+int AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVCodecParserContextGetKeyFrame(const AVCodecParserContext* parser_context) const {
+  auto parser_context_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVCodecParserContext*>(parser_context);
+  return parser_context_d->key_frame;
+}
+
+int64_t AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVCodecParserContextGetPts(const AVCodecParserContext* parser_context) const {
+  auto parser_context_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVCodecParserContext*>(parser_context);
+  return parser_context_d->pts;
+}
+
+int64_t AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVCodecParserContextGetDts(const AVCodecParserContext* parser_context) const {
+  auto parser_context_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVCodecParserContext*>(parser_context);
+  return parser_context_d->dts;
+}
+
 ////
 // AVHWConfig
 
@@ -1536,6 +1614,34 @@ int AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVHWConfigGetMethods(const AVCodecHWConfi
 #endif
 }
 
+////
+// AVIndexEntry
+
+int64_t AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVIndexEntryGetPos(const AVIndexEntry* entry) const {
+  auto entry_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVIndexEntry*>(entry);
+  return entry_d->pos;
+}
+
+int64_t AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVIndexEntryGetTimestamp(const AVIndexEntry* entry) const {
+  auto entry_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVIndexEntry*>(entry);
+  return entry_d->timestamp;
+}
+
+int AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVIndexEntryGetFlags(const AVIndexEntry* entry) const {
+  auto entry_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVIndexEntry*>(entry);
+  return entry_d->flags;
+}
+
+int AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVIndexEntryGetSize(const AVIndexEntry* entry) const {
+  auto entry_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVIndexEntry*>(entry);
+  return entry_d->size;
+}
+
+int AVC_MODULE_DATA_WRAPPER_CLASSNAME::AVIndexEntryGetMinDistance(const AVIndexEntry* entry) const {
+  auto entry_d = reinterpret_cast<const AVC_MODULE_DATA_WRAPPER_NAMESPACE::AVIndexEntry*>(entry);
+  return entry_d->min_distance;
+}
+
 ///////
 // AVCPBProperties
 
@@ -42,6 +42,7 @@
 #include "i_avc_module_data_wrapper_factory.h"
 
 #include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>
 
 #if DEBUG_PRINT
 #include <cstdio>
@@ -51,6 +52,7 @@
 #include "dynamic_loader.hpp"
 #endif //AVC_LIBRARIES_STATIC_LINK
 
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 
@@ -195,6 +197,56 @@ static const char* kAvDeviceModuleName = "avdevice";
 static const char* kSwScaleModuleName = "swscale";
 static const char* kSwResampleModuleName = "swresample";
 
+// sizeof(AVPacket) for lavc 59-61, used for accounting when size is not available from data wrapper
+static const size_t kApproxAVPacketSize = 104;
+
+// Send/receive loop shared by DecodeBatch and EncodeBatch. Function pointers are called directly,
+// module check is done once by caller
+template <typename Input, typename Output, typename SendFunc, typename ReceiveFunc>
+static int RunCodecBatch(AVCodecContext* avctx, SendFunc send_func, ReceiveFunc receive_func,
+                         const Input* const* inputs, int inputs_count, int* send_results,
+                         Output* const* outputs, int outputs_count, int* outputs_received) {
+  int received = 0;
+  int receive_res = AVERROR(EAGAIN);
+
+  auto drain = [&]() {
+    while (received < outputs_count) {
+      receive_res = receive_func(avctx, outputs[received]);
+      if (receive_res < 0)
+        return;
+      received++;
+    }
+    receive_res = 0;  // all outputs are filled
+  };
+
+  int index = 0;
+  for (; index < inputs_count; index++) {
+    int res = send_func(avctx, inputs[index]);
+    if (res == AVERROR(EAGAIN)) {
+      // Codec is full: move its output to free slots and try again
+      drain();
+      if (receive_res == 0)
+        break;
+      res = send_func(avctx, inputs[index]);
+      if (res == AVERROR(EAGAIN))
+        break;  // later inputs must not overtake this one
+    }
+
+    if (send_results)
+      send_results[index] = res;
+  }
+
+  if (send_results) {
+    for (int i = index; i < inputs_count; i++)
+      send_results[i] = AVERROR(EAGAIN);
+  }
+
+  drain();
+  if (outputs_received)
+    *outputs_received = received;
+  return receive_res;
+}
+
 
 AvcModuleProvider::AvcModuleProvider(
   std::shared_ptr<cmf::IDynamicModulesLoader> modules_loader, 
@@ -204,6 +256,8 @@ AvcModuleProvider::AvcModuleProvider(
     , load_handler_(load_handler)
     , modules_path_(modules_path)
     , strict_modules_names_(false)
+    , memory_accounting_(std::make_shared<AvcMemoryAccounting>())
+    , thread_budget_(AvcThreadBudget::Instance())
 {
   avcodec_module_name_ = kDefaultAvCodecModuleName;
   avformat_module_name_ = kDefaultAvFormatModuleName;
@@ -235,7 +289,9 @@ AvcModuleProvider::AvcModuleProvider(
     , avutil_module_name_(avutil_module_name)
     , avdevice_module_name_(avdevice_module_name)
     , swscale_module_name_(swscale_module_name)
-    , swresample_module_name_(swresample_module_name) {
+    , swresample_module_name_(swresample_module_name)
+    , memory_accounting_(std::make_shared<AvcMemoryAccounting>())
+    , thread_budget_(AvcThreadBudget::Instance()) {
   if (avcodec_module_name_.size() == 0) 
     avcodec_module_name_ = kDefaultAvCodecModuleName;
 
@@ -683,6 +739,7 @@ void AvcModuleProvider::LoadAvCodecFunctions() {
     .LoadProc("av_new_packet", av_new_packet_)
     .LoadProc("av_packet_ref", av_packet_ref_)
     .LoadProc("av_packet_unref", av_packet_unref_)
+    .LoadProc("av_packet_move_ref", av_packet_move_ref_)
     .LoadProc("av_packet_rescale_ts", av_packet_rescale_ts_)
     .LoadProc("avcodec_alloc_context3", avcodec_alloc_context3_)
     .LoadProc("avcodec_free_context", avcodec_free_context_)
@@ -1082,18 +1139,31 @@ int AvcModuleProvider::av_lockmgr_register(int (*cb)(void **mutex,
 AVPacket *AvcModuleProvider::av_packet_alloc(void) {
   if (!avcodec_handle_) Load();
   AVC_CHECK_AND_CALL(av_packet_alloc_, "av_packet_alloc", kAvCodecModuleName);
-  return av_packet_alloc_();
+  AVPacket* pkt = av_packet_alloc_();
+  if (pkt && memory_accounting_->IsEnabled()) {
+    // sizeof(AVPacket) is not part of public ABI since lavc 59, use approximate size for it
+    size_t size = data_wrapper_ ? data_wrapper_->AVPacketSizeof() : 0;
+    memory_accounting_->OnAllocate(pkt, kAvcMemoryObject_Packet, size ? size : kApproxAVPacketSize);
+  }
+  return pkt;
 }
 
 AVPacket *AvcModuleProvider::av_packet_clone(AVPacket *src) {
   if (!avcodec_handle_) Load();
   AVC_CHECK_AND_CALL(av_packet_clone_, "av_packet_clone", kAvCodecModuleName);
-  return av_packet_clone_(src);
+  AVPacket* pkt = av_packet_clone_(src);
+  if (pkt && memory_accounting_->IsEnabled()) {
+    size_t size = data_wrapper_ ? data_wrapper_->AVPacketSizeof() : 0;
+    memory_accounting_->OnAllocate(pkt, kAvcMemoryObject_Packet, size ? size : kApproxAVPacketSize);
+  }
+  return pkt;
 }
 
 void AvcModuleProvider::av_packet_free(AVPacket **pkt) {
   if (!avcodec_handle_) Load();
   AVC_CHECK_AND_CALL(av_packet_free_, "av_packet_free", kAvCodecModuleName);
+  if (pkt && memory_accounting_->IsActive())
+    memory_accounting_->OnRelease(*pkt, kAvcMemoryObject_Packet);
   return av_packet_free_(pkt);
 }
 
@@ -1121,6 +1191,12 @@ void AvcModuleProvider::av_packet_unref(AVPacket *pkt) {
   av_packet_unref_(pkt);
 }
 
+void AvcModuleProvider::av_packet_move_ref(AVPacket *dst, AVPacket *src) {
+  if (!avcodec_handle_) Load();
+  AVC_CHECK_AND_CALL(av_packet_move_ref_, "av_packet_move_ref", kAvCodecModuleName);
+  av_packet_move_ref_(dst, src);
+}
+
 void AvcModuleProvider::av_packet_rescale_ts(AVPacket* pkt, cmf::MediaTimeBase tb_src, cmf::MediaTimeBase tb_dst) {
   if (!avcodec_handle_) Load();
   AVC_CHECK_AND_CALL(av_packet_rescale_ts_, "av_packet_rescale_ts", kAvCodecModuleName);
@@ -1136,6 +1212,8 @@ AVCodecContext *AvcModuleProvider::avcodec_alloc_context3(const AVCodec *codec)
 void AvcModuleProvider::avcodec_free_context(AVCodecContext **avctx) {
   if (!avcodec_handle_) Load();
   AVC_CHECK_AND_CALL(avcodec_free_context_, "avcodec_free_context", kAvCodecModuleName);
+  if (avctx && thread_budget_->IsActive())
+    thread_budget_->StopSession(*avctx);
   avcodec_free_context_(avctx);
 }
 
@@ -1186,7 +1264,19 @@ int AvcModuleProvider::avcodec_open2(AVCodecContext *avctx, const AVCodec *codec
                                      AVDictionary **options) {
   if (!avcodec_handle_) Load();
   AVC_CHECK_AND_CALL(avcodec_open2_, "avcodec_open2", kAvCodecModuleName);
-  return avcodec_open2_(avctx, codec, options);
+
+  // automatic threading (thread_count 0 and no "threads" option) takes share of thread budget
+  bool budgeted = false;
+  if (avctx && data_wrapper_ && thread_budget_->IsEnabled() && data_wrapper_->AVCodecContextGetThreadCount(avctx) == 0 &&
+      (!options || !*options || !av_dict_get(*options, "threads", nullptr, 0))) {
+    data_wrapper_->AVCodecContextSetThreadCount(avctx, thread_budget_->StartSession(avctx));
+    budgeted = true;
+  }
+
+  int ret = avcodec_open2_(avctx, codec, options);
+  if (ret < 0 && budgeted)
+    thread_budget_->StopSession(avctx);
+  return ret;
 }
 int AvcModuleProvider::avcodec_receive_frame(AVCodecContext *avctx, AVFrame *frame) {
   if (!avcodec_handle_) Load();
@@ -1934,12 +2024,19 @@ void AvcModuleProvider::av_dict_free(AVDictionary **m) {
 AVFrame *AvcModuleProvider::av_frame_alloc(void) {
   if (!avutil_handle_) Load();
   AVC_CHECK_AND_CALL(av_frame_alloc_, "av_frame_alloc", kAvUtilModuleName);
-  return av_frame_alloc_();
+  AVFrame* frame = av_frame_alloc_();
+  if (frame && memory_accounting_->IsEnabled())
+    memory_accounting_->OnAllocate(frame, kAvcMemoryObject_Frame, data_wrapper_ ? data_wrapper_->AVFrameSizeof() : 0);
+  return frame;
 }
 
 void AvcModuleProvider::av_frame_free(AVFrame **frame) {
   if (!avutil_handle_) Load();
   AVC_CHECK_AND_CALL(av_frame_free_, "av_frame_free", kAvUtilModuleName);
+  if (frame && memory_accounting_->IsActive()) {
+    memory_accounting_->OnRelease(*frame, kAvcMemoryObject_FrameBuffer);
+    memory_accounting_->OnRelease(*frame, kAvcMemoryObject_Frame);
+  }
   av_frame_free_(frame);
 }
 
@@ -1958,12 +2055,18 @@ int AvcModuleProvider::av_frame_replace(AVFrame* dst, const AVFrame* src) {
 AVFrame* AvcModuleProvider::av_frame_clone(const AVFrame* src) {
   if (!avutil_handle_) Load();
   AVC_CHECK_AND_CALL(av_frame_clone_, "av_frame_clone", kAvUtilModuleName);
-  return av_frame_clone_(src);
+  AVFrame* frame = av_frame_clone_(src);
+  // clone references buffers of source frame, only new frame structure is allocated
+  if (frame && memory_accounting_->IsEnabled())
+    memory_accounting_->OnAllocate(frame, kAvcMemoryObject_Frame, data_wrapper_ ? data_wrapper_->AVFrameSizeof() : 0);
+  return frame;
 }
 
 void AvcModuleProvider::av_frame_unref(AVFrame* frame) {
   if (!avutil_handle_) Load();
   AVC_CHECK_AND_CALL(av_frame_unref_, "av_frame_unref", kAvUtilModuleName);
+  if (memory_accounting_->IsActive())
+    memory_accounting_->OnRelease(frame, kAvcMemoryObject_FrameBuffer);
   av_frame_unref_(frame);
 }
 
@@ -1976,7 +2079,17 @@ void AvcModuleProvider::av_frame_move_ref(AVFrame* dst, AVFrame* src) {
 int AvcModuleProvider::av_frame_get_buffer(AVFrame *frame, int align) {
   if (!avutil_handle_) Load();
   AVC_CHECK_AND_CALL(av_frame_get_buffer_, "av_frame_get_buffer", kAvUtilModuleName);
-  return av_frame_get_buffer_(frame, align);
+  int ret = av_frame_get_buffer_(frame, align);
+  if (ret >= 0 && data_wrapper_ && memory_accounting_->IsEnabled()) {
+    size_t size = 0;
+    for (int i = 0; i < AV_NUM_DATA_POINTERS; i++) {
+      AVBufferRef* buf = data_wrapper_->AVFrameGetBuf(frame, i);
+      if (buf)
+        size += static_cast<size_t>(data_wrapper_->AVBufferRefGetSize(buf));
+    }
+    memory_accounting_->OnAllocate(frame, kAvcMemoryObject_FrameBuffer, size);
+  }
+  return ret;
 }
 
 int AvcModuleProvider::av_frame_get_channels(const AVFrame *frame) {
@@ -2071,12 +2184,16 @@ void AvcModuleProvider::av_frame_set_sample_rate(AVFrame *frame, int val) {
 void AvcModuleProvider::av_free(void *ptr) {
   if (!avutil_handle_) Load();
   AVC_CHECK_AND_CALL(av_free_, "av_free", kAvUtilModuleName);
+  if (memory_accounting_->IsActive())
+    memory_accounting_->OnRelease(ptr, kAvcMemoryObject_Malloc);
   av_free_(ptr);
 }
 
 void AvcModuleProvider::av_freep(void *ptr) {
   if (!avutil_handle_) Load();
   AVC_CHECK_AND_CALL(av_freep_, "av_freep", kAvUtilModuleName);
+  if (ptr && memory_accounting_->IsActive())
+    memory_accounting_->OnRelease(*reinterpret_cast<void**>(ptr), kAvcMemoryObject_Malloc);
   av_freep_(ptr);
 }
 
@@ -2135,7 +2252,10 @@ void AvcModuleProvider::av_log_set_level(int level) {
 void *AvcModuleProvider::av_malloc(size_t size) {
   if (!avutil_handle_) Load();
   AVC_CHECK_AND_CALL(av_malloc_, "av_malloc", kAvUtilModuleName);
-  return av_malloc_(size);
+  void* ptr = av_malloc_(size);
+  if (ptr && memory_accounting_->IsEnabled())
+    memory_accounting_->OnAllocate(ptr, kAvcMemoryObject_Malloc, size);
+  return ptr;
 }
 
 AVBufferRef *AvcModuleProvider::av_buffer_create(uint8_t *data, int size,
@@ -2144,7 +2264,11 @@ AVBufferRef *AvcModuleProvider::av_buffer_create(uint8_t *data, int size,
                                                  void *opaque, int flags) {
   if (!avutil_handle_) Load();
   AVC_CHECK_AND_CALL(av_buffer_create_, "av_buffer_create", kAvUtilModuleName);
-  return av_buffer_create_(data, size, free, opaque, flags);
+  AVBufferRef* buf = av_buffer_create_(data, size, free, opaque, flags);
+  // only reference returned by av_buffer_create is tracked, other refs to same buffer are not counted
+  if (buf && memory_accounting_->IsEnabled())
+    memory_accounting_->OnAllocate(buf, kAvcMemoryObject_Buffer, size > 0 ? static_cast<size_t>(size) : 0);
+  return buf;
 }
 
 int AvcModuleProvider::av_buffer_is_writable(const AVBufferRef *buf) {
@@ -2174,12 +2298,21 @@ int AvcModuleProvider::av_buffer_make_writable(AVBufferRef **buf) {
 int AvcModuleProvider::av_buffer_realloc(AVBufferRef **pbuf, int size) {
   if (!avutil_handle_) Load();
   AVC_CHECK_AND_CALL(av_buffer_realloc_, "av_buffer_realloc", kAvUtilModuleName);
-  return av_buffer_realloc_(pbuf, size);
+  AVBufferRef* prev = pbuf ? *pbuf : nullptr;
+  int ret = av_buffer_realloc_(pbuf, size);
+  // reference may be replaced by new one, move record to it with new size
+  if (ret >= 0 && pbuf && memory_accounting_->IsActive()) {
+    memory_accounting_->OnRelease(prev, kAvcMemoryObject_Buffer);
+    memory_accounting_->OnAllocate(*pbuf, kAvcMemoryObject_Buffer, size > 0 ? static_cast<size_t>(size) : 0);
+  }
+  return ret;
 }
 
 void AvcModuleProvider::av_buffer_unref(AVBufferRef **buf) {
   if (!avutil_handle_) Load();
   AVC_CHECK_AND_CALL(av_buffer_unref_, "av_buffer_unref", kAvUtilModuleName);
+  if (buf && memory_accounting_->IsActive())
+    memory_accounting_->OnRelease(*buf, kAvcMemoryObject_Buffer);
   av_buffer_unref_(buf);
 }
 
@@ -2509,6 +2642,24 @@ void AvcModuleProvider::avdevice_register_all() {
   avdevice_register_all_();
 }
 
+int AvcModuleProvider::DecodeBatch(AVCodecContext* avctx, const AVPacket* const* packets, int packets_count, int* send_results,
+                                   AVFrame* const* frames, int frames_count, int* frames_received) {
+  if (!avcodec_handle_) Load();
+  AVC_CHECK_AND_CALL(avcodec_send_packet_, "avcodec_send_packet", kAvCodecModuleName);
+  AVC_CHECK_AND_CALL(avcodec_receive_frame_, "avcodec_receive_frame", kAvCodecModuleName);
+  return RunCodecBatch(avctx, avcodec_send_packet_, avcodec_receive_frame_,
+    packets, packets_count, send_results, frames, frames_count, frames_received);
+}
+
+int AvcModuleProvider::EncodeBatch(AVCodecContext* avctx, const AVFrame* const* frames, int frames_count, int* send_results,
+                                   AVPacket* const* packets, int packets_count, int* packets_received) {
+  if (!avcodec_handle_) Load();
+  AVC_CHECK_AND_CALL(avcodec_send_frame_, "avcodec_send_frame", kAvCodecModuleName);
+  AVC_CHECK_AND_CALL(avcodec_receive_packet_, "avcodec_receive_packet", kAvCodecModuleName);
+  return RunCodecBatch(avctx, avcodec_send_frame_, avcodec_receive_packet_,
+    frames, frames_count, send_results, packets, packets_count, packets_received);
+}
+
 std::shared_ptr<IAvcModuleDataWrapper> AvcModuleProvider::d() const {
   return data_wrapper_;
 }
@@ -2524,5 +2675,13 @@ std::shared_ptr<IAvcVideoPixelFormatConverter> AvcModuleProvider::GetVideoPixelF
   return video_pixel_format_converter;
 }
 
+std::shared_ptr<IAvcMemoryAccounting> AvcModuleProvider::GetMemoryAccounting() {
+  return memory_accounting_;
+}
+
+std::shared_ptr<IAvcThreadBudget> AvcModuleProvider::GetThreadBudget() {
+  return thread_budget_;
+}
+
 }  // namespace detail
 }  // namespace avc
@@ -28,6 +28,8 @@
 #include <tools/i_dynamic_modules_loader.h>
 #include <avc/i_avc_module_provider.h>
 #include <avc/i_avc_module_load_handler.h>
+#include "avc_memory_accounting.h"
+#include "avc_thread_budget.h"
 
 namespace avc {
 namespace detail {
@@ -117,6 +119,7 @@ public:
   int av_new_packet(AVPacket *pkt, int size) override;
   void av_packet_ref(AVPacket *dst, const AVPacket* src) override;
   void av_packet_unref(AVPacket *pkt) override;
+  void av_packet_move_ref(AVPacket *dst, AVPacket *src) override;
   void av_packet_rescale_ts(AVPacket* pkt, cmf::MediaTimeBase tb_src, cmf::MediaTimeBase tb_dst) override;
 
   AVCodecContext *avcodec_alloc_context3(const AVCodec *codec) override;
@@ -488,12 +491,24 @@ public:
   unsigned avdevice_version() override;
   void avdevice_register_all() override;
 
+  // batched codec calls
+  int DecodeBatch(AVCodecContext* avctx, const AVPacket* const* packets, int packets_count, int* send_results,
+                  AVFrame* const* frames, int frames_count, int* frames_received) override;
+  int EncodeBatch(AVCodecContext* avctx, const AVFrame* const* frames, int frames_count, int* send_results,
+                  AVPacket* const* packets, int packets_count, int* packets_received) override;
+
   // Wrappers for data structures
   std::shared_ptr<IAvcModuleDataWrapper> d() const override;
 
   // pixel format converter
   std::shared_ptr<IAvcVideoPixelFormatConverter> GetVideoPixelFormatConverter() override;
 
+  // memory accounting
+  std::shared_ptr<IAvcMemoryAccounting> GetMemoryAccounting() override;
+
+  // codec thread budget
+  std::shared_ptr<IAvcThreadBudget> GetThreadBudget() override;
+
  private:
   void LoadAvCodecFunctions();
   void LoadAvFormatFunctions();
@@ -527,6 +542,7 @@ public:
   int (*av_new_packet_)(AVPacket *pkt, int size) = nullptr;
   int (*av_packet_ref_)(AVPacket *dst, const AVPacket* src) = nullptr;
   void (*av_packet_unref_)(AVPacket *pkt) = nullptr;
+  void (*av_packet_move_ref_)(AVPacket *dst, AVPacket *src) = nullptr;
   void (*av_packet_rescale_ts_)(AVPacket* pkt, AVRational tb_src, AVRational tb_dst) = nullptr;
 
   AVCodecContext *(*avcodec_alloc_context3_)(const AVCodec *codec) = nullptr;
@@ -917,6 +933,8 @@ public:
 
   std::shared_ptr<IAvcModuleDataWrapper> data_wrapper_;
   std::shared_ptr<IAvcVideoPixelFormatConverter> video_pixel_format_converter_;
+  std::shared_ptr<AvcMemoryAccounting> memory_accounting_;
+  std::shared_ptr<AvcThreadBudget> thread_budget_;
   int data_wrapper_compatibility_score_ = 0;
 };
 
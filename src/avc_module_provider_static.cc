@@ -99,6 +99,7 @@ void AvcModuleProvider::LoadStatically() {
   Assign(av_new_packet_, &::av_new_packet);
   Assign(av_packet_ref_, &::av_packet_ref);
   Assign(av_packet_unref_, &::av_packet_unref);
+  Assign(av_packet_move_ref_, &::av_packet_move_ref);
   Assign(avcodec_alloc_context3_, &::avcodec_alloc_context3);
   Assign(avcodec_free_context_, &::avcodec_free_context);
 
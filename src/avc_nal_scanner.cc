@@ -0,0 +1,263 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_nal_scanner.h"
+#include <avc/libav_detached_common.h>
+#include <cerrno>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AVC_NAL_SCANNER_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif //_MSC_VER
+#else //SSE2
+#define AVC_NAL_SCANNER_SSE2 0
+#endif //SSE2
+
+namespace avc {
+
+std::shared_ptr<IAvcNalScanner> API_EXPORT CreateAvcNalScanner(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  int codec_id,
+  const uint8_t* extradata,
+  int extradata_size) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  auto scanner = std::make_shared<avc::detail::AvcNalScanner>();
+  if (!scanner->Init(avc_module_provider, codec_id, extradata, extradata_size))
+    return nullptr;
+
+  return scanner;
+}
+
+namespace detail {
+
+namespace {
+
+const int kH264NalSlice = 1;
+const int kH264NalIdrSlice = 5;
+const int kH264NalSps = 7;
+const int kH264NalPps = 8;
+
+const int kHevcNalLastVcl = 31;
+const int kHevcNalFirstIrap = 16;   // BLA_W_LP
+const int kHevcNalLastIrap = 23;    // RSV_IRAP_VCL23
+const int kHevcNalVps = 32;
+const int kHevcNalPps = 34;
+
+#if AVC_NAL_SCANNER_SSE2
+inline int CountTrailingZeros(int mask) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, static_cast<unsigned long>(mask));
+  return static_cast<int>(index);
+#else //_MSC_VER
+  return __builtin_ctz(static_cast<unsigned int>(mask));
+#endif //_MSC_VER
+}
+#endif //AVC_NAL_SCANNER_SSE2
+
+}  // namespace
+
+bool AvcNalScanner::Init(std::shared_ptr<IAvcModuleProvider> avc_module_provider, int codec_id,
+                         const uint8_t* extradata, int extradata_size) {
+  avc_module_provider_ = avc_module_provider;
+  codec_ = Codec::kNone;
+  length_size_ = 0;
+
+  if (codec_id == AV_CODEC_ID_H264) {
+    codec_ = Codec::kH264;
+    // avcC starts with configurationVersion 1, Annex B extradata with start code
+    if (extradata && extradata_size >= 7 && extradata[0] == 1)
+      length_size_ = (extradata[4] & 3) + 1;
+  } else if (codec_id == AV_CODEC_ID_HEVC) {
+    codec_ = Codec::kHevc;
+    // same check as libavcodec hevc decoder: anything but start code is hvcC
+    if (extradata && extradata_size >= 23 && (extradata[0] || extradata[1] || extradata[2] > 1))
+      length_size_ = (extradata[21] & 3) + 1;
+  }
+  return IsEnabled();
+}
+
+const uint8_t* AvcNalScanner::FindStartCode(const uint8_t* begin, const uint8_t* end) {
+  const uint8_t* p = begin;
+
+#if AVC_NAL_SCANNER_SSE2
+  // 16 candidate positions at once: byte is 0, next byte is 0, byte after it is 1
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi8(1);
+  while (end - p >= 18) {
+    __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+    __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2));
+    __m128i match = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, zero), _mm_cmpeq_epi8(b1, zero)),
+                                  _mm_cmpeq_epi8(b2, one));
+    int mask = _mm_movemask_epi8(match);
+    if (mask)
+      return p + CountTrailingZeros(mask);
+    p += 16;
+  }
+#endif //AVC_NAL_SCANNER_SSE2
+
+  // byte after candidate decides how far start code can not begin
+  while (end - p >= 3) {
+    if (p[2] > 1)
+      p += 3;
+    else if (p[1])
+      p += 2;
+    else if (p[0] || p[2] != 1)
+      p++;
+    else
+      return p;
+  }
+  return end;
+}
+
+int AvcNalScanner::GetUnitType(const uint8_t* unit) const {
+  return codec_ == Codec::kH264 ? (unit[0] & 0x1F) : ((unit[0] >> 1) & 0x3F);
+}
+
+bool AvcNalScanner::ClassifyUnit(int type, size_t offset, AvcNalScanResult* result) const {
+  result->nal_units_count_++;
+
+  bool slice = false;
+  bool keyframe = false;
+  if (codec_ == Codec::kH264) {
+    slice = type >= kH264NalSlice && type <= kH264NalIdrSlice;
+    keyframe = type == kH264NalIdrSlice;
+    if (type == kH264NalSps || type == kH264NalPps)
+      result->parameter_sets_ = true;
+  } else {
+    slice = type <= kHevcNalLastVcl;
+    keyframe = type >= kHevcNalFirstIrap && type <= kHevcNalLastIrap;
+    if (type >= kHevcNalVps && type <= kHevcNalPps)
+      result->parameter_sets_ = true;
+  }
+
+  if (keyframe && !result->keyframe_) {
+    result->keyframe_ = true;
+    result->keyframe_offset_ = static_cast<int32_t>(offset);
+  }
+  return slice;
+}
+
+int AvcNalScanner::Scan(const uint8_t* data, size_t size, AvcNalScanResult* result,
+                        std::vector<AvcNalUnit>* units) const {
+  if (!result)
+    return AVERROR(EINVAL);
+
+  *result = AvcNalScanResult();
+  if (units)
+    units->clear();
+  if (!IsEnabled() || !data)
+    return 0;
+
+  const uint8_t* end = data + size;
+  if (length_size_ > 0) {
+    const uint8_t* p = data;
+    while (end - p > length_size_) {
+      size_t unit_size = 0;
+      for (int i = 0; i < length_size_; i++)
+        unit_size = (unit_size << 8) | p[i];
+      p += length_size_;
+
+      if (unit_size > static_cast<size_t>(end - p))
+        return AVERROR_INVALIDDATA;
+      if (!unit_size)
+        continue;
+
+      int type = GetUnitType(p);
+      bool slice = ClassifyUnit(type, p - data, result);
+      if (units)
+        units->push_back(AvcNalUnit{ static_cast<uint32_t>(p - data), static_cast<uint32_t>(unit_size), type, 0 });
+      else if (slice)
+        break;
+      p += unit_size;
+    }
+    return 0;
+  }
+
+  const uint8_t* p = FindStartCode(data, end);
+  while (p < end) {
+    const uint8_t* unit = p + 3;
+    if (unit >= end)
+      break;
+
+    // slice header is enough, end of slice is not searched when units are not requested
+    int type = GetUnitType(unit);
+    bool slice = ClassifyUnit(type, unit - data, result);
+    if (!units && slice)
+      break;
+
+    const uint8_t* next = FindStartCode(unit, end);
+    if (units) {
+      // zero bytes before start code are trailing_zero_8bits or first byte of 4 bytes start code
+      const uint8_t* unit_end = next;
+      while (unit_end > unit + 1 && unit_end[-1] == 0)
+        unit_end--;
+      units->push_back(AvcNalUnit{ static_cast<uint32_t>(unit - data), static_cast<uint32_t>(unit_end - unit), type, 0 });
+    }
+    p = next;
+  }
+  return 0;
+}
+
+int AvcNalScanner::ScanPacket(AVPacket* packet, AvcNalScanResult* result) const {
+  if (!packet)
+    return AVERROR(EINVAL);
+
+  auto d = avc_module_provider_->d();
+  AvcNalScanResult local_result;
+  if (!result)
+    result = &local_result;
+
+  const uint8_t* data = static_cast<const uint8_t*>(d->AVPacketGetData(packet));
+  int size = d->AVPacketGetSize(packet);
+  int ret = Scan(data, size > 0 ? static_cast<size_t>(size) : 0, result);
+  if (ret < 0)
+    return ret;
+
+  if (!result->keyframe_)
+    return 0;
+
+  d->AVPacketSetFlags(packet, d->AVPacketGetFlags(packet) | AV_PKT_FLAG_KEY);
+  return 1;
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,69 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_NAL_SCANNER_HEADER
+#define AVC_NAL_SCANNER_HEADER
+
+#include <avc/i_avc_nal_scanner.h>
+#include <avc/i_avc_module_provider.h>
+
+#include <memory>
+
+namespace avc {
+namespace detail {
+
+class AvcNalScanner
+  : public virtual IAvcNalScanner {
+ public:
+  AvcNalScanner() = default;
+  virtual ~AvcNalScanner() = default;
+
+  /// \brief Scanner for codec (AVCodecID) and stream extradata. Returns false for codecs without NAL units
+  bool Init(std::shared_ptr<IAvcModuleProvider> avc_module_provider, int codec_id,
+            const uint8_t* extradata, int extradata_size);
+  bool IsEnabled() const { return codec_ != Codec::kNone; }
+
+  int Scan(const uint8_t* data, size_t size, AvcNalScanResult* result,
+           std::vector<AvcNalUnit>* units = nullptr) const override;
+  int ScanPacket(AVPacket* packet, AvcNalScanResult* result = nullptr) const override;
+  int GetLengthSize() const override { return length_size_; }
+
+  /// \brief First 00 00 01 in [begin, end) or end
+  static const uint8_t* FindStartCode(const uint8_t* begin, const uint8_t* end);
+
+ private:
+  enum class Codec { kNone, kH264, kHevc };
+
+  int GetUnitType(const uint8_t* unit) const;
+
+  /// \brief Account unit in result, returns true for slice: slice type decides keyframe and scan may stop
+  bool ClassifyUnit(int type, size_t offset, AvcNalScanResult* result) const;
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  Codec codec_ = Codec::kNone;
+  int length_size_ = 0;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_NAL_SCANNER_HEADER
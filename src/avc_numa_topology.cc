@@ -0,0 +1,268 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "avc_numa_topology.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#	include <windows.h>
+#else //_WIN32
+#	include <unistd.h>
+#ifdef __linux__
+#	include <sched.h>
+#	include <dirent.h>
+#	include <sys/syscall.h>
+#endif //__linux__
+#endif //_WIN32
+
+namespace avc {
+namespace detail {
+
+#ifdef __linux__
+// linux/mempolicy.h values, libnuma is not required
+static const int kMpolDefault = 0;
+static const int kMpolPreferred = 1;
+
+static std::vector<int> parse_cpu_list(const std::string& str) {
+  // format is "0-7,16-23"
+  std::vector<int> cpus;
+  size_t pos = 0;
+  while (pos < str.size()) {
+    size_t end = str.find(',', pos);
+    if (end == std::string::npos)
+      end = str.size();
+
+    std::string range = str.substr(pos, end - pos);
+    int first = -1;
+    int last = -1;
+    int n = sscanf(range.c_str(), "%d-%d", &first, &last);
+    if (n == 1)
+      last = first;
+
+    if (n >= 1 && first >= 0 && last >= first) {
+      for (int cpu = first; cpu <= last; cpu++)
+        cpus.push_back(cpu);
+    }
+    pos = end + 1;
+  }
+  return cpus;
+}
+
+static std::string read_first_line(const std::string& path) {
+  std::string result;
+  FILE* f = fopen(path.c_str(), "r");
+  if (!f)
+    return result;
+
+  char buf[4096];
+  if (fgets(buf, sizeof(buf), f)) {
+    result = buf;
+    while (!result.empty() && (result.back() == '\n' || result.back() == '\r'))
+      result.pop_back();
+  }
+  fclose(f);
+  return result;
+}
+#endif //__linux__
+
+const AvcNumaTopology& AvcNumaTopology::Instance() {
+  static AvcNumaTopology instance;
+  return instance;
+}
+
+AvcNumaTopology::AvcNumaTopology() {
+  Detect();
+}
+
+void AvcNumaTopology::Detect() {
+#ifdef __linux__
+  DIR* dir = opendir("/sys/devices/system/node");
+  if (dir) {
+    std::vector<int> node_ids;
+    struct dirent* entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr) {
+      int node_id = -1;
+      char tail = 0;
+      if (sscanf(entry->d_name, "node%d%c", &node_id, &tail) == 1 && node_id >= 0)
+        node_ids.push_back(node_id);
+    }
+    closedir(dir);
+
+    int max_node_id = -1;
+    for (int id : node_ids)
+      if (id > max_node_id) max_node_id = id;
+
+    // node ids may be sparse, keep vector index equal to node id
+    if (max_node_id >= 0)
+      node_cpus_.resize(static_cast<size_t>(max_node_id) + 1);
+
+    for (int id : node_ids) {
+      node_cpus_[id] = parse_cpu_list(read_first_line(
+        "/sys/devices/system/node/node" + std::to_string(id) + "/cpulist"));
+    }
+  }
+#elif defined(_WIN32)
+  ULONG highest_node = 0;
+  if (GetNumaHighestNodeNumber(&highest_node)) {
+    node_cpus_.resize(static_cast<size_t>(highest_node) + 1);
+    for (ULONG node = 0; node <= highest_node; node++) {
+      ULONGLONG mask = 0;
+      if (!GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &mask))
+        continue;
+
+      for (int cpu = 0; cpu < 64; cpu++)
+        if (mask & (1ULL << cpu))
+          node_cpus_[node].push_back(cpu);
+    }
+  }
+#endif //__linux__
+
+  if (node_cpus_.empty())
+    node_cpus_.resize(1);
+
+  for (size_t node = 0; node < node_cpus_.size(); node++) {
+    for (int cpu : node_cpus_[node]) {
+      if (cpu >= static_cast<int>(cpu_to_node_.size()))
+        cpu_to_node_.resize(static_cast<size_t>(cpu) + 1, 0);
+      cpu_to_node_[cpu] = static_cast<int>(node);
+    }
+  }
+}
+
+int AvcNumaTopology::GetNodeOfCpu(int cpu) const {
+  if (cpu < 0 || cpu >= static_cast<int>(cpu_to_node_.size()))
+    return 0;
+  return cpu_to_node_[cpu];
+}
+
+int AvcNumaTopology::GetCurrentNode() const {
+  if (node_cpus_.size() < 2)
+    return 0;
+
+#ifdef __linux__
+  return GetNodeOfCpu(sched_getcpu());
+#elif defined(_WIN32)
+  return GetNodeOfCpu(static_cast<int>(GetCurrentProcessorNumber()));
+#else //__linux__
+  return 0;
+#endif //__linux__
+}
+
+const std::vector<int>& AvcNumaTopology::GetNodeCpus(int numa_node) const {
+  if (numa_node < 0 || numa_node >= static_cast<int>(node_cpus_.size()))
+    return node_cpus_[0];
+  return node_cpus_[numa_node];
+}
+
+bool AvcNumaTopology::BindCurrentThreadToNode(int numa_node) const {
+  if (numa_node < 0 || numa_node >= static_cast<int>(node_cpus_.size()))
+    return false;
+
+  const std::vector<int>& cpus = node_cpus_[numa_node];
+  if (cpus.empty())
+    return false;
+
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus)
+    if (cpu < CPU_SETSIZE)
+      CPU_SET(cpu, &cpu_set);
+
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0)
+    return false;
+
+#ifdef SYS_set_mempolicy
+  unsigned long mask[16] = {};
+  const size_t bits_per_word = sizeof(unsigned long) * 8;
+  if (static_cast<size_t>(numa_node) < sizeof(mask) * 8) {
+    mask[numa_node / bits_per_word] |= 1UL << (numa_node % bits_per_word);
+    syscall(SYS_set_mempolicy, kMpolPreferred, mask, sizeof(mask) * 8);
+  }
+#endif //SYS_set_mempolicy
+  return true;
+#elif defined(_WIN32)
+  DWORD_PTR mask = 0;
+  for (int cpu : cpus)
+    if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8))
+      mask |= static_cast<DWORD_PTR>(1) << cpu;
+
+  // Windows places pages on node of the thread that touches them first
+  return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else //__linux__
+  return false;
+#endif //__linux__
+}
+
+////
+// AvcScopedNumaMemoryPolicy
+
+AvcScopedNumaMemoryPolicy::AvcScopedNumaMemoryPolicy(int numa_node) {
+#if defined(__linux__) && defined(SYS_set_mempolicy) && defined(SYS_get_mempolicy)
+  if (numa_node < 0 || AvcNumaTopology::Instance().GetNodesCount() < 2)
+    return;
+
+  const size_t bits_per_word = sizeof(unsigned long) * 8;
+  if (static_cast<size_t>(numa_node) >= kMaskWords * bits_per_word)
+    return;
+
+  if (syscall(SYS_get_mempolicy, &old_mode_, old_mask_, kMaskWords * bits_per_word, nullptr, 0) != 0)
+    return;
+
+  unsigned long mask[kMaskWords] = {};
+  mask[numa_node / bits_per_word] |= 1UL << (numa_node % bits_per_word);
+  restore_ = syscall(SYS_set_mempolicy, kMpolPreferred, mask, kMaskWords * bits_per_word) == 0;
+#else
+  (void)numa_node;
+#endif
+}
+
+AvcScopedNumaMemoryPolicy::~AvcScopedNumaMemoryPolicy() {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+  if (!restore_)
+    return;
+
+  const size_t bits_per_word = sizeof(unsigned long) * 8;
+  if (old_mode_ == kMpolDefault)
+    syscall(SYS_set_mempolicy, kMpolDefault, nullptr, 0);
+  else
+    syscall(SYS_set_mempolicy, old_mode_, old_mask_, kMaskWords * bits_per_word);
+#endif
+}
+
+void AvcNumaTouchPages(void* data, size_t size) {
+  if (!data || !size)
+    return;
+
+  const size_t kPageSize = 4096;
+  volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+  for (size_t offset = 0; offset < size; offset += kPageSize)
+    p[offset] = p[offset];
+  p[size - 1] = p[size - 1];
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_NUMA_TOPOLOGY_HEADER
+#define AVC_NUMA_TOPOLOGY_HEADER
+
+#include <cstddef>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+/// \brief NUMA nodes and their CPUs as seen by OS. Systems without NUMA report one node
+class AvcNumaTopology {
+ public:
+  static const AvcNumaTopology& Instance();
+
+  int GetNodesCount() const { return static_cast<int>(node_cpus_.size()); }
+  int GetNodeOfCpu(int cpu) const;
+  int GetCurrentNode() const;
+  const std::vector<int>& GetNodeCpus(int numa_node) const;
+
+  /// \brief Pin current thread to node CPUs and set preferred memory node for it
+  bool BindCurrentThreadToNode(int numa_node) const;
+
+ private:
+  AvcNumaTopology();
+  void Detect();
+
+  std::vector<std::vector<int>> node_cpus_;
+  std::vector<int> cpu_to_node_;
+};
+
+/// \brief Makes memory faulted by current thread prefer numa_node until destroyed. No-op for negative node
+class AvcScopedNumaMemoryPolicy {
+ public:
+  explicit AvcScopedNumaMemoryPolicy(int numa_node);
+  ~AvcScopedNumaMemoryPolicy();
+
+  AvcScopedNumaMemoryPolicy(const AvcScopedNumaMemoryPolicy&) = delete;
+  AvcScopedNumaMemoryPolicy& operator=(const AvcScopedNumaMemoryPolicy&) = delete;
+
+ private:
+  static const size_t kMaskWords = 16;
+
+  bool restore_ = false;
+  int old_mode_ = 0;
+  unsigned long old_mask_[kMaskWords] = {};
+};
+
+/// \brief Touch every page of memory block, so first-touch policy places it on current preferred node
+void AvcNumaTouchPages(void* data, size_t size);
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_NUMA_TOPOLOGY_HEADER
@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_packet_batch.h"
+#include <cstdint>
+#include <cstring>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+
+size_t API_EXPORT GetAvcPacketBatchArenaSize(IAvcModuleProvider* avc_module_provider, size_t count) {
+  return avc::detail::AvcPacketBatch::GetPacketStride(avc_module_provider) * count;
+}
+
+std::shared_ptr<IAvcPacketBatch> API_EXPORT CreateAvcPacketBatch(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  size_t count,
+  void* arena,
+  size_t arena_size) {
+  if (!avc_module_provider || !count)
+    return nullptr;
+
+  auto batch = std::make_shared<avc::detail::AvcPacketBatch>(avc_module_provider);
+  if (batch->AllocateInArena(count, arena, arena_size))
+    return batch;
+
+#if DEBUG_PRINT
+  fprintf(stderr, "CreateAvcPacketBatch: arena is not usable, fallback to av_packet_alloc (%zu packets)\n", count);
+#endif //DEBUG_PRINT
+
+  if (!batch->AllocateSeparately(count))
+    return nullptr;
+
+  return batch;
+}
+
+namespace detail {
+
+AvcPacketBatch::AvcPacketBatch(std::shared_ptr<IAvcModuleProvider> avc_module_provider)
+  : avc_module_provider_(avc_module_provider) {
+}
+
+AvcPacketBatch::~AvcPacketBatch() {
+  Release();
+}
+
+size_t AvcPacketBatch::GetPacketStride(IAvcModuleProvider* avc_module_provider) {
+  if (!avc_module_provider || !avc_module_provider->IsAvCodecLoaded())
+    return 0;
+
+  auto d = avc_module_provider->d();
+  if (!d)
+    return 0;
+
+  size_t packet_size = d->AVPacketSizeof();
+  if (!packet_size)
+    return 0;
+
+  const size_t alignment = alignof(std::max_align_t);
+  return (packet_size + alignment - 1) / alignment * alignment;
+}
+
+bool AvcPacketBatch::AllocateInArena(size_t count, void* arena, size_t arena_size) {
+  size_t stride = GetPacketStride(avc_module_provider_.get());
+  if (!stride)
+    return false;
+
+  if (!arena) {
+    own_arena_.resize((stride * count + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+    arena = own_arena_.data();
+    arena_size = own_arena_.size() * sizeof(std::max_align_t);
+  }
+
+  if (reinterpret_cast<uintptr_t>(arena) % alignof(std::max_align_t) != 0 || arena_size < stride * count)
+    return false;
+
+  // av_init_packet does not touch data and size, so arena is zeroed first
+  memset(arena, 0, stride * count);
+
+  uint8_t* ptr = static_cast<uint8_t*>(arena);
+  packets_.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    AVPacket* packet = reinterpret_cast<AVPacket*>(ptr + i * stride);
+    avc_module_provider_->av_init_packet(packet);
+    packets_.push_back(packet);
+  }
+
+  arena_backed_ = true;
+  return true;
+}
+
+bool AvcPacketBatch::AllocateSeparately(size_t count) {
+  packets_.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    AVPacket* packet = avc_module_provider_->av_packet_alloc();
+    if (!packet) {
+      Release();
+      return false;
+    }
+    packets_.push_back(packet);
+  }
+
+  arena_backed_ = false;
+  return true;
+}
+
+AVPacket* AvcPacketBatch::GetPacket(size_t idx) const {
+  if (idx >= packets_.size())
+    return nullptr;
+
+  return packets_[idx];
+}
+
+void AvcPacketBatch::UnrefAll() {
+  for (AVPacket* packet : packets_)
+    avc_module_provider_->av_packet_unref(packet);
+}
+
+void AvcPacketBatch::Release() {
+  if (arena_backed_) {
+    UnrefAll();
+  } else {
+    for (AVPacket* packet : packets_)
+      avc_module_provider_->av_packet_free(&packet);
+  }
+
+  packets_.clear();
+  own_arena_.clear();
+  arena_backed_ = false;
+}
+
+}  // namespace detail
+}//namespace avc
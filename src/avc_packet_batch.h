@@ -0,0 +1,66 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_PACKET_BATCH_HEADER
+#define AVC_PACKET_BATCH_HEADER
+
+#include <avc/i_avc_packet_batch.h>
+#include <avc/i_avc_module_provider.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcPacketBatch
+  : public virtual IAvcPacketBatch {
+ public:
+  AvcPacketBatch(std::shared_ptr<IAvcModuleProvider> avc_module_provider);
+  virtual ~AvcPacketBatch();
+
+  /// \brief Place packets into arena (own arena is allocated when arena is null). Returns false if arena
+  /// can not be used and packets must be allocated by AllocateSeparately
+  bool AllocateInArena(size_t count, void* arena, size_t arena_size);
+  bool AllocateSeparately(size_t count);
+
+  size_t GetCount() const override { return packets_.size(); }
+  AVPacket* GetPacket(size_t idx) const override;
+  bool IsArenaBacked() const override { return arena_backed_; }
+  void UnrefAll() override;
+
+  /// \brief Arena stride of one packet, 0 when sizeof(AVPacket) is not part of ABI
+  static size_t GetPacketStride(IAvcModuleProvider* avc_module_provider);
+
+ private:
+  void Release();
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  std::vector<AVPacket*> packets_;
+  std::vector<std::max_align_t> own_arena_;
+  bool arena_backed_ = false;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_PACKET_BATCH_HEADER
@@ -0,0 +1,312 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_packet_interleaver.h"
+#include "avc_media_utils.h"
+#include <avc/libav_detached_common.h>
+#include <algorithm>
+#include <cerrno>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+
+std::shared_ptr<IAvcPacketInterleaver> API_EXPORT CreateAvcPacketInterleaver(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  AVFormatContext* output_context,
+  const AvcPacketInterleaverConfig& config) {
+  if (!avc_module_provider || !output_context)
+    return nullptr;
+
+  if (!avc_module_provider->IsAvFormatLoaded() || !avc_module_provider->IsAvCodecLoaded())
+    return nullptr;
+
+  return std::make_shared<avc::detail::AvcPacketInterleaver>(avc_module_provider, output_context, config);
+}
+
+namespace detail {
+
+AvcPacketInterleaver::AvcPacketInterleaver(std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+                                           AVFormatContext* output_context,
+                                           const AvcPacketInterleaverConfig& config)
+  : avc_module_provider_(avc_module_provider)
+  , output_context_(output_context)
+  , config_(config)
+  , newest_dts_us_(AV_NOPTS_VALUE) {
+  int streams_count = avc_module_provider_->d()->AVFormatContextGetNbStreams(output_context_);
+  streams_.resize(static_cast<size_t>(std::max(streams_count, 0)));
+  for (auto& stream : streams_)
+    stream.max_delay_us_ = config_.max_delay_us_;
+}
+
+AvcPacketInterleaver::~AvcPacketInterleaver() {
+  // Queued packets are not written: owner calls Flush when output is still valid
+  for (auto& stream : streams_) {
+    for (auto& queued : stream.queue_)
+      avc_module_provider_->av_packet_free(&queued.packet_);
+  }
+
+  for (AVPacket* packet : free_packets_)
+    avc_module_provider_->av_packet_free(&packet);
+}
+
+int AvcPacketInterleaver::Write(AVPacket* packet) {
+  if (!packet)
+    return AVERROR(EINVAL);
+
+  auto d = avc_module_provider_->d();
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  int stream_index = d->AVPacketGetStreamIndex(packet);
+  if (stream_index < 0 || stream_index >= static_cast<int>(streams_.size())) {
+    avc_module_provider_->av_packet_unref(packet);
+    return AVERROR(EINVAL);
+  }
+
+  QueuedPacket queued;
+  queued.packet_ = AcquirePacket();
+  if (!queued.packet_) {
+    avc_module_provider_->av_packet_unref(packet);
+    return AVERROR(ENOMEM);
+  }
+
+  avc_module_provider_->av_packet_move_ref(queued.packet_, packet);
+  queued.dts_us_ = GetDtsMicroseconds(stream_index, queued.packet_);
+  queued.size_ = static_cast<size_t>(std::max(d->AVPacketGetSize(queued.packet_), 0));
+
+  StreamState& stream = streams_[stream_index];
+  stream.queue_.push_back(queued);
+  stream.stat_.packets_queued_++;
+  stream.stat_.bytes_queued_ += queued.size_;
+  stream.stat_.last_dts_us_ = queued.dts_us_;
+
+  stat_.packets_queued_++;
+  stat_.bytes_queued_ += queued.size_;
+  if (newest_dts_us_ == AV_NOPTS_VALUE || queued.dts_us_ > newest_dts_us_)
+    newest_dts_us_ = queued.dts_us_;
+
+  int res = WriteReady();
+
+  // Byte cap: oldest packets leave queue even though some stream is still silent
+  while (config_.max_bytes_ > 0 && stat_.bytes_queued_ > config_.max_bytes_) {
+    int oldest_stream = FindOldestStream();
+    if (oldest_stream < 0)
+      break;
+
+    if (config_.overflow_policy_ == kAvcInterleaverOverflow_Drop) {
+      DropFront(oldest_stream);
+      continue;
+    }
+
+    int write_res = WriteFront(oldest_stream);
+    stat_.packets_forced_++;
+    if (write_res < 0 && res >= 0)
+      res = write_res;
+  }
+
+  stat_.packets_queued_peak_ = std::max(stat_.packets_queued_peak_, stat_.packets_queued_);
+  stat_.bytes_queued_peak_ = std::max(stat_.bytes_queued_peak_, stat_.bytes_queued_);
+  return res < 0 ? res : 0;
+}
+
+void AvcPacketInterleaver::EndStream(int stream_index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stream_index < 0 || stream_index >= static_cast<int>(streams_.size()))
+    return;
+
+  streams_[stream_index].stat_.ended_ = true;
+  // Other streams may wait only for this one
+  WriteReady();
+}
+
+void AvcPacketInterleaver::SetStreamMaxDelay(int stream_index, int64_t max_delay_us) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stream_index < 0 || stream_index >= static_cast<int>(streams_.size()))
+    return;
+
+  streams_[stream_index].max_delay_us_ = max_delay_us;
+}
+
+int AvcPacketInterleaver::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  int res = 0;
+  int stream_index;
+  while ((stream_index = FindOldestStream()) >= 0) {
+    int write_res = WriteFront(stream_index);
+    if (write_res < 0 && res >= 0)
+      res = write_res;
+  }
+  return res;
+}
+
+AvcPacketInterleaverStatistics AvcPacketInterleaver::GetStatistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AvcPacketInterleaverStatistics stat = stat_;
+  int oldest_stream = FindOldestStream();
+  stat.queue_span_us_ = oldest_stream >= 0 ? newest_dts_us_ - streams_[oldest_stream].queue_.front().dts_us_ : 0;
+  return stat;
+}
+
+AvcInterleaverStreamStatistics AvcPacketInterleaver::GetStreamStatistics(int stream_index) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stream_index < 0 || stream_index >= static_cast<int>(streams_.size()))
+    return AvcInterleaverStreamStatistics();
+
+  return streams_[stream_index].stat_;
+}
+
+int64_t AvcPacketInterleaver::GetDtsMicroseconds(int stream_index, const AVPacket* packet) {
+  auto d = avc_module_provider_->d();
+  StreamState& stream = streams_[stream_index];
+
+  int64_t dts = GetPacketTimestamp(d.get(), packet);
+  if (dts == AV_NOPTS_VALUE)
+    return stream.stat_.last_dts_us_;  // keep packet next to previous one of the stream
+
+  if (!stream.time_base_known_) {
+    stream.time_base_ = d->AVStreamGetTimeBase(d->AVFormatContextGetStreamByIdx(output_context_, stream_index));
+    stream.time_base_known_ = true;
+  }
+
+  AVRational microseconds;
+  microseconds.num = 1;
+  microseconds.den = 1000000;
+
+  return avc_module_provider_->av_rescale_q_rnd(dts, ToAVRational(stream.time_base_), microseconds,
+    AV_ROUND_NEAR_INF | AV_ROUND_PASS_MINMAX);
+}
+
+int AvcPacketInterleaver::FindOldestStream() const {
+  int oldest_stream = -1;
+  for (size_t i = 0; i < streams_.size(); i++) {
+    if (streams_[i].queue_.empty())
+      continue;
+
+    if (oldest_stream < 0 || streams_[i].queue_.front().dts_us_ < streams_[oldest_stream].queue_.front().dts_us_)
+      oldest_stream = static_cast<int>(i);
+  }
+  return oldest_stream;
+}
+
+bool AvcPacketInterleaver::IsReady(int stream_index, bool& delay_expired) const {
+  int64_t dts_us = streams_[stream_index].queue_.front().dts_us_;
+  delay_expired = false;
+
+  for (size_t i = 0; i < streams_.size(); i++) {
+    const StreamState& stream = streams_[i];
+    // Queued packets of other streams are not older, ended stream will not send older ones
+    if (static_cast<int>(i) == stream_index || !stream.queue_.empty() || stream.stat_.ended_)
+      continue;
+
+    if (stream.max_delay_us_ < 0 || newest_dts_us_ - dts_us <= stream.max_delay_us_)
+      return false;
+
+    delay_expired = true;
+  }
+  return true;
+}
+
+int AvcPacketInterleaver::WriteReady() {
+  int stream_index;
+  bool delay_expired = false;
+  while ((stream_index = FindOldestStream()) >= 0 && IsReady(stream_index, delay_expired)) {
+    if (delay_expired)
+      stat_.packets_delay_expired_++;
+
+    int res = WriteFront(stream_index);
+    if (res < 0)
+      return res;
+  }
+  return 0;
+}
+
+int AvcPacketInterleaver::WriteFront(int stream_index) {
+  QueuedPacket queued = PopFront(stream_index);
+
+  // av_write_frame does not take packet ownership, packet is unreferenced by ReleasePacket
+  int res = avc_module_provider_->av_write_frame(output_context_, queued.packet_);
+  if (res >= 0) {
+    stat_.packets_written_++;
+    stat_.bytes_written_ += queued.size_;
+    streams_[stream_index].stat_.packets_written_++;
+  }
+#if DEBUG_PRINT
+  else {
+    fprintf(stderr, "AvcPacketInterleaver: av_write_frame for stream %d returned %d\n", stream_index, res);
+  }
+#endif //DEBUG_PRINT
+
+  ReleasePacket(queued.packet_);
+  return res;
+}
+
+void AvcPacketInterleaver::DropFront(int stream_index) {
+  QueuedPacket queued = PopFront(stream_index);
+  stat_.packets_dropped_++;
+  streams_[stream_index].stat_.packets_dropped_++;
+  ReleasePacket(queued.packet_);
+}
+
+AvcPacketInterleaver::QueuedPacket AvcPacketInterleaver::PopFront(int stream_index) {
+  StreamState& stream = streams_[stream_index];
+  QueuedPacket queued = stream.queue_.front();
+  stream.queue_.pop_front();
+
+  stream.stat_.packets_queued_--;
+  stream.stat_.bytes_queued_ -= queued.size_;
+  stat_.packets_queued_--;
+  stat_.bytes_queued_ -= queued.size_;
+  return queued;
+}
+
+AVPacket* AvcPacketInterleaver::AcquirePacket() {
+  if (free_packets_.empty())
+    return avc_module_provider_->av_packet_alloc();
+
+  AVPacket* packet = free_packets_.back();
+  free_packets_.pop_back();
+  return packet;
+}
+
+void AvcPacketInterleaver::ReleasePacket(AVPacket* packet) {
+  avc_module_provider_->av_packet_unref(packet);
+  free_packets_.push_back(packet);
+}
+
+}  // namespace detail
+}//namespace avc
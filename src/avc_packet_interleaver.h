@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_PACKET_INTERLEAVER_HEADER
+#define AVC_PACKET_INTERLEAVER_HEADER
+
+#include <avc/i_avc_packet_interleaver.h>
+#include <avc/i_avc_module_provider.h>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcPacketInterleaver
+  : public virtual IAvcPacketInterleaver {
+ public:
+  AvcPacketInterleaver(std::shared_ptr<IAvcModuleProvider> avc_module_provider, AVFormatContext* output_context,
+                       const AvcPacketInterleaverConfig& config);
+  virtual ~AvcPacketInterleaver();
+
+  int Write(AVPacket* packet) override;
+  void EndStream(int stream_index) override;
+  void SetStreamMaxDelay(int stream_index, int64_t max_delay_us) override;
+  int Flush() override;
+
+  AvcPacketInterleaverStatistics GetStatistics() const override;
+  AvcInterleaverStreamStatistics GetStreamStatistics(int stream_index) const override;
+
+ private:
+  struct QueuedPacket {
+    AVPacket* packet_ = nullptr;
+    int64_t dts_us_ = 0;
+    size_t size_ = 0;
+  };
+
+  struct StreamState {
+    std::deque<QueuedPacket> queue_;     ///< DTS order, muxer requires monotonic DTS inside stream anyway
+    AvcInterleaverStreamStatistics stat_;
+    cmf::MediaTimeBase time_base_;
+    bool time_base_known_ = false;       ///< muxer may change time base in avformat_write_header, read it lazily
+    int64_t max_delay_us_ = 0;
+  };
+
+  int64_t GetDtsMicroseconds(int stream_index, const AVPacket* packet);
+  int FindOldestStream() const;
+  bool IsReady(int stream_index, bool& delay_expired) const;
+  int WriteReady();
+  int WriteFront(int stream_index);
+  void DropFront(int stream_index);
+  QueuedPacket PopFront(int stream_index);
+
+  AVPacket* AcquirePacket();
+  void ReleasePacket(AVPacket* packet);
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AVFormatContext* output_context_;
+  AvcPacketInterleaverConfig config_;
+
+  mutable std::mutex mutex_;
+  std::vector<StreamState> streams_;
+  std::vector<AVPacket*> free_packets_;
+  int64_t newest_dts_us_;
+  AvcPacketInterleaverStatistics stat_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_PACKET_INTERLEAVER_HEADER
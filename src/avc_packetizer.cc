@@ -0,0 +1,315 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_packetizer.h"
+#include <avc/libav_detached_common.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+
+std::shared_ptr<IAvcPacketizer> API_EXPORT CreateAvcPacketizer(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  int codec_id) {
+  if (!avc_module_provider || !avc_module_provider->IsAvCodecLoaded())
+    return nullptr;
+
+  auto packetizer = std::make_shared<avc::detail::AvcPacketizer>(avc_module_provider);
+  if (packetizer->Open(codec_id) < 0)
+    return nullptr;
+
+  return packetizer;
+}
+
+namespace detail {
+
+namespace {
+
+// mapping is wrapped by buffers of int size, file is sent by windows
+const size_t kFileWindowSize = 256 * 1024 * 1024;
+
+// parser may read a bit past its input, so end of file is sent as zero padded copy
+const size_t kFileTailSize = 64 * 1024;
+
+const size_t kMaxParseSize = INT_MAX - AV_INPUT_BUFFER_PADDING_SIZE;
+
+void ReleaseMappedFile(void* opaque, uint8_t* /*data*/) {
+  delete static_cast<std::shared_ptr<AvcMappedFile>*>(opaque);
+}
+
+}  // namespace
+
+AvcPacketizer::AvcPacketizer(std::shared_ptr<IAvcModuleProvider> avc_module_provider)
+  : avc_module_provider_(avc_module_provider) {
+}
+
+AvcPacketizer::~AvcPacketizer() {
+  ReleaseInput();
+  if (parser_context_)
+    avc_module_provider_->av_parser_close(parser_context_);
+  avc_module_provider_->avcodec_free_context(&codec_context_);
+}
+
+int AvcPacketizer::Open(int codec_id) {
+  parser_context_ = avc_module_provider_->av_parser_init(codec_id);
+  if (!parser_context_) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcPacketizer: no parser for codec %d\n", codec_id);
+#endif //DEBUG_PRINT
+    return AVERROR(ENOSYS);
+  }
+
+  // parsers store stream parameters to codec context, decoder is not opened
+  codec_context_ = avc_module_provider_->avcodec_alloc_context3(avc_module_provider_->avcodec_find_decoder(codec_id));
+  if (!codec_context_)
+    return AVERROR(ENOMEM);
+  return 0;
+}
+
+int AvcPacketizer::SendData(AVBufferRef* buffer, const uint8_t* data, size_t size,
+                            int64_t pts, int64_t dts, int64_t pos) {
+  if (finished_)
+    return AVERROR_EOF;
+
+  if (file_)
+    return AVERROR(EINVAL);
+
+  if (input_size_ > 0 || flushing_)
+    return AVERROR(EAGAIN);
+
+  ReleaseInput();
+  if (!data || !size) {
+    flushing_ = true;
+    return 0;
+  }
+
+  if (buffer) {
+    input_buffer_ = avc_module_provider_->av_buffer_ref(buffer);
+    if (!input_buffer_)
+      return AVERROR(ENOMEM);
+  }
+
+  input_data_ = data;
+  input_size_ = size;
+  input_pts_ = pts;
+  input_dts_ = dts;
+  input_pos_ = pos;
+  return 0;
+}
+
+int AvcPacketizer::SendFile(const std::string& url) {
+  if (finished_)
+    return AVERROR_EOF;
+
+  if (file_ || input_size_ > 0 || flushing_)
+    return AVERROR(EAGAIN);
+
+  std::string path = url;
+  if (path.compare(0, 5, "file:") == 0)
+    path = path.substr(5);
+
+  auto file = std::make_shared<AvcMappedFile>();
+  if (!file->Open(path))
+    return AVERROR(ENOENT);
+
+  file_ = file;
+  file_offset_ = 0;
+  return 0;
+}
+
+int AvcPacketizer::SendNextFileWindow() {
+  ReleaseInput();
+
+  size_t file_size = file_->GetSize();
+  size_t tail_offset = file_size - std::min(file_size, kFileTailSize);
+  const uint8_t* data = file_->GetData() + file_offset_;
+
+  if (file_offset_ < tail_offset) {
+    // window is followed by mapped tail, parser can not read past mapping
+    size_t size = std::min(kFileWindowSize, tail_offset - file_offset_);
+    auto holder = new std::shared_ptr<AvcMappedFile>(file_);
+    input_buffer_ = avc_module_provider_->av_buffer_create(const_cast<uint8_t*>(data), static_cast<int>(size),
+                                                           ReleaseMappedFile, holder, AV_BUFFER_FLAG_READONLY);
+    if (!input_buffer_) {
+      delete holder;
+      return AVERROR(ENOMEM);
+    }
+
+    input_data_ = data;
+    input_size_ = size;
+  } else {
+    // av_new_packet allocates zeroed padding, its buffer holds tail copy
+    AVPacket* tail = avc_module_provider_->av_packet_alloc();
+    if (!tail)
+      return AVERROR(ENOMEM);
+
+    size_t size = file_size - file_offset_;
+    int ret = avc_module_provider_->av_new_packet(tail, static_cast<int>(size));
+    if (ret >= 0) {
+      auto d = avc_module_provider_->d();
+      memcpy(d->AVPacketGetData(tail), data, size);
+      input_buffer_ = avc_module_provider_->av_buffer_ref(d->AVPacketGetBuf(tail));
+      input_data_ = static_cast<const uint8_t*>(d->AVPacketGetData(tail));
+      input_size_ = size;
+      stat_.bytes_copied_ += size;
+      if (!input_buffer_)
+        ret = AVERROR(ENOMEM);
+    }
+    avc_module_provider_->av_packet_free(&tail);
+    if (ret < 0) {
+      ReleaseInput();
+      return ret;
+    }
+  }
+
+  input_pts_ = AV_NOPTS_VALUE;
+  input_dts_ = AV_NOPTS_VALUE;
+  input_pos_ = static_cast<int64_t>(file_offset_);
+  file_offset_ += input_size_;
+  return 0;
+}
+
+int AvcPacketizer::ReceivePacket(AVPacket* packet) {
+  if (!packet)
+    return AVERROR(EINVAL);
+
+  if (finished_)
+    return AVERROR_EOF;
+
+  while (true) {
+    if (!input_size_ && !flushing_) {
+      if (!file_)
+        return AVERROR(EAGAIN);
+
+      if (file_offset_ < file_->GetSize()) {
+        int ret = SendNextFileWindow();
+        if (ret < 0)
+          return ret;
+      } else {
+        flushing_ = true;
+      }
+    }
+
+    int size = static_cast<int>(std::min(input_size_, kMaxParseSize));
+    uint8_t* out_data = nullptr;
+    int out_size = 0;
+    int consumed = avc_module_provider_->av_parser_parse2(parser_context_, codec_context_, &out_data, &out_size,
+                                                         input_data_, size, input_pts_, input_dts_, input_pos_);
+    if (consumed < 0)
+      return consumed;
+
+    // timestamps belong to first byte of input only
+    input_pts_ = AV_NOPTS_VALUE;
+    input_dts_ = AV_NOPTS_VALUE;
+    if (input_pos_ >= 0)
+      input_pos_ += consumed;
+
+    if (out_size > 0) {
+      // packet may point into input, consumed bytes are released after it is referenced
+      int ret = EmitPacket(packet, out_data, out_size);
+      input_data_ += consumed;
+      input_size_ -= consumed;
+      return ret;
+    }
+
+    if (!size) {
+      finished_ = true;
+      ReleaseInput();
+      file_.reset();
+      return AVERROR_EOF;
+    }
+
+    if (!consumed)
+      return AVERROR_INVALIDDATA;
+
+    input_data_ += consumed;
+    input_size_ -= consumed;
+  }
+}
+
+int AvcPacketizer::EmitPacket(AVPacket* packet, uint8_t* data, int size) {
+  auto d = avc_module_provider_->d();
+
+  const uint8_t* buffer_begin = input_buffer_ ? d->AVBufferRefGetData(input_buffer_) : nullptr;
+  const uint8_t* buffer_end = input_buffer_ ? buffer_begin + d->AVBufferRefGetSize(input_buffer_) : nullptr;
+  bool inside = buffer_begin && data >= buffer_begin &&
+                static_cast<size_t>(buffer_end - data) >= static_cast<size_t>(size) + AV_INPUT_BUFFER_PADDING_SIZE;
+
+  if (inside) {
+    AVBufferRef* buffer = avc_module_provider_->av_buffer_ref(input_buffer_);
+    if (!buffer)
+      return AVERROR(ENOMEM);
+
+    d->AVPacketSetBuf(packet, buffer);
+    d->AVPacketSetData(packet, data);
+    d->AVPacketSetSize(packet, size);
+    stat_.packets_referenced_++;
+  } else {
+    int ret = avc_module_provider_->av_new_packet(packet, size);
+    if (ret < 0)
+      return ret;
+
+    memcpy(d->AVPacketGetData(packet), data, size);
+    stat_.packets_copied_++;
+    stat_.bytes_copied_ += size;
+  }
+
+  d->AVPacketSetPts(packet, d->AVCodecParserContextGetPts(parser_context_));
+  d->AVPacketSetDts(packet, d->AVCodecParserContextGetDts(parser_context_));
+  if (d->AVCodecParserContextGetKeyFrame(parser_context_) == 1)
+    d->AVPacketSetFlags(packet, d->AVPacketGetFlags(packet) | AV_PKT_FLAG_KEY);
+
+  stat_.packets_++;
+  return 0;
+}
+
+void AvcPacketizer::ReleaseInput() {
+  if (input_buffer_)
+    avc_module_provider_->av_buffer_unref(&input_buffer_);
+
+  input_buffer_ = nullptr;
+  input_data_ = nullptr;
+  input_size_ = 0;
+}
+
+}  // namespace detail
+}//namespace avc
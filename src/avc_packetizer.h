@@ -0,0 +1,78 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_PACKETIZER_HEADER
+#define AVC_PACKETIZER_HEADER
+
+#include <avc/i_avc_packetizer.h>
+#include <avc/i_avc_module_provider.h>
+#include "avc_mapped_file.h"
+
+#include <memory>
+#include <string>
+
+namespace avc {
+namespace detail {
+
+class AvcPacketizer
+  : public virtual IAvcPacketizer {
+ public:
+  explicit AvcPacketizer(std::shared_ptr<IAvcModuleProvider> avc_module_provider);
+  virtual ~AvcPacketizer();
+
+  int Open(int codec_id);
+
+  int SendData(AVBufferRef* buffer, const uint8_t* data, size_t size,
+               int64_t pts, int64_t dts, int64_t pos) override;
+  int SendFile(const std::string& url) override;
+  int ReceivePacket(AVPacket* packet) override;
+
+  AvcPacketizerStatistics GetStatistics() const override { return stat_; }
+
+ private:
+  int SendNextFileWindow();
+  int EmitPacket(AVPacket* packet, uint8_t* data, int size);
+  void ReleaseInput();
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AVCodecParserContext* parser_context_ = nullptr;
+  AVCodecContext* codec_context_ = nullptr;
+
+  AVBufferRef* input_buffer_ = nullptr;
+  const uint8_t* input_data_ = nullptr;
+  size_t input_size_ = 0;
+  int64_t input_pts_ = 0;
+  int64_t input_dts_ = 0;
+  int64_t input_pos_ = -1;
+  bool flushing_ = false;
+  bool finished_ = false;
+
+  std::shared_ptr<AvcMappedFile> file_;   ///< shared with buffers of packets, mapping outlives packetizer
+  size_t file_offset_ = 0;
+
+  AvcPacketizerStatistics stat_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_PACKETIZER_HEADER
@@ -0,0 +1,350 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_remuxer.h"
+#include "avc_media_output.h"
+#include "avc_media_utils.h"
+#include <avc/ffmpeg-loader.h>
+#include <avc/libav_detached_common.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <numeric>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+
+std::shared_ptr<IAvcRemuxer> API_EXPORT CreateAvcRemuxer(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcRemuxerConfig& config) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  if (!avc_module_provider->IsAvFormatLoaded() || !avc_module_provider->IsAvCodecLoaded())
+    return nullptr;
+
+  return std::make_shared<avc::detail::AvcRemuxer>(avc_module_provider, config);
+}
+
+namespace detail {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const AVRational kMicroseconds = { 1, AV_TIME_BASE };
+
+}  // namespace
+
+AvcRemuxer::AvcRemuxer(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcRemuxerConfig& config)
+  : avc_module_provider_(avc_module_provider)
+  , config_(config)
+  , input_(avc_module_provider) {
+  if (config_.batch_size_ == 0)
+    config_.batch_size_ = AvcRemuxerConfig().batch_size_;
+}
+
+int AvcRemuxer::Remux(const std::string& input_url, const std::string& output_url) {
+  auto start = Clock::now();
+  auto d = avc_module_provider_->d();
+  stat_ = AvcRemuxerStatistics();
+  streams_.clear();
+
+  int ret = input_.Open(input_url);
+  if (ret < 0)
+    return ret;
+
+  AvcMediaOutput output(avc_module_provider_);
+  ret = output.Create(output_url, config_.output_format_);
+  AVFormatContext* output_context = output.GetFormatContext();
+
+  if (ret >= 0)
+    ret = CreateOutputStreams(output_context);
+  if (ret >= 0)
+    ret = output.OpenFile();
+  if (ret >= 0) {
+    AVDictionary* options = nullptr;
+    for (auto& option : config_.muxer_options_)
+      avc_module_provider_->av_dict_set(&options, option.first.c_str(), option.second.c_str(), 0);
+
+    ret = avc_module_provider_->avformat_write_header(output_context, &options);
+    avc_module_provider_->av_dict_free(&options);
+  }
+
+  // trim points are relative to input start, muxer may change stream time bases in write_header
+  int64_t origin_us = d->AVFormatContextGetStartTime(input_.GetFormatContext());
+  if (origin_us == AV_NOPTS_VALUE)
+    origin_us = 0;
+
+  if (ret >= 0)
+    SetupStreamMapping(output_context, origin_us);
+
+  if (ret >= 0 && config_.start_seconds_ > 0) {
+    int64_t start_us = origin_us + static_cast<int64_t>(config_.start_seconds_ * AV_TIME_BASE);
+    ret = avc_module_provider_->av_seek_frame(input_.GetFormatContext(), -1, start_us, AVSEEK_FLAG_BACKWARD);
+  }
+
+  std::shared_ptr<IAvcPacketBatch> batch;
+  if (ret >= 0) {
+    batch = CreateAvcPacketBatch(avc_module_provider_, config_.batch_size_);
+    if (!batch)
+      ret = AVERROR(ENOMEM);
+  }
+
+  bool eof = false;
+  while (ret >= 0 && !eof) {
+    size_t count = 0;
+    while (count < batch->GetCount()) {
+      AVPacket* packet = batch->GetPacket(count);
+      int res = avc_module_provider_->av_read_frame(input_.GetFormatContext(), packet);
+      if (res == AVERROR_EOF) {
+        eof = true;
+        break;
+      }
+      if (res < 0) {
+        ret = res;
+        break;
+      }
+
+      stat_.packets_read_++;
+      if (!AcceptPacket(packet)) {
+        avc_module_provider_->av_packet_unref(packet);
+        stat_.packets_dropped_++;
+        if (IsAllStreamsEnded()) {
+          eof = true;
+          break;
+        }
+        continue;
+      }
+      count++;
+    }
+
+    RescaleBatch(batch.get(), count);
+    for (size_t i = 0; ret >= 0 && i < count; i++) {
+      AVPacket* packet = batch->GetPacket(i);
+      int size = d->AVPacketGetSize(packet);
+
+      // muxer takes packet reference and resets packet, payload is never copied
+      ret = avc_module_provider_->av_interleaved_write_frame(output_context, packet);
+      if (ret >= 0) {
+        stat_.packets_written_++;
+        stat_.bytes_written_ += size > 0 ? static_cast<uint64_t>(size) : 0;
+      }
+    }
+
+    // packets left after write error
+    batch->UnrefAll();
+    if (count > 0)
+      stat_.batches_++;
+  }
+
+  if (ret >= 0)
+    ret = avc_module_provider_->av_write_trailer(output_context);
+
+#if DEBUG_PRINT
+  if (ret < 0)
+    fprintf(stderr, "AvcRemuxer: remux %s to %s failed %d\n", input_url.c_str(), output_url.c_str(), ret);
+#endif //DEBUG_PRINT
+
+  output.Close();
+  input_.Close();
+
+  stat_.elapsed_ms_ = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  if (stat_.elapsed_ms_ > 0) {
+    double seconds = stat_.elapsed_ms_ / 1000.0;
+    stat_.packets_per_second_ = static_cast<double>(stat_.packets_written_) / seconds;
+    stat_.megabytes_per_second_ = static_cast<double>(stat_.bytes_written_) / (1024.0 * 1024.0) / seconds;
+  }
+  return ret;
+}
+
+int AvcRemuxer::CreateOutputStreams(AVFormatContext* output_context) {
+  auto d = avc_module_provider_->d();
+  int streams_count = input_.GetStreamsCount();
+  for (int index : config_.streams_) {
+    if (index < 0 || index >= streams_count)
+      return AVERROR_STREAM_NOT_FOUND;
+  }
+
+  streams_.assign(streams_count, StreamMapping());
+  int selected_count = 0;
+  for (int i = 0; i < streams_count; i++) {
+    int media_type = input_.GetStreamMediaType(i);
+    bool selected = config_.streams_.empty()
+      ? (media_type == AVMEDIA_TYPE_VIDEO || media_type == AVMEDIA_TYPE_AUDIO || media_type == AVMEDIA_TYPE_SUBTITLE)
+      : std::find(config_.streams_.begin(), config_.streams_.end(), i) != config_.streams_.end();
+
+    AVStream* input_stream = input_.GetStream(i);
+    if (!selected) {
+      // demuxer does not return packets of discarded streams
+      d->AVStreamSetDiscard(input_stream, AVDISCARD_ALL);
+      continue;
+    }
+
+    AVStream* stream = avc_module_provider_->avformat_new_stream(output_context, nullptr);
+    if (!stream)
+      return AVERROR(ENOMEM);
+
+    int ret = avc_module_provider_->avcodec_parameters_copy(d->AVStreamGetCodecPar(stream), d->AVStreamGetCodecPar(input_stream));
+    if (ret < 0)
+      return ret;
+
+    d->AVCodecParametersSetCodecTag(d->AVStreamGetCodecPar(stream), 0);
+    d->AVStreamSetTimeBase(stream, d->AVStreamGetTimeBase(input_stream));
+    streams_[i].output_index_ = d->AVStreamGetIndex(stream);
+    streams_[i].is_video_ = media_type == AVMEDIA_TYPE_VIDEO;
+    selected_count++;
+  }
+
+  return selected_count > 0 ? 0 : AVERROR_STREAM_NOT_FOUND;
+}
+
+void AvcRemuxer::SetupStreamMapping(AVFormatContext* output_context, int64_t origin_us) {
+  auto d = avc_module_provider_->d();
+  for (size_t i = 0; i < streams_.size(); i++) {
+    StreamMapping& mapping = streams_[i];
+    if (mapping.output_index_ < 0)
+      continue;
+
+    mapping.src_time_base_ = input_.GetStreamTimeBase(static_cast<int>(i));
+    mapping.dst_time_base_ = d->AVStreamGetTimeBase(d->AVFormatContextGetStreamByIdx(output_context, mapping.output_index_));
+
+    // timestamp * src / dst == timestamp * mul / div, 0 / 0 sends every timestamp to av_rescale_q_rnd
+    int64_t mul = static_cast<int64_t>(mapping.src_time_base_.num_) * mapping.dst_time_base_.den_;
+    int64_t div = static_cast<int64_t>(mapping.src_time_base_.den_) * mapping.dst_time_base_.num_;
+    if (mul > 0 && div > 0) {
+      int64_t gcd = std::gcd(mul, div);
+      mapping.mul_ = mul / gcd;
+      mapping.div_ = div / gcd;
+    } else {
+      mapping.mul_ = 0;
+      mapping.div_ = 0;
+    }
+
+    AVRational src = ToAVRational(mapping.src_time_base_);
+    if (config_.start_seconds_ > 0) {
+      int64_t start_us = origin_us + static_cast<int64_t>(config_.start_seconds_ * AV_TIME_BASE);
+      mapping.start_ = avc_module_provider_->av_rescale_q_rnd(start_us, kMicroseconds, src, AV_ROUND_DOWN);
+    }
+    if (config_.end_seconds_ > 0) {
+      int64_t end_us = origin_us + static_cast<int64_t>(config_.end_seconds_ * AV_TIME_BASE);
+      mapping.end_ = avc_module_provider_->av_rescale_q_rnd(end_us, kMicroseconds, src, AV_ROUND_UP);
+    }
+    mapping.started_ = config_.start_seconds_ <= 0;
+  }
+}
+
+bool AvcRemuxer::AcceptPacket(AVPacket* packet) {
+  auto d = avc_module_provider_->d();
+  int index = d->AVPacketGetStreamIndex(packet);
+  if (index < 0 || index >= static_cast<int>(streams_.size()) || streams_[index].output_index_ < 0)
+    return false;
+
+  StreamMapping& mapping = streams_[index];
+  if (mapping.ended_)
+    return false;
+
+  int64_t timestamp = GetPacketTimestamp(d.get(), packet);
+  if (timestamp != AV_NOPTS_VALUE && timestamp >= mapping.end_) {
+    mapping.ended_ = true;
+    return false;
+  }
+
+  if (!mapping.started_) {
+    // video has to begin with keyframe to be decodable, other streams begin exactly at trim point
+    if (mapping.is_video_) {
+      if ((d->AVPacketGetFlags(packet) & AV_PKT_FLAG_KEY) == 0)
+        return false;
+    } else if (timestamp == AV_NOPTS_VALUE || timestamp < mapping.start_) {
+      return false;
+    }
+    mapping.started_ = true;
+  }
+
+  return true;
+}
+
+bool AvcRemuxer::IsAllStreamsEnded() const {
+  for (auto& mapping : streams_)
+    if (mapping.output_index_ >= 0 && !mapping.ended_)
+      return false;
+
+  return true;
+}
+
+int64_t AvcRemuxer::RescaleValue(int64_t value, const StreamMapping& mapping) {
+  if (mapping.mul_ == 1 && mapping.div_ == 1)
+    return value;
+
+  // same result as av_rescale_q_rnd with AV_ROUND_NEAR_INF while value * mul_ fits int64
+  if (mapping.div_ > 0) {
+    int64_t limit = (INT64_MAX - mapping.div_) / mapping.mul_;
+    int64_t half = mapping.div_ / 2;
+    if (value >= 0 && value <= limit)
+      return (value * mapping.mul_ + half) / mapping.div_;
+    if (value < 0 && value >= -limit)
+      return -((-value * mapping.mul_ + half) / mapping.div_);
+  }
+
+  return avc_module_provider_->av_rescale_q_rnd(value, ToAVRational(mapping.src_time_base_),
+    ToAVRational(mapping.dst_time_base_), AV_ROUND_NEAR_INF | AV_ROUND_PASS_MINMAX);
+}
+
+void AvcRemuxer::RescaleBatch(IAvcPacketBatch* batch, size_t count) {
+  // one pass over batch with ratios computed once per stream, library call only on int64 overflow
+  auto d = avc_module_provider_->d();
+  for (size_t i = 0; i < count; i++) {
+    AVPacket* packet = batch->GetPacket(i);
+    const StreamMapping& mapping = streams_[d->AVPacketGetStreamIndex(packet)];
+
+    int64_t pts = d->AVPacketGetPts(packet);
+    int64_t dts = d->AVPacketGetDts(packet);
+    int64_t duration = d->AVPacketGetDuration(packet);
+    d->AVPacketSetPts(packet, pts != AV_NOPTS_VALUE ? RescaleValue(pts - mapping.start_, mapping) : pts);
+    d->AVPacketSetDts(packet, dts != AV_NOPTS_VALUE ? RescaleValue(dts - mapping.start_, mapping) : dts);
+    if (duration > 0)
+      d->AVPacketSetDuration(packet, RescaleValue(duration, mapping));
+
+    d->AVPacketSetStreamIndex(packet, mapping.output_index_);
+    d->AVPacketSetPos(packet, -1);
+  }
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_REMUXER_HEADER
+#define AVC_REMUXER_HEADER
+
+#include <avc/i_avc_remuxer.h>
+#include <avc/i_avc_module_provider.h>
+#include <avc/i_avc_packet_batch.h>
+#include "avc_media_input.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcRemuxer
+  : public virtual IAvcRemuxer {
+ public:
+  AvcRemuxer(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcRemuxerConfig& config);
+  virtual ~AvcRemuxer() = default;
+
+  int Remux(const std::string& input_url, const std::string& output_url) override;
+  AvcRemuxerStatistics GetStatistics() const override { return stat_; }
+
+ private:
+  /// \brief Mapping of input stream to output stream with precomputed rescale ratio
+  struct StreamMapping {
+    int output_index_ = -1;         ///< -1 when stream is not copied
+    cmf::MediaTimeBase src_time_base_;
+    cmf::MediaTimeBase dst_time_base_;
+    int64_t mul_ = 1;               ///< src_time_base_ / dst_time_base_ reduced to mul_ / div_
+    int64_t div_ = 1;
+    int64_t start_ = 0;             ///< trim start in source time base, also subtracted from timestamps
+    int64_t end_ = INT64_MAX;       ///< trim end in source time base
+    bool is_video_ = false;
+    bool started_ = false;
+    bool ended_ = false;
+  };
+
+  int CreateOutputStreams(AVFormatContext* output_context);
+  void SetupStreamMapping(AVFormatContext* output_context, int64_t origin_us);
+  bool AcceptPacket(AVPacket* packet);
+  bool IsAllStreamsEnded() const;
+  int64_t RescaleValue(int64_t value, const StreamMapping& mapping);
+  void RescaleBatch(IAvcPacketBatch* batch, size_t count);
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AvcRemuxerConfig config_;
+
+  AvcMediaInput input_;
+  std::vector<StreamMapping> streams_;
+  AvcRemuxerStatistics stat_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_REMUXER_HEADER
@@ -0,0 +1,746 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_smart_trimmer.h"
+#include "avc_media_utils.h"
+#include <avc/libav_detached_common.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+
+std::shared_ptr<IAvcSmartTrimmer> API_EXPORT CreateAvcSmartTrimmer(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  const AvcSmartTrimmerConfig& config) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  if (!avc_module_provider->IsAvFormatLoaded() || !avc_module_provider->IsAvCodecLoaded())
+    return nullptr;
+
+  return std::make_shared<avc::detail::AvcSmartTrimmer>(avc_module_provider, config);
+}
+
+namespace detail {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const AVRational kMicroseconds = { 1, AV_TIME_BASE };
+
+const int kHevcNalVps = 32;
+const int kHevcNalPps = 34;
+
+double ElapsedMs(Clock::time_point from) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - from).count();
+}
+
+}  // namespace
+
+AvcSmartTrimmer::AvcSmartTrimmer(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcSmartTrimmerConfig& config)
+  : avc_module_provider_(avc_module_provider)
+  , config_(config)
+  , input_(avc_module_provider)
+  , output_(avc_module_provider)
+  , last_video_dts_(AV_NOPTS_VALUE) {
+}
+
+AvcSmartTrimmer::~AvcSmartTrimmer() {
+  Close();
+}
+
+int AvcSmartTrimmer::Trim(const std::string& input_url, const std::string& output_url,
+                          double start_seconds, double end_seconds) {
+  auto start = Clock::now();
+  Close();
+  stat_ = AvcSmartTrimmerStatistics();
+  video_done_ = false;
+  after_reencode_ = false;
+  last_video_dts_ = AV_NOPTS_VALUE;
+  if (start_seconds < 0 || (end_seconds > 0 && end_seconds <= start_seconds))
+    return AVERROR(EINVAL);
+
+  int ret = input_.Open(input_url);
+  if (ret >= 0) {
+    video_index_ = input_.FindBestStream(AVMEDIA_TYPE_VIDEO);
+    if (video_index_ < 0)
+      ret = AVERROR_STREAM_NOT_FOUND;
+  }
+
+  if (ret >= 0)
+    ret = CreateOutput(output_url, start_seconds, end_seconds);
+
+  AVPacket* packet = nullptr;
+  if (ret >= 0) {
+    packet = avc_module_provider_->av_packet_alloc();
+    encoded_packet_ = avc_module_provider_->av_packet_alloc();
+    converted_packet_ = avc_module_provider_->av_packet_alloc();
+    frame_ = avc_module_provider_->av_frame_alloc();
+    if (!packet || !encoded_packet_ || !converted_packet_ || !frame_)
+      ret = AVERROR(ENOMEM);
+  }
+
+  // demuxer lands on keyframe before start, GOPs which end before start are dropped
+  if (ret >= 0 && start_seconds > 0)
+    ret = avc_module_provider_->av_seek_frame(input_.GetFormatContext(), video_index_, start_, AVSEEK_FLAG_BACKWARD);
+
+  auto d = avc_module_provider_->d();
+  while (ret >= 0 && !(video_done_ && IsAllAudioEnded())) {
+    ret = avc_module_provider_->av_read_frame(input_.GetFormatContext(), packet);
+    if (ret == AVERROR_EOF) {
+      ret = 0;
+      break;
+    }
+
+    if (ret < 0)
+      break;
+
+    if (d->AVPacketGetStreamIndex(packet) == video_index_)
+      ret = ProcessVideoPacket(packet);
+    else
+      ret = ProcessAudioPacket(packet);
+    avc_module_provider_->av_packet_unref(packet);
+  }
+
+  // last GOP of input has no next keyframe
+  if (ret >= 0 && !video_done_ && !gop_.empty())
+    ret = FlushGop(nullptr);
+
+  if (ret >= 0)
+    ret = avc_module_provider_->av_write_trailer(output_.GetFormatContext());
+
+#if DEBUG_PRINT
+  if (ret < 0)
+    fprintf(stderr, "AvcSmartTrimmer: trim %s to %s failed %d\n", input_url.c_str(), output_url.c_str(), ret);
+#endif //DEBUG_PRINT
+
+  avc_module_provider_->av_packet_free(&packet);
+  Close();
+  stat_.elapsed_ms_ = ElapsedMs(start);
+  return ret;
+}
+
+int AvcSmartTrimmer::CreateOutput(const std::string& output_url, double start_seconds, double end_seconds) {
+  auto d = avc_module_provider_->d();
+  int ret = output_.Create(output_url, config_.output_format_);
+  if (ret < 0)
+    return ret;
+
+  // trim points are relative to input start
+  int64_t origin_us = d->AVFormatContextGetStartTime(input_.GetFormatContext());
+  if (origin_us == AV_NOPTS_VALUE)
+    origin_us = 0;
+  int64_t start_us = origin_us + static_cast<int64_t>(start_seconds * AV_TIME_BASE);
+  int64_t end_us = end_seconds > 0 ? origin_us + static_cast<int64_t>(end_seconds * AV_TIME_BASE) : INT64_MAX;
+
+  audio_streams_.assign(input_.GetStreamsCount(), AudioStream());
+  for (int i = 0; i < input_.GetStreamsCount(); i++) {
+    AVStream* input_stream = input_.GetStream(i);
+    bool audio = config_.copy_audio_ && input_.GetStreamMediaType(i) == AVMEDIA_TYPE_AUDIO;
+    if (i != video_index_ && !audio) {
+      d->AVStreamSetDiscard(input_stream, AVDISCARD_ALL);
+      continue;
+    }
+
+    AVStream* stream = avc_module_provider_->avformat_new_stream(output_.GetFormatContext(), nullptr);
+    if (!stream)
+      return AVERROR(ENOMEM);
+
+    ret = avc_module_provider_->avcodec_parameters_copy(d->AVStreamGetCodecPar(stream), d->AVStreamGetCodecPar(input_stream));
+    if (ret < 0)
+      return ret;
+
+    cmf::MediaTimeBase time_base = input_.GetStreamTimeBase(i);
+    d->AVCodecParametersSetCodecTag(d->AVStreamGetCodecPar(stream), 0);
+    d->AVStreamSetTimeBase(stream, time_base);
+
+    int64_t start_timestamp = avc_module_provider_->av_rescale_q_rnd(start_us, kMicroseconds, ToAVRational(time_base),
+      AV_ROUND_NEAR_INF | AV_ROUND_PASS_MINMAX);
+    int64_t end_timestamp = end_us == INT64_MAX ? INT64_MAX
+      : avc_module_provider_->av_rescale_q_rnd(end_us, kMicroseconds, ToAVRational(time_base), AV_ROUND_NEAR_INF);
+    if (i == video_index_) {
+      // copied packets keep layout of input. H.264 and HEVC from avcC / hvcC have NAL length prefixes,
+      // encoder without global header writes Annex B, so its packets get same prefixes
+      AVCodecParameters* codecpar = d->AVStreamGetCodecPar(input_stream);
+      int codec_id = d->AVCodecParametersGetCodecId(codecpar);
+      const uint8_t* extradata = d->AVCodecParametersGetExtraData(codecpar);
+      int extradata_size = d->AVCodecParametersGetExtraDataSize(codecpar);
+      AvcNalScanner input_scanner;
+      if (input_scanner.Init(avc_module_provider_, codec_id, extradata, extradata_size)) {
+        nal_length_size_ = input_scanner.GetLengthSize();
+        annexb_scanner_.Init(avc_module_provider_, codec_id, nullptr, 0);
+        SetupParameterSets(codec_id, extradata, extradata_size);
+      }
+
+      output_video_index_ = d->AVStreamGetIndex(stream);
+      video_time_base_ = time_base;
+      start_ = start_timestamp;
+      end_ = end_timestamp;
+    } else {
+      AudioStream& audio_stream = audio_streams_[i];
+      audio_stream.output_index_ = d->AVStreamGetIndex(stream);
+      audio_stream.start_ = start_timestamp;
+      audio_stream.end_ = end_timestamp;
+    }
+  }
+
+  ret = output_.OpenFile();
+  if (ret >= 0)
+    ret = avc_module_provider_->avformat_write_header(output_.GetFormatContext(), nullptr);
+  return ret;
+}
+
+int AvcSmartTrimmer::ProcessVideoPacket(AVPacket* packet) {
+  if (video_done_)
+    return 0;
+
+  auto d = avc_module_provider_->d();
+  bool key = (d->AVPacketGetFlags(packet) & AV_PKT_FLAG_KEY) != 0;
+  if (key && !gop_.empty()) {
+    int ret = FlushGop(packet);
+    if (ret < 0 || video_done_)
+      return ret;
+  }
+
+  // packets before first keyframe can not be decoded
+  if (gop_.empty() && !key)
+    return 0;
+
+  AVPacket* stored = nullptr;
+  if (!free_packets_.empty()) {
+    stored = free_packets_.back();
+    free_packets_.pop_back();
+  } else {
+    stored = avc_module_provider_->av_packet_alloc();
+    if (!stored)
+      return AVERROR(ENOMEM);
+  }
+
+  // GOP keeps packet references, payload is not copied
+  avc_module_provider_->av_packet_move_ref(stored, packet);
+  gop_.push_back(stored);
+  return 0;
+}
+
+int AvcSmartTrimmer::ProcessAudioPacket(AVPacket* packet) {
+  auto d = avc_module_provider_->d();
+  int index = d->AVPacketGetStreamIndex(packet);
+  if (index < 0 || index >= static_cast<int>(audio_streams_.size()))
+    return 0;
+
+  AudioStream& audio_stream = audio_streams_[index];
+  if (audio_stream.output_index_ < 0 || audio_stream.ended_)
+    return 0;
+
+  int64_t timestamp = GetPacketTimestamp(d.get(), packet);
+  if (timestamp != AV_NOPTS_VALUE && timestamp >= audio_stream.end_) {
+    audio_stream.ended_ = true;
+    return 0;
+  }
+
+  if (timestamp == AV_NOPTS_VALUE || timestamp < audio_stream.start_)
+    return 0;
+
+  return WritePacket(packet, input_.GetStreamTimeBase(index), audio_stream.start_, audio_stream.output_index_);
+}
+
+bool AvcSmartTrimmer::IsAllAudioEnded() const {
+  for (auto& audio_stream : audio_streams_)
+    if (audio_stream.output_index_ >= 0 && !audio_stream.ended_)
+      return false;
+
+  return true;
+}
+
+int AvcSmartTrimmer::FlushGop(const AVPacket* next_key_packet) {
+  auto d = avc_module_provider_->d();
+  int64_t gop_start = GetPacketPresentationTimestamp(d.get(), gop_.front());
+  int64_t gop_end = AV_NOPTS_VALUE;
+  if (next_key_packet) {
+    gop_end = GetPacketPresentationTimestamp(d.get(), next_key_packet);
+  } else {
+    for (AVPacket* packet : gop_) {
+      int64_t pts = GetPacketPresentationTimestamp(d.get(), packet);
+      if (pts != AV_NOPTS_VALUE)
+        gop_end = std::max(gop_end, pts + std::max<int64_t>(1, d->AVPacketGetDuration(packet)));
+    }
+  }
+
+  if (gop_start == AV_NOPTS_VALUE || gop_end == AV_NOPTS_VALUE) {
+    ReleaseGop();
+    return AVERROR_INVALIDDATA;
+  }
+
+  // seek may land few GOPs before start
+  if (gop_end <= start_) {
+    ReleaseGop();
+    return 0;
+  }
+
+  int ret = 0;
+  bool is_tail = gop_end > end_;
+  if (gop_start < start_ || is_tail) {
+    // re-encoded head is followed by copied GOP, its DTS go just below DTS of next keyframe.
+    // Re-encoded tail follows copied GOP and continues from DTS of own keyframe
+    const AVPacket* reference = (is_tail || !next_key_packet) ? gop_.front() : next_key_packet;
+    int64_t reference_pts = d->AVPacketGetPts(reference);
+    int64_t reference_dts = d->AVPacketGetDts(reference);
+    int64_t dts_offset = 0;
+    if (reference_pts != AV_NOPTS_VALUE && reference_dts != AV_NOPTS_VALUE && reference_pts > reference_dts)
+      dts_offset = reference_pts - reference_dts;
+
+    ret = ReencodeGop(dts_offset);
+    after_reencode_ = true;
+    stat_.gops_reencoded_++;
+  } else {
+    ret = CopyGop();
+    after_reencode_ = false;
+    stat_.gops_copied_++;
+  }
+
+  ReleaseGop();
+  if (gop_end >= end_)
+    video_done_ = true;
+  return ret;
+}
+
+int AvcSmartTrimmer::CopyGop() {
+  auto d = avc_module_provider_->d();
+  int64_t gop_start = GetPacketPresentationTimestamp(d.get(), gop_.front());
+
+  // parameter sets of encoder replaced ones of input, which have same ids, so input ones are sent again
+  bool insert_parameter_sets = after_reencode_ && !parameter_sets_.empty();
+  for (AVPacket* packet : gop_) {
+    // leading pictures of open GOP reference previous GOP, which was re-encoded
+    int64_t pts = d->AVPacketGetPts(packet);
+    if (after_reencode_ && pts != AV_NOPTS_VALUE && pts < gop_start)
+      continue;
+
+    int ret = 0;
+    if (insert_parameter_sets) {
+      insert_parameter_sets = false;
+      ret = PrependParameterSets(packet);
+      if (ret >= 0)
+        ret = WriteVideoPacket(converted_packet_);
+      avc_module_provider_->av_packet_unref(converted_packet_);
+    } else {
+      ret = WriteVideoPacket(packet);
+    }
+
+    if (ret < 0)
+      return ret;
+    stat_.packets_copied_++;
+  }
+  return 0;
+}
+
+void AvcSmartTrimmer::SetupParameterSets(int codec_id, const uint8_t* extradata, int extradata_size) {
+  parameter_sets_.clear();
+  if (!extradata || extradata_size <= 0)
+    return;
+
+  uint64_t max_unit_size = nal_length_size_ > 0 ? (static_cast<uint64_t>(1) << (8 * nal_length_size_)) - 1 : UINT32_MAX;
+  auto append = [&](const uint8_t* unit, size_t unit_size) -> bool {
+    if (unit_size == 0 || unit_size > max_unit_size)
+      return false;
+
+    if (nal_length_size_ > 0) {
+      for (int i = nal_length_size_ - 1; i >= 0; i--)
+        parameter_sets_.push_back(static_cast<uint8_t>(unit_size >> (8 * i)));
+    } else {
+      const uint8_t start_code[] = { 0, 0, 0, 1 };
+      parameter_sets_.insert(parameter_sets_.end(), start_code, start_code + sizeof(start_code));
+    }
+    parameter_sets_.insert(parameter_sets_.end(), unit, unit + unit_size);
+    return true;
+  };
+
+  // unit list of avcC / hvcC, every unit has 16 bit size. Units which are not kept are skipped
+  const uint8_t* p = extradata;
+  const uint8_t* end = extradata + extradata_size;
+  auto read_units = [&](int count, bool keep) -> bool {
+    for (int i = 0; i < count; i++) {
+      if (end - p < 2)
+        return false;
+      size_t unit_size = (static_cast<size_t>(p[0]) << 8) | p[1];
+      p += 2;
+      if (unit_size > static_cast<size_t>(end - p) || (keep && !append(p, unit_size)))
+        return false;
+      p += unit_size;
+    }
+    return true;
+  };
+
+  bool valid = true;
+  if (nal_length_size_ == 0) {
+    // Annex B extradata is sequence of start code prefixed units
+    AvcNalScanResult scan_result;
+    valid = annexb_scanner_.Scan(extradata, static_cast<size_t>(extradata_size), &scan_result, &nal_units_) >= 0;
+    for (size_t i = 0; valid && i < nal_units_.size(); i++)
+      valid = append(extradata + nal_units_[i].offset_, nal_units_[i].size_);
+  } else if (codec_id == AV_CODEC_ID_H264) {
+    // avcC: 5 bytes of header, SPS count in low 5 bits, SPS units, PPS count, PPS units
+    p += 5;
+    valid = p < end && read_units(*p++ & 0x1F, true);
+    valid = valid && p < end && read_units(*p++, true);
+  } else {
+    // hvcC: 22 bytes of header, array count, arrays of type byte, 16 bit unit count and units
+    p += 22;
+    int arrays_count = p < end ? *p++ : 0;
+    for (int i = 0; valid && i < arrays_count; i++) {
+      if (end - p < 3) {
+        valid = false;
+        break;
+      }
+
+      // SEI and other units of hvcC are not repeated
+      int type = p[0] & 0x3F;
+      int count = (p[1] << 8) | p[2];
+      p += 3;
+      valid = read_units(count, type >= kHevcNalVps && type <= kHevcNalPps);
+    }
+  }
+
+#if DEBUG_PRINT
+  if (!valid)
+    fprintf(stderr, "AvcSmartTrimmer: parameter sets of extradata are not parsed, codec %d size %d\n", codec_id, extradata_size);
+#endif //DEBUG_PRINT
+  if (!valid)
+    parameter_sets_.clear();
+}
+
+int AvcSmartTrimmer::PrependParameterSets(const AVPacket* packet) {
+  auto d = avc_module_provider_->d();
+  const uint8_t* data = static_cast<const uint8_t*>(d->AVPacketGetData(packet));
+  int size = d->AVPacketGetSize(packet);
+  if (size < 0 || static_cast<uint64_t>(size) + parameter_sets_.size() > INT32_MAX)
+    return AVERROR(EINVAL);
+
+  int ret = avc_module_provider_->av_new_packet(converted_packet_, static_cast<int>(parameter_sets_.size()) + size);
+  if (ret < 0)
+    return ret;
+
+  uint8_t* out = static_cast<uint8_t*>(d->AVPacketGetData(converted_packet_));
+  memcpy(out, parameter_sets_.data(), parameter_sets_.size());
+  if (size > 0)
+    memcpy(out + parameter_sets_.size(), data, size);
+  CopyPacketProps(converted_packet_, packet);
+  return 0;
+}
+
+void AvcSmartTrimmer::CopyPacketProps(AVPacket* dst, const AVPacket* src) {
+  auto d = avc_module_provider_->d();
+  d->AVPacketSetPts(dst, d->AVPacketGetPts(src));
+  d->AVPacketSetDts(dst, d->AVPacketGetDts(src));
+  d->AVPacketSetDuration(dst, d->AVPacketGetDuration(src));
+  d->AVPacketSetFlags(dst, d->AVPacketGetFlags(src));
+}
+
+int AvcSmartTrimmer::ReencodeGop(int64_t dts_offset) {
+  auto start = Clock::now();
+  auto d = avc_module_provider_->d();
+  if (!decoder_context_) {
+    decoder_context_ = input_.OpenDecoder(video_index_, 0, nullptr, 0, nullptr, config_.codec_autotuner_.get());
+    if (!decoder_context_)
+      return AVERROR_DECODER_NOT_FOUND;
+  } else {
+    avc_module_provider_->avcodec_flush_buffers(decoder_context_);
+  }
+
+  int ret = OpenEncoder();
+  if (ret < 0)
+    return ret;
+
+  // decoder starts from keyframe, leading pictures of open GOP can not be restored
+  leading_limit_ = std::max(start_, GetPacketPresentationTimestamp(d.get(), gop_.front()));
+
+  auto drain_decoder = [&]() -> int {
+    while (true) {
+      int r = avc_module_provider_->avcodec_receive_frame(decoder_context_, frame_);
+      if (r == AVERROR(EAGAIN) || r == AVERROR_EOF)
+        return 0;
+      if (r < 0)
+        return r;
+
+      r = EncodeFrame(frame_, dts_offset);
+      avc_module_provider_->av_frame_unref(frame_);
+      if (r < 0)
+        return r;
+    }
+  };
+
+  for (size_t i = 0; ret >= 0 && i < gop_.size(); i++) {
+    while ((ret = avc_module_provider_->avcodec_send_packet(decoder_context_, gop_[i])) == AVERROR(EAGAIN)) {
+      ret = drain_decoder();
+      if (ret < 0)
+        break;
+    }
+
+    // damaged packet loses some frames only, like in ffmpeg tool
+    if (ret == AVERROR_INVALIDDATA)
+      ret = 0;
+    if (ret >= 0)
+      ret = drain_decoder();
+  }
+
+  if (ret >= 0)
+    ret = avc_module_provider_->avcodec_send_packet(decoder_context_, nullptr);
+  if (ret >= 0)
+    ret = drain_decoder();
+  if (ret >= 0)
+    ret = avc_module_provider_->avcodec_send_frame(encoder_context_, nullptr);
+  if (ret >= 0)
+    ret = WriteEncodedPackets(dts_offset);
+
+  avc_module_provider_->avcodec_free_context(&encoder_context_);
+  stat_.reencode_ms_ += ElapsedMs(start);
+  return ret;
+}
+
+int AvcSmartTrimmer::OpenEncoder() {
+  auto d = avc_module_provider_->d();
+  avc_module_provider_->avcodec_free_context(&encoder_context_);
+
+  AVStream* stream = input_.GetStream(video_index_);
+  AVCodecParameters* codecpar = d->AVStreamGetCodecPar(stream);
+  AVCodec* codec = avc_module_provider_->avcodec_find_encoder(d->AVCodecParametersGetCodecId(codecpar));
+  if (!codec)
+    return AVERROR_ENCODER_NOT_FOUND;
+
+  // decoded frames go to encoder as is, so encoder has to support pixel format of input
+  int pix_fmt = d->AVCodecParametersGetFormat(codecpar);
+  if (SelectEncoderPixelFormat(d.get(), codec, pix_fmt) != pix_fmt)
+    return AVERROR(EINVAL);
+
+  encoder_context_ = avc_module_provider_->avcodec_alloc_context3(codec);
+  if (!encoder_context_)
+    return AVERROR(ENOMEM);
+
+  cmf::MediaTimeBase frame_rate = GetStreamFrameRate(d.get(), stream);
+
+  int64_t bit_rate = config_.bit_rate_ > 0 ? config_.bit_rate_ : d->AVCodecParametersGetBitRate(codecpar);
+  int profile = d->AVCodecParametersGetProfile(codecpar);
+
+  d->AVCodecContextSetWidth(encoder_context_, d->AVCodecParametersGetWidth(codecpar));
+  d->AVCodecContextSetHeight(encoder_context_, d->AVCodecParametersGetHeight(codecpar));
+  d->AVCodecContextSetPixFmt(encoder_context_, pix_fmt);
+  d->AVCodecContextSetTimeBase(encoder_context_, video_time_base_);
+  d->AVCodecContextSetFrameRate(encoder_context_, frame_rate);
+  if (profile >= 0)
+    d->AVCodecContextSetProfile(encoder_context_, profile);
+  if (bit_rate > 0)
+    d->AVCodecContextSetBitRate(encoder_context_, bit_rate);
+  if (config_.encoder_threads_ > 0)
+    d->AVCodecContextSetThreadCount(encoder_context_, config_.encoder_threads_);
+  else if (config_.codec_autotuner_)
+    config_.codec_autotuner_->Apply(encoder_context_, true);
+
+  // no AV_CODEC_FLAG_GLOBAL_HEADER: parameter sets of re-encoded part go in-band, extradata of output
+  // stays the one of input and describes copied GOPs
+  // without B-frames DTS equal PTS, part is one GOP which starts with keyframe
+  d->AVCodecContextSetMaxBFrames(encoder_context_, 0);
+  d->AVCodecContextSetGopSize(encoder_context_, static_cast<int>(gop_.size()) + 1);
+
+  AVDictionary* options = nullptr;
+  for (auto& option : config_.encoder_options_)
+    avc_module_provider_->av_dict_set(&options, option.first.c_str(), option.second.c_str(), 0);
+
+  int ret = avc_module_provider_->avcodec_open2(encoder_context_, codec, &options);
+  avc_module_provider_->av_dict_free(&options);
+  return ret;
+}
+
+int AvcSmartTrimmer::EncodeFrame(AVFrame* frame, int64_t dts_offset) {
+  auto d = avc_module_provider_->d();
+  int64_t pts = d->AVFrameGetPts(frame);
+  if (pts == AV_NOPTS_VALUE)
+    pts = d->AVFrameGetPktDts(frame);
+  if (pts == AV_NOPTS_VALUE || pts < leading_limit_ || pts >= end_)
+    return 0;
+
+  d->AVFrameSetPts(frame, pts);
+  d->AVFrameSetPictType(frame, AV_PICTURE_TYPE_NONE);
+
+  int ret = 0;
+  while ((ret = avc_module_provider_->avcodec_send_frame(encoder_context_, frame)) == AVERROR(EAGAIN)) {
+    ret = WriteEncodedPackets(dts_offset);
+    if (ret < 0)
+      return ret;
+  }
+
+  if (ret < 0)
+    return ret;
+
+  stat_.frames_reencoded_++;
+  return WriteEncodedPackets(dts_offset);
+}
+
+int AvcSmartTrimmer::WriteEncodedPackets(int64_t dts_offset) {
+  auto d = avc_module_provider_->d();
+  while (true) {
+    int ret = avc_module_provider_->avcodec_receive_packet(encoder_context_, encoded_packet_);
+    if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF)
+      return 0;
+    if (ret < 0)
+      return ret;
+
+    if (nal_length_size_ > 0) {
+      ret = ConvertEncodedPacket();
+      if (ret < 0) {
+        avc_module_provider_->av_packet_unref(encoded_packet_);
+        return ret;
+      }
+    }
+
+    // encoder time base is stream time base, DTS are moved by pts - dts of neighbouring copied keyframe
+    int64_t pts = d->AVPacketGetPts(encoded_packet_);
+    int64_t dts = pts != AV_NOPTS_VALUE ? pts - dts_offset : d->AVPacketGetDts(encoded_packet_);
+    if (dts != AV_NOPTS_VALUE && last_video_dts_ != AV_NOPTS_VALUE && dts <= last_video_dts_)
+      dts = last_video_dts_ + 1;
+    d->AVPacketSetDts(encoded_packet_, dts);
+
+    ret = WriteVideoPacket(encoded_packet_);
+    avc_module_provider_->av_packet_unref(encoded_packet_);
+    if (ret < 0)
+      return ret;
+  }
+}
+
+int AvcSmartTrimmer::ConvertEncodedPacket() {
+  // start codes of encoder output are replaced by NAL length prefixes of input
+  auto d = avc_module_provider_->d();
+  const uint8_t* data = static_cast<const uint8_t*>(d->AVPacketGetData(encoded_packet_));
+  int size = d->AVPacketGetSize(encoded_packet_);
+  AvcNalScanResult scan_result;
+  int ret = annexb_scanner_.Scan(data, size > 0 ? static_cast<size_t>(size) : 0, &scan_result, &nal_units_);
+  if (ret < 0)
+    return ret;
+
+  uint64_t max_unit_size = (static_cast<uint64_t>(1) << (8 * nal_length_size_)) - 1;
+  uint64_t converted_size = 0;
+  for (const AvcNalUnit& unit : nal_units_) {
+    if (unit.size_ > max_unit_size)
+      return AVERROR(EINVAL);
+    converted_size += nal_length_size_ + unit.size_;
+  }
+
+  if (converted_size > INT32_MAX)
+    return AVERROR(EINVAL);
+
+  ret = avc_module_provider_->av_new_packet(converted_packet_, static_cast<int>(converted_size));
+  if (ret < 0)
+    return ret;
+
+  uint8_t* out = static_cast<uint8_t*>(d->AVPacketGetData(converted_packet_));
+  for (const AvcNalUnit& unit : nal_units_) {
+    for (int i = nal_length_size_ - 1; i >= 0; i--)
+      *out++ = static_cast<uint8_t>(unit.size_ >> (8 * i));
+    memcpy(out, data + unit.offset_, unit.size_);
+    out += unit.size_;
+  }
+
+  CopyPacketProps(converted_packet_, encoded_packet_);
+  avc_module_provider_->av_packet_unref(encoded_packet_);
+  avc_module_provider_->av_packet_move_ref(encoded_packet_, converted_packet_);
+  return 0;
+}
+
+int AvcSmartTrimmer::WriteVideoPacket(AVPacket* packet) {
+  int64_t dts = avc_module_provider_->d()->AVPacketGetDts(packet);
+  if (dts != AV_NOPTS_VALUE)
+    last_video_dts_ = dts;
+
+  return WritePacket(packet, video_time_base_, start_, output_video_index_);
+}
+
+int AvcSmartTrimmer::WritePacket(AVPacket* packet, cmf::MediaTimeBase time_base, int64_t shift, int output_index) {
+  auto d = avc_module_provider_->d();
+  int64_t pts = d->AVPacketGetPts(packet);
+  int64_t dts = d->AVPacketGetDts(packet);
+  if (pts != AV_NOPTS_VALUE)
+    d->AVPacketSetPts(packet, pts - shift);
+  if (dts != AV_NOPTS_VALUE)
+    d->AVPacketSetDts(packet, dts - shift);
+
+  AVStream* stream = d->AVFormatContextGetStreamByIdx(output_.GetFormatContext(), output_index);
+  d->AVPacketSetStreamIndex(packet, output_index);
+  d->AVPacketSetPos(packet, -1);
+  avc_module_provider_->av_packet_rescale_ts(packet, time_base, d->AVStreamGetTimeBase(stream));
+
+  // muxer takes packet reference
+  int ret = avc_module_provider_->av_interleaved_write_frame(output_.GetFormatContext(), packet);
+  if (ret >= 0)
+    stat_.packets_written_++;
+  return ret;
+}
+
+void AvcSmartTrimmer::ReleaseGop() {
+  for (AVPacket* packet : gop_) {
+    avc_module_provider_->av_packet_unref(packet);
+    free_packets_.push_back(packet);
+  }
+  gop_.clear();
+}
+
+void AvcSmartTrimmer::Close() {
+  ReleaseGop();
+  for (AVPacket* packet : free_packets_)
+    avc_module_provider_->av_packet_free(&packet);
+  free_packets_.clear();
+
+  avc_module_provider_->avcodec_free_context(&encoder_context_);
+  avc_module_provider_->avcodec_free_context(&decoder_context_);
+  avc_module_provider_->av_frame_free(&frame_);
+  avc_module_provider_->av_packet_free(&encoded_packet_);
+  avc_module_provider_->av_packet_free(&converted_packet_);
+  nal_length_size_ = 0;
+  parameter_sets_.clear();
+  output_.Close();
+  input_.Close();
+  audio_streams_.clear();
+  video_index_ = -1;
+  output_video_index_ = -1;
+}
+
+}  // namespace detail
+}//namespace avc
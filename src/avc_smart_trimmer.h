@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_SMART_TRIMMER_HEADER
+#define AVC_SMART_TRIMMER_HEADER
+
+#include <avc/i_avc_smart_trimmer.h>
+#include <avc/i_avc_module_provider.h>
+#include "avc_media_input.h"
+#include "avc_media_output.h"
+#include "avc_nal_scanner.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcSmartTrimmer
+  : public virtual IAvcSmartTrimmer {
+ public:
+  AvcSmartTrimmer(std::shared_ptr<IAvcModuleProvider> avc_module_provider, const AvcSmartTrimmerConfig& config);
+  virtual ~AvcSmartTrimmer();
+
+  int Trim(const std::string& input_url, const std::string& output_url,
+           double start_seconds, double end_seconds) override;
+  AvcSmartTrimmerStatistics GetStatistics() const override { return stat_; }
+
+ private:
+  /// \brief Copied audio stream, trim range in stream time base
+  struct AudioStream {
+    int output_index_ = -1;
+    int64_t start_ = 0;
+    int64_t end_ = INT64_MAX;
+    bool ended_ = false;
+  };
+
+  int CreateOutput(const std::string& output_url, double start_seconds, double end_seconds);
+  int ProcessVideoPacket(AVPacket* packet);
+  int ProcessAudioPacket(AVPacket* packet);
+  int FlushGop(const AVPacket* next_key_packet);
+  int CopyGop();
+  void SetupParameterSets(int codec_id, const uint8_t* extradata, int extradata_size);
+  int PrependParameterSets(const AVPacket* packet);
+  void CopyPacketProps(AVPacket* dst, const AVPacket* src);
+  int ReencodeGop(int64_t dts_offset);
+  int OpenEncoder();
+  int EncodeFrame(AVFrame* frame, int64_t dts_offset);
+  int WriteEncodedPackets(int64_t dts_offset);
+  int ConvertEncodedPacket();
+  int WriteVideoPacket(AVPacket* packet);
+  int WritePacket(AVPacket* packet, cmf::MediaTimeBase time_base, int64_t shift, int output_index);
+  bool IsAllAudioEnded() const;
+  void ReleaseGop();
+  void Close();
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  AvcSmartTrimmerConfig config_;
+
+  AvcMediaInput input_;
+  AvcMediaOutput output_;
+  int video_index_ = -1;
+  int output_video_index_ = -1;
+  cmf::MediaTimeBase video_time_base_;
+  int64_t start_ = 0;                        ///< trim range in video time base
+  int64_t end_ = INT64_MAX;
+  std::vector<AudioStream> audio_streams_;   ///< by input stream index
+
+  std::vector<AVPacket*> gop_;               ///< packets from keyframe until next keyframe
+  std::vector<AVPacket*> free_packets_;
+  bool video_done_ = false;
+  bool after_reencode_ = false;              ///< previous GOP was re-encoded
+  int64_t last_video_dts_;                   ///< input timeline, for DTS continuity
+
+  AVCodecContext* decoder_context_ = nullptr;
+  AVCodecContext* encoder_context_ = nullptr;
+  AVFrame* frame_ = nullptr;
+  AVPacket* encoded_packet_ = nullptr;
+  AVPacket* converted_packet_ = nullptr;
+  int nal_length_size_ = 0;                  ///< NAL length prefix of input packets, 0 when encoder output is written as is
+  AvcNalScanner annexb_scanner_;             ///< splits Annex B output of encoder to NAL units
+  std::vector<AvcNalUnit> nal_units_;
+  std::vector<uint8_t> parameter_sets_;      ///< of input extradata in NAL layout of input, sent again after re-encoded part
+  int64_t leading_limit_ = 0;                ///< re-encoded frames before this pts are dropped
+
+  AvcSmartTrimmerStatistics stat_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_SMART_TRIMMER_HEADER
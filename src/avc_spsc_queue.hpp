@@ -0,0 +1,144 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_SPSC_QUEUE_HEADER
+#define AVC_SPSC_QUEUE_HEADER
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+/// \brief Bounded lock-free queue for single producer and single consumer threads.
+/// Capacity is rounded up to power of two
+template <typename T>
+class AvcSpscQueue {
+ public:
+  explicit AvcSpscQueue(size_t capacity)
+    : buffer_(RoundUpCapacity(capacity))
+    , mask_(buffer_.size() - 1) {
+  }
+
+  AvcSpscQueue(const AvcSpscQueue&) = delete;
+  AvcSpscQueue& operator=(const AvcSpscQueue&) = delete;
+
+  /// \brief Producer side. Returns false when queue is full
+  bool TryPush(const T& value) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - producer_cached_head_ > mask_) {
+      producer_cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail - producer_cached_head_ > mask_)
+        return false;
+    }
+
+    buffer_[tail & mask_] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// \brief Consumer side. Returns false when queue is empty
+  bool TryPop(T& value) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == consumer_cached_tail_) {
+      consumer_cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head == consumer_cached_tail_)
+        return false;
+    }
+
+    value = buffer_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// \brief Approximate values when called from third thread
+  size_t GetSize() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+  bool IsEmpty() const { return GetSize() == 0; }
+  bool IsFull() const { return GetSize() > mask_; }
+  size_t GetCapacity() const { return buffer_.size(); }
+
+ private:
+  static size_t RoundUpCapacity(size_t capacity) {
+    size_t result = 2;
+    while (result < capacity)
+      result <<= 1;
+    return result;
+  }
+
+  std::vector<T> buffer_;
+  const size_t mask_;
+
+  // consumer and producer indexes are placed in different cache lines to avoid false sharing
+  alignas(64) std::atomic<size_t> head_{0};
+  size_t consumer_cached_tail_ = 0;
+
+  alignas(64) std::atomic<size_t> tail_{0};
+  size_t producer_cached_head_ = 0;
+};
+
+/// \brief Parking place for thread which waits on lock-free queues. Waiting thread spins shortly, then sleeps.
+/// Notify is cheap when nobody sleeps: no mutex is taken
+class AvcThreadWaiter {
+ public:
+  template <typename Predicate>
+  void Wait(Predicate pred) {
+    for (int i = 0; i < kSpinCount; i++) {
+      if (pred())
+        return;
+      std::this_thread::yield();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    cond_.wait(lock, pred);
+    sleeping_.store(false, std::memory_order_relaxed);
+  }
+
+  /// \brief Must be called after state checked by predicate is changed
+  void Notify() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!sleeping_.load(std::memory_order_relaxed))
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+    }
+    cond_.notify_all();
+  }
+
+ private:
+  static const int kSpinCount = 16;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::atomic<bool> sleeping_{false};
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_SPSC_QUEUE_HEADER
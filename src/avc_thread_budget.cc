@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "avc_thread_budget.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace avc {
+namespace detail {
+
+AvcThreadBudget::AvcThreadBudget()
+  : hardware_threads_(std::max(1, static_cast<int>(std::thread::hardware_concurrency()))) {
+}
+
+std::shared_ptr<AvcThreadBudget> AvcThreadBudget::Instance() {
+  static std::shared_ptr<AvcThreadBudget> instance = std::make_shared<AvcThreadBudget>();
+  return instance;
+}
+
+void AvcThreadBudget::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void AvcThreadBudget::SetConfig(const AvcThreadBudgetConfig& config) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  config_ = config;
+}
+
+AvcThreadBudgetConfig AvcThreadBudget::GetConfig() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return config_;
+}
+
+int AvcThreadBudget::StartSession(const void* key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = sessions_.find(key);
+  if (it != sessions_.end())
+    return it->second;
+
+  int threads = ComputeShare(static_cast<int>(sessions_.size()) + 1);
+  AddSessionLocked(key, threads);
+  return threads;
+}
+
+int AvcThreadBudget::AttachSession(const void* key, int threads) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = sessions_.find(key);
+  if (it != sessions_.end())
+    return it->second;
+
+  threads = std::max(threads, 1);
+  AddSessionLocked(key, threads);
+  return threads;
+}
+
+void AvcThreadBudget::StopSession(const void* key) {
+  if (sessions_count_.load(std::memory_order_relaxed) == 0)
+    return;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = sessions_.find(key);
+  if (it == sessions_.end())
+    return;
+
+  // freed threads go to sessions started next
+  threads_ -= it->second;
+  sessions_.erase(it);
+  sessions_count_.store(static_cast<int>(sessions_.size()), std::memory_order_relaxed);
+}
+
+int AvcThreadBudget::GetShare() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return ComputeShare(static_cast<int>(sessions_.size()) + 1);
+}
+
+bool AvcThreadBudget::IsOversubscribed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return threads_ > GetCoresBudget();
+}
+
+AvcThreadBudgetStatistics AvcThreadBudget::GetStatistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AvcThreadBudgetStatistics stat;
+  stat.cores_budget_ = GetCoresBudget();
+  stat.sessions_ = static_cast<int>(sessions_.size());
+  stat.threads_ = threads_;
+  stat.peak_threads_ = peak_threads_;
+  stat.oversubscribed_threads_ = std::max(threads_ - stat.cores_budget_, 0);
+  stat.sessions_started_ = sessions_started_;
+  stat.oversubscribed_starts_ = oversubscribed_starts_;
+  return stat;
+}
+
+void AvcThreadBudget::AddSessionLocked(const void* key, int threads) {
+  if (threads_ + threads > GetCoresBudget())
+    oversubscribed_starts_++;
+
+  sessions_.emplace(key, threads);
+  threads_ += threads;
+  peak_threads_ = std::max(peak_threads_, threads_);
+  sessions_started_++;
+  sessions_count_.store(static_cast<int>(sessions_.size()), std::memory_order_relaxed);
+}
+
+int AvcThreadBudget::GetCoresBudget() const {
+  return config_.cores_budget_ > 0 ? config_.cores_budget_ : hardware_threads_;
+}
+
+int AvcThreadBudget::ComputeShare(int sessions) const {
+  int budget = GetCoresBudget();
+  int share = budget / std::max(std::max(sessions, config_.expected_sessions_), 1);
+
+  // share never takes more than what is left, so oversubscription is limited to min_threads_ per session
+  share = std::min(share, budget - threads_);
+  if (config_.max_threads_ > 0)
+    share = std::min(share, config_.max_threads_);
+  return std::max(share, std::max(config_.min_threads_, 1));
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_THREAD_BUDGET_HEADER
+#define AVC_THREAD_BUDGET_HEADER
+
+#include <avc/i_avc_thread_budget.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace avc {
+namespace detail {
+
+class AvcThreadBudget final
+  : public virtual IAvcThreadBudget {
+ public:
+  AvcThreadBudget();
+  virtual ~AvcThreadBudget() = default;
+
+  /// \brief Budget shared by all providers of process
+  static std::shared_ptr<AvcThreadBudget> Instance();
+
+  void SetEnabled(bool enabled) override;
+  bool IsEnabled() const override { return enabled_.load(std::memory_order_relaxed); }
+
+  void SetConfig(const AvcThreadBudgetConfig& config) override;
+  AvcThreadBudgetConfig GetConfig() const override;
+
+  int StartSession(const void* key) override;
+  void StopSession(const void* key) override;
+  int AttachSession(const void* key, int threads) override;
+
+  int GetShare() const override;
+  bool IsOversubscribed() const override;
+  AvcThreadBudgetStatistics GetStatistics() const override;
+
+  /// \brief Stop hooks must run while budget is enabled or some sessions are still live
+  bool IsActive() const {
+    return enabled_.load(std::memory_order_relaxed) || sessions_count_.load(std::memory_order_relaxed) > 0;
+  }
+
+ private:
+  void AddSessionLocked(const void* key, int threads);
+  int GetCoresBudget() const;
+  int ComputeShare(int sessions) const;
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<int> sessions_count_{0};
+  int hardware_threads_;
+
+  mutable std::mutex mutex_;
+  AvcThreadBudgetConfig config_;
+  std::unordered_map<const void*, int> sessions_;  ///< threads by session key
+  int threads_ = 0;
+  int peak_threads_ = 0;
+  uint64_t sessions_started_ = 0;
+  uint64_t oversubscribed_starts_ = 0;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_THREAD_BUDGET_HEADER
@@ -0,0 +1,48 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_THREAD_POOL_EXECUTOR_HEADER
+#define AVC_THREAD_POOL_EXECUTOR_HEADER
+
+#include <avc/i_avc_executor.h>
+#include "avc_work_stealing_pool.h"
+
+namespace avc {
+namespace detail {
+
+class AvcThreadPoolExecutor
+  : public virtual IAvcExecutor {
+ public:
+  explicit AvcThreadPoolExecutor(int threads_count) : pool_(threads_count) {}
+  virtual ~AvcThreadPoolExecutor() = default;
+
+  void Post(std::function<void()> task) override { pool_.Submit(std::move(task)); }
+  int GetThreadsCount() const override { return pool_.GetWorkersCount(); }
+
+ private:
+  AvcWorkStealingPool pool_;
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_THREAD_POOL_EXECUTOR_HEADER
@@ -0,0 +1,680 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef DEBUG_PRINT
+#define DEBUG_PRINT 0
+#endif //DEBUG_PRINT
+
+#ifndef FFMPEG_LOADER_DLL
+#define FFMPEG_LOADER_DLL 0
+#endif //FFMPEG_LOADER_DLL
+
+#if FFMPEG_LOADER_DLL
+#include <tools/api/dynamic_export.h>
+#else //
+#define API_EXPORT
+#endif //FFMPEG_LOADER_DLL
+
+#include "avc_transcode_scheduler.h"
+#include "avc_media_utils.h"
+#include <avc/libav_detached_common.h>
+#include <cerrno>
+
+#if DEBUG_PRINT
+#include <cstdio>
+#endif //DEBUG_PRINT
+
+namespace avc {
+
+std::shared_ptr<IAvcTranscodeScheduler> API_EXPORT CreateAvcTranscodeScheduler(
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider,
+  int workers_count) {
+  if (!avc_module_provider)
+    return nullptr;
+
+  if (!avc_module_provider->IsAvFormatLoaded() || !avc_module_provider->IsAvCodecLoaded())
+    return nullptr;
+
+  if (workers_count <= 0)
+    workers_count = static_cast<int>(std::thread::hardware_concurrency());
+
+  return std::make_shared<avc::detail::AvcTranscodeScheduler>(avc_module_provider, workers_count > 0 ? workers_count : 1);
+}
+
+namespace detail {
+
+namespace {
+
+// Items taken by one stage task. Small batches keep stages of one job interleaved on workers,
+// large enough to make scheduling cost small compared to codec work
+const size_t kStageBatch = 8;
+const size_t kMuxBatch = 32;
+
+// Stage is not scheduled while its output queue has more items, so memory of one job is bounded
+const size_t kStageQueueLimit = 16;
+
+}  // namespace
+
+AvcTranscodeScheduler::AvcTranscodeScheduler(std::shared_ptr<IAvcModuleProvider> avc_module_provider, int workers_count)
+  : avc_module_provider_(avc_module_provider)
+  , frame_pool_(std::make_shared<AvcFramePool>(avc_module_provider, -1, kStageQueueLimit * 4 * workers_count))
+  , pool_(workers_count) {
+}
+
+AvcTranscodeScheduler::~AvcTranscodeScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& job : jobs_)
+      job.second->canceled_.store(true, std::memory_order_relaxed);
+  }
+
+  WaitAll();
+  pool_.Stop();
+}
+
+int64_t AvcTranscodeScheduler::SubmitJob(const AvcTranscodeJobConfig& config) {
+  std::shared_ptr<Job> job = std::make_shared<Job>(avc_module_provider_);
+  job->config_ = config;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job->id_ = next_job_id_++;
+    jobs_[job->id_] = job;
+    jobs_running_++;
+  }
+  jobs_submitted_.fetch_add(1, std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> lock(job->mutex_);
+  SubmitStage(job, kStage_Setup);
+  return job->id_;
+}
+
+int AvcTranscodeScheduler::WaitJob(int64_t job_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = jobs_.find(job_id);
+  if (it == jobs_.end())
+    return AVERROR(EINVAL);
+
+  std::shared_ptr<Job> job = it->second;
+  job_finished_cv_.wait(lock, [&job] {
+    int state = job->state_.load(std::memory_order_acquire);
+    return state == kAvcTranscodeJob_Done || state == kAvcTranscodeJob_Failed;
+  });
+
+  jobs_.erase(job_id);
+  return job->state_.load(std::memory_order_acquire) == kAvcTranscodeJob_Done ? 0 : job->error_;
+}
+
+void AvcTranscodeScheduler::WaitAll() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  job_finished_cv_.wait(lock, [this] { return jobs_running_ == 0; });
+}
+
+void AvcTranscodeScheduler::CancelJob(int64_t job_id) {
+  // job notices flag when its current task ends
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = jobs_.find(job_id);
+  if (it != jobs_.end())
+    it->second->canceled_.store(true, std::memory_order_relaxed);
+}
+
+bool AvcTranscodeScheduler::GetJobStatus(int64_t job_id, AvcTranscodeJobStatus& status) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = jobs_.find(job_id);
+  if (it == jobs_.end())
+    return false;
+
+  const Job& job = *it->second;
+  status.state_ = static_cast<AvcTranscodeJobState>(job.state_.load(std::memory_order_acquire));
+  status.error_ = status.state_ == kAvcTranscodeJob_Failed ? job.error_ : 0;
+  status.frames_decoded_ = job.frames_decoded_.load(std::memory_order_relaxed);
+  status.frames_encoded_ = job.frames_encoded_.load(std::memory_order_relaxed);
+  status.packets_written_ = job.packets_written_.load(std::memory_order_relaxed);
+  return true;
+}
+
+AvcTranscodeSchedulerStatistics AvcTranscodeScheduler::GetStatistics() const {
+  AvcTranscodeSchedulerStatistics stat;
+  stat.workers_count_ = pool_.GetWorkersCount();
+  stat.tasks_executed_ = pool_.GetExecutedCount();
+  stat.tasks_stolen_ = pool_.GetStolenCount();
+  stat.jobs_submitted_ = jobs_submitted_.load(std::memory_order_relaxed);
+  stat.jobs_done_ = jobs_done_.load(std::memory_order_relaxed);
+  stat.jobs_failed_ = jobs_failed_.load(std::memory_order_relaxed);
+  return stat;
+}
+
+void AvcTranscodeScheduler::SubmitStage(const std::shared_ptr<Job>& job, Stage stage) {
+  job->scheduled_[stage] = true;
+  job->tasks_in_flight_++;
+  pool_.Submit([this, job, stage] { RunStage(job, stage); });
+}
+
+void AvcTranscodeScheduler::RunStage(std::shared_ptr<Job> job, Stage stage) {
+  int ret = job->canceled_.load(std::memory_order_relaxed) ? AVERROR_EXIT : 0;
+  if (ret == 0) {
+    switch (stage) {
+    case kStage_Setup: ret = Setup(*job); break;
+    case kStage_Decode: ret = Decode(*job); break;
+    case kStage_Scale: ret = Scale(*job); break;
+    case kStage_Encode: ret = Encode(*job); break;
+    case kStage_Mux: ret = Mux(*job); break;
+    default: ret = AVERROR(EINVAL); break;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(job->mutex_);
+  job->scheduled_[stage] = false;
+  job->tasks_in_flight_--;
+  if (ret < 0 && job->error_ == 0) {
+#if DEBUG_PRINT
+    fprintf(stderr, "AvcTranscodeScheduler: job %lld stage %d failed %d\n", static_cast<long long>(job->id_), stage, ret);
+#endif //DEBUG_PRINT
+    job->error_ = ret;
+  }
+
+  ScheduleStages(job);
+}
+
+void AvcTranscodeScheduler::ScheduleStages(const std::shared_ptr<Job>& job) {
+  if (job->finished_)
+    return;
+
+  if (job->error_ == 0 && job->canceled_.load(std::memory_order_relaxed))
+    job->error_ = AVERROR_EXIT;
+
+  if (job->error_ < 0 || job->mux_done_) {
+    // tasks of other stages may still use contexts, last finished task closes job
+    if (job->tasks_in_flight_ == 0)
+      FinishJob(*job);
+    return;
+  }
+
+  if (!job->setup_done_)
+    return;
+
+  // every stage runs at most one task at time, so stage data is not locked. Some stage is always runnable
+  // until job ends: mux drains packets, encode drains scaled frames, scale drains decoded frames
+  if (!job->decode_done_ && !job->scheduled_[kStage_Decode] &&
+      job->decoded_frames_.size() < kStageQueueLimit && job->packets_.size() < kStageQueueLimit)
+    SubmitStage(job, kStage_Decode);
+
+  if (!job->scale_done_ && !job->scheduled_[kStage_Scale] &&
+      (!job->decoded_frames_.empty() || job->decode_done_) && job->scaled_frames_.size() < kStageQueueLimit)
+    SubmitStage(job, kStage_Scale);
+
+  if (!job->encode_done_ && !job->scheduled_[kStage_Encode] &&
+      (!job->scaled_frames_.empty() || job->scale_done_) && job->packets_.size() < kStageQueueLimit)
+    SubmitStage(job, kStage_Encode);
+
+  if (!job->mux_done_ && !job->scheduled_[kStage_Mux] &&
+      (!job->packets_.empty() || job->encode_done_))
+    SubmitStage(job, kStage_Mux);
+}
+
+void AvcTranscodeScheduler::FinishJob(Job& job) {
+  job.finished_ = true;
+  CloseJob(job);
+
+  bool done = job.error_ == 0;
+  (done ? jobs_done_ : jobs_failed_).fetch_add(1, std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  job.state_.store(done ? kAvcTranscodeJob_Done : kAvcTranscodeJob_Failed, std::memory_order_release);
+  jobs_running_--;
+  job_finished_cv_.notify_all();
+}
+
+int AvcTranscodeScheduler::Setup(Job& job) {
+  job.state_.store(kAvcTranscodeJob_Running, std::memory_order_release);
+
+  auto d = avc_module_provider_->d();
+  int ret = job.input_.Open(job.config_.input_url_);
+  if (ret < 0)
+    return ret;
+
+  job.video_stream_index_ = job.input_.FindBestStream(AVMEDIA_TYPE_VIDEO);
+  if (job.video_stream_index_ < 0)
+    return AVERROR_STREAM_NOT_FOUND;
+
+  // codecs of one job are single-threaded by default, parallelism comes from stages and jobs
+  job.decoder_context_ = job.input_.OpenDecoder(job.video_stream_index_, job.config_.codec_threads_, nullptr, 0,
+                                                nullptr, job.config_.codec_autotuner_.get());
+  if (!job.decoder_context_)
+    return AVERROR_DECODER_NOT_FOUND;
+
+  ret = job.output_.Create(job.config_.output_url_, job.config_.output_format_);
+  if (ret < 0)
+    return ret;
+
+  ret = OpenEncoder(job);
+  if (ret < 0)
+    return ret;
+
+  int streams_count = job.input_.GetStreamsCount();
+  job.output_indexes_.assign(streams_count, -1);
+  for (int i = 0; i < streams_count; i++) {
+    bool is_video = i == job.video_stream_index_;
+    if (!is_video && !(job.config_.copy_audio_ && job.input_.GetStreamMediaType(i) == AVMEDIA_TYPE_AUDIO))
+      continue;
+
+    AVStream* stream = avc_module_provider_->avformat_new_stream(job.output_.GetFormatContext(), nullptr);
+    if (!stream)
+      return AVERROR(ENOMEM);
+
+    if (is_video) {
+      ret = avc_module_provider_->avcodec_parameters_from_context(d->AVStreamGetCodecPar(stream), job.encoder_context_);
+      d->AVStreamSetTimeBase(stream, d->AVCodecContextGetTimeBase(job.encoder_context_));
+      job.video_output_index_ = d->AVStreamGetIndex(stream);
+    } else {
+      AVStream* input_stream = job.input_.GetStream(i);
+      ret = avc_module_provider_->avcodec_parameters_copy(d->AVStreamGetCodecPar(stream), d->AVStreamGetCodecPar(input_stream));
+      // codec tag of input container may be invalid in output container
+      d->AVCodecParametersSetCodecTag(d->AVStreamGetCodecPar(stream), 0);
+      d->AVStreamSetTimeBase(stream, d->AVStreamGetTimeBase(input_stream));
+    }
+
+    if (ret < 0)
+      return ret;
+
+    job.output_indexes_[i] = d->AVStreamGetIndex(stream);
+    job.source_time_bases_.push_back(is_video ? d->AVCodecContextGetTimeBase(job.encoder_context_) : job.input_.GetStreamTimeBase(i));
+  }
+
+  ret = OpenOutput(job);
+  if (ret < 0)
+    return ret;
+
+  std::lock_guard<std::mutex> lock(job.mutex_);
+  job.setup_done_ = true;
+  return 0;
+}
+
+int AvcTranscodeScheduler::OpenEncoder(Job& job) {
+  auto d = avc_module_provider_->d();
+  AVCodec* codec = avc_module_provider_->avcodec_find_encoder_by_name(job.config_.video_encoder_name_.c_str());
+  if (!codec)
+    return AVERROR_ENCODER_NOT_FOUND;
+
+  job.encoder_context_ = avc_module_provider_->avcodec_alloc_context3(codec);
+  if (!job.encoder_context_)
+    return AVERROR(ENOMEM);
+
+  int width = job.config_.width_ > 0 ? job.config_.width_ : d->AVCodecContextGetWidth(job.decoder_context_);
+  int height = job.config_.height_ > 0 ? job.config_.height_ : d->AVCodecContextGetHeight(job.decoder_context_);
+
+  // keep decoder pixel format when encoder supports it, otherwise first supported format
+  int pix_fmt = SelectEncoderPixelFormat(d.get(), codec, d->AVCodecContextGetPixFmt(job.decoder_context_));
+  cmf::MediaTimeBase frame_rate = GetStreamFrameRate(d.get(), job.input_.GetStream(job.video_stream_index_));
+
+  d->AVCodecContextSetWidth(job.encoder_context_, width);
+  d->AVCodecContextSetHeight(job.encoder_context_, height);
+  d->AVCodecContextSetPixFmt(job.encoder_context_, pix_fmt);
+  d->AVCodecContextSetTimeBase(job.encoder_context_, cmf::MediaTimeBase(frame_rate.den_, frame_rate.num_));
+  d->AVCodecContextSetFrameRate(job.encoder_context_, frame_rate);
+  d->AVCodecContextSetThreadCount(job.encoder_context_, job.config_.codec_threads_);
+  if (job.config_.codec_threads_ == 0 && job.config_.codec_autotuner_)
+    job.config_.codec_autotuner_->Apply(job.encoder_context_, true);
+  if (job.config_.bit_rate_ > 0)
+    d->AVCodecContextSetBitRate(job.encoder_context_, job.config_.bit_rate_);
+  if (job.config_.gop_size_ > 0)
+    d->AVCodecContextSetGopSize(job.encoder_context_, job.config_.gop_size_);
+
+  if (job.output_.IsGlobalHeader()) {
+    d->AVCodecContextSetFlags(job.encoder_context_,
+      d->AVCodecContextGetFlags(job.encoder_context_) | AV_CODEC_FLAG_GLOBAL_HEADER);
+  }
+
+  return avc_module_provider_->avcodec_open2(job.encoder_context_, codec, nullptr);
+}
+
+int AvcTranscodeScheduler::OpenOutput(Job& job) {
+  int ret = job.output_.OpenFile();
+  if (ret < 0)
+    return ret;
+
+  // muxer may change stream time bases here, packets are rescaled before write
+  return avc_module_provider_->avformat_write_header(job.output_.GetFormatContext(), nullptr);
+}
+
+int AvcTranscodeScheduler::ReceiveDecodedFrames(Job& job, std::vector<AVFrame*>& frames) {
+  while (true) {
+    AVFrame* frame = frame_pool_->AcquireFrame();
+    if (!frame)
+      return AVERROR(ENOMEM);
+
+    int ret = avc_module_provider_->avcodec_receive_frame(job.decoder_context_, frame);
+    if (ret < 0) {
+      frame_pool_->ReleaseFrame(frame);
+      return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF ? 0 : ret;
+    }
+
+    frames.push_back(frame);
+    job.frames_decoded_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+int AvcTranscodeScheduler::Decode(Job& job) {
+  auto d = avc_module_provider_->d();
+  std::vector<AVFrame*> frames;
+  std::vector<AVPacket*> packets;
+  AVPacket* packet = frame_pool_->AcquirePacket();
+  bool eof = false;
+  int ret = packet ? 0 : AVERROR(ENOMEM);
+
+  while (ret >= 0 && frames.size() < kStageBatch && packets.size() < kStageBatch) {
+    ret = avc_module_provider_->av_read_frame(job.input_.GetFormatContext(), packet);
+    if (ret == AVERROR_EOF) {
+      eof = true;
+      ret = avc_module_provider_->avcodec_send_packet(job.decoder_context_, nullptr);
+      if (ret >= 0 || ret == AVERROR_EOF)
+        ret = ReceiveDecodedFrames(job, frames);
+      break;
+    }
+
+    if (ret < 0)
+      break;
+
+    int stream_index = d->AVPacketGetStreamIndex(packet);
+    if (stream_index == job.video_stream_index_) {
+      while ((ret = avc_module_provider_->avcodec_send_packet(job.decoder_context_, packet)) == AVERROR(EAGAIN)) {
+        ret = ReceiveDecodedFrames(job, frames);
+        if (ret < 0)
+          break;
+      }
+
+      // damaged packet loses some frames only, like in ffmpeg tool
+      if (ret == AVERROR_INVALIDDATA)
+        ret = 0;
+      if (ret >= 0)
+        ret = ReceiveDecodedFrames(job, frames);
+      avc_module_provider_->av_packet_unref(packet);
+    } else if (stream_index >= 0 && stream_index < static_cast<int>(job.output_indexes_.size()) &&
+               job.output_indexes_[stream_index] >= 0) {
+      d->AVPacketSetStreamIndex(packet, job.output_indexes_[stream_index]);
+      packets.push_back(packet);
+      packet = frame_pool_->AcquirePacket();
+      if (!packet)
+        ret = AVERROR(ENOMEM);
+    } else {
+      avc_module_provider_->av_packet_unref(packet);
+    }
+  }
+
+  frame_pool_->ReleasePacket(packet);
+  if (ret < 0) {
+    for (AVFrame* frame : frames)
+      frame_pool_->ReleaseFrame(frame);
+    for (AVPacket* queued_packet : packets)
+      frame_pool_->ReleasePacket(queued_packet);
+    return ret;
+  }
+
+  std::lock_guard<std::mutex> lock(job.mutex_);
+  job.decoded_frames_.insert(job.decoded_frames_.end(), frames.begin(), frames.end());
+  job.packets_.insert(job.packets_.end(), packets.begin(), packets.end());
+  job.decode_done_ = eof;
+  return 0;
+}
+
+int AvcTranscodeScheduler::ScaleFrame(Job& job, AVFrame* frame, AVFrame*& scaled) {
+  auto d = avc_module_provider_->d();
+  int width = d->AVFrameGetWidth(frame);
+  int height = d->AVFrameGetHeight(frame);
+  int format = d->AVFrameGetFormat(frame);
+  int dst_width = d->AVCodecContextGetWidth(job.encoder_context_);
+  int dst_height = d->AVCodecContextGetHeight(job.encoder_context_);
+  int dst_format = d->AVCodecContextGetPixFmt(job.encoder_context_);
+
+  if (width == dst_width && height == dst_height && format == dst_format) {
+    scaled = frame;
+    return 0;
+  }
+
+  if (!avc_module_provider_->IsSwScaleLoaded())
+    return AVERROR(ENOSYS);
+
+  // source parameters may change in the middle of stream
+  if (!job.sws_context_ || job.sws_width_ != width || job.sws_height_ != height || job.sws_format_ != format) {
+    if (job.sws_context_)
+      avc_module_provider_->sws_freeContext(job.sws_context_);
+
+    job.sws_context_ = avc_module_provider_->sws_getContext(width, height, format,
+      dst_width, dst_height, dst_format, SWS_BICUBIC, nullptr, nullptr, nullptr);
+    if (!job.sws_context_)
+      return AVERROR(EINVAL);
+
+    job.sws_width_ = width;
+    job.sws_height_ = height;
+    job.sws_format_ = format;
+  }
+
+  scaled = frame_pool_->AcquireVideoFrame(dst_width, dst_height, dst_format);
+  if (!scaled)
+    return AVERROR(ENOMEM);
+
+  int ret = avc_module_provider_->sws_scale(job.sws_context_, d->AVFrameGetDataPtr(frame), d->AVFrameGetLineSizePtr(frame),
+    0, height, d->AVFrameGetDataPtr(scaled), d->AVFrameGetLineSizePtr(scaled));
+  if (ret < 0) {
+    frame_pool_->ReleaseFrame(scaled);
+    scaled = nullptr;
+    return ret;
+  }
+
+  d->AVFrameSetPts(scaled, d->AVFrameGetPts(frame));
+  frame_pool_->ReleaseFrame(frame);
+  return 0;
+}
+
+int AvcTranscodeScheduler::Scale(Job& job) {
+  auto d = avc_module_provider_->d();
+  std::vector<AVFrame*> frames;
+  {
+    std::lock_guard<std::mutex> lock(job.mutex_);
+    while (!job.decoded_frames_.empty() && frames.size() < kStageBatch) {
+      frames.push_back(job.decoded_frames_.front());
+      job.decoded_frames_.pop_front();
+    }
+
+    if (frames.empty()) {
+      job.scale_done_ = job.decode_done_;
+      return 0;
+    }
+  }
+
+  cmf::MediaTimeBase stream_time_base = job.input_.GetStreamTimeBase(job.video_stream_index_);
+  cmf::MediaTimeBase encoder_time_base = d->AVCodecContextGetTimeBase(job.encoder_context_);
+
+  int ret = 0;
+  size_t i = 0;
+  for (; i < frames.size(); i++) {
+    AVFrame* frame = frames[i];
+    int64_t pts = d->AVFrameGetPts(frame);
+    AVFrame* scaled = nullptr;
+    ret = ScaleFrame(job, frame, scaled);
+    if (ret < 0)
+      break;
+
+    // encoder counts frames in 1/fps, duplicated or missing pts get next free value
+    if (pts != AV_NOPTS_VALUE)
+      pts = avc_module_provider_->av_rescale_q_rnd(pts, ToAVRational(stream_time_base), ToAVRational(encoder_time_base),
+        AV_ROUND_NEAR_INF | AV_ROUND_PASS_MINMAX);
+    if (pts == AV_NOPTS_VALUE || pts < job.next_pts_)
+      pts = job.next_pts_;
+    job.next_pts_ = pts + 1;
+
+    d->AVFrameSetPts(scaled, pts);
+    // encoder chooses frame types itself
+    d->AVFrameSetPictType(scaled, AV_PICTURE_TYPE_NONE);
+    frames[i] = scaled;
+  }
+
+  if (ret < 0) {
+    for (size_t j = 0; j < frames.size(); j++)
+      frame_pool_->ReleaseFrame(frames[j]);
+    return ret;
+  }
+
+  std::lock_guard<std::mutex> lock(job.mutex_);
+  job.scaled_frames_.insert(job.scaled_frames_.end(), frames.begin(), frames.end());
+  return 0;
+}
+
+int AvcTranscodeScheduler::ReceiveEncodedPackets(Job& job, std::vector<AVPacket*>& packets) {
+  auto d = avc_module_provider_->d();
+  while (true) {
+    AVPacket* packet = frame_pool_->AcquirePacket();
+    if (!packet)
+      return AVERROR(ENOMEM);
+
+    int ret = avc_module_provider_->avcodec_receive_packet(job.encoder_context_, packet);
+    if (ret < 0) {
+      frame_pool_->ReleasePacket(packet);
+      return ret == AVERROR(EAGAIN) ? 0 : ret;
+    }
+
+    d->AVPacketSetStreamIndex(packet, job.video_output_index_);
+    packets.push_back(packet);
+  }
+}
+
+int AvcTranscodeScheduler::Encode(Job& job) {
+  std::vector<AVFrame*> frames;
+  bool flush = false;
+  {
+    std::lock_guard<std::mutex> lock(job.mutex_);
+    while (!job.scaled_frames_.empty() && frames.size() < kStageBatch) {
+      frames.push_back(job.scaled_frames_.front());
+      job.scaled_frames_.pop_front();
+    }
+    flush = frames.empty() && job.scale_done_;
+  }
+
+  std::vector<AVPacket*> packets;
+  int ret = 0;
+  size_t i = 0;
+  for (; i < frames.size() && ret >= 0; i++) {
+    while ((ret = avc_module_provider_->avcodec_send_frame(job.encoder_context_, frames[i])) == AVERROR(EAGAIN)) {
+      ret = ReceiveEncodedPackets(job, packets);
+      if (ret < 0)
+        break;
+    }
+
+    frame_pool_->ReleaseFrame(frames[i]);
+    if (ret >= 0) {
+      job.frames_encoded_.fetch_add(1, std::memory_order_relaxed);
+      ret = ReceiveEncodedPackets(job, packets);
+    }
+  }
+
+  for (; i < frames.size(); i++)
+    frame_pool_->ReleaseFrame(frames[i]);
+
+  if (flush && ret >= 0) {
+    ret = avc_module_provider_->avcodec_send_frame(job.encoder_context_, nullptr);
+    if (ret >= 0)
+      ret = ReceiveEncodedPackets(job, packets);
+  }
+
+  bool encode_done = false;
+  if (ret == AVERROR_EOF) {
+    encode_done = true;
+    ret = 0;
+  }
+
+  if (ret < 0) {
+    for (AVPacket* packet : packets)
+      frame_pool_->ReleasePacket(packet);
+    return ret;
+  }
+
+  std::lock_guard<std::mutex> lock(job.mutex_);
+  job.packets_.insert(job.packets_.end(), packets.begin(), packets.end());
+  job.encode_done_ = encode_done;
+  return 0;
+}
+
+int AvcTranscodeScheduler::Mux(Job& job) {
+  auto d = avc_module_provider_->d();
+  std::vector<AVPacket*> packets;
+  bool last = false;
+  {
+    std::lock_guard<std::mutex> lock(job.mutex_);
+    while (!job.packets_.empty() && packets.size() < kMuxBatch) {
+      packets.push_back(job.packets_.front());
+      job.packets_.pop_front();
+    }
+    // encode is finished after decode, so no packets come anymore
+    last = job.packets_.empty() && job.encode_done_;
+  }
+
+  int ret = 0;
+  for (AVPacket* packet : packets) {
+    if (ret >= 0) {
+      int stream_index = d->AVPacketGetStreamIndex(packet);
+      AVStream* stream = d->AVFormatContextGetStreamByIdx(job.output_.GetFormatContext(), stream_index);
+      avc_module_provider_->av_packet_rescale_ts(packet, job.source_time_bases_[stream_index], d->AVStreamGetTimeBase(stream));
+
+      // packet reference is taken by muxer and packet is reset
+      ret = avc_module_provider_->av_interleaved_write_frame(job.output_.GetFormatContext(), packet);
+      if (ret >= 0)
+        job.packets_written_.fetch_add(1, std::memory_order_relaxed);
+    }
+    frame_pool_->ReleasePacket(packet);
+  }
+
+  if (ret >= 0 && last)
+    ret = avc_module_provider_->av_write_trailer(job.output_.GetFormatContext());
+
+  if (ret < 0)
+    return ret;
+
+  std::lock_guard<std::mutex> lock(job.mutex_);
+  job.mux_done_ = last;
+  return 0;
+}
+
+void AvcTranscodeScheduler::CloseJob(Job& job) {
+  for (AVFrame* frame : job.decoded_frames_)
+    frame_pool_->ReleaseFrame(frame);
+  for (AVFrame* frame : job.scaled_frames_)
+    frame_pool_->ReleaseFrame(frame);
+  for (AVPacket* packet : job.packets_)
+    frame_pool_->ReleasePacket(packet);
+  job.decoded_frames_.clear();
+  job.scaled_frames_.clear();
+  job.packets_.clear();
+
+  if (job.sws_context_)
+    avc_module_provider_->sws_freeContext(job.sws_context_);
+  job.sws_context_ = nullptr;
+
+  avc_module_provider_->avcodec_free_context(&job.decoder_context_);
+  avc_module_provider_->avcodec_free_context(&job.encoder_context_);
+
+  job.output_.Close();
+
+  job.input_.Close();
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_TRANSCODE_SCHEDULER_HEADER
+#define AVC_TRANSCODE_SCHEDULER_HEADER
+
+#include <avc/i_avc_transcode_scheduler.h>
+#include <avc/i_avc_module_provider.h>
+#include "avc_frame_pool.h"
+#include "avc_media_input.h"
+#include "avc_media_output.h"
+#include "avc_work_stealing_pool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+class AvcTranscodeScheduler
+  : public virtual IAvcTranscodeScheduler {
+ public:
+  AvcTranscodeScheduler(std::shared_ptr<IAvcModuleProvider> avc_module_provider, int workers_count);
+  virtual ~AvcTranscodeScheduler();
+
+  int64_t SubmitJob(const AvcTranscodeJobConfig& config) override;
+  int WaitJob(int64_t job_id) override;
+  void WaitAll() override;
+  void CancelJob(int64_t job_id) override;
+  bool GetJobStatus(int64_t job_id, AvcTranscodeJobStatus& status) const override;
+  AvcTranscodeSchedulerStatistics GetStatistics() const override;
+
+ private:
+  enum Stage {
+    kStage_Setup = 0,
+    kStage_Decode,
+    kStage_Scale,
+    kStage_Encode,
+    kStage_Mux,
+    kStage_Count
+  };
+
+  struct Job {
+    int64_t id_ = 0;
+    AvcTranscodeJobConfig config_;
+
+    // stage data, used only by task of its stage
+    AvcMediaInput input_;
+    AVCodecContext* decoder_context_ = nullptr;
+    AVCodecContext* encoder_context_ = nullptr;
+    SwsContext* sws_context_ = nullptr;
+    int sws_width_ = 0;
+    int sws_height_ = 0;
+    int sws_format_ = -1;
+    AvcMediaOutput output_;
+    int video_stream_index_ = -1;
+    int video_output_index_ = -1;
+    std::vector<int> output_indexes_;                 ///< input stream index -> output stream index or -1
+    std::vector<cmf::MediaTimeBase> source_time_bases_;  ///< output stream index -> time base of queued packets
+    int64_t next_pts_ = 0;
+
+    // shared state, guarded by mutex_
+    std::mutex mutex_;
+    std::deque<AVFrame*> decoded_frames_;
+    std::deque<AVFrame*> scaled_frames_;
+    std::deque<AVPacket*> packets_;
+    bool scheduled_[kStage_Count] = {};
+    bool setup_done_ = false;
+    bool decode_done_ = false;
+    bool scale_done_ = false;
+    bool encode_done_ = false;
+    bool mux_done_ = false;
+    int tasks_in_flight_ = 0;
+    int error_ = 0;
+    bool finished_ = false;
+
+    std::atomic<bool> canceled_{false};
+    std::atomic<int> state_{kAvcTranscodeJob_Queued};
+    std::atomic<uint64_t> frames_decoded_{0};
+    std::atomic<uint64_t> frames_encoded_{0};
+    std::atomic<uint64_t> packets_written_{0};
+
+    explicit Job(std::shared_ptr<IAvcModuleProvider> avc_module_provider)
+      : input_(avc_module_provider)
+      , output_(avc_module_provider) {}
+  };
+
+  void RunStage(std::shared_ptr<Job> job, Stage stage);
+
+  /// \brief Submit tasks for stages which have input. Called with job mutex locked
+  void ScheduleStages(const std::shared_ptr<Job>& job);
+  void SubmitStage(const std::shared_ptr<Job>& job, Stage stage);
+  void FinishJob(Job& job);
+
+  int Setup(Job& job);
+  int OpenEncoder(Job& job);
+  int OpenOutput(Job& job);
+  int Decode(Job& job);
+  int ReceiveDecodedFrames(Job& job, std::vector<AVFrame*>& frames);
+  int Scale(Job& job);
+  int ScaleFrame(Job& job, AVFrame* frame, AVFrame*& scaled);
+  int Encode(Job& job);
+  int ReceiveEncodedPackets(Job& job, std::vector<AVPacket*>& packets);
+  int Mux(Job& job);
+  void CloseJob(Job& job);
+
+  std::shared_ptr<IAvcModuleProvider> avc_module_provider_;
+  std::shared_ptr<AvcFramePool> frame_pool_;
+  AvcWorkStealingPool pool_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable job_finished_cv_;
+  std::map<int64_t, std::shared_ptr<Job>> jobs_;
+  int64_t next_job_id_ = 1;
+  int jobs_running_ = 0;
+
+  std::atomic<uint64_t> jobs_submitted_{0};
+  std::atomic<uint64_t> jobs_done_{0};
+  std::atomic<uint64_t> jobs_failed_{0};
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_TRANSCODE_SCHEDULER_HEADER
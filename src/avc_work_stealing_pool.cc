@@ -0,0 +1,142 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "avc_work_stealing_pool.h"
+#include "avc_numa_topology.h"
+
+namespace avc {
+namespace detail {
+
+static thread_local const AvcWorkStealingPool* g_current_pool = nullptr;
+static thread_local int g_current_worker_index = -1;
+
+AvcWorkStealingPool::AvcWorkStealingPool(int workers_count, int numa_node)
+  : numa_node_(numa_node) {
+  if (workers_count < 1)
+    workers_count = 1;
+
+  for (int i = 0; i < workers_count; i++)
+    workers_.emplace_back(new Worker());
+
+  for (int i = 0; i < workers_count; i++)
+    workers_[i]->thread_ = std::thread(&AvcWorkStealingPool::WorkerThread, this, i);
+}
+
+AvcWorkStealingPool::~AvcWorkStealingPool() {
+  Stop();
+}
+
+int AvcWorkStealingPool::GetCurrentWorkerIndex() const {
+  return g_current_pool == this ? g_current_worker_index : -1;
+}
+
+void AvcWorkStealingPool::Submit(Task task) {
+  int index = GetCurrentWorkerIndex();
+  if (index < 0)
+    index = static_cast<int>(next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size());
+
+  {
+    std::lock_guard<std::mutex> lock(workers_[index]->mutex_);
+    workers_[index]->tasks_.push_back(std::move(task));
+  }
+
+  // counter is changed under sleep mutex, so worker can not miss wake up between check and wait.
+  // Notify under lock too: task may finish and pool owner may destroy pool right after task is queued,
+  // and Stop can not pass sleep mutex while foreign thread is still inside Submit
+  std::lock_guard<std::mutex> lock(sleep_mutex_);
+  pending_.fetch_add(1, std::memory_order_relaxed);
+  sleep_cond_.notify_one();
+}
+
+void AvcWorkStealingPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    if (stop_)
+      return;
+    stop_ = true;
+  }
+  sleep_cond_.notify_all();
+
+  for (auto& worker : workers_)
+    if (worker->thread_.joinable())
+      worker->thread_.join();
+}
+
+bool AvcWorkStealingPool::PopLocal(int index, Task& task) {
+  Worker& worker = *workers_[index];
+  std::lock_guard<std::mutex> lock(worker.mutex_);
+  if (worker.tasks_.empty())
+    return false;
+
+  task = std::move(worker.tasks_.back());
+  worker.tasks_.pop_back();
+  return true;
+}
+
+bool AvcWorkStealingPool::Steal(int index, Task& task) {
+  size_t count = workers_.size();
+  for (size_t i = 1; i < count; i++) {
+    Worker& victim = *workers_[(index + i) % count];
+    std::unique_lock<std::mutex> lock(victim.mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || victim.tasks_.empty())
+      continue;
+
+    task = std::move(victim.tasks_.front());
+    victim.tasks_.pop_front();
+    stolen_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+void AvcWorkStealingPool::WorkerThread(int index) {
+  g_current_pool = this;
+  g_current_worker_index = index;
+
+  if (numa_node_ >= 0)
+    AvcNumaTopology::Instance().BindCurrentThreadToNode(numa_node_);
+
+  while (true) {
+    Task task;
+    if (PopLocal(index, task) || Steal(index, task)) {
+      pending_.fetch_sub(1, std::memory_order_relaxed);
+      task();
+      executed_.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    if (pending_.load(std::memory_order_relaxed) > 0)
+      continue;  // task is queued, but victim was busy on try_lock
+
+    if (stop_)
+      break;
+
+    sleep_cond_.wait(lock, [this] { return stop_ || pending_.load(std::memory_order_relaxed) > 0; });
+  }
+
+  g_current_pool = nullptr;
+  g_current_worker_index = -1;
+}
+
+}  // namespace detail
+}//namespace avc
@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2025, Alex Bobryshev <alexbobryshev555@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef AVC_WORK_STEALING_POOL_HEADER
+#define AVC_WORK_STEALING_POOL_HEADER
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace avc {
+namespace detail {
+
+/// \brief Fixed pool of worker threads. Every worker has own deque: owner takes newest task from back
+/// (cache is warm for it), idle workers steal oldest tasks from front of other deques.
+/// Tasks submitted by worker go to its own deque, tasks from other threads are spread round robin
+class AvcWorkStealingPool {
+ public:
+  typedef std::function<void()> Task;
+
+  explicit AvcWorkStealingPool(int workers_count, int numa_node = -1);
+  ~AvcWorkStealingPool();
+
+  AvcWorkStealingPool(const AvcWorkStealingPool&) = delete;
+  AvcWorkStealingPool& operator=(const AvcWorkStealingPool&) = delete;
+
+  void Submit(Task task);
+
+  /// \brief Run all queued tasks, including tasks submitted by them, and join workers
+  void Stop();
+
+  int GetWorkersCount() const { return static_cast<int>(workers_.size()); }
+
+  /// \brief Index of worker of this pool which runs current thread, -1 for other threads
+  int GetCurrentWorkerIndex() const;
+
+  uint64_t GetExecutedCount() const { return executed_.load(std::memory_order_relaxed); }
+  uint64_t GetStolenCount() const { return stolen_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Worker {
+    std::mutex mutex_;
+    std::deque<Task> tasks_;
+    std::thread thread_;
+  };
+
+  void WorkerThread(int index);
+  bool PopLocal(int index, Task& task);
+  bool Steal(int index, Task& task);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  int numa_node_;
+  std::atomic<uint32_t> next_worker_{0};
+
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cond_;
+  std::atomic<int64_t> pending_{0};
+  bool stop_ = false;
+
+  std::atomic<uint64_t> executed_{0};
+  std::atomic<uint64_t> stolen_{0};
+};
+
+}  // namespace detail
+}//namespace avc
+
+#endif  // AVC_WORK_STEALING_POOL_HEADER